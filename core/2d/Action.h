@@ -30,6 +30,7 @@ THE SOFTWARE.
 #define __ACTIONS_CCACTION_H__
 
 #include "base/Ref.h"
+#include "base/ObjectAllocator.h"
 #include "math/Math.h"
 #include "base/ScriptSupport.h"
 
@@ -52,6 +53,8 @@ enum
  */
 class AX_DLL Action : public Ref, public Clonable
 {
+    AX_POOLED_ALLOCATION
+
 public:
     /** Default tag used for all the actions. */
     static const int INVALID_TAG = -1;
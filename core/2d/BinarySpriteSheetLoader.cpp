@@ -0,0 +1,663 @@
+#include "2d/BinarySpriteSheetLoader.h"
+#include "2d/PlistSpriteSheetLoader.h"
+
+#include "platform/FileUtils.h"
+#include "2d/AutoPolygon.h"
+#include "2d/SpriteFrameCache.h"
+#include "base/NinePatchImageParser.h"
+#include "base/NS.h"
+#include "base/Macros.h"
+#include "base/Utils.h"
+#include "base/Director.h"
+#include "renderer/Texture2D.h"
+#include "renderer/TextureCache.h"
+
+#include "mio/mio.hpp"
+
+#include <string.h>
+#include <limits.h>
+#include <algorithm>
+#include <vector>
+
+NS_AX_BEGIN
+
+namespace
+{
+/*
+ * Binary sprite sheet layout, all values are little endian:
+ *
+ *   FileHeader
+ *   FrameRecord[frameCount]
+ *   AliasRecord[aliasCount]
+ *   int32_t[polygonIntCount]  vertices, uvs and triangle indices of polygon frames
+ *   char[stringBytes]         frame names, alias names and texture name, not null terminated
+ */
+constexpr char SPRITE_SHEET_MAGIC[]     = "AXSS";
+constexpr uint32_t SPRITE_SHEET_VERSION = 2;
+constexpr int32_t DEFAULT_PIXEL_FORMAT  = -1;
+
+/* Pixel formats are stored as these stable ids rather than backend::PixelFormat values, which change whenever the
+ * backend enum is reordered. Never renumber existing entries. */
+struct SheetPixelFormat
+{
+    int32_t id;
+    backend::PixelFormat format;
+};
+
+constexpr SheetPixelFormat SHEET_PIXEL_FORMATS[] = {
+    {0, backend::PixelFormat::RGBA8},  {1, backend::PixelFormat::RGBA4}, {2, backend::PixelFormat::RGB5A1},
+    {3, backend::PixelFormat::RGB565}, {4, backend::PixelFormat::A8},    {5, backend::PixelFormat::L8},
+    {6, backend::PixelFormat::LA8},    {7, backend::PixelFormat::RGB8},
+};
+
+int32_t toSheetPixelFormat(backend::PixelFormat format)
+{
+    for (auto& item : SHEET_PIXEL_FORMATS)
+    {
+        if (item.format == format)
+            return item.id;
+    }
+    return DEFAULT_PIXEL_FORMAT;
+}
+
+backend::PixelFormat fromSheetPixelFormat(int32_t id)
+{
+    for (auto& item : SHEET_PIXEL_FORMATS)
+    {
+        if (item.id == id)
+            return item.format;
+    }
+    return backend::PixelFormat::NONE;
+}
+
+enum FrameFlags : uint32_t
+{
+    FRAME_ROTATED = 1,
+    FRAME_ANCHOR  = 1 << 1,
+    FRAME_POLYGON = 1 << 2,
+};
+
+struct FileHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t frameCount;
+    uint32_t aliasCount;
+    uint32_t polygonIntCount;
+    uint32_t stringBytes;
+    float textureWidth;
+    float textureHeight;
+    int32_t pixelFormat;
+    uint32_t textureNameOffset;
+    uint32_t textureNameLength;
+};
+
+struct FrameRecord
+{
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    float rect[4];
+    float offset[2];
+    float sourceSize[2];
+    float anchor[2];
+    uint32_t flags;
+    uint32_t polygonOffset;
+    uint32_t vertexIntCount;
+    uint32_t indexCount;
+};
+
+struct AliasRecord
+{
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t frameIndex;
+};
+
+static_assert(sizeof(FileHeader) == 44, "unexpected padding in FileHeader");
+static_assert(sizeof(FrameRecord) == 64, "unexpected padding in FrameRecord");
+static_assert(sizeof(AliasRecord) == 12, "unexpected padding in AliasRecord");
+
+/* Bounds checked view of a binary sprite sheet, records are copied out since the buffer carries no alignment
+ * guarantee. */
+class SpriteSheetView
+{
+public:
+    bool init(const uint8_t* data, size_t size)
+    {
+        if (!data || size < sizeof(FileHeader))
+            return false;
+
+        memcpy(&_header, data, sizeof(_header));
+        if (memcmp(_header.magic, SPRITE_SHEET_MAGIC, sizeof(_header.magic)) != 0 ||
+            _header.version != SPRITE_SHEET_VERSION)
+            return false;
+
+        _data          = data;
+        _framesOffset  = sizeof(FileHeader);
+        _aliasesOffset = _framesOffset + size_t{_header.frameCount} * sizeof(FrameRecord);
+        _polygonOffset = _aliasesOffset + size_t{_header.aliasCount} * sizeof(AliasRecord);
+        _stringsOffset = _polygonOffset + size_t{_header.polygonIntCount} * sizeof(int32_t);
+        return _stringsOffset + _header.stringBytes <= size &&
+               checkString(_header.textureNameOffset, _header.textureNameLength);
+    }
+
+    const FileHeader& header() const { return _header; }
+
+    bool frame(uint32_t index, FrameRecord& record) const
+    {
+        memcpy(&record, _data + _framesOffset + size_t{index} * sizeof(FrameRecord), sizeof(record));
+        return checkString(record.nameOffset, record.nameLength) &&
+               (!(record.flags & FRAME_POLYGON) ||
+                size_t{record.polygonOffset} + size_t{record.vertexIntCount} * 2 + record.indexCount <=
+                    _header.polygonIntCount);
+    }
+
+    bool alias(uint32_t index, AliasRecord& record) const
+    {
+        memcpy(&record, _data + _aliasesOffset + size_t{index} * sizeof(AliasRecord), sizeof(record));
+        return checkString(record.nameOffset, record.nameLength) && record.frameIndex < _header.frameCount;
+    }
+
+    std::string_view string(uint32_t offset, uint32_t length) const
+    {
+        return std::string_view{reinterpret_cast<const char*>(_data + _stringsOffset + offset), length};
+    }
+
+    /* Copies `count` ints of the polygon pool starting at `offset` */
+    void polygonInts(uint32_t offset, uint32_t count, std::vector<int>& out) const
+    {
+        out.resize(count);
+        if (count)
+            memcpy(out.data(), _data + _polygonOffset + size_t{offset} * sizeof(int32_t), count * sizeof(int32_t));
+    }
+
+private:
+    bool checkString(uint32_t offset, uint32_t length) const
+    {
+        return size_t{offset} + length <= _header.stringBytes;
+    }
+
+    FileHeader _header{};
+    const uint8_t* _data  = nullptr;
+    size_t _framesOffset  = 0;
+    size_t _aliasesOffset = 0;
+    size_t _polygonOffset = 0;
+    size_t _stringsOffset = 0;
+};
+
+/* Maps a sprite sheet file into memory, falls back to reading it when the file isn't on the native file system. */
+class SpriteSheetFile
+{
+public:
+    bool open(std::string_view filePath)
+    {
+        const auto fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
+        if (fullPath.empty())
+        {
+            AXLOG("axmol: SpriteFrameCache: can not find %s", filePath.data());
+            return false;
+        }
+
+        std::error_code error;
+        _mmap.map(fullPath, error);
+        if (!error && _mmap.is_mapped())
+            return true;
+
+        _content = FileUtils::getInstance()->getDataFromFile(fullPath);
+        return !_content.isNull();
+    }
+
+    const uint8_t* data() const
+    {
+        return _mmap.is_mapped() ? reinterpret_cast<const uint8_t*>(_mmap.data()) : _content.getBytes();
+    }
+    size_t size() const { return _mmap.is_mapped() ? _mmap.size() : static_cast<size_t>(_content.getSize()); }
+
+private:
+    mio::mmap_source _mmap;
+    Data _content;
+};
+
+/* Whether the triangle list of a polygon frame only refers to its own vertices, `vertexIntCount` is the number of
+ * ints in the vertex array. Indices are stored as unsigned short by PolygonInfo. */
+bool isValidPolygon(uint32_t vertexIntCount, const int* indices, uint32_t indexCount)
+{
+    if (vertexIntCount % 2 != 0 || indexCount % 3 != 0)
+        return false;
+
+    const int64_t vertexCount = std::min<int64_t>(vertexIntCount / 2, int64_t{USHRT_MAX} + 1);
+    for (uint32_t i = 0; i < indexCount; ++i)
+    {
+        if (indices[i] < 0 || indices[i] >= vertexCount)
+            return false;
+    }
+    return true;
+}
+
+class StringTableWriter
+{
+public:
+    uint32_t add(std::string_view str)
+    {
+        const auto offset = static_cast<uint32_t>(_buffer.size());
+        _buffer.append(str);
+        return offset;
+    }
+    const std::string& buffer() const { return _buffer; }
+
+private:
+    std::string _buffer;
+};
+}  // namespace
+
+void BinarySpriteSheetLoader::load(std::string_view filePath, SpriteFrameCache& cache)
+{
+    AXASSERT(!filePath.empty(), "sprite sheet filename should not be empty");
+
+    SpriteSheetFile file;
+    if (file.open(filePath))
+    {
+        auto texturePath = getTexturePath(file.data(), file.size(), filePath);
+        addSpriteFramesWithBuffer(file.data(), file.size(), texturePath, filePath, cache);
+    }
+}
+
+void BinarySpriteSheetLoader::load(std::string_view filePath, Texture2D* texture, SpriteFrameCache& cache)
+{
+    SpriteSheetFile file;
+    if (file.open(filePath))
+        addSpriteFramesWithBuffer(file.data(), file.size(), texture, filePath, cache);
+}
+
+void BinarySpriteSheetLoader::load(std::string_view filePath, std::string_view textureFileName, SpriteFrameCache& cache)
+{
+    AXASSERT(!textureFileName.empty(), "texture name should not be null");
+
+    SpriteSheetFile file;
+    if (file.open(filePath))
+        addSpriteFramesWithBuffer(file.data(), file.size(), textureFileName, filePath, cache);
+}
+
+void BinarySpriteSheetLoader::load(const Data& content, Texture2D* texture, SpriteFrameCache& cache)
+{
+    if (content.isNull())
+    {
+        return;
+    }
+
+    addSpriteFramesWithBuffer(content.getBytes(), static_cast<size_t>(content.getSize()), texture,
+                              "by#addSpriteFramesWithFileContent()", cache);
+}
+
+void BinarySpriteSheetLoader::reload(std::string_view filePath, SpriteFrameCache& cache)
+{
+    SpriteSheetFile file;
+    if (!file.open(filePath))
+        return;
+
+    auto texturePath = getTexturePath(file.data(), file.size(), filePath);
+
+    Texture2D* texture = nullptr;
+    if (Director::getInstance()->getTextureCache()->reloadTexture(texturePath))
+    {
+        texture = Director::getInstance()->getTextureCache()->getTextureForKey(texturePath);
+    }
+
+    if (texture)
+    {
+        addSpriteFramesWithBuffer(file.data(), file.size(), texture, filePath, cache, true);
+    }
+    else
+    {
+        AXLOG("axmol: SpriteFrameCache: Couldn't load texture");
+    }
+}
+
+std::string BinarySpriteSheetLoader::getTexturePath(const uint8_t* data, size_t size, std::string_view path)
+{
+    SpriteSheetView view;
+    if (view.init(data, size) && view.header().textureNameLength)
+    {
+        // build texture path relative to sprite sheet file
+        auto textureName = view.string(view.header().textureNameOffset, view.header().textureNameLength);
+        return FileUtils::getInstance()->fullPathFromRelativeFile(textureName, path);
+    }
+
+    // build texture path by replacing file extension
+    std::string texturePath{path};
+    const auto startPos = texturePath.find_last_of('.');
+    if (startPos != std::string::npos)
+    {
+        texturePath.erase(startPos);
+    }
+    texturePath.append(".png");
+
+    AXLOG("axmol: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    return texturePath;
+}
+
+bool BinarySpriteSheetLoader::addSpriteFramesWithBuffer(const uint8_t* data,
+                                                        size_t size,
+                                                        std::string_view texturePath,
+                                                        std::string_view path,
+                                                        SpriteFrameCache& cache)
+{
+    SpriteSheetView view;
+    if (!view.init(data, size))
+    {
+        AXLOG("axmol: SpriteFrameCache: %s is not a valid binary sprite sheet", path.data());
+        return false;
+    }
+
+    Texture2D* texture     = nullptr;
+    const auto pixelFormat = fromSheetPixelFormat(view.header().pixelFormat);
+    if (pixelFormat != backend::PixelFormat::NONE)
+    {
+        texture = Director::getInstance()->getTextureCache()->addImage(texturePath, pixelFormat);
+    }
+    else
+    {
+        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+    }
+
+    if (!texture)
+    {
+        AXLOG("axmol: SpriteFrameCache: Couldn't load texture");
+        return false;
+    }
+
+    return addSpriteFramesWithBuffer(data, size, texture, path, cache);
+}
+
+bool BinarySpriteSheetLoader::addSpriteFramesWithBuffer(const uint8_t* data,
+                                                        size_t size,
+                                                        Texture2D* texture,
+                                                        std::string_view path,
+                                                        SpriteFrameCache& cache,
+                                                        bool reload)
+{
+    SpriteSheetView view;
+    if (!view.init(data, size))
+    {
+        AXLOG("axmol: SpriteFrameCache: %s is not a valid binary sprite sheet", path.data());
+        return false;
+    }
+
+    auto& header = view.header();
+
+    auto spriteSheet    = std::make_shared<SpriteSheet>();
+    spriteSheet->format = getFormat();
+    spriteSheet->path   = path;
+
+    const Vec2 textureSize{header.textureWidth, header.textureHeight};
+    std::vector<SpriteFrame*> frames(header.frameCount, nullptr);
+    std::vector<int> polygonInts;
+
+    std::string textureFileName;
+    Image* image = nullptr;
+    NinePatchImageParser parser;
+
+    FrameRecord record;
+    for (uint32_t i = 0; i < header.frameCount; ++i)
+    {
+        if (!view.frame(i, record))
+        {
+            AXLOG("axmol: SpriteFrameCache: corrupted frame record %u in %s", i, path.data());
+            break;
+        }
+
+        const auto spriteFrameName = view.string(record.nameOffset, record.nameLength);
+        if (reload)
+        {
+            cache.eraseFrame(spriteFrameName);
+        }
+        else if (cache.findFrame(spriteFrameName))
+        {
+            continue;
+        }
+
+        const Vec2 sourceSize{record.sourceSize[0], record.sourceSize[1]};
+
+        PolygonInfo info;
+        const bool hasPolygon = !reload && (record.flags & FRAME_POLYGON);
+        if (hasPolygon)
+        {
+            const auto vertexInts = record.vertexIntCount;
+            view.polygonInts(record.polygonOffset, vertexInts * 2 + record.indexCount, polygonInts);
+
+            // out of range indices would make the renderer read past the vertices, the frame is dropped
+            if (!isValidPolygon(vertexInts, polygonInts.data() + vertexInts * 2, record.indexCount))
+            {
+                AXLOG("axmol: SpriteFrameCache: invalid polygon of frame %s in %s",
+                      std::string{spriteFrameName}.c_str(), path.data());
+                continue;
+            }
+            initializePolygonInfo(textureSize, sourceSize, polygonInts.data(), polygonInts.data() + vertexInts,
+                                  vertexInts, polygonInts.data() + vertexInts * 2, record.indexCount, info);
+        }
+
+        auto* spriteFrame = SpriteFrame::createWithTexture(
+            texture, Rect(record.rect[0], record.rect[1], record.rect[2], record.rect[3]),
+            (record.flags & FRAME_ROTATED) != 0, Vec2(record.offset[0], record.offset[1]), sourceSize);
+        if (hasPolygon)
+        {
+            spriteFrame->setPolygonInfo(info);
+        }
+        if (!reload && (record.flags & FRAME_ANCHOR))
+        {
+            spriteFrame->setAnchorPoint(Vec2(record.anchor[0], record.anchor[1]));
+        }
+
+        if (!reload && NinePatchImageParser::isNinePatchImage(spriteFrameName))
+        {
+            if (image == nullptr)
+            {
+                textureFileName = Director::getInstance()->getTextureCache()->getTextureFilePath(texture);
+                image           = new Image();
+                image->initWithImageFile(textureFileName);
+            }
+            parser.setSpriteFrameInfo(image, spriteFrame->getRectInPixels(), spriteFrame->isRotated());
+            cache.addSpriteFrameCapInset(spriteFrame, parser.parseCapInset(), texture);
+        }
+
+        cache.insertFrame(spriteSheet, spriteFrameName, spriteFrame);
+        frames[i] = spriteFrame;
+    }
+
+    AliasRecord alias;
+    for (uint32_t i = 0; i < header.aliasCount; ++i)
+    {
+        if (!view.alias(i, alias))
+        {
+            AXLOG("axmol: SpriteFrameCache: corrupted alias record %u in %s", i, path.data());
+            break;
+        }
+
+        auto* spriteFrame = frames[alias.frameIndex];
+        if (!spriteFrame)
+            continue;
+
+        const auto aliasName = view.string(alias.nameOffset, alias.nameLength);
+        if (reload)
+        {
+            cache.eraseFrame(aliasName);
+        }
+        else if (cache.findFrame(aliasName))
+        {
+            AXLOGWARN("axmol: WARNING: an alias with name %s already exists", std::string{aliasName}.c_str());
+            continue;
+        }
+        cache.insertFrame(spriteSheet, aliasName, spriteFrame);
+    }
+
+    spriteSheet->full = true;
+
+    AX_SAFE_DELETE(image);
+    return true;
+}
+
+bool BinarySpriteSheetLoader::convertFromPlist(std::string_view plistPath, std::string_view outputPath)
+{
+    auto fileUtils      = FileUtils::getInstance();
+    const auto fullPath = fileUtils->fullPathForFilename(plistPath);
+    if (fullPath.empty())
+    {
+        AXLOG("axmol: BinarySpriteSheetLoader: can not find %s", plistPath.data());
+        return false;
+    }
+
+    auto dict = fileUtils->getValueMapFromFile(fullPath);
+    if (dict["frames"].getType() != Value::Type::MAP)
+    {
+        AXLOG("axmol: BinarySpriteSheetLoader: %s has no frames", plistPath.data());
+        return false;
+    }
+
+    FileHeader header{};
+    memcpy(header.magic, SPRITE_SHEET_MAGIC, sizeof(header.magic));
+    header.version     = SPRITE_SHEET_VERSION;
+    header.pixelFormat = DEFAULT_PIXEL_FORMAT;
+
+    StringTableWriter strings;
+    int format = 0;
+
+    auto metaItr = dict.find("metadata"sv);
+    if (metaItr != dict.end())
+    {
+        auto& metadataDict = metaItr->second.asValueMap();
+        format             = optValue(metadataDict, "format"sv).asInt();
+
+        auto textureSize     = SizeFromString(optValue(metadataDict, "size"sv).asString());
+        header.textureWidth  = textureSize.width;
+        header.textureHeight = textureSize.height;
+
+        auto textureFileName     = optValue(metadataDict, "textureFileName"sv).asString();
+        header.textureNameOffset = strings.add(textureFileName);
+        header.textureNameLength = static_cast<uint32_t>(textureFileName.size());
+
+        header.pixelFormat = toSheetPixelFormat(
+            PlistSpriteSheetLoader::getPixelFormatByName(optValue(metadataDict, "pixelFormat"sv).asString()));
+    }
+
+    if (format < 0 || format > 3)
+    {
+        AXLOG("axmol: BinarySpriteSheetLoader: plist format %d is not supported", format);
+        return false;
+    }
+
+    std::vector<FrameRecord> frames;
+    std::vector<AliasRecord> aliases;
+    std::vector<int32_t> polygons;
+    hlookup::string_set aliasNames;
+
+    auto& framesDict = dict["frames"].asValueMap();
+    frames.reserve(framesDict.size());
+    for (auto&& iter : framesDict)
+    {
+        auto& frameDict = iter.second.asValueMap();
+
+        FrameRecord record{};
+        record.nameOffset = strings.add(iter.first);
+        record.nameLength = static_cast<uint32_t>(iter.first.size());
+
+        Rect rect;
+        Vec2 offset;
+        Vec2 sourceSize;
+        bool rotated = false;
+        if (format == 0)
+        {
+            rect.setRect(optValue(frameDict, "x"sv).asFloat(), optValue(frameDict, "y"sv).asFloat(),
+                         optValue(frameDict, "width"sv).asFloat(), optValue(frameDict, "height"sv).asFloat());
+            offset.set(optValue(frameDict, "offsetX"sv).asFloat(), optValue(frameDict, "offsetY"sv).asFloat());
+            sourceSize.set((float)std::abs(optValue(frameDict, "originalWidth"sv).asInt()),
+                           (float)std::abs(optValue(frameDict, "originalHeight"sv).asInt()));
+        }
+        else if (format == 1 || format == 2)
+        {
+            rect       = RectFromString(optValue(frameDict, "frame"sv).asString());
+            rotated    = format == 2 && optValue(frameDict, "rotated"sv).asBool();
+            offset     = PointFromString(optValue(frameDict, "offset"sv).asString());
+            sourceSize = SizeFromString(optValue(frameDict, "sourceSize"sv).asString());
+        }
+        else
+        {
+            auto spriteSize  = SizeFromString(optValue(frameDict, "spriteSize"sv).asString());
+            auto textureRect = RectFromString(optValue(frameDict, "textureRect"sv).asString());
+            rect.setRect(textureRect.origin.x, textureRect.origin.y, spriteSize.width, spriteSize.height);
+            rotated    = optValue(frameDict, "textureRotated"sv).asBool();
+            offset     = PointFromString(optValue(frameDict, "spriteOffset"sv).asString());
+            sourceSize = SizeFromString(optValue(frameDict, "spriteSourceSize"sv).asString());
+
+            for (const auto& value : optValue(frameDict, "aliases"sv).asValueVector())
+            {
+                auto aliasName = value.asString();
+                if (!aliasNames.emplace(aliasName).second)
+                {
+                    AXLOGWARN("axmol: WARNING: an alias with name %s already exists", aliasName.c_str());
+                    continue;
+                }
+                aliases.push_back(AliasRecord{strings.add(aliasName), static_cast<uint32_t>(aliasName.size()),
+                                              static_cast<uint32_t>(frames.size())});
+            }
+
+            if (frameDict.find("vertices") != frameDict.end())
+            {
+                using ax::utils::parseIntegerList;
+                auto vertices   = parseIntegerList(optValue(frameDict, "vertices"sv).asString());
+                auto verticesUV = parseIntegerList(optValue(frameDict, "verticesUV"sv).asString());
+                auto indices    = parseIntegerList(optValue(frameDict, "triangles"sv).asString());
+                if (vertices.size() == verticesUV.size())
+                {
+                    record.flags |= FRAME_POLYGON;
+                    record.polygonOffset  = static_cast<uint32_t>(polygons.size());
+                    record.vertexIntCount = static_cast<uint32_t>(vertices.size());
+                    record.indexCount     = static_cast<uint32_t>(indices.size());
+                    polygons.insert(polygons.end(), vertices.begin(), vertices.end());
+                    polygons.insert(polygons.end(), verticesUV.begin(), verticesUV.end());
+                    polygons.insert(polygons.end(), indices.begin(), indices.end());
+                }
+                else
+                {
+                    AXLOGWARN("axmol: WARNING: vertices and verticesUV of %s don't match", iter.first.c_str());
+                }
+            }
+            if (frameDict.find("anchor") != frameDict.end())
+            {
+                auto anchor = PointFromString(optValue(frameDict, "anchor"sv).asString());
+                record.flags |= FRAME_ANCHOR;
+                record.anchor[0] = anchor.x;
+                record.anchor[1] = anchor.y;
+            }
+        }
+
+        if (rotated)
+            record.flags |= FRAME_ROTATED;
+        record.rect[0]       = rect.origin.x;
+        record.rect[1]       = rect.origin.y;
+        record.rect[2]       = rect.size.width;
+        record.rect[3]       = rect.size.height;
+        record.offset[0]     = offset.x;
+        record.offset[1]     = offset.y;
+        record.sourceSize[0] = sourceSize.x;
+        record.sourceSize[1] = sourceSize.y;
+        frames.push_back(record);
+    }
+
+    header.frameCount      = static_cast<uint32_t>(frames.size());
+    header.aliasCount      = static_cast<uint32_t>(aliases.size());
+    header.polygonIntCount = static_cast<uint32_t>(polygons.size());
+    header.stringBytes     = static_cast<uint32_t>(strings.buffer().size());
+
+    std::string buffer;
+    buffer.reserve(sizeof(header) + frames.size() * sizeof(FrameRecord) + aliases.size() * sizeof(AliasRecord) +
+                   polygons.size() * sizeof(int32_t) + strings.buffer().size());
+    buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    buffer.append(reinterpret_cast<const char*>(frames.data()), frames.size() * sizeof(FrameRecord));
+    buffer.append(reinterpret_cast<const char*>(aliases.data()), aliases.size() * sizeof(AliasRecord));
+    buffer.append(reinterpret_cast<const char*>(polygons.data()), polygons.size() * sizeof(int32_t));
+    buffer.append(strings.buffer());
+
+    return FileUtils::writeBinaryToFile(buffer.data(), buffer.size(), outputPath);
+}
+
+NS_AX_END
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+
+#include "2d/SpriteSheetLoader.h"
+#include "base/Data.h"
+
+NS_AX_BEGIN
+
+/**
+ * Loads sprite sheets stored in the compact "AXSS" binary format.
+ *
+ * Frames are read straight out of a memory mapped file (or a Data buffer when the file can't be mapped, e.g. inside
+ * an apk), so no ValueMap tree is built and no "{{x,y},{w,h}}" strings are parsed at load time. Files are produced
+ * offline from TexturePacker/Zwoptex plists with convertFromPlist().
+ */
+class BinarySpriteSheetLoader : public SpriteSheetLoader
+{
+public:
+    static constexpr uint32_t FORMAT = SpriteSheetFormat::BINARY;
+
+    uint32_t getFormat() override { return FORMAT; }
+    void load(std::string_view filePath, SpriteFrameCache& cache) override;
+    void load(std::string_view filePath, Texture2D* texture, SpriteFrameCache& cache) override;
+    void load(std::string_view filePath, std::string_view textureFileName, SpriteFrameCache& cache) override;
+    void load(const Data& content, Texture2D* texture, SpriteFrameCache& cache) override;
+    void reload(std::string_view filePath, SpriteFrameCache& cache) override;
+
+    /** Converts a plist sprite sheet (format 0 - 3) to the binary format.
+     *
+     * @param plistPath The plist file to convert.
+     * @param outputPath The full path of the binary file to write.
+     * @return true if the binary file was written.
+     */
+    static bool convertFromPlist(std::string_view plistPath, std::string_view outputPath);
+
+protected:
+    /* Adds the frames of a binary sprite sheet buffer, the texture will be associated with the created sprite frames.
+     */
+    bool addSpriteFramesWithBuffer(const uint8_t* data,
+                                   size_t size,
+                                   Texture2D* texture,
+                                   std::string_view path,
+                                   SpriteFrameCache& cache,
+                                   bool reload = false);
+
+    /* Resolves the texture of a binary sprite sheet buffer and adds its frames. */
+    bool addSpriteFramesWithBuffer(const uint8_t* data,
+                                   size_t size,
+                                   std::string_view texturePath,
+                                   std::string_view path,
+                                   SpriteFrameCache& cache);
+
+    /* Gets the texture path stored in the buffer relative to `path`, or `path` with a .png extension. */
+    std::string getTexturePath(const uint8_t* data, size_t size, std::string_view path);
+};
+
+NS_AX_END
@@ -365,13 +365,18 @@ void Camera::unprojectGL(const Vec2& viewport, const Vec3* src, Vec3* dst) const
 }
 
 bool Camera::isVisibleInFrustum(const AABB* aabb) const
+{
+    return !getFrustum().isOutOfFrustum(*aabb);
+}
+
+const Frustum& Camera::getFrustum() const
 {
     if (_frustumDirty)
     {
         _frustum.initFrustum(this);
         _frustumDirty = false;
     }
-    return !_frustum.isOutOfFrustum(*aabb);
+    return _frustum;
 }
 
 float Camera::getDepthInView(const Mat4& transform) const
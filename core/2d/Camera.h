@@ -195,6 +195,11 @@ public:
      */
     bool isVisibleInFrustum(const AABB* aabb) const;
 
+    /**
+     * Get the frustum of the camera, updated when the view projection matrix changed
+     */
+    const Frustum& getFrustum() const;
+
     /**
      * Get object depth towards camera
      */
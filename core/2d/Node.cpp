@@ -69,7 +69,21 @@ int Node::__attachedNodeCount              = 0;
 // MARK: Constructor, Destructor, Init
 
 Node::Node()
-    : _rotationX(0.0f)
+    : _parent(nullptr)
+    , _localZOrder$Arrival(0LL)
+    , _globalZOrder(0)
+    , _cameraMask(1)
+    , _visible(true)
+    , _reorderChildDirty(false)
+    , _contentSizeDirty(true)
+    , _transformDirty(true)
+    , _inverseDirty(true)
+    , _additionalTransformDirty(false)
+    , _transformUpdated(true)
+    , _usingNormalizedPosition(false)
+    , _normalizedPositionDirty(false)
+    , _additionalTransform(nullptr)
+    , _rotationX(0.0f)
     , _rotationY(0.0f)
     , _rotationZ_X(0.0f)
     , _rotationZ_Y(0.0f)
@@ -77,53 +91,33 @@ Node::Node()
     , _scaleY(1.0f)
     , _scaleZ(1.0f)
     , _positionZ(0.0f)
-    , _usingNormalizedPosition(false)
-    , _normalizedPositionDirty(false)
     , _skewX(0.0f)
     , _skewY(0.0f)
     , _anchorPoint(0, 0)
     , _contentSize(Vec2::ZERO)
-    , _contentSizeDirty(true)
-    , _transformDirty(true)
-    , _inverseDirty(true)
-    , _additionalTransform(nullptr)
-    , _additionalTransformDirty(false)
-    , _transformUpdated(true)
+    // "whole screen" objects. like Scenes and Layers, should set _ignoreAnchorPointForPosition to true
+    , _ignoreAnchorPointForPosition(false)
     // children (lazy allocs)
     , _childrenIndexer(nullptr)
-    // lazy alloc
-    , _localZOrder$Arrival(0LL)
-    , _globalZOrder(0)
-    , _parent(nullptr)
-    // "whole screen" objects. like Scenes and Layers, should set _ignoreAnchorPointForPosition to true
     , _tag(Node::INVALID_TAG)
     , _name()
     , _hashOfName(0)
-    // userData is always inited as nil
-    , _userData(nullptr)
-    , _userObject(nullptr)
     , _running(false)
-    , _visible(true)
-    , _ignoreAnchorPointForPosition(false)
-    , _reorderChildDirty(false)
     , _isTransitionFinished(false)
+    , _cascadeColorEnabled(false)
+    , _cascadeOpacityEnabled(false)
+    , _childFollowCameraMask(false)
 #if AX_ENABLE_SCRIPT_BINDING
     , _scriptHandler(0)
     , _updateScriptHandler(0)
 #endif
     , _componentContainer(nullptr)
-    , _displayedOpacity(255)
-    , _realOpacity(255)
     , _displayedColor(Color3B::WHITE)
+    , _displayedOpacity(255)
     , _realColor(Color3B::WHITE)
-    , _cascadeColorEnabled(false)
-    , _cascadeOpacityEnabled(false)
-    , _childFollowCameraMask(false)
-    , _cameraMask(1)
-    , _onEnterCallback(nullptr)
-    , _onExitCallback(nullptr)
-    , _onEnterTransitionDidFinishCallback(nullptr)
-    , _onExitTransitionDidStartCallback(nullptr)
+    , _realOpacity(255)
+    // userData, userObject and the event callbacks are allocated on first use
+    , _extension(nullptr)
 #if AX_USE_PHYSICS
     , _physicsBody(nullptr)
 #endif
@@ -137,7 +131,7 @@ Node::Node()
     _eventDispatcher = _director->getEventDispatcher();
     _eventDispatcher->retain();
 
-    _transform = _inverse = Mat4::IDENTITY;
+    _transform = Mat4::IDENTITY;
 }
 
 Node* Node::create()
@@ -170,7 +164,8 @@ Node::~Node()
     // User object has to be released before others, since userObject may have a weak reference of this node
     // It may invoke `node->stopAllActions();` while `_actionManager` is null if the next line is after
     // `AX_SAFE_RELEASE_NULL(_actionManager)`.
-    AX_SAFE_RELEASE_NULL(_userObject);
+    if (_extension)
+        AX_SAFE_RELEASE_NULL(_extension->userObject);
 
     for (auto&& child : _children)
     {
@@ -198,6 +193,7 @@ Node::~Node()
     AX_SAFE_RELEASE(_eventDispatcher);
 
     delete[] _additionalTransform;
+    delete _extension;
     AX_SAFE_RELEASE(_programState);
 }
 
@@ -760,24 +756,82 @@ NodeIndexerMap_t* Node::getParentChildrenIndexer()
 /// userData setter
 void Node::setUserData(void* userData)
 {
-    _userData = userData;
+    if (userData || _extension)
+        getExtension()->userData = userData;
 }
 
 void Node::setUserObject(Ref* userObject)
 {
+    if (!userObject && !_extension)
+        return;
+
+    auto& currentObject = getExtension()->userObject;
 #if AX_ENABLE_GC_FOR_NATIVE_OBJECTS
     auto sEngine = ScriptEngineManager::getInstance()->getScriptEngine();
     if (sEngine)
     {
         if (userObject)
             sEngine->retainScriptObject(this, userObject);
-        if (_userObject)
-            sEngine->releaseScriptObject(this, _userObject);
+        if (currentObject)
+            sEngine->releaseScriptObject(this, currentObject);
     }
 #endif  // AX_ENABLE_GC_FOR_NATIVE_OBJECTS
     AX_SAFE_RETAIN(userObject);
-    AX_SAFE_RELEASE(_userObject);
-    _userObject = userObject;
+    AX_SAFE_RELEASE(currentObject);
+    currentObject = userObject;
+}
+
+Node::Extension* Node::getExtension() const
+{
+    if (!_extension)
+        _extension = new Extension();
+    return _extension;
+}
+
+static const std::function<void()> s_emptyNodeCallback;
+
+void Node::setOnEnterCallback(const std::function<void()>& callback)
+{
+    if (callback || _extension)
+        getExtension()->onEnterCallback = callback;
+}
+
+const std::function<void()>& Node::getOnEnterCallback() const
+{
+    return _extension ? _extension->onEnterCallback : s_emptyNodeCallback;
+}
+
+void Node::setOnExitCallback(const std::function<void()>& callback)
+{
+    if (callback || _extension)
+        getExtension()->onExitCallback = callback;
+}
+
+const std::function<void()>& Node::getOnExitCallback() const
+{
+    return _extension ? _extension->onExitCallback : s_emptyNodeCallback;
+}
+
+void Node::setOnEnterTransitionDidFinishCallback(const std::function<void()>& callback)
+{
+    if (callback || _extension)
+        getExtension()->onEnterTransitionDidFinishCallback = callback;
+}
+
+const std::function<void()>& Node::getOnEnterTransitionDidFinishCallback() const
+{
+    return _extension ? _extension->onEnterTransitionDidFinishCallback : s_emptyNodeCallback;
+}
+
+void Node::setOnExitTransitionDidStartCallback(const std::function<void()>& callback)
+{
+    if (callback || _extension)
+        getExtension()->onExitTransitionDidStartCallback = callback;
+}
+
+const std::function<void()>& Node::getOnExitTransitionDidStartCallback() const
+{
+    return _extension ? _extension->onExitTransitionDidStartCallback : s_emptyNodeCallback;
 }
 
 Scene* Node::getScene() const
@@ -1335,8 +1389,8 @@ void Node::onEnter()
         ++__attachedNodeCount;
     }
 
-    if (_onEnterCallback)
-        _onEnterCallback();
+    if (_extension && _extension->onEnterCallback)
+        _extension->onEnterCallback();
 
     if (_componentContainer && !_componentContainer->isEmpty())
     {
@@ -1359,8 +1413,8 @@ void Node::onEnter()
 
 void Node::onEnterTransitionDidFinish()
 {
-    if (_onEnterTransitionDidFinishCallback)
-        _onEnterTransitionDidFinishCallback();
+    if (_extension && _extension->onEnterTransitionDidFinishCallback)
+        _extension->onEnterTransitionDidFinishCallback();
 
     _isTransitionFinished = true;
     for (const auto& child : _children)
@@ -1373,8 +1427,8 @@ void Node::onEnterTransitionDidFinish()
 
 void Node::onExitTransitionDidStart()
 {
-    if (_onExitTransitionDidStartCallback)
-        _onExitTransitionDidStartCallback();
+    if (_extension && _extension->onExitTransitionDidStartCallback)
+        _extension->onExitTransitionDidStartCallback();
 
     for (const auto& child : _children)
         child->onExitTransitionDidStart();
@@ -1391,8 +1445,8 @@ void Node::onExit()
         --__attachedNodeCount;
     }
 
-    if (_onExitCallback)
-        _onExitCallback();
+    if (_extension && _extension->onExitCallback)
+        _extension->onExitCallback();
 
     if (_componentContainer && !_componentContainer->isEmpty())
     {
@@ -33,6 +33,7 @@
 
 #include <cstdint>
 #include "base/Macros.h"
+#include "base/ObjectAllocator.h"
 #include "base/Vector.h"
 #include "base/Protocols.h"
 #include "base/ScriptSupport.h"
@@ -116,6 +117,8 @@ Node and override `draw`.
 
 class AX_DLL Node : public Ref
 {
+    AX_POOLED_ALLOCATION
+
 public:
     /** Default tag used for all the nodes */
     static const int INVALID_TAG = -1;
@@ -1005,11 +1008,11 @@ public:
      * @return A custom user data pointer.
      * @lua NA
      */
-    virtual void* getUserData() { return _userData; }
+    virtual void* getUserData() { return _extension ? _extension->userData : nullptr; }
     /**
      * @lua NA
      */
-    virtual const void* getUserData() const { return _userData; }
+    virtual const void* getUserData() const { return _extension ? _extension->userData : nullptr; }
 
     /**
      * Sets a custom user data pointer.
@@ -1031,11 +1034,11 @@ public:
      * @return A user assigned Object.
      * @lua NA
      */
-    virtual Ref* getUserObject() { return _userObject; }
+    virtual Ref* getUserObject() { return _extension ? _extension->userObject : nullptr; }
     /**
      * @lua NA
      */
-    virtual const Ref* getUserObject() const { return _userObject; }
+    virtual const Ref* getUserObject() const { return _extension ? _extension->userObject : nullptr; }
 
     /**
      * Returns a user assigned Object.
@@ -1752,54 +1755,42 @@ public:
      * Set the callback of event onEnter.
      * @param callback A std::function<void()> callback.
      */
-    void setOnEnterCallback(const std::function<void()>& callback) { _onEnterCallback = callback; }
+    void setOnEnterCallback(const std::function<void()>& callback);
     /**
      * Get the callback of event onEnter.
      * @return A std:function<void()> callback.
      */
-    const std::function<void()>& getOnEnterCallback() const { return _onEnterCallback; }
+    const std::function<void()>& getOnEnterCallback() const;
     /**
      * Set the callback of event onExit.
      * @param callback A std::function<void()> callback.
      */
-    void setOnExitCallback(const std::function<void()>& callback) { _onExitCallback = callback; }
+    void setOnExitCallback(const std::function<void()>& callback);
     /**
      * Get the callback of event onExit.
      * @return A std::function<void()>.
      */
-    const std::function<void()>& getOnExitCallback() const { return _onExitCallback; }
+    const std::function<void()>& getOnExitCallback() const;
     /**
      * Set the callback of event EnterTransitionDidFinish.
      * @param callback A std::function<void()> callback.
      */
-    void setOnEnterTransitionDidFinishCallback(const std::function<void()>& callback)
-    {
-        _onEnterTransitionDidFinishCallback = callback;
-    }
+    void setOnEnterTransitionDidFinishCallback(const std::function<void()>& callback);
     /**
      * Get the callback of event EnterTransitionDidFinish.
      * @return std::function<void()>
      */
-    const std::function<void()>& getOnEnterTransitionDidFinishCallback() const
-    {
-        return _onEnterTransitionDidFinishCallback;
-    }
+    const std::function<void()>& getOnEnterTransitionDidFinishCallback() const;
     /**
      * Set the callback of event ExitTransitionDidStart.
      * @param callback A std::function<void()> callback.
      */
-    void setOnExitTransitionDidStartCallback(const std::function<void()>& callback)
-    {
-        _onExitTransitionDidStartCallback = callback;
-    }
+    void setOnExitTransitionDidStartCallback(const std::function<void()>& callback);
     /**
      * Get the callback of event ExitTransitionDidStart.
      * @return std::function<void()>
      */
-    const std::function<void()>& getOnExitTransitionDidStartCallback() const
-    {
-        return _onExitTransitionDidStartCallback;
-    }
+    const std::function<void()>& getOnExitTransitionDidStartCallback() const;
 
     /**
      * get & set camera mask, the node is visible by the camera whose camera flag & node's camera mask is true
@@ -1897,37 +1888,30 @@ private:
     NodeIndexerMap_t* getParentChildrenIndexer();
 
 protected:
-    float _rotationX;  ///< rotation on the X-axis
-    float _rotationY;  ///< rotation on the Y-axis
-
-    // rotation Z is decomposed in 2 to simulate Skew for Flash animations
-    float _rotationZ_X;  ///< rotation angle on Z-axis, component X
-    float _rotationZ_Y;  ///< rotation angle on Z-axis, component Y
-
-    Quaternion _rotationQuat;  /// rotation using quaternion, if _rotationZ_X == _rotationZ_Y, _rotationQuat =
-                               /// RotationZ_X * RotationY * RotationX, else _rotationQuat = RotationY * RotationX
-
-    float _scaleX;  ///< scaling factor on x-axis
-    float _scaleY;  ///< scaling factor on y-axis
-    float _scaleZ;  ///< scaling factor on z-axis
-
-    Vec2 _position;    ///< position of the node
-    float _positionZ;  ///< OpenGL real Z position
-    Vec2 _normalizedPosition;
-
-    float _skewX;  ///< skew angle on x-axis
-    float _skewY;  ///< skew angle on y-axis
+    /// rarely used state, allocated by getExtension() on first write
+    struct Extension
+    {
+        void* userData  = nullptr;  ///< A user assigned void pointer, Can be point to any cpp object
+        Ref* userObject = nullptr;  ///< A user assigned Object
 
-    Vec2 _anchorPointInPoints;  ///< anchor point in points
-    Vec2 _anchorPoint;          ///< anchor point normalized (NOT in points)
+        std::function<void()> onEnterCallback;
+        std::function<void()> onExitCallback;
+        std::function<void()> onEnterTransitionDidFinishCallback;
+        std::function<void()> onExitTransitionDidStartCallback;
+    };
 
-    Vec2 _contentSize;  ///< untransformed size of the node
+    Extension* getExtension() const;
 
+    // Traversal hot data, visit(), processParentFlags() and sortAllChildren() read it every frame. It leads the
+    // object so a visit touches the fewest cache lines, the transform components follow and rarely used state comes
+    // last or lives in the extension.
     Mat4 _modelViewTransform;  ///< ModelView transform of the Node.
     // "cache" variables are allowed to be mutable
-    mutable Mat4 _transform;             ///< transform
-    mutable Mat4 _inverse;               ///< inverse transform
-    mutable Mat4* _additionalTransform;  ///< two transforms needed by additional transforms
+    mutable Mat4 _transform;  ///< transform
+
+    Vector<Node*> _children;  ///< array of children nodes
+    Node* _parent;            ///< weak reference to parent node
+    Director* _director;      // cached director pointer to improve rendering performance
 
 #if AX_LITTLE_ENDIAN
     union
@@ -1953,48 +1937,73 @@ protected:
 
     float _globalZOrder;  ///< Global order used to sort the node
 
+    // camera mask, it is visible only when _cameraMask & current camera' camera flag is true
+    unsigned short _cameraMask;
+
+    bool _visible;            ///< is this node visible
+    bool _reorderChildDirty;  ///< children order dirty flag
+    bool _contentSizeDirty;   ///< whether or not the contentSize is dirty
+
+    mutable bool _transformDirty;            ///< transform dirty flag
+    mutable bool _inverseDirty;              ///< inverse transform dirty flag
+    mutable bool _additionalTransformDirty;  ///< transform dirty ?
+    bool _transformUpdated;                  ///< Whether or not the Transform object was updated since the last frame
+
+    bool _usingNormalizedPosition;
+    bool _normalizedPositionDirty;
+
+    mutable Mat4* _additionalTransform;  ///< two transforms needed by additional transforms
+    mutable Mat4 _inverse;               ///< inverse transform, rebuilt lazily when _inverseDirty is set
+
+    // transform components, read when the transform is rebuilt
+    float _rotationX;  ///< rotation on the X-axis
+    float _rotationY;  ///< rotation on the Y-axis
+
+    // rotation Z is decomposed in 2 to simulate Skew for Flash animations
+    float _rotationZ_X;  ///< rotation angle on Z-axis, component X
+    float _rotationZ_Y;  ///< rotation angle on Z-axis, component Y
+
+    Quaternion _rotationQuat;  /// rotation using quaternion, if _rotationZ_X == _rotationZ_Y, _rotationQuat =
+                               /// RotationZ_X * RotationY * RotationX, else _rotationQuat = RotationY * RotationX
+
+    float _scaleX;  ///< scaling factor on x-axis
+    float _scaleY;  ///< scaling factor on y-axis
+    float _scaleZ;  ///< scaling factor on z-axis
+
+    Vec2 _position;    ///< position of the node
+    float _positionZ;  ///< OpenGL real Z position
+    Vec2 _normalizedPosition;
+
+    float _skewX;  ///< skew angle on x-axis
+    float _skewY;  ///< skew angle on y-axis
+
+    Vec2 _anchorPointInPoints;  ///< anchor point in points
+    Vec2 _anchorPoint;          ///< anchor point normalized (NOT in points)
+
+    Vec2 _contentSize;  ///< untransformed size of the node
+
+    bool _ignoreAnchorPointForPosition;  ///< true if the Anchor Vec2 will be (0,0) when you position the Node, false
+                                         ///< otherwise. Used by Layer and Scene.
+
     static std::uint32_t s_globalOrderOfArrival;
 
-    Vector<Node*> _children;             ///< array of children nodes
     NodeIndexerMap_t* _childrenIndexer;  ///< The children indexer for fast find child
-    Node* _parent;                       ///< weak reference to parent node
-    Director* _director;                 // cached director pointer to improve rendering performance
     int _tag;                            ///< a tag. Can be any number you assigned just to identify this node
 
     std::string _name;     ///< a string label, an user defined string to identify this node
     uint64_t _hashOfName;  ///< hash value of _name, used for speed in getChildByName
 
-    void* _userData;   ///< A user assigned void pointer, Can be point to any cpp object
-    Ref* _userObject;  ///< A user assigned Object
-
     Scheduler* _scheduler;  ///< scheduler used to schedule timers and updates
 
     ActionManager* _actionManager;  ///< a pointer to ActionManager singleton, which is used to handle all the actions
 
     EventDispatcher* _eventDispatcher;  ///< event dispatcher used to dispatch all kinds of events
 
-    bool _reorderChildDirty;             ///< children order dirty flag
-    bool _running;                       ///< is running
-    bool _visible;                       ///< is this node visible
-    bool _ignoreAnchorPointForPosition;  ///< true if the Anchor Vec2 will be (0,0) when you position the Node, false
-                                         ///< otherwise. Used by Layer and Scene.
-
+    bool _running;               ///< is running
     bool _isTransitionFinished;  ///< flag to indicate whether the transition was finished
     bool _cascadeColorEnabled;
     bool _cascadeOpacityEnabled;
-    bool _contentSizeDirty;  ///< whether or not the contentSize is dirty
-
-    mutable bool _transformDirty;            ///< transform dirty flag
-    mutable bool _inverseDirty;              ///< inverse transform dirty flag
-    mutable bool _additionalTransformDirty;  ///< transform dirty ?
-    bool _transformUpdated;                  ///< Whether or not the Transform object was updated since the last frame
-
-    bool _usingNormalizedPosition;
-    bool _normalizedPositionDirty;
-    
     bool _childFollowCameraMask;
-    // camera mask, it is visible only when _cameraMask & current camera' camera flag is true
-    unsigned short _cameraMask;
 
 #if AX_ENABLE_SCRIPT_BINDING
     int _scriptHandler;        ///< script handler for onEnter() & onExit(), used in Javascript binding and Lua binding.
@@ -2010,10 +2019,7 @@ protected:
     Color3B _realColor;
     uint8_t _realOpacity;
 
-    std::function<void()> _onEnterCallback;
-    std::function<void()> _onExitCallback;
-    std::function<void()> _onEnterTransitionDidFinishCallback;
-    std::function<void()> _onExitTransitionDidStartCallback;
+    mutable Extension* _extension;
 
     backend::ProgramState* _programState = nullptr;
 
@@ -57,6 +57,16 @@ THE SOFTWARE.
 #include "base/Utils.h"
 #include "renderer/TextureCache.h"
 #include "platform/FileUtils.h"
+#include "base/JobSystem.h"
+
+// SSE2 & NEON are always available on x64 & arm64
+#if defined(__aarch64__) || defined(_M_ARM64)
+#    include <arm_neon.h>
+#    define AX_PARTICLE_NEON
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define AX_PARTICLE_SSE2
+#endif
 
 using namespace std;
 
@@ -96,6 +106,196 @@ inline void normalize_point(float x, float y, particle_point* out)
     out->y = y * n;
 }
 
+// the per-property loops of ParticleSystem::stepParticles, each kernel runs 4 particles per SIMD step and finishes the
+// rest with the scalar code. The compiler may contract the scalar multiply-adds into FMAs (e.g. on aarch64), so the
+// tails can differ from the lanes in the last bits.
+
+// v[i] += delta
+static void stepAdd(float* v, float delta, int count)
+{
+    int i = 0;
+#if defined(AX_PARTICLE_SSE2)
+    const __m128 d = _mm_set1_ps(delta);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(v + i, _mm_add_ps(_mm_loadu_ps(v + i), d));
+#elif defined(AX_PARTICLE_NEON)
+    const float32x4_t d = vdupq_n_f32(delta);
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(v + i, vaddq_f32(vld1q_f32(v + i), d));
+#endif
+    for (; i < count; ++i)
+        v[i] += delta;
+}
+
+// v[i] = MIN(v[i] + delta, limit[i])
+static void stepAddClamped(float* v, const float* limit, float delta, int count)
+{
+    int i = 0;
+#if defined(AX_PARTICLE_SSE2)
+    const __m128 d = _mm_set1_ps(delta);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(v + i, _mm_min_ps(_mm_add_ps(_mm_loadu_ps(v + i), d), _mm_loadu_ps(limit + i)));
+#elif defined(AX_PARTICLE_NEON)
+    const float32x4_t d = vdupq_n_f32(delta);
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(v + i, vminq_f32(vaddq_f32(vld1q_f32(v + i), d), vld1q_f32(limit + i)));
+#endif
+    for (; i < count; ++i)
+    {
+        v[i] += delta;
+        v[i] = MIN(v[i], limit[i]);
+    }
+}
+
+// v[i] += rate[i] * dt
+static void stepMultiplyAdd(float* v, const float* rate, float dt, int count)
+{
+    int i = 0;
+#if defined(AX_PARTICLE_SSE2)
+    const __m128 t = _mm_set1_ps(dt);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(v + i, _mm_add_ps(_mm_loadu_ps(v + i), _mm_mul_ps(_mm_loadu_ps(rate + i), t)));
+#elif defined(AX_PARTICLE_NEON)
+    const float32x4_t t = vdupq_n_f32(dt);
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(v + i, vaddq_f32(vld1q_f32(v + i), vmulq_f32(vld1q_f32(rate + i), t)));
+#endif
+    for (; i < count; ++i)
+        v[i] += rate[i] * dt;
+}
+
+// v[i] = MAX(0, v[i] + rate[i] * dt)
+static void stepMultiplyAddPositive(float* v, const float* rate, float dt, int count)
+{
+    int i = 0;
+#if defined(AX_PARTICLE_SSE2)
+    const __m128 t    = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_add_ps(_mm_loadu_ps(v + i), _mm_mul_ps(_mm_loadu_ps(rate + i), t));
+        _mm_storeu_ps(v + i, _mm_max_ps(x, zero));
+    }
+#elif defined(AX_PARTICLE_NEON)
+    const float32x4_t t    = vdupq_n_f32(dt);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t x = vaddq_f32(vld1q_f32(v + i), vmulq_f32(vld1q_f32(rate + i), t));
+        vst1q_f32(v + i, vmaxq_f32(x, zero));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        v[i] += (rate[i] * dt);
+        v[i] = MAX(0, v[i]);
+    }
+}
+
+// gravity mode: radial and tangential acceleration along the normalized position, then direction and position
+static void stepGravity(ParticleData& p, const Vec2& gravity, float dt, float yCoordFlipped, int count)
+{
+    int i = 0;
+#if defined(AX_PARTICLE_SSE2)
+    const __m128 gx   = _mm_set1_ps(gravity.x);
+    const __m128 gy   = _mm_set1_ps(gravity.y);
+    const __m128 t    = _mm_set1_ps(dt);
+    const __m128 fy   = _mm_set1_ps(yCoordFlipped);
+    const __m128 one  = _mm_set1_ps(1.0f);
+    const __m128 tol  = _mm_set1_ps(MATH_TOLERANCE);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(p.posx + i);
+        __m128 y = _mm_loadu_ps(p.posy + i);
+
+        // normalize_point leaves the radial zero for unit, zero and too short positions
+        __m128 n     = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+        __m128 len   = _mm_sqrt_ps(n);
+        __m128 valid = _mm_and_ps(_mm_cmpneq_ps(n, one), _mm_cmpge_ps(len, tol));
+        __m128 inv   = _mm_div_ps(one, len);
+        __m128 nx    = _mm_and_ps(_mm_mul_ps(x, inv), valid);
+        __m128 ny    = _mm_and_ps(_mm_mul_ps(y, inv), valid);
+
+        __m128 radial     = _mm_loadu_ps(p.modeA.radialAccel + i);
+        __m128 tangential = _mm_loadu_ps(p.modeA.tangentialAccel + i);
+        __m128 ax = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, radial), _mm_mul_ps(ny, _mm_xor_ps(tangential, sign))), gx);
+        __m128 ay = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ny, radial), _mm_mul_ps(nx, tangential)), gy);
+
+        __m128 dirX = _mm_add_ps(_mm_loadu_ps(p.modeA.dirX + i), _mm_mul_ps(ax, t));
+        __m128 dirY = _mm_add_ps(_mm_loadu_ps(p.modeA.dirY + i), _mm_mul_ps(ay, t));
+        _mm_storeu_ps(p.modeA.dirX + i, dirX);
+        _mm_storeu_ps(p.modeA.dirY + i, dirY);
+        _mm_storeu_ps(p.posx + i, _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(dirX, t), fy)));
+        _mm_storeu_ps(p.posy + i, _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(dirY, t), fy)));
+    }
+#elif defined(AX_PARTICLE_NEON)
+    const float32x4_t gx  = vdupq_n_f32(gravity.x);
+    const float32x4_t gy  = vdupq_n_f32(gravity.y);
+    const float32x4_t t   = vdupq_n_f32(dt);
+    const float32x4_t fy  = vdupq_n_f32(yCoordFlipped);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t tol = vdupq_n_f32(MATH_TOLERANCE);
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t x = vld1q_f32(p.posx + i);
+        float32x4_t y = vld1q_f32(p.posy + i);
+
+        // normalize_point leaves the radial zero for unit, zero and too short positions
+        float32x4_t n    = vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y));
+        float32x4_t len  = vsqrtq_f32(n);
+        uint32x4_t valid = vandq_u32(vmvnq_u32(vceqq_f32(n, one)), vcgeq_f32(len, tol));
+        float32x4_t inv  = vdivq_f32(one, len);
+        float32x4_t nx   = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(x, inv)), valid));
+        float32x4_t ny   = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(y, inv)), valid));
+
+        float32x4_t radial     = vld1q_f32(p.modeA.radialAccel + i);
+        float32x4_t tangential = vld1q_f32(p.modeA.tangentialAccel + i);
+        float32x4_t ax = vaddq_f32(vaddq_f32(vmulq_f32(nx, radial), vmulq_f32(ny, vnegq_f32(tangential))), gx);
+        float32x4_t ay = vaddq_f32(vaddq_f32(vmulq_f32(ny, radial), vmulq_f32(nx, tangential)), gy);
+
+        float32x4_t dirX = vaddq_f32(vld1q_f32(p.modeA.dirX + i), vmulq_f32(ax, t));
+        float32x4_t dirY = vaddq_f32(vld1q_f32(p.modeA.dirY + i), vmulq_f32(ay, t));
+        vst1q_f32(p.modeA.dirX + i, dirX);
+        vst1q_f32(p.modeA.dirY + i, dirY);
+        vst1q_f32(p.posx + i, vaddq_f32(x, vmulq_f32(vmulq_f32(dirX, t), fy)));
+        vst1q_f32(p.posy + i, vaddq_f32(y, vmulq_f32(vmulq_f32(dirY, t), fy)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        particle_point tmp, radial = {0.0f, 0.0f}, tangential;
+
+        // radial acceleration
+        if (p.posx[i] || p.posy[i])
+        {
+            normalize_point(p.posx[i], p.posy[i], &radial);
+        }
+        tangential = radial;
+        radial.x *= p.modeA.radialAccel[i];
+        radial.y *= p.modeA.radialAccel[i];
+
+        // tangential acceleration
+        std::swap(tangential.x, tangential.y);
+        tangential.x *= -p.modeA.tangentialAccel[i];
+        tangential.y *= p.modeA.tangentialAccel[i];
+
+        // (gravity + radial + tangential) * dt
+        tmp.x = radial.x + tangential.x + gravity.x;
+        tmp.y = radial.y + tangential.y + gravity.y;
+        tmp.x *= dt;
+        tmp.y *= dt;
+
+        p.modeA.dirX[i] += tmp.x;
+        p.modeA.dirY[i] += tmp.y;
+
+        tmp.x = p.modeA.dirX[i] * dt * yCoordFlipped;
+        tmp.y = p.modeA.dirY[i] * dt * yCoordFlipped;
+        p.posx[i] += tmp.x;
+        p.posy[i] += tmp.y;
+    }
+}
+
 ParticleData::ParticleData()
 {
     memset(this, 0, sizeof(ParticleData));
@@ -191,6 +391,8 @@ void ParticleData::release()
 
 Vector<ParticleSystem*> ParticleSystem::__allInstances;
 float ParticleSystem::__totalParticleCountFactor = 1.0f;
+std::vector<ParticleSystem*> ParticleSystem::__queuedParticleSystems;
+bool ParticleSystem::__parallelUpdateEnabled = true;
 
 ParticleSystem::ParticleSystem()
     : _isBlendAdditive(false)
@@ -252,6 +454,8 @@ ParticleSystem::ParticleSystem()
     , _fixedFPS(0)
     , _fixedFPSDelta(0)
     , _sourcePositionCompatible(true)  // In the furture this member's default value maybe false or be removed.
+    , _queuedStep{}
+    , _isStepQueued(false)
 {
     modeA.gravity.setZero();
     modeA.speed              = 0;
@@ -1559,29 +1763,36 @@ void ParticleSystem::update(float dt)
 
     AX_PROFILER_START_CATEGORY(kProfilerCategoryParticles, "CCParticleSystem - update");
 
+    // a step queued earlier in this frame, e.g. by simulate(), is done before the next one starts
+    if (_queuedStep.pendingFinish && !finishQueuedStep())
+        return;
+
     if (_componentContainer && !_componentContainer->isEmpty())
     {
         _componentContainer->visit(dt);
     }
 
+    bool simulate = true;
     if (_fixedFPS != 0)
     {
         _fixedFPSDelta += dt;
         if (_fixedFPSDelta < 1.0F / _fixedFPS)
         {
-            updateParticleQuads();
-            _transformSystemDirty = false;
-            AX_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles, "CCParticleSystem - update");
-            return;
+            simulate = false;
+        }
+        else
+        {
+            dt             = _fixedFPSDelta;
+            _fixedFPSDelta = 0.0F;
         }
-        dt             = _fixedFPSDelta;
-        _fixedFPSDelta = 0.0F;
     }
 
     float pureDt = dt;
     dt *= _timeScale;
 
-    if (_isActive && _emissionRate)
+    // particles are emitted here on the main thread, so every system draws from its own _rng in the same order no
+    // matter how the steps are spread across the workers later
+    if (simulate && _isActive && _emissionRate)
     {
         float rate         = 1.0f / _emissionRate;
         int totalParticles = static_cast<int>(_totalParticles * __totalParticleCountFactor);
@@ -1606,238 +1817,255 @@ void ParticleSystem::update(float dt)
         }
     }
 
+    _queuedStep = QueuedStep{dt, pureDt, simulate, true, true, false};
+
+    // a batch node shares one texture atlas among its systems, they are always stepped right away
+    if (__parallelUpdateEnabled && !_batchNode)
+    {
+        prepareParticleQuads();
+        if (!_isStepQueued)
+        {
+            _isStepQueued = true;
+            retain();
+            __queuedParticleSystems.emplace_back(this);
+        }
+    }
+    else if (!finishQueuedStep())
+    {
+        return;
+    }
+
+    AX_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles, "CCParticleSystem - update");
+}
+
+bool ParticleSystem::stepParticles(float dt, float pureDt)
+{
     // The reason for using for-loops separately for every property is because
     // When the processor needs to read from or write to a location in memory,
     // it first checks whether a copy of that data is in the cpu's cache.
     // And wether if every property's memory of the particle system is continuous,
     // for the purpose of improving cache hit rate, we should process only one property in one for-loop.
     // It was proved to be effective especially for low-end devices.
+    stepAdd(_particleData.timeToLive, -dt, _particleCount);
+
+    if (_isOpacityFadeInAllocated)
     {
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.timeToLive[i] -= dt;
-        }
+        stepAddClamped(_particleData.opacityFadeInDelta, _particleData.opacityFadeInLength, dt, _particleCount);
+    }
 
-        if (_isOpacityFadeInAllocated)
-        {
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.opacityFadeInDelta[i] += dt;
-                _particleData.opacityFadeInDelta[i] =
-                    MIN(_particleData.opacityFadeInDelta[i], _particleData.opacityFadeInLength[i]);
-            }
-        }
+    if (_isScaleInAllocated)
+    {
+        stepAddClamped(_particleData.scaleInDelta, _particleData.scaleInLength, dt, _particleCount);
+    }
 
-        if (_isScaleInAllocated)
+    if (_isLifeAnimated || _isEmitterAnimated || _isLoopAnimated)
+    {
+        if (_isEmitterAnimated && !_animations.empty())
         {
             for (int i = 0; i < _particleCount; ++i)
             {
-                _particleData.scaleInDelta[i] += dt;
-                _particleData.scaleInDelta[i] = MIN(_particleData.scaleInDelta[i], _particleData.scaleInLength[i]);
-            }
-        }
-
-        if (_isLifeAnimated || _isEmitterAnimated || _isLoopAnimated)
-        {
-            if (_isEmitterAnimated && !_animations.empty())
-            {
-                for (int i = 0; i < _particleCount; ++i)
+                _particleData.animTimeDelta[i] += (_animationTimescaleInd ? pureDt : dt);
+                if (_particleData.animTimeDelta[i] > _particleData.animTimeLength[i])
                 {
-                    _particleData.animTimeDelta[i] += (_animationTimescaleInd ? pureDt : dt);
-                    if (_particleData.animTimeDelta[i] > _particleData.animTimeLength[i])
-                    {
-                        auto& anim    = _animations.at(_particleData.animIndex[i]);
-                        float percent = _rng.float01();
-                        percent       = anim.reverseIndices ? 1.0F - percent : percent;
-
-                        _particleData.animCellIndex[i] = anim.animationIndices[MIN(
-                            percent * anim.animationIndices.size(), anim.animationIndices.size() - 1)];
-                        _particleData.animTimeDelta[i] = 0;
-                    }
-                }
-            }
-            if (_isLifeAnimated && _animations.empty())
-            {
-                for (int i = 0; i < _particleCount; ++i)
-                {
-                    float percent = (_particleData.totalTimeToLive[i] - _particleData.timeToLive[i]) /
-                                    _particleData.totalTimeToLive[i];
-                    percent = _isAnimationReversed ? 1.0F - percent : percent;
-                    _particleData.animCellIndex[i] =
-                        (unsigned short)MIN(percent * _animIndexCount, _animIndexCount - 1);
-                }
-            }
-            if (_isLifeAnimated && !_animations.empty())
-            {
-                for (int i = 0; i < _particleCount; ++i)
-                {
-                    auto& anim = _animations.at(_particleData.animIndex[i]);
-
-                    float percent = (_particleData.totalTimeToLive[i] - _particleData.timeToLive[i]) /
-                                    _particleData.totalTimeToLive[i];
-                    percent = (!!_isAnimationReversed != !!anim.reverseIndices) ? 1.0F - percent : percent;
-                    percent = MAX(0.0F, percent);
-
-                    _particleData.animCellIndex[i] = anim.animationIndices[MIN(percent * anim.animationIndices.size(),
-                                                                               anim.animationIndices.size() - 1)];
-                }
-            }
-            if (_isLoopAnimated && !_animations.empty())
-            {
-                for (int i = 0; i < _particleCount; ++i)
-                {
-                    auto& anim = _animations.at(_particleData.animIndex[i]);
-
-                    _particleData.animTimeDelta[i] += (_animationTimescaleInd ? pureDt : dt);
-                    if (_particleData.animTimeDelta[i] >= _particleData.animTimeLength[i])
-                        _particleData.animTimeDelta[i] = 0;
-
-                    float percent = _particleData.animTimeDelta[i] / _particleData.animTimeLength[i];
+                    auto& anim    = _animations.at(_particleData.animIndex[i]);
+                    float percent = _rng.float01();
                     percent       = anim.reverseIndices ? 1.0F - percent : percent;
-                    percent       = MAX(0.0F, percent);
 
-                    _particleData.animCellIndex[i] = anim.animationIndices[MIN(percent * anim.animationIndices.size(),
-                                                                               anim.animationIndices.size() - 1)];
+                    _particleData.animCellIndex[i] = anim.animationIndices[MIN(
+                        percent * anim.animationIndices.size(), anim.animationIndices.size() - 1)];
+                    _particleData.animTimeDelta[i] = 0;
                 }
             }
-            if (_isLoopAnimated && _animations.empty())
-                std::fill_n(_particleData.animTimeDelta, _particleCount, 0);
         }
-
-        for (int i = 0; i < _particleCount; ++i)
+        if (_isLifeAnimated && _animations.empty())
         {
-            if (_particleData.timeToLive[i] <= 0.0f)
+            for (int i = 0; i < _particleCount; ++i)
             {
-                int j = _particleCount - 1;
-                while (j > 0 && _particleData.timeToLive[j] <= 0)
-                {
-                    _particleCount--;
-                    j--;
-                }
-                _particleData.copyParticle(i, _particleCount - 1);
-                if (_batchNode)
-                {
-                    // disable the switched particle
-                    int currentIndex = _particleData.atlasIndex[i];
-                    _batchNode->disableParticle(_atlasIndex + currentIndex);
-                    // switch indexes
-                    _particleData.atlasIndex[_particleCount - 1] = currentIndex;
-                }
-                --_particleCount;
-                if (_particleCount == 0 && _isAutoRemoveOnFinish)
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
+                float percent =
+                    (_particleData.totalTimeToLive[i] - _particleData.timeToLive[i]) / _particleData.totalTimeToLive[i];
+                percent = _isAnimationReversed ? 1.0F - percent : percent;
+                _particleData.animCellIndex[i] = (unsigned short)MIN(percent * _animIndexCount, _animIndexCount - 1);
             }
         }
-
-        if (_emitterMode == Mode::GRAVITY)
+        if (_isLifeAnimated && !_animations.empty())
         {
             for (int i = 0; i < _particleCount; ++i)
             {
-                particle_point tmp, radial = {0.0f, 0.0f}, tangential;
+                auto& anim = _animations.at(_particleData.animIndex[i]);
 
-                // radial acceleration
-                if (_particleData.posx[i] || _particleData.posy[i])
-                {
-                    normalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
-                }
-                tangential = radial;
-                radial.x *= _particleData.modeA.radialAccel[i];
-                radial.y *= _particleData.modeA.radialAccel[i];
+                float percent =
+                    (_particleData.totalTimeToLive[i] - _particleData.timeToLive[i]) / _particleData.totalTimeToLive[i];
+                percent = (!!_isAnimationReversed != !!anim.reverseIndices) ? 1.0F - percent : percent;
+                percent = MAX(0.0F, percent);
 
-                // tangential acceleration
-                std::swap(tangential.x, tangential.y);
-                tangential.x *= -_particleData.modeA.tangentialAccel[i];
-                tangential.y *= _particleData.modeA.tangentialAccel[i];
-
-                // (gravity + radial + tangential) * dt
-                tmp.x = radial.x + tangential.x + modeA.gravity.x;
-                tmp.y = radial.y + tangential.y + modeA.gravity.y;
-                tmp.x *= dt;
-                tmp.y *= dt;
-
-                _particleData.modeA.dirX[i] += tmp.x;
-                _particleData.modeA.dirY[i] += tmp.y;
-
-                // this is cocos2d-x v3.0
-                // if (_configName.length()>0 && _yCoordFlipped != -1)
-
-                // this is cocos2d-x v3.0
-                tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
-                tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
-                _particleData.posx[i] += tmp.x;
-                _particleData.posy[i] += tmp.y;
+                _particleData.animCellIndex[i] = anim.animationIndices[MIN(percent * anim.animationIndices.size(),
+                                                                           anim.animationIndices.size() - 1)];
             }
         }
-        else
+        if (_isLoopAnimated && !_animations.empty())
         {
             for (int i = 0; i < _particleCount; ++i)
             {
-                _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * dt;
+                auto& anim = _animations.at(_particleData.animIndex[i]);
+
+                _particleData.animTimeDelta[i] += (_animationTimescaleInd ? pureDt : dt);
+                if (_particleData.animTimeDelta[i] >= _particleData.animTimeLength[i])
+                    _particleData.animTimeDelta[i] = 0;
+
+                float percent = _particleData.animTimeDelta[i] / _particleData.animTimeLength[i];
+                percent       = anim.reverseIndices ? 1.0F - percent : percent;
+                percent       = MAX(0.0F, percent);
+
+                _particleData.animCellIndex[i] = anim.animationIndices[MIN(percent * anim.animationIndices.size(),
+                                                                           anim.animationIndices.size() - 1)];
             }
+        }
+        if (_isLoopAnimated && _animations.empty())
+            std::fill_n(_particleData.animTimeDelta, _particleCount, 0);
+    }
 
-            for (int i = 0; i < _particleCount; ++i)
+    for (int i = 0; i < _particleCount; ++i)
+    {
+        if (_particleData.timeToLive[i] <= 0.0f)
+        {
+            int j = _particleCount - 1;
+            while (j > 0 && _particleData.timeToLive[j] <= 0)
             {
-                _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * dt;
+                _particleCount--;
+                j--;
             }
-
-            for (int i = 0; i < _particleCount; ++i)
+            _particleData.copyParticle(i, _particleCount - 1);
+            if (_batchNode)
             {
-                _particleData.posx[i] = -cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
+                // disable the switched particle
+                int currentIndex = _particleData.atlasIndex[i];
+                _batchNode->disableParticle(_atlasIndex + currentIndex);
+                // switch indexes
+                _particleData.atlasIndex[_particleCount - 1] = currentIndex;
             }
-            for (int i = 0; i < _particleCount; ++i)
+            --_particleCount;
+            if (_particleCount == 0 && _isAutoRemoveOnFinish)
             {
-                _particleData.posy[i] =
-                    -sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
+                return false;
             }
         }
+    }
 
-        // color r,g,b,a
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.colorR[i] += _particleData.deltaColorR[i] * dt;
-        }
-
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.colorG[i] += _particleData.deltaColorG[i] * dt;
-        }
+    if (_emitterMode == Mode::GRAVITY)
+    {
+        // this is cocos2d-x v3.0
+        // if (_configName.length()>0 && _yCoordFlipped != -1)
 
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.colorB[i] += _particleData.deltaColorB[i] * dt;
-        }
+        // this is cocos2d-x v3.0
+        stepGravity(_particleData, modeA.gravity, dt, _yCoordFlipped, _particleCount);
+    }
+    else
+    {
+        stepMultiplyAdd(_particleData.modeB.angle, _particleData.modeB.degreesPerSecond, dt, _particleCount);
+        stepMultiplyAdd(_particleData.modeB.radius, _particleData.modeB.deltaRadius, dt, _particleCount);
 
         for (int i = 0; i < _particleCount; ++i)
         {
-            _particleData.colorA[i] += _particleData.deltaColorA[i] * dt;
+            _particleData.posx[i] = -cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
         }
-        // size
         for (int i = 0; i < _particleCount; ++i)
         {
-            _particleData.size[i] += (_particleData.deltaSize[i] * dt);
-            _particleData.size[i] = MAX(0, _particleData.size[i]);
-        }
-        // angle
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.rotation[i] += _particleData.deltaRotation[i] * dt;
+            _particleData.posy[i] =
+                -sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
         }
+    }
+
+    // color r,g,b,a
+    stepMultiplyAdd(_particleData.colorR, _particleData.deltaColorR, dt, _particleCount);
+    stepMultiplyAdd(_particleData.colorG, _particleData.deltaColorG, dt, _particleCount);
+    stepMultiplyAdd(_particleData.colorB, _particleData.deltaColorB, dt, _particleCount);
+    stepMultiplyAdd(_particleData.colorA, _particleData.deltaColorA, dt, _particleCount);
+    // size
+    stepMultiplyAddPositive(_particleData.size, _particleData.deltaSize, dt, _particleCount);
+    // angle
+    stepMultiplyAdd(_particleData.rotation, _particleData.deltaRotation, dt, _particleCount);
+
+    return true;
+}
+
+void ParticleSystem::runQueuedStep()
+{
+    if (!_queuedStep.pendingRun)
+        return;
+    _queuedStep.pendingRun = false;
+
+    if (_queuedStep.simulate && !stepParticles(_queuedStep.dt, _queuedStep.pureDt))
+    {
+        _queuedStep.finished = true;
+        return;
+    }
+
+    updateParticleQuads();
+    _transformSystemDirty = false;
+}
 
-        updateParticleQuads();
-        _transformSystemDirty = false;
+bool ParticleSystem::finishQueuedStep()
+{
+    if (!_queuedStep.pendingFinish)
+        return true;
+
+    runQueuedStep();
+    _queuedStep.pendingFinish = false;
+
+    if (_queuedStep.finished)
+    {
+        this->unscheduleUpdate();
+        if (_parent)
+            _parent->removeChild(this, true);
+        return false;
     }
 
     // update and send gl buffer only when this node is visible.
-    if (_visible && !_batchNode)
+    if (_queuedStep.simulate && _visible && !_batchNode)
     {
         postStep();
     }
+    return true;
+}
 
-    AX_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles, "CCParticleSystem - update");
+void ParticleSystem::prepareParticleQuads()
+{
+    // should be overridden
+}
+
+void ParticleSystem::setParallelUpdateEnabled(bool enabled)
+{
+    __parallelUpdateEnabled = enabled;
+}
+
+bool ParticleSystem::isParallelUpdateEnabled()
+{
+    return __parallelUpdateEnabled;
+}
+
+// systems only touch their own particles, quads and _rng, the sizes vary a lot so a job takes a few of them
+static const size_t PARTICLE_SYSTEMS_PER_JOB = 4;
+
+void ParticleSystem::updateQueuedParticleSystems()
+{
+    if (__queuedParticleSystems.empty())
+        return;
+
+    std::vector<ParticleSystem*> systems;
+    systems.swap(__queuedParticleSystems);
+
+    JobSystem::getInstance()->parallelFor(systems.size(), PARTICLE_SYSTEMS_PER_JOB, [&systems](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            systems[i]->runQueuedStep();
+    });
+
+    // postStep, the removal on finish and Ref::release aren't thread safe, they are done here
+    for (auto&& system : systems)
+    {
+        system->_isStepQueued = false;
+        system->finishQueuedStep();
+        system->release();
+    }
 }
 
 void ParticleSystem::updateWithNoTime()
@@ -433,6 +433,19 @@ public:
      */
     static Vector<ParticleSystem*>& getAllParticleSystems();
 
+    /** Enables or disables stepping the particle systems in parallel, enabled by default.
+     *
+     * When enabled, update() only emits the new particles. The simulation and the quads of every system that isn't
+     * in a ParticleBatchNode are computed later by updateQueuedParticleSystems() across the JobSystem workers, so
+     * subclasses overriding updateParticleQuads() have to keep it thread safe, see prepareParticleQuads().
+     */
+    static void setParallelUpdateEnabled(bool enabled);
+    static bool isParallelUpdateEnabled();
+
+    /** Steps all particle systems queued by update() in parallel, called once per frame before the scene is drawn.
+     */
+    static void updateQueuedParticleSystems();
+
 protected:
     bool allocAnimationMem();
     void deallocAnimationMem();
@@ -464,7 +477,7 @@ public:
     bool isFull();
 
     /** Update the verts position data of particle,
-     should be overridden by subclasses.
+     should be overridden by subclasses. May run on a worker thread, see setParallelUpdateEnabled().
      */
     virtual void updateParticleQuads();
     /** Update the VBO verts buffer which does not use batch node,
@@ -1458,6 +1471,25 @@ public:
 protected:
     virtual void updateBlendFunc();
 
+    /** Captures the node transforms updateParticleQuads() needs, called on the main thread when a step is queued
+     for updateQueuedParticleSystems(). */
+    virtual void prepareParticleQuads();
+
+    /** Advances the living particles by dt, safe to run on a worker thread.
+     *
+     * @return False if the last particle died and the system removes itself on finish.
+     */
+    bool stepParticles(float dt, float pureDt);
+
+    /** Runs the simulation and updateParticleQuads() of the queued step, safe to run on a worker thread. */
+    void runQueuedStep();
+
+    /** Runs the queued step if it's still pending, then postStep() or the removal on finish on the main thread.
+     *
+     * @return False if the system was removed from its parent.
+     */
+    bool finishQueuedStep();
+
 private:
     friend class EngineDataManager;
     /** Internal use only, it's used by EngineDataManager class for Android platform */
@@ -1683,6 +1715,22 @@ protected:
 
     FastRNG _rng;
 
+    /** The step update() computed the delta times for */
+    struct QueuedStep
+    {
+        float dt;
+        float pureDt;
+        bool simulate;       // false if _fixedFPS skipped the frame, only the quads are rebuilt
+        bool pendingRun;     // waits for runQueuedStep()
+        bool pendingFinish;  // waits for finishQueuedStep()
+        bool finished;       // the last particle died and the system removes itself on finish
+    };
+    QueuedStep _queuedStep;
+    bool _isStepQueued;  // in __queuedParticleSystems, retained
+
+    static std::vector<ParticleSystem*> __queuedParticleSystems;
+    static bool __parallelUpdateEnabled;
+
 private:
     AX_DISALLOW_COPY_AND_ASSIGN(ParticleSystem);
 };
@@ -303,22 +303,31 @@ inline void updatePosWithParticle(V3F_C4B_T2F_Quad* quad,
     quad->tr.vertices.y = cy;
 }
 
-void ParticleSystemQuad::updateParticleQuads()
+void ParticleSystemQuad::prepareParticleQuads()
 {
-    if (_particleCount <= 0)
-    {
-        return;
-    }
-
-    Vec2 currentPosition;
     if (_positionType == PositionType::FREE)
     {
-        currentPosition = this->convertToWorldSpace(Vec2::ZERO);
+        _quadsOrigin        = this->convertToWorldSpace(Vec2::ZERO);
+        _quadsWorldToNodeTM = getWorldToNodeTransform();
     }
     else if (_positionType == PositionType::RELATIVE)
     {
-        currentPosition = _position;
+        _quadsOrigin = _position;
     }
+}
+
+void ParticleSystemQuad::updateParticleQuads()
+{
+    if (_particleCount <= 0)
+    {
+        return;
+    }
+
+    // queued steps captured the transforms on the main thread already
+    if (!_isStepQueued)
+        prepareParticleQuads();
+
+    const Vec2& currentPosition = _quadsOrigin;
 
     V3F_C4B_T2F_Quad* startQuad;
     Vec2 pos = Vec2::ZERO;
@@ -336,7 +345,7 @@ void ParticleSystemQuad::updateParticleQuads()
     if (_positionType == PositionType::FREE)
     {
         Vec3 p1(currentPosition.x, currentPosition.y, 0);
-        Mat4 worldToNodeTM = getWorldToNodeTransform();
+        const Mat4& worldToNodeTM = _quadsWorldToNodeTM;
         worldToNodeTM.transformPoint(&p1);
         Vec3 p2;
         Vec2 newPos;
@@ -668,6 +677,9 @@ void ParticleSystemQuad::updateParticleQuads()
 // overriding draw method
 void ParticleSystemQuad::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
 {
+    // drawn before updateQueuedParticleSystems(), e.g. into a RenderTexture from an update callback
+    runQueuedStep();
+
     // quad command
     if (_particleCount > 0)
     {
@@ -167,9 +167,14 @@ protected:
 
     bool allocMemory();
 
+    virtual void prepareParticleQuads() override;
+
     V3F_C4B_T2F_Quad* _quads = nullptr;  // quads to be rendered
     unsigned short* _indices = nullptr;  // indices
 
+    Vec2 _quadsOrigin;         // emitter position the quads are built relative to
+    Mat4 _quadsWorldToNodeTM;  // world to node transform for PositionType::FREE
+
     QuadCommand _quadCommand;  // quad command
 
     backend::UniformLocation _mvpMatrixLocaiton;
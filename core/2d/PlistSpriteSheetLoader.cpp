@@ -147,6 +147,26 @@ void PlistSpriteSheetLoader::reload(std::string_view filePath, SpriteFrameCache&
     }
 }
 
+backend::PixelFormat PlistSpriteSheetLoader::getPixelFormatByName(std::string_view name)
+{
+    static hlookup::string_map<backend::PixelFormat> pixelFormats = {
+        {"RGBA8888", backend::PixelFormat::RGBA8},
+        {"RGBA4444", backend::PixelFormat::RGBA4},
+        {"RGB5A1", backend::PixelFormat::RGB5A1},
+        {"RGBA5551", backend::PixelFormat::RGB5A1},
+        {"RGB565", backend::PixelFormat::RGB565},
+        {"A8", backend::PixelFormat::A8},
+        {"ALPHA", backend::PixelFormat::A8},
+        {"I8", backend::PixelFormat::L8},
+        {"AI88", backend::PixelFormat::LA8},
+        {"ALPHA_INTENSITY", backend::PixelFormat::LA8},
+        //{"BGRA8888", backend::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
+        {"RGB888", backend::PixelFormat::RGB8}};
+
+    const auto pixelFormatIt = pixelFormats.find(name);
+    return pixelFormatIt != pixelFormats.end() ? pixelFormatIt->second : backend::PixelFormat::NONE;
+}
+
 void PlistSpriteSheetLoader::addSpriteFramesWithDictionary(ValueMap& dictionary,
                                                            Texture2D* texture,
                                                            std::string_view plist,
@@ -335,25 +355,10 @@ void PlistSpriteSheetLoader::addSpriteFramesWithDictionary(ValueMap& dict,
         }
     }
 
-    Texture2D* texture                                                        = nullptr;
-    static std::unordered_map<std::string, backend::PixelFormat> pixelFormats = {
-        {"RGBA8888", backend::PixelFormat::RGBA8},
-        {"RGBA4444", backend::PixelFormat::RGBA4},
-        {"RGB5A1", backend::PixelFormat::RGB5A1},
-        {"RGBA5551", backend::PixelFormat::RGB5A1},
-        {"RGB565", backend::PixelFormat::RGB565},
-        {"A8", backend::PixelFormat::A8},
-        {"ALPHA", backend::PixelFormat::A8},
-        {"I8", backend::PixelFormat::L8},
-        {"AI88", backend::PixelFormat::LA8},
-        {"ALPHA_INTENSITY", backend::PixelFormat::LA8},
-        //{"BGRA8888", backend::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
-        {"RGB888", backend::PixelFormat::RGB8}};
-
-    const auto pixelFormatIt = pixelFormats.find(pixelFormatName);
-    if (pixelFormatIt != pixelFormats.end())
+    Texture2D* texture     = nullptr;
+    const auto pixelFormat = getPixelFormatByName(pixelFormatName);
+    if (pixelFormat != backend::PixelFormat::NONE)
     {
-        const backend::PixelFormat pixelFormat        = (*pixelFormatIt).second;
         texture = Director::getInstance()->getTextureCache()->addImage(texturePath, pixelFormat);
     }
     else
@@ -20,6 +20,10 @@ public:
     void load(const Data& content, Texture2D* texture, SpriteFrameCache& cache) override;
     void reload(std::string_view filePath, SpriteFrameCache& cache) override;
 
+    /** Maps a TexturePacker pixel format name, e.g. "RGBA4444", to the backend format, returns
+     * PixelFormat::NONE for unknown names */
+    static backend::PixelFormat getPixelFormatByName(std::string_view name);
+
 protected:
     /*Adds multiple Sprite Frames with a dictionary. The texture will be associated with the created sprite frames.
      */
@@ -426,21 +426,13 @@ bool RenderTexture::saveToFileAsNonPMA(std::string_view fileName,
                                        bool isRGBA,
                                        SaveFileCallbackType callback)
 {
-    AXASSERT(format == Image::Format::JPG || format == Image::Format::PNG,
-             "the image can only be saved as JPG or PNG format");
-    if (isRGBA && format == Image::Format::JPG)
-        AXLOG("RGBA is not supported for JPG format");
-
-    _saveFileCallback = callback;
-
-    std::string fullpath = FileUtils::getInstance()->getWritablePath().append(fileName);
-
-    auto renderer          = _director->getRenderer();
-    auto saveToFileCommand = renderer->nextCallbackCommand();
-    saveToFileCommand->init(_globalZOrder);
-    saveToFileCommand->func = AX_CALLBACK_0(RenderTexture::onSaveToFile, this, std::move(fullpath), isRGBA, true);
-
-    renderer->addCommand(saveToFileCommand);
+    saveToFileAsync(
+        fileName, format, isRGBA,
+        [this, callback = std::move(callback)](const Image::SaveFileResult& result) {
+            if (callback)
+                callback(this, result.filename);
+        },
+        true);
     return true;
 }
 
@@ -448,42 +440,80 @@ bool RenderTexture::saveToFile(std::string_view fileName,
                                Image::Format format,
                                bool isRGBA,
                                SaveFileCallbackType callback)
+{
+    saveToFileAsync(fileName, format, isRGBA, [this, callback = std::move(callback)](const Image::SaveFileResult& result) {
+        if (callback)
+            callback(this, result.filename);
+    });
+    return true;
+}
+
+void RenderTexture::saveToFileAsync(std::string_view fileName,
+                                    Image::Format format,
+                                    bool isRGBA,
+                                    Image::SaveFileResultCallback callback,
+                                    bool asNonPMA)
 {
     AXASSERT(format == Image::Format::JPG || format == Image::Format::PNG,
              "the image can only be saved as JPG or PNG format");
     if (isRGBA && format == Image::Format::JPG)
         AXLOG("RGBA is not supported for JPG format");
 
-    _saveFileCallback = callback;
-
     std::string fullpath = FileUtils::getInstance()->getWritablePath().append(fileName);
 
+    // released once the file is written, so switching scene meanwhile is safe
+    retain();
+
     auto renderer          = _director->getRenderer();
     auto saveToFileCommand = renderer->nextCallbackCommand();
     saveToFileCommand->init(_globalZOrder);
-    saveToFileCommand->func = AX_CALLBACK_0(RenderTexture::onSaveToFile, this, std::move(fullpath), isRGBA, false);
+    saveToFileCommand->func = AX_CALLBACK_0(RenderTexture::onSaveToFile, this, std::move(fullpath), isRGBA, asNonPMA,
+                                            std::move(callback));
 
-    _director->getRenderer()->addCommand(saveToFileCommand);
-    return true;
+    renderer->addCommand(saveToFileCommand);
 }
 
-void RenderTexture::onSaveToFile(std::string filename, bool isRGBA, bool forceNonPMA)
+void RenderTexture::onSaveToFile(std::string filename,
+                                 bool isRGBA,
+                                 bool forceNonPMA,
+                                 Image::SaveFileResultCallback callback)
 {
-    auto callbackFunc = [this, _filename = std::move(filename), isRGBA, forceNonPMA](RefPtr<Image> image) {
-        if (image)
-        {
-            if (forceNonPMA && image->hasPremultipliedAlpha())
-            {
-                image->reversePremultipliedAlpha();
-            }
-            image->saveToFile(_filename, !isRGBA);
-        }
-        if (_saveFileCallback)
+    using clock_type = std::chrono::steady_clock;
+
+    // only the readback runs here, reversing PMA and encoding are done by a worker
+    auto onImage = [this, filename, isRGBA, forceNonPMA, callback,
+                    readbackStart = clock_type::now()](RefPtr<Image> image) {
+        const float readbackTime = std::chrono::duration<float>(clock_type::now() - readbackStart).count();
+        if (!image)
         {
-            _saveFileCallback(this, _filename);
+            Image::SaveFileResult result;
+            result.filename = filename;
+            result.waitTime = readbackTime;
+            if (callback)
+                callback(result);
+            release();
+            return;
         }
+
+        image->setPNGCompressionLevel(_pngCompressionLevel);
+        image->saveToFileAsync(
+            filename, !isRGBA,
+            [this, callback, readbackTime](const Image::SaveFileResult& result) {
+                if (callback)
+                {
+                    auto timedResult = result;
+                    timedResult.waitTime += readbackTime;
+                    callback(timedResult);
+                }
+                release();
+            },
+            forceNonPMA);
     };
-    newImage(callbackFunc);
+
+    if (_texture2D)
+        newImage(onImage);
+    else
+        onImage(nullptr);
 }
 
 /* get buffer as Image */
@@ -505,11 +535,13 @@ void RenderTexture::newImage(std::function<void(RefPtr<Image>)> imageCallback, b
     int savedBufferHeight      = (int)s.height;
     bool hasPremultipliedAlpha = _texture2D->hasPremultipliedAlpha();
 
-    _director->getRenderer()->readPixels(_renderTarget, [=](const backend::PixelBufferDescriptor& pbd) {
+    _director->getRenderer()->readPixels(_renderTarget, [=](backend::PixelBufferDescriptor& pbd) {
         if (pbd)
         {
-            auto image = utils::makeInstance<Image>(&Image::initWithRawData, pbd._data.getBytes(), pbd._data.getSize(),
-                                                    pbd._width, pbd._height, 8, hasPremultipliedAlpha);
+            // the image takes the readback buffer, the pixels aren't copied
+            RefPtr<Image> image(ReferencedObject<Image>{new Image()});
+            if (!image->initWithRawData(std::move(pbd._data), pbd._width, pbd._height, 8, hasPremultipliedAlpha))
+                image.reset();
             imageCallback(image);
         }
         else
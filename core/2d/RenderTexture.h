@@ -225,6 +225,26 @@ public:
                     bool isRGBA                   = true,
                     SaveFileCallbackType callback = nullptr);
 
+    /** Saves the texture into a file in the writable path, like saveToFile but the callback reports the timings.
+     * The pixels are read back in the following render and encoded on a worker thread, so the frame doesn't wait
+     * for the PNG/JPG encoder. saveToFile and saveToFileAsNonPMA are saved this way too.
+     *
+     * @param filename The file name.
+     * @param format The image format, JPG or PNG.
+     * @param isRGBA The file is RGBA or not.
+     * @param callback Invoked on the axmol thread once the file is written, the wait time includes the readback.
+     * @param asNonPMA Saves the file in non-PMA.
+     */
+    void saveToFileAsync(std::string_view filename,
+                         Image::Format format,
+                         bool isRGBA,
+                         Image::SaveFileResultCallback callback,
+                         bool asNonPMA = false);
+
+    /** Sets the compression level of the saved PNG files, see Image::setPNGCompressionLevel. Ignored when AX_USE_WIC is on. */
+    void setPNGCompressionLevel(int level) { _pngCompressionLevel = level; }
+    int getPNGCompressionLevel() const { return _pngCompressionLevel; }
+
     /** Listen "come to background" message, and save render texture.
      * It only has effect on Android.
      *
@@ -381,7 +401,7 @@ protected:
     void onEnd();
     void clearColorAttachment();
 
-    void onSaveToFile(std::string fileName, bool isRGBA = true, bool forceNonPMA = false);
+    void onSaveToFile(std::string fileName, bool isRGBA, bool forceNonPMA, Image::SaveFileResultCallback callback);
 
     bool _keepMatrix = false;
     Rect _rtTextureRect;
@@ -418,12 +438,7 @@ protected:
 
     //CallbackCommand _beforeClearAttachmentCommand;
     //CallbackCommand _afterClearAttachmentCommand;
-    /*this command is used to encapsulate saveToFile,
-     call saveToFile twice will overwrite this command and callback
-     and the command and callback will be executed twice.
-    */
-    //CallbackCommand _saveToFileCommand;
-    std::function<void(RenderTexture*, std::string_view)> _saveFileCallback = nullptr;
+    int _pngCompressionLevel = -1;
 
     Mat4 _oldTransMatrix, _oldProjMatrix;
     Mat4 _transformMatrix, _projectionMatrix;
@@ -33,6 +33,12 @@ THE SOFTWARE.
 #include "base/EventListenerCustom.h"
 #include "base/UTF8.h"
 #include "renderer/Renderer.h"
+#include "3d/Skeleton3D.h"
+#include "2d/ParticleSystem.h"
+
+#if AX_USE_CULLING
+#    include "3d/AABBTree.h"
+#endif
 
 #if AX_USE_PHYSICS
 #    include "physics/PhysicsWorld.h"
@@ -77,6 +83,9 @@ Scene::~Scene()
 #if AX_USE_PHYSICS
     delete _physicsWorld;
 #endif
+#if AX_USE_CULLING
+    delete _cullingTree;
+#endif
 
 #if AX_ENABLE_GC_FOR_NATIVE_OBJECTS
     auto sEngine = ScriptEngineManager::getInstance()->getScriptEngine();
@@ -184,6 +193,20 @@ void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eye
     Camera* defaultCamera = nullptr;
     const auto& transform = getNodeToParentTransform();
 
+    // sample this frame's 3d animations for all skeletons at once before any skin is drawn
+    Skeleton3D::updateAnimatedSkeletons();
+
+    // step the particle systems queued by their updates this frame at once before any quad is drawn
+    ParticleSystem::updateQueuedParticleSystems();
+
+#if AX_USE_CULLING
+    if (_cullingTree)
+    {
+        _cullingStats         = CullingStats{};
+        _cullingStats.proxies = _cullingTree->getProxyCount();
+    }
+#endif
+
     for (const auto& camera : getCameras())
     {
         if (!camera->isVisible())
@@ -213,6 +236,15 @@ void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eye
         camera->apply();
         // clear background with max depth
         camera->clearBackground();
+#if AX_USE_CULLING
+        // nodes read their visibility from this query while drawing
+        if (_cullingTree)
+        {
+            _cullingCamera = camera;
+            _cullingQuery  = _cullingTree->cull(camera->getFrustum(), &_cullingStats.nodesTested,
+                                                &_cullingStats.visible);
+        }
+#endif
         // visit the scene
         visit(renderer, transform, 0);
 #if AX_USE_NAVMESH
@@ -255,9 +287,21 @@ void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eye
     }
 #endif
 
+#if AX_USE_CULLING
+    _cullingCamera = nullptr;
+#endif
     Camera::_visitingCamera = nullptr;
 }
 
+#if AX_USE_CULLING
+AABBTree* Scene::getCullingTree()
+{
+    if (!_cullingTree)
+        _cullingTree = new AABBTree();
+    return _cullingTree;
+}
+#endif
+
 void Scene::removeAllChildren()
 {
     if (_defaultCamera)
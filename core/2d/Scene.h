@@ -40,6 +40,19 @@ class BaseLight;
 class Renderer;
 class EventListenerCustom;
 class EventCustom;
+#if AX_USE_CULLING
+class AABBTree;
+
+/** Frustum culling statistics of the 3D nodes of a scene, accumulated over all cameras of a frame. */
+struct CullingStats
+{
+    size_t proxies     = 0;  ///< nodes in the culling tree
+    size_t nodesTested = 0;  ///< tree nodes tested against camera frustums
+    size_t visible     = 0;  ///< nodes found visible by the tree
+    size_t culled      = 0;  ///< nodes which skipped drawing
+    size_t directTests = 0;  ///< nodes tested on their own because they moved after the tree was culled
+};
+#endif
 #if AX_USE_PHYSICS
 class PhysicsWorld;
 #endif
@@ -128,6 +141,17 @@ public:
 
     void onProjectionChanged(EventCustom* event);
 
+#if AX_USE_CULLING
+    /**
+     * Gets the bounding volume hierarchy of the 3D nodes in the scene, created on first use.
+     * The tree is culled against each camera before the scene is visited.
+     */
+    AABBTree* getCullingTree();
+
+    /** Gets the culling statistics of the last rendered frame. */
+    const CullingStats& getCullingStats() const { return _cullingStats; }
+#endif
+
 private:
     void initDefaultCamera();
 
@@ -138,6 +162,7 @@ protected:
     friend class Camera;
     friend class BaseLight;
     friend class Renderer;
+    friend class MeshRenderer;
 
     std::vector<Camera*> _cameras;     // weak ref to Camera
 
@@ -150,6 +175,13 @@ protected:
 
     std::vector<BaseLight*> _lights;
 
+#if AX_USE_CULLING
+    AABBTree* _cullingTree = nullptr;
+    Camera* _cullingCamera = nullptr;  // the camera _cullingQuery was culled against, weak ref
+    uint32_t _cullingQuery = 0;
+    CullingStats _cullingStats;
+#endif
+
 private:
     AX_DISALLOW_COPY_AND_ASSIGN(Scene);
 
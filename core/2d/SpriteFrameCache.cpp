@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "2d/Sprite.h"
 #include "2d/AutoPolygon.h"
 #include "2d/PlistSpriteSheetLoader.h"
+#include "2d/BinarySpriteSheetLoader.h"
 #include "platform/FileUtils.h"
 #include "base/Macros.h"
 #include "base/Director.h"
@@ -69,6 +70,7 @@ bool SpriteFrameCache::init()
     clear();
 
     registerSpriteSheetLoader(std::make_shared<PlistSpriteSheetLoader>());
+    registerSpriteSheetLoader(std::make_shared<BinarySpriteSheetLoader>());
 
     return true;
 }
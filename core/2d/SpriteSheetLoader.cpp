@@ -13,9 +13,19 @@ void SpriteSheetLoader::initializePolygonInfo(const Vec2& textureSize,
                                               const std::vector<int>& triangleIndices,
                                               PolygonInfo& info)
 {
-    const auto vertexCount = vertices.size();
-    const auto indexCount  = triangleIndices.size();
+    initializePolygonInfo(textureSize, spriteSize, vertices.data(), verticesUV.data(), vertices.size(),
+                          triangleIndices.data(), triangleIndices.size(), info);
+}
 
+void SpriteSheetLoader::initializePolygonInfo(const Vec2& textureSize,
+                                              const Vec2& spriteSize,
+                                              const int* vertices,
+                                              const int* verticesUV,
+                                              size_t vertexCount,
+                                              const int* triangleIndices,
+                                              size_t indexCount,
+                                              PolygonInfo& info)
+{
     const auto scaleFactor = AX_CONTENT_SCALE_FACTOR();
 
     auto* vertexData = new V3F_C4B_T2F[vertexCount];
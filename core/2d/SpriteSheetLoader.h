@@ -56,6 +56,7 @@ struct SpriteSheetFormat
     enum : uint32_t
     {
         PLIST  = 1,
+        BINARY = 2,
         CUSTOM = 1000
     };
 };
@@ -92,6 +93,17 @@ public:
                                const std::vector<int>& triangleIndices,
                                PolygonInfo& polygonInfo);
 
+    /** Configures PolygonInfo class from raw vertex/uv/index arrays, `vertexIntCount` is the number of ints in
+     * `vertices` and `verticesUV` */
+    void initializePolygonInfo(const Vec2& textureSize,
+                               const Vec2& spriteSize,
+                               const int* vertices,
+                               const int* verticesUV,
+                               size_t vertexIntCount,
+                               const int* triangleIndices,
+                               size_t indexCount,
+                               PolygonInfo& polygonInfo);
+
     uint32_t getFormat() override                                                                            = 0;
     void load(std::string_view filePath, SpriteFrameCache& cache) override                                   = 0;
     void load(std::string_view filePath, Texture2D* texture, SpriteFrameCache& cache) override               = 0;
@@ -0,0 +1,413 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "3d/AABBTree.h"
+
+NS_AX_BEGIN
+
+// fat AABBs are enlarged by this fraction of their size on every side
+static const float AABB_EXTENSION_RATIO = 0.1f;
+
+static AABB combine(const AABB& a, const AABB& b)
+{
+    AABB ret(a);
+    ret.merge(b);
+    return ret;
+}
+
+static float surfaceArea(const AABB& aabb)
+{
+    Vec3 d = aabb._max - aabb._min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+static bool contains(const AABB& outer, const AABB& inner)
+{
+    return outer._min.x <= inner._min.x && outer._min.y <= inner._min.y && outer._min.z <= inner._min.z &&
+           outer._max.x >= inner._max.x && outer._max.y >= inner._max.y && outer._max.z >= inner._max.z;
+}
+
+static AABB fatten(const AABB& aabb)
+{
+    Vec3 margin = (aabb._max - aabb._min) * AABB_EXTENSION_RATIO;
+    margin.x    = std::max(margin.x, 0.001f);
+    margin.y    = std::max(margin.y, 0.001f);
+    margin.z    = std::max(margin.z, 0.001f);
+    return AABB(aabb._min - margin, aabb._max + margin);
+}
+
+AABBTree::AABBTree() {}
+
+AABBTree::~AABBTree() {}
+
+int AABBTree::allocateNode()
+{
+    if (_freeList == NULL_NODE)
+    {
+        _nodes.emplace_back();
+        _nodes.back().parent = NULL_NODE;
+        return static_cast<int>(_nodes.size()) - 1;
+    }
+
+    int nodeId        = _freeList;
+    auto& node        = _nodes[nodeId];
+    _freeList         = node.next;
+    node.parent       = NULL_NODE;
+    node.child1       = NULL_NODE;
+    node.child2       = NULL_NODE;
+    node.height       = 0;
+    node.userData     = nullptr;
+    node.visibleQuery = 0;
+    return nodeId;
+}
+
+void AABBTree::freeNode(int nodeId)
+{
+    auto& node  = _nodes[nodeId];
+    node.next   = _freeList;
+    node.height = -1;
+    _freeList   = nodeId;
+}
+
+int AABBTree::createProxy(const AABB& aabb, void* userData)
+{
+    int proxyId    = allocateNode();
+    auto& node     = _nodes[proxyId];
+    node.aabb      = fatten(aabb);
+    node.userData  = userData;
+    node.height    = 0;
+    node.moveQuery = _queryId;
+
+    insertLeaf(proxyId);
+    ++_proxyCount;
+    return proxyId;
+}
+
+void AABBTree::destroyProxy(int proxyId)
+{
+    AXASSERT(proxyId >= 0 && proxyId < (int)_nodes.size() && _nodes[proxyId].isLeaf(), "invalid proxy");
+
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+    --_proxyCount;
+}
+
+bool AABBTree::moveProxy(int proxyId, const AABB& aabb)
+{
+    AXASSERT(proxyId >= 0 && proxyId < (int)_nodes.size() && _nodes[proxyId].isLeaf(), "invalid proxy");
+
+    if (contains(_nodes[proxyId].aabb, aabb))
+        return false;
+
+    removeLeaf(proxyId);
+    _nodes[proxyId].aabb      = fatten(aabb);
+    _nodes[proxyId].moveQuery = _queryId;
+    insertLeaf(proxyId);
+    return true;
+}
+
+uint32_t AABBTree::cull(const Frustum& frustum, size_t* nodesTested, size_t* visibleProxies)
+{
+    const uint32_t queryId = ++_queryId;
+    if (_root == NULL_NODE)
+        return queryId;
+
+    size_t tested  = 0;
+    size_t visible = 0;
+
+    // the low bit of a stack entry tells the subtree is inside the frustum and needs no more tests
+    _stack.clear();
+    _stack.emplace_back(_root << 1);
+    while (!_stack.empty())
+    {
+        const int entry  = _stack.back();
+        const int nodeId = entry >> 1;
+        bool inside      = entry & 1;
+        _stack.pop_back();
+
+        auto& node = _nodes[nodeId];
+        if (!inside)
+        {
+            ++tested;
+            auto result = frustum.intersectAABB(node.aabb);
+            if (result == Frustum::Intersection::OUTSIDE)
+                continue;
+            inside = result == Frustum::Intersection::INSIDE;
+        }
+
+        if (node.isLeaf())
+        {
+            node.visibleQuery = queryId;
+            ++visible;
+        }
+        else
+        {
+            _stack.emplace_back(node.child1 << 1 | (int)inside);
+            _stack.emplace_back(node.child2 << 1 | (int)inside);
+        }
+    }
+
+    if (nodesTested)
+        *nodesTested += tested;
+    if (visibleProxies)
+        *visibleProxies += visible;
+    return queryId;
+}
+
+AABBTree::Visibility AABBTree::getVisibility(int proxyId, uint32_t queryId) const
+{
+    auto& node = _nodes[proxyId];
+    if (node.moveQuery >= queryId)
+        return Visibility::UNKNOWN;
+    return node.visibleQuery == queryId ? Visibility::VISIBLE : Visibility::CULLED;
+}
+
+void AABBTree::query(const AABB& aabb, const std::function<bool(int proxyId)>& callback) const
+{
+    if (_root == NULL_NODE)
+        return;
+
+    // callbacks may query again, so don't share the member stack
+    std::vector<int> stack;
+    stack.emplace_back(_root);
+    while (!stack.empty())
+    {
+        auto& node = _nodes[stack.back()];
+        int nodeId = stack.back();
+        stack.pop_back();
+
+        if (!node.aabb.intersects(aabb))
+            continue;
+
+        if (node.isLeaf())
+        {
+            if (!callback(nodeId))
+                return;
+        }
+        else
+        {
+            stack.emplace_back(node.child1);
+            stack.emplace_back(node.child2);
+        }
+    }
+}
+
+void AABBTree::insertLeaf(int leaf)
+{
+    if (_root == NULL_NODE)
+    {
+        _root                = leaf;
+        _nodes[_root].parent = NULL_NODE;
+        return;
+    }
+
+    // find the best sibling by the surface area heuristic
+    const AABB leafAABB = _nodes[leaf].aabb;
+    int index           = _root;
+    while (!_nodes[index].isLeaf())
+    {
+        const auto& node = _nodes[index];
+        int child1       = node.child1;
+        int child2       = node.child2;
+
+        float area         = surfaceArea(node.aabb);
+        float combinedArea = surfaceArea(combine(node.aabb, leafAABB));
+
+        // cost of creating a new parent for this node and the new leaf
+        float cost = 2.0f * combinedArea;
+
+        // minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int child) {
+            const auto& childNode = _nodes[child];
+            float newArea         = surfaceArea(combine(leafAABB, childNode.aabb));
+            if (childNode.isLeaf())
+                return newArea + inheritanceCost;
+            return newArea - surfaceArea(childNode.aabb) + inheritanceCost;
+        };
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    int sibling   = index;
+    int oldParent = _nodes[sibling].parent;
+    int newParent = allocateNode();
+
+    auto& parentNode  = _nodes[newParent];
+    parentNode.parent = oldParent;
+    parentNode.aabb   = combine(leafAABB, _nodes[sibling].aabb);
+    parentNode.height = _nodes[sibling].height + 1;
+    parentNode.child1 = sibling;
+    parentNode.child2 = leaf;
+
+    if (oldParent != NULL_NODE)
+    {
+        if (_nodes[oldParent].child1 == sibling)
+            _nodes[oldParent].child1 = newParent;
+        else
+            _nodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        _root = newParent;
+    }
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent    = newParent;
+
+    // walk back up the tree fixing heights and AABBs
+    index = _nodes[leaf].parent;
+    while (index != NULL_NODE)
+    {
+        index = balance(index);
+
+        auto& node  = _nodes[index];
+        node.height = 1 + std::max(_nodes[node.child1].height, _nodes[node.child2].height);
+        node.aabb   = combine(_nodes[node.child1].aabb, _nodes[node.child2].aabb);
+
+        index = node.parent;
+    }
+}
+
+void AABBTree::removeLeaf(int leaf)
+{
+    if (leaf == _root)
+    {
+        _root = NULL_NODE;
+        return;
+    }
+
+    int parent      = _nodes[leaf].parent;
+    int grandParent = _nodes[parent].parent;
+    int sibling     = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    if (grandParent != NULL_NODE)
+    {
+        // destroy the parent and connect the sibling to the grand parent
+        if (_nodes[grandParent].child1 == parent)
+            _nodes[grandParent].child1 = sibling;
+        else
+            _nodes[grandParent].child2 = sibling;
+        _nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        int index = grandParent;
+        while (index != NULL_NODE)
+        {
+            index = balance(index);
+
+            auto& node  = _nodes[index];
+            node.aabb   = combine(_nodes[node.child1].aabb, _nodes[node.child2].aabb);
+            node.height = 1 + std::max(_nodes[node.child1].height, _nodes[node.child2].height);
+
+            index = node.parent;
+        }
+    }
+    else
+    {
+        _root                  = sibling;
+        _nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+    }
+}
+
+// Performs a left or right rotation if node A is imbalanced, returns the new root index.
+int AABBTree::balance(int iA)
+{
+    auto* A = &_nodes[iA];
+    if (A->isLeaf() || A->height < 2)
+        return iA;
+
+    int iB  = A->child1;
+    int iC  = A->child2;
+    auto* B = &_nodes[iB];
+    auto* C = &_nodes[iC];
+
+    int balance = C->height - B->height;
+
+    // rotate C up, F or G becomes a child of A
+    auto rotate = [this](int iA, int iC, int iB) {
+        auto* A = &_nodes[iA];
+        auto* B = &_nodes[iB];
+        auto* C = &_nodes[iC];
+        int iF  = C->child1;
+        int iG  = C->child2;
+        auto* F = &_nodes[iF];
+        auto* G = &_nodes[iG];
+
+        // swap A and C
+        C->child1 = iA;
+        C->parent = A->parent;
+        A->parent = iC;
+
+        // A's old parent should point to C
+        if (C->parent != NULL_NODE)
+        {
+            if (_nodes[C->parent].child1 == iA)
+                _nodes[C->parent].child1 = iC;
+            else
+                _nodes[C->parent].child2 = iC;
+        }
+        else
+        {
+            _root = iC;
+        }
+
+        // keep the taller grandchild under C
+        int iKeep = iF, iMove = iG;
+        if (F->height < G->height)
+            std::swap(iKeep, iMove);
+
+        C->child2 = iKeep;
+        if (A->child1 == iC)
+            A->child1 = iMove;
+        else
+            A->child2 = iMove;
+        _nodes[iMove].parent = iA;
+
+        A->aabb   = combine(B->aabb, _nodes[iMove].aabb);
+        C->aabb   = combine(A->aabb, _nodes[iKeep].aabb);
+        A->height = 1 + std::max(B->height, _nodes[iMove].height);
+        C->height = 1 + std::max(A->height, _nodes[iKeep].height);
+    };
+
+    if (balance > 1)
+    {
+        rotate(iA, iC, iB);
+        return iC;
+    }
+    if (balance < -1)
+    {
+        rotate(iA, iB, iC);
+        return iB;
+    }
+    return iA;
+}
+
+NS_AX_END
@@ -0,0 +1,142 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __AX_AABB_TREE_H__
+#define __AX_AABB_TREE_H__
+
+#include <vector>
+#include <functional>
+
+#include "3d/AABB.h"
+#include "3d/Frustum.h"
+
+NS_AX_BEGIN
+
+/**
+ * @addtogroup _3d
+ * @{
+ */
+
+/**
+ * A dynamic bounding volume hierarchy.
+ *
+ * Every proxy is a leaf holding an enlarged ("fat") copy of the object's AABB, so objects which move a little don't
+ * touch the tree. Internal nodes are balanced with tree rotations on insertion, which keeps the height near log(n)
+ * for any insertion order.
+ *
+ * cull() classifies the whole tree against a frustum and stamps the visible leaves, subtrees fully inside the frustum
+ * are accepted without testing them.
+ */
+class AX_DLL AABBTree
+{
+public:
+    static constexpr int NULL_NODE = -1;
+
+    enum class Visibility
+    {
+        VISIBLE,
+        CULLED,
+        UNKNOWN,  ///< the proxy left its fat AABB after the cull query, test it directly
+    };
+
+    AABBTree();
+    ~AABBTree();
+
+    /** Creates a proxy, returns its id. */
+    int createProxy(const AABB& aabb, void* userData);
+
+    /** Destroys a proxy, the id may be reused. */
+    void destroyProxy(int proxyId);
+
+    /**
+     * Moves a proxy, it is only reinserted when the aabb leaves its fat AABB.
+     * @return true if the proxy was reinserted.
+     */
+    bool moveProxy(int proxyId, const AABB& aabb);
+
+    void* getUserData(int proxyId) const { return _nodes[proxyId].userData; }
+
+    const AABB& getFatAABB(int proxyId) const { return _nodes[proxyId].aabb; }
+
+    /**
+     * Stamps the proxies whose fat AABB intersects the frustum.
+     * @param nodesTested Incremented by the number of tree nodes tested against the frustum, may be null.
+     * @param visibleProxies Incremented by the number of visible proxies, may be null.
+     * @return The id of this query, to pass to getVisibility().
+     */
+    uint32_t cull(const Frustum& frustum, size_t* nodesTested = nullptr, size_t* visibleProxies = nullptr);
+
+    /** Gets the visibility of a proxy found by the cull query `queryId`. */
+    Visibility getVisibility(int proxyId, uint32_t queryId) const;
+
+    /** Calls `callback` with every proxy whose fat AABB overlaps `aabb`, return false from it to stop. */
+    void query(const AABB& aabb, const std::function<bool(int proxyId)>& callback) const;
+
+    int getProxyCount() const { return _proxyCount; }
+
+    /** Gets the height of the tree, 0 when it has a single leaf. */
+    int getHeight() const { return _root != NULL_NODE ? _nodes[_root].height : 0; }
+
+protected:
+    struct TreeNode
+    {
+        AABB aabb;
+        void* userData = nullptr;
+        union
+        {
+            int parent;
+            int next;  // in the free list
+        };
+        int child1            = NULL_NODE;
+        int child2            = NULL_NODE;
+        int height            = -1;  // leaf = 0, free node = -1
+        uint32_t visibleQuery = 0;   // last cull query which found the leaf visible
+        uint32_t moveQuery    = 0;   // cull query count when the leaf was last reinserted
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    int allocateNode();
+    void freeNode(int nodeId);
+
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+
+    int balance(int nodeId);
+
+    std::vector<TreeNode> _nodes;
+    int _root         = NULL_NODE;
+    int _freeList     = NULL_NODE;
+    int _proxyCount   = 0;
+    uint32_t _queryId = 0;
+
+    mutable std::vector<int> _stack;
+};
+
+// end of 3d group
+/// @}
+
+NS_AX_END
+
+#endif  // __AX_AABB_TREE_H__
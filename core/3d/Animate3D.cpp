@@ -32,8 +32,191 @@
 #include "base/Director.h"
 #include "base/EventDispatcher.h"
 
+#include <algorithm>
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#    include <arm_neon.h>
+#    define AX_ANIMATE3D_NEON
+#elif defined(__SSE__)
+#    include <xmmintrin.h>
+#    define AX_ANIMATE3D_SSE
+#endif
+
 NS_AX_BEGIN
 
+namespace
+{
+// Lane operations of the interpolation kernels, the kernels are written once and instantiated for the SIMD
+// registers and for plain floats, which handle the tail of a batch and targets without SIMD.
+struct ScalarLanes
+{
+    typedef float V;
+    static constexpr size_t width = 1;
+    static V load(const float* p) { return *p; }
+    static void store(float* p, V v) { *p = v; }
+    static V set(float v) { return v; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V abs(V a) { return std::abs(a); }
+    static V sign(V a) { return a >= 0.0f ? 1.0f : -1.0f; }
+};
+
+#if defined(AX_ANIMATE3D_NEON)
+struct SimdLanes
+{
+    typedef float32x4_t V;
+    static constexpr size_t width = 4;
+    static V load(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, V v) { vst1q_f32(p, v); }
+    static V set(float v) { return vdupq_n_f32(v); }
+    static V add(V a, V b) { return vaddq_f32(a, b); }
+    static V sub(V a, V b) { return vsubq_f32(a, b); }
+    static V mul(V a, V b) { return vmulq_f32(a, b); }
+    static V abs(V a) { return vabsq_f32(a); }
+    static V sign(V a) { return vbslq_f32(vcgeq_f32(a, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f), vdupq_n_f32(-1.0f)); }
+};
+#elif defined(AX_ANIMATE3D_SSE)
+struct SimdLanes
+{
+    typedef __m128 V;
+    static constexpr size_t width = 4;
+    static V load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V set(float v) { return _mm_set1_ps(v); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    // |a| as max(a, -a)
+    static V abs(V a) { return _mm_max_ps(a, _mm_sub_ps(_mm_setzero_ps(), a)); }
+    static V sign(V a)
+    {
+        V mask = _mm_cmpge_ps(a, _mm_setzero_ps());
+        return _mm_sub_ps(_mm_and_ps(mask, _mm_set1_ps(2.0f)), _mm_set1_ps(1.0f));
+    }
+};
+#endif
+
+// dst[i] = from[i] + (to[i] - from[i]) * t[i] for i in [begin, count), returns where it stopped
+template <typename L>
+size_t lerpLanes(const float* from, const float* to, const float* t, float* dst, size_t begin, size_t count)
+{
+    size_t i = begin;
+    for (; i + L::width <= count; i += L::width)
+    {
+        auto a = L::load(from + i);
+        L::store(dst + i, L::add(a, L::mul(L::sub(L::load(to + i), a), L::load(t + i))));
+    }
+    return i;
+}
+
+// Quaternion::slerp for lanes of quaternions split into x, y, z, w arrays `stride` floats apart. This is the same
+// division and trig free approximation, so batched and single evaluation agree.
+template <typename L>
+size_t slerpLanes(const float* from, const float* to, const float* t, float* dst, size_t begin, size_t count,
+                  size_t stride)
+{
+    typedef typename L::V V;
+    const V one = L::set(1.0f), half = L::set(0.5f);
+    size_t i = begin;
+    for (; i + L::width <= count; i += L::width)
+    {
+        const V q1x = L::load(from + i), q1y = L::load(from + stride + i);
+        const V q1z = L::load(from + stride * 2 + i), q1w = L::load(from + stride * 3 + i);
+        const V q2x = L::load(to + i), q2y = L::load(to + stride + i);
+        const V q2z = L::load(to + stride * 2 + i), q2w = L::load(to + stride * 3 + i);
+
+        V cosTheta = L::add(L::add(L::mul(q1w, q2w), L::mul(q1x, q2x)), L::add(L::mul(q1y, q2y), L::mul(q1z, q2z)));
+
+        // fold theta and bisect the interval, folding t as well
+        V alpha = L::sign(cosTheta);
+        V halfY = L::add(one, L::mul(alpha, cosTheta));
+        V f2b   = L::sub(L::load(t + i), half);
+        V u     = L::abs(f2b);
+        V f2a   = L::sub(u, f2b);
+        f2b     = L::add(f2b, u);
+        u       = L::add(u, u);
+        V f1    = L::sub(one, u);
+
+        // one iteration of Newton to get 1-cos(theta / 2) to good accuracy
+        V halfSecHalfTheta =
+            L::sub(L::set(1.09f), L::mul(L::sub(L::set(0.476537f), L::mul(L::set(0.0903321f), halfY)), halfY));
+        halfSecHalfTheta = L::mul(
+            halfSecHalfTheta, L::sub(L::set(1.5f), L::mul(halfY, L::mul(halfSecHalfTheta, halfSecHalfTheta))));
+        V versHalfTheta = L::sub(one, L::mul(halfY, halfSecHalfTheta));
+
+        // series expansions of the coefficients
+        V sqNotU = L::mul(f1, f1);
+        V ratio2 = L::mul(L::set(0.0000440917108f), versHalfTheta);
+        V ratio1 = L::add(L::set(-0.00158730159f), L::mul(L::sub(sqNotU, L::set(16.0f)), ratio2));
+        ratio1   = L::add(L::set(0.0333333333f), L::mul(L::mul(ratio1, L::sub(sqNotU, L::set(9.0f))), versHalfTheta));
+        ratio1   = L::add(L::set(-0.333333333f), L::mul(L::mul(ratio1, L::sub(sqNotU, L::set(4.0f))), versHalfTheta));
+        ratio1   = L::add(one, L::mul(L::mul(ratio1, L::sub(sqNotU, one)), versHalfTheta));
+
+        V sqU  = L::mul(u, u);
+        ratio2 = L::add(L::set(-0.00158730159f), L::mul(L::sub(sqU, L::set(16.0f)), ratio2));
+        ratio2 = L::add(L::set(0.0333333333f), L::mul(L::mul(ratio2, L::sub(sqU, L::set(9.0f))), versHalfTheta));
+        ratio2 = L::add(L::set(-0.333333333f), L::mul(L::mul(ratio2, L::sub(sqU, L::set(4.0f))), versHalfTheta));
+        ratio2 = L::add(one, L::mul(L::mul(ratio2, L::sub(sqU, one)), versHalfTheta));
+
+        // perform the bisection and resolve the folding done earlier
+        f1     = L::mul(f1, L::mul(ratio1, halfSecHalfTheta));
+        f2a    = L::mul(f2a, ratio2);
+        f2b    = L::mul(f2b, ratio2);
+        alpha  = L::mul(alpha, L::add(f1, f2a));
+        V beta = L::add(f1, f2b);
+
+        V w = L::add(L::mul(alpha, q1w), L::mul(beta, q2w));
+        V x = L::add(L::mul(alpha, q1x), L::mul(beta, q2x));
+        V y = L::add(L::mul(alpha, q1y), L::mul(beta, q2y));
+        V z = L::add(L::mul(alpha, q1z), L::mul(beta, q2z));
+
+        // correct small constraint errors in the inputs
+        V lengthSq = L::add(L::add(L::mul(w, w), L::mul(x, x)), L::add(L::mul(y, y), L::mul(z, z)));
+        f1         = L::sub(L::set(1.5f), L::mul(half, lengthSq));
+        L::store(dst + i, L::mul(x, f1));
+        L::store(dst + stride + i, L::mul(y, f1));
+        L::store(dst + stride * 2 + i, L::mul(z, f1));
+        L::store(dst + stride * 3 + i, L::mul(w, f1));
+    }
+    return i;
+}
+
+void lerpBatch(const float* from, const float* to, const float* t, float* dst, size_t count)
+{
+    size_t i = 0;
+#if defined(AX_ANIMATE3D_NEON) || defined(AX_ANIMATE3D_SSE)
+    i = lerpLanes<SimdLanes>(from, to, t, dst, i, count);
+#endif
+    lerpLanes<ScalarLanes>(from, to, t, dst, i, count);
+}
+
+void slerpBatch(const float* from, const float* to, const float* t, float* dst, size_t count, size_t stride)
+{
+    size_t i = 0;
+#if defined(AX_ANIMATE3D_NEON) || defined(AX_ANIMATE3D_SSE)
+    i = slerpLanes<SimdLanes>(from, to, t, dst, i, count, stride);
+#endif
+    slerpLanes<ScalarLanes>(from, to, t, dst, i, count, stride);
+}
+
+// Finds the key segment containing time, keyTimes[0] < time < keyTimes[keyCount - 1]. Playback moves a key or two
+// per frame at most, so walking on from last frame's key replaces the binary search except after a seek or a loop.
+uint32_t seekKey(const float* keyTimes, uint32_t keyCount, float time, uint32_t cursor)
+{
+    if (cursor + 1 < keyCount && time >= keyTimes[cursor])
+    {
+        for (int step = 0; step < 4 && cursor + 1 < keyCount; ++step, ++cursor)
+        {
+            if (time < keyTimes[cursor + 1])
+                return cursor;
+        }
+    }
+    auto it = std::upper_bound(keyTimes, keyTimes + keyCount, time);
+    return static_cast<uint32_t>(std::max<ptrdiff_t>(it - keyTimes - 1, 0));
+}
+}  // namespace
+
 std::unordered_map<Node*, Animate3D*> Animate3D::s_fadeInAnimates;
 std::unordered_map<Node*, Animate3D*> Animate3D::s_fadeOutAnimates;
 std::unordered_map<Node*, Animate3D*> Animate3D::s_runningAnimates;
@@ -154,6 +337,8 @@ void Animate3D::startWithTarget(Node* target)
     {
         _boneCurves.clear();
         _nodeCurves.clear();
+        _boneBindings.clear();
+        _skeleton = nullptr;
 
         bool hasCurve    = false;
         MeshRenderer* mesh = dynamic_cast<MeshRenderer*>(target);
@@ -174,7 +359,13 @@ void Animate3D::startWithTarget(Node* target)
                         {
                             auto curve        = _animation->getBoneCurveByName(boneName);
                             _boneCurves[bone] = curve;
-                            hasCurve          = true;
+                            int depth = 0;
+                            for (auto parent = bone->getParentBone(); parent; parent = parent->getParentBone())
+                                ++depth;
+                            _boneBindings.emplace_back(BoneBinding{
+                                bone, depth, {curve->translateTrack, curve->rotTrack, curve->scaleTrack}});
+                            _skeleton = skin;
+                            hasCurve  = true;
                         }
                         else
                         {
@@ -226,6 +417,10 @@ void Animate3D::startWithTarget(Node* target)
         {
             AXLOG("warning: no animation found for the skeleton");
         }
+        // bones closest to the root come first, so a bone budget drops the extremities first
+        std::stable_sort(_boneBindings.begin(), _boneBindings.end(),
+                         [](const BoneBinding& a, const BoneBinding& b) { return a.depth < b.depth; });
+        _keyCursors.assign(_boneBindings.size() * 3, 0);
     }
 
     auto runningAction = s_runningAnimates.find(target);
@@ -334,7 +529,6 @@ void Animate3D::update(float t)
             if (_weight > 0.0f)
             {
                 float transDst[3], rotDst[4], scaleDst[3];
-                float *trans = nullptr, *rot = nullptr, *scale = nullptr;
                 if (_playReverse)
                 {
                     t        = 1 - t;
@@ -344,27 +538,11 @@ void Animate3D::update(float t)
                 t        = _start + t * _last;
                 lastTime = _start + lastTime * _last;
 
-                for (const auto& it : _boneCurves)
-                {
-                    auto bone  = it.first;
-                    auto curve = it.second;
-                    if (curve->translateCurve)
-                    {
-                        curve->translateCurve->evaluate(t, transDst, _translateEvaluate);
-                        trans = &transDst[0];
-                    }
-                    if (curve->rotCurve)
-                    {
-                        curve->rotCurve->evaluate(t, rotDst, _roteEvaluate);
-                        rot = &rotDst[0];
-                    }
-                    if (curve->scaleCurve)
-                    {
-                        curve->scaleCurve->evaluate(t, scaleDst, _scaleEvaluate);
-                        scale = &scaleDst[0];
-                    }
-                    bone->setAnimationValue(trans, rot, scale, this, _weight);
-                }
+                // bones are sampled by Skeleton3D::updateAnimatedSkeletons, in parallel with other skeletons, as often
+                // as the animation LOD of the mesh renderer allows
+                unsigned int maxBones = 0;
+                if (_skeleton && static_cast<MeshRenderer*>(_target)->isAnimationUpdateDue(&maxBones))
+                    _skeleton->addAnimateSample(this, t, _weight, maxBones);
 
                 for (const auto& it : _nodeCurves)
                 {
@@ -421,6 +599,114 @@ void Animate3D::update(float t)
     }
 }
 
+void Animate3D::evaluateBones(float t, float weight, unsigned int maxBones)
+{
+    const size_t count       = maxBones ? std::min<size_t>(maxBones, _boneBindings.size()) : _boneBindings.size();
+    const size_t slerpStride = (count + 3) & ~static_cast<size_t>(3);
+    auto& samples            = _samples;
+    // translation and scale tracks are lerped together, 3 floats each
+    samples.lerpFrom.resize(count * 6);
+    samples.lerpTo.resize(count * 6);
+    samples.lerpT.resize(count * 6);
+    samples.lerpOut.resize(count * 6);
+    samples.slerpFrom.resize(slerpStride * 4);
+    samples.slerpTo.resize(slerpStride * 4);
+    samples.slerpT.resize(slerpStride);
+    samples.slerpOut.resize(slerpStride * 4);
+
+    const float* keyTimes  = _animation->getKeyTimes();
+    const float* keyValues = _animation->getKeyValues();
+    const EvaluateType evaluateTypes[3] = {_translateEvaluate, _roteEvaluate, _scaleEvaluate};
+
+    // gather the key pairs surrounding t
+    size_t lerpCount = 0, slerpCount = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto& binding = _boneBindings[i];
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            if (binding.tracks[channel] < 0)
+                continue;
+
+            const auto& track   = _animation->getTrack(binding.tracks[channel]);
+            const float* times  = keyTimes + track.keyOffset;
+            const uint32_t last = track.keyCount - 1;
+            uint32_t from = 0, to = 0;
+            float alpha = 0.0f;
+            if (last > 0 && t > times[0])
+            {
+                if (t >= times[last])
+                {
+                    from = to = last;
+                }
+                else
+                {
+                    auto& cursor = _keyCursors[i * 3 + channel];
+                    cursor       = seekKey(times, track.keyCount, t, cursor);
+                    from         = cursor;
+                    to           = cursor + 1;
+                    alpha        = (t - times[from]) / (times[to] - times[from]);
+                    if (evaluateTypes[channel] == EvaluateType::INT_NEAR)
+                    {
+                        from  = alpha > 0.5f ? to : from;
+                        to    = from;
+                        alpha = 0.0f;
+                    }
+                }
+            }
+
+            const uint32_t componentSize = channel == 1 ? 4 : 3;
+            const float* fromValue       = keyValues + track.valueOffset + from * componentSize;
+            const float* toValue         = keyValues + track.valueOffset + to * componentSize;
+            if (channel == 1)
+            {
+                for (int c = 0; c < 4; ++c)
+                {
+                    samples.slerpFrom[c * slerpStride + slerpCount] = fromValue[c];
+                    samples.slerpTo[c * slerpStride + slerpCount]   = toValue[c];
+                }
+                samples.slerpT[slerpCount++] = alpha;
+            }
+            else
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    samples.lerpFrom[lerpCount * 3 + c] = fromValue[c];
+                    samples.lerpTo[lerpCount * 3 + c]   = toValue[c];
+                    samples.lerpT[lerpCount * 3 + c]    = alpha;
+                }
+                ++lerpCount;
+            }
+        }
+    }
+
+    lerpBatch(samples.lerpFrom.data(), samples.lerpTo.data(), samples.lerpT.data(), samples.lerpOut.data(),
+              lerpCount * 3);
+    slerpBatch(samples.slerpFrom.data(), samples.slerpTo.data(), samples.slerpT.data(), samples.slerpOut.data(),
+               slerpCount, slerpStride);
+
+    // hand the results to the bones in gather order
+    lerpCount = slerpCount = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto& binding = _boneBindings[i];
+        float rotDst[4];
+        float *trans = nullptr, *rot = nullptr, *scale = nullptr;
+        if (binding.tracks[0] >= 0)
+            trans = &samples.lerpOut[3 * lerpCount++];
+        if (binding.tracks[1] >= 0)
+        {
+            for (int c = 0; c < 4; ++c)
+                rotDst[c] = samples.slerpOut[c * slerpStride + slerpCount];
+            ++slerpCount;
+            rot = &rotDst[0];
+        }
+        if (binding.tracks[2] >= 0)
+            scale = &samples.lerpOut[3 * lerpCount++];
+        binding.bone->setAnimationValue(trans, rot, scale, this, weight);
+    }
+}
+
 float Animate3D::getSpeed() const
 {
     return _playReverse ? -_absSpeed : _absSpeed;
@@ -500,6 +786,7 @@ Animate3D::Animate3D()
     , _lastTime(0.0f)
     , _originInterval(0.0f)
     , _frameRate(30.0f)
+    , _skeleton(nullptr)
 {
     setQuality(Animate3DQuality::QUALITY_HIGH);
 }
@@ -28,6 +28,7 @@
 
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 #include "3d/Animation3D.h"
 #include "base/Macros.h"
@@ -37,6 +38,7 @@
 NS_AX_BEGIN
 
 class Bone3D;
+class Skeleton3D;
 class MeshRenderer;
 class EventCustom;
 
@@ -141,6 +143,11 @@ public:
     bool initWithFrames(Animation3D* animation, int startFrame, int endFrame, float frameRate);
 
 protected:
+    friend class Skeleton3D;
+
+    /**sample the bone curves at time t (0 - 1 of the animation) into the bone blend states, maxBones 0 samples all*/
+    void evaluateBones(float t, float weight, unsigned int maxBones);
+
     enum class Animate3DState
     {
         FadeIn,
@@ -168,6 +175,24 @@ protected:
     Animate3DQuality _quality;
 
     std::unordered_map<Bone3D*, Animation3D::Curve*> _boneCurves;  // weak ref
+
+    struct BoneBinding
+    {
+        Bone3D* bone;
+        int depth;      // number of ancestors of the bone
+        int tracks[3];  // translate, rotation and scale track of the animation, -1 if absent
+    };
+    std::vector<BoneBinding> _boneBindings;  // flattened _boneCurves sampled by evaluateBones, root bones first
+    std::vector<uint32_t> _keyCursors;       // key index of each binding track found last frame
+    Skeleton3D* _skeleton;                   // skeleton of the target, weak ref
+
+    // per frame sample scratch, vec3 tracks are interleaved, quaternion tracks are split into x, y, z, w lanes
+    struct SampleBuffer
+    {
+        std::vector<float> lerpFrom, lerpTo, lerpT, lerpOut;
+        std::vector<float> slerpFrom, slerpTo, slerpT, slerpOut;
+    };
+    SampleBuffer _samples;
     std::unordered_map<Node*, Animation3D::Curve*> _nodeCurves;
 
     std::unordered_map<int, ValueMap> _keyFrameUserInfos;
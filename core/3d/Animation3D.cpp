@@ -92,7 +92,9 @@ Animation3D::~Animation3D()
     }
 }
 
-Animation3D::Curve::Curve() : translateCurve(nullptr), rotCurve(nullptr), scaleCurve(nullptr) {}
+Animation3D::Curve::Curve()
+    : translateCurve(nullptr), rotCurve(nullptr), scaleCurve(nullptr), translateTrack(-1), rotTrack(-1), scaleTrack(-1)
+{}
 Animation3D::Curve::~Curve()
 {
     AX_SAFE_RELEASE_NULL(translateCurve);
@@ -100,6 +102,19 @@ Animation3D::Curve::~Curve()
     AX_SAFE_RELEASE_NULL(scaleCurve);
 }
 
+int Animation3D::addTrack(const float* keys, const float* values, uint32_t count, uint32_t componentSize)
+{
+    Track track;
+    track.keyOffset   = static_cast<uint32_t>(_keyTimes.size());
+    track.keyCount    = count;
+    track.valueOffset = static_cast<uint32_t>(_keyValues.size());
+
+    _keyTimes.insert(_keyTimes.end(), keys, keys + count);
+    _keyValues.insert(_keyValues.end(), values, values + count * componentSize);
+    _tracks.emplace_back(track);
+    return static_cast<int>(_tracks.size() - 1);
+}
+
 bool Animation3D::init(const Animation3DData& data)
 {
     _duration = data._totalTime;
@@ -128,6 +143,7 @@ bool Animation3D::init(const Animation3DData& data)
             curve->translateCurve = Curve::AnimationCurveVec3::create(&keys[0], &values[0].x, (int)keys.size());
             if (curve->translateCurve)
                 curve->translateCurve->retain();
+            curve->translateTrack = addTrack(&keys[0], &values[0].x, (uint32_t)keys.size(), 3);
         }
     }
 
@@ -154,6 +170,7 @@ bool Animation3D::init(const Animation3DData& data)
             curve->rotCurve = Curve::AnimationCurveQuat::create(&keys[0], &values[0].x, (int)keys.size());
             if (curve->rotCurve)
                 curve->rotCurve->retain();
+            curve->rotTrack = addTrack(&keys[0], &values[0].x, (uint32_t)keys.size(), 4);
         }
     }
 
@@ -180,6 +197,7 @@ bool Animation3D::init(const Animation3DData& data)
             curve->scaleCurve = Curve::AnimationCurveVec3::create(&keys[0], &values[0].x, (int)keys.size());
             if (curve->scaleCurve)
                 curve->scaleCurve->retain();
+            curve->scaleTrack = addTrack(&keys[0], &values[0].x, (uint32_t)keys.size(), 3);
         }
     }
 
@@ -27,6 +27,7 @@
 #define __CCANIMATION3D_H__
 
 #include <unordered_map>
+#include <vector>
 
 #include "3d/AnimationCurve.h"
 
@@ -62,6 +63,10 @@ public:
         AnimationCurveQuat* rotCurve;
         /**scaling curve*/
         AnimationCurveVec3* scaleCurve;
+        /**index of the curves in the compiled tracks, -1 if the curve is absent*/
+        int translateTrack;
+        int rotTrack;
+        int scaleTrack;
         /**constructor */
         Curve();
         /**constructor */
@@ -84,6 +89,26 @@ public:
     /**get the bone Curves set*/
     const hlookup::string_map<Curve*>& getBoneCurves() const { return _boneCurves; }
 
+    /**
+     * Key range of one compiled curve. Key times and values of all the curves are packed into two contiguous
+     * arrays, so sampling every bone of a clip walks linear memory instead of one heap block per curve.
+     */
+    struct Track
+    {
+        uint32_t keyOffset;    // index of the first key in getKeyTimes()
+        uint32_t keyCount;     // number of keys
+        uint32_t valueOffset;  // index of the first float of the first key in getKeyValues()
+    };
+
+    /**get compiled track by index, see Curve::translateTrack*/
+    const Track& getTrack(int index) const { return _tracks[index]; }
+
+    /**get packed key times of all tracks*/
+    const float* getKeyTimes() const { return _keyTimes.data(); }
+
+    /**get packed key values of all tracks, 3 floats per key for translation and scale, 4 for rotation*/
+    const float* getKeyValues() const { return _keyValues.data(); }
+
     Animation3D();
     virtual ~Animation3D();
     /**init Animation3D from bundle data*/
@@ -93,8 +118,14 @@ public:
     bool initWithFile(std::string_view filename, std::string_view animationName);
 
 protected:
+    int addTrack(const float* keys, const float* values, uint32_t count, uint32_t componentSize);
+
     hlookup::string_map<Curve*> _boneCurves;  // bone curves map, key bone name, value AnimationCurve
 
+    std::vector<Track> _tracks;     // compiled curves
+    std::vector<float> _keyTimes;   // key times of all tracks
+    std::vector<float> _keyValues;  // key values of all tracks
+
     float _duration;  // animation duration
 };
 
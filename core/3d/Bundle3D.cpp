@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "platform/FileUtils.h"
 #include "3d/BundleReader.h"
 #include "base/Data.h"
+#include "mio/mio.hpp"
 
 #define BUNDLE_TYPE_SCENE 1
 #define BUNDLE_TYPE_NODE 2
@@ -161,6 +162,7 @@ void Bundle3D::clear()
     if (_isBinary)
     {
         _binaryBuffer.clear();
+        _binaryMapping.reset();
         AX_SAFE_DELETE_ARRAY(_references);
     }
     else
@@ -399,6 +401,12 @@ bool Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
         AXLOG("warning: Failed to read meshdata: attribCount '%s'.", _path.c_str());
         return false;
     }
+    // versions before 0.6 don't store aabbs, they are calculated from the copied vertices
+    bool inPlace = _meshDataInPlace && _binaryMapping && _version != "0.3" && _version != "0.4" && _version != "0.5";
+#if AX_ENABLE_CACHE_TEXTURE_DATA
+    // the buffers are refilled from copies when the renderer is recreated
+    inPlace = false;
+#endif
     MeshData* meshData = nullptr;
     for (unsigned int i = 0; i < meshSize; ++i)
     {
@@ -410,6 +418,8 @@ bool Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
             goto FAILED;
         }
         meshData              = new MeshData();
+        if (inPlace)
+            meshData->source = _binaryMapping;
         meshData->attribCount = attribSize;
         meshData->attribs.resize(meshData->attribCount);
         for (ssize_t j = 0; j < meshData->attribCount; ++j)
@@ -434,11 +444,24 @@ bool Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
             goto FAILED;
         }
 
-        meshData->vertex.resize(vertexSizeInFloat);
-        if (_binaryReader.read(&meshData->vertex[0], 4, vertexSizeInFloat) != vertexSizeInFloat)
+        if (inPlace)
         {
-            AXLOG("warning: Failed to read meshdata: vertex element '%s'.", _path.c_str());
-            goto FAILED;
+            meshData->vertexView.data = _binaryReader.view(4, vertexSizeInFloat);
+            meshData->vertexView.size = vertexSizeInFloat * 4;
+            if (!meshData->vertexView.data)
+            {
+                AXLOG("warning: Failed to read meshdata: vertex element '%s'.", _path.c_str());
+                goto FAILED;
+            }
+        }
+        else
+        {
+            meshData->vertex.resize(vertexSizeInFloat);
+            if (_binaryReader.read(&meshData->vertex[0], 4, vertexSizeInFloat) != vertexSizeInFloat)
+            {
+                AXLOG("warning: Failed to read meshdata: vertex element '%s'.", _path.c_str());
+                goto FAILED;
+            }
         }
 
         // Read index data
@@ -447,7 +470,6 @@ bool Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
 
         for (unsigned int k = 0; k < meshPartCount; ++k)
         {
-            IndexArray indexArray{};
             std::string meshPartid = _binaryReader.readString();
             meshData->subMeshIds.emplace_back(meshPartid);
             unsigned int nIndexCount;
@@ -456,14 +478,29 @@ bool Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
                 AXLOG("warning: Failed to read meshdata: nIndexCount '%s'.", _path.c_str());
                 goto FAILED;
             }
-            indexArray.resize(nIndexCount);
-            if (_binaryReader.read(indexArray.data(), 2, nIndexCount) != nIndexCount)
+            if (inPlace)
             {
-                AXLOG("warning: Failed to read meshdata: indices '%s'.", _path.c_str());
-                goto FAILED;
+                auto indices = _binaryReader.view(2, nIndexCount);
+                if (!indices)
+                {
+                    AXLOG("warning: Failed to read meshdata: indices '%s'.", _path.c_str());
+                    goto FAILED;
+                }
+                meshData->subMeshIndexViews.emplace_back(MeshData::BufferView{indices, nIndexCount * 2u});
+                meshData->numIndex = (int)meshData->subMeshIndexViews.size();
+            }
+            else
+            {
+                IndexArray indexArray{};
+                indexArray.resize(nIndexCount);
+                if (_binaryReader.read(indexArray.data(), 2, nIndexCount) != nIndexCount)
+                {
+                    AXLOG("warning: Failed to read meshdata: indices '%s'.", _path.c_str());
+                    goto FAILED;
+                }
+                meshData->subMeshIndices.emplace_back(std::move(indexArray));
+                meshData->numIndex = (int)meshData->subMeshIndices.size();
             }
-            auto& storedIndices = meshData->subMeshIndices.emplace_back(std::move(indexArray));
-            meshData->numIndex = (int)meshData->subMeshIndices.size();
             // meshData->subMeshAABB.emplace_back(calculateAABB(meshData->vertex, meshData->getPerVertexSize(),
             // indexArray));
             if (_version != "0.3" && _version != "0.4" && _version != "0.5")
@@ -480,7 +517,7 @@ bool Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
             else
             {
                 meshData->subMeshAABB.emplace_back(
-                    calculateAABB(meshData->vertex, meshData->getPerVertexSize(), storedIndices));
+                    calculateAABB(meshData->vertex, meshData->getPerVertexSize(), meshData->subMeshIndices.back()));
             }
         }
         meshdatas.meshDatas.emplace_back(meshData);
@@ -1087,18 +1124,29 @@ bool Bundle3D::loadBinary(std::string_view path)
 {
     clear();
 
-    // get file data
-    _binaryBuffer.clear();
-    _binaryBuffer = FileUtils::getInstance()->getDataFromFile(path);
-    if (_binaryBuffer.isNull())
+    // map the file so mesh data can be read in place, files which can't be mapped (e.g. inside an apk) are read
+    auto mapping = std::make_shared<mio::mmap_source>();
+    std::error_code error;
+    mapping->map(path, error);
+    if (!error && mapping->is_mapped() && mapping->size() > 0)
     {
-        clear();
-        AXLOG("warning: Failed to read file: %s", path.data());
-        return false;
+        _binaryMapping = mapping;
+        _binaryReader.init(mapping->data(), static_cast<ssize_t>(mapping->size()));
     }
+    else
+    {
+        // get file data
+        _binaryBuffer = FileUtils::getInstance()->getDataFromFile(path);
+        if (_binaryBuffer.isNull())
+        {
+            clear();
+            AXLOG("warning: Failed to read file: %s", path.data());
+            return false;
+        }
 
-    // Initialise bundle reader
-    _binaryReader.init((char*)_binaryBuffer.getBytes(), _binaryBuffer.getSize());
+        // Initialise bundle reader
+        _binaryReader.init((const char*)_binaryBuffer.getBytes(), _binaryBuffer.getSize());
+    }
 
     // Read identifier info
     char identifier[] = {'C', '3', 'B', '\0'};
@@ -2313,7 +2361,13 @@ std::vector<Vec3> Bundle3D::getTrianglesList(std::string_view path)
 }
 
 Bundle3D::Bundle3D()
-    : _modelPath(""), _path(""), _version(""), _referenceCount(0), _references(nullptr), _isBinary(false)
+    : _modelPath("")
+    , _path("")
+    , _version("")
+    , _referenceCount(0)
+    , _references(nullptr)
+    , _isBinary(false)
+    , _meshDataInPlace(false)
 {}
 Bundle3D::~Bundle3D()
 {
@@ -92,6 +92,12 @@ public:
      */
     virtual bool loadAnimationData(std::string_view id, Animation3DData* animationdata);
 
+    /**
+     * Lets loadMeshDatas reference vertices and indices in place instead of copying them, see MeshData::isMapped.
+     * Only c3b files which can be memory mapped are read in place, false by default.
+     */
+    void setMeshDataInPlace(bool inPlace) { _meshDataInPlace = inPlace; }
+
     // since 3.3, to support reskin
     virtual bool loadMeshDatas(MeshDatas& meshdatas);
     // since 3.3, to support reskin
@@ -192,10 +198,12 @@ protected:
 
     // for binary reading
     Data _binaryBuffer;
+    std::shared_ptr<const void> _binaryMapping;  // the memory mapped file, _binaryBuffer is used when it can't be mapped
     BundleReader _binaryReader;
     unsigned int _referenceCount;
     Reference* _references;
     bool _isBinary;
+    bool _meshDataInPlace;
 };
 
 // end of 3d group
@@ -21,6 +21,8 @@ int MeshVertexAttrib::getAttribSizeBytes() const
     case backend::VertexFormat::INT:
     case backend::VertexFormat::UBYTE4:
     case backend::VertexFormat::USHORT2:
+    case backend::VertexFormat::HALF2:
+    case backend::VertexFormat::BYTE4:
         return 4;
     default:
         AXASSERT(false, "VertexFormat convert to size error");
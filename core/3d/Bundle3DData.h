@@ -36,6 +36,7 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <string>
 
 #include "3d/3DProgramInfo.h"
@@ -233,6 +234,7 @@ struct AX_DLL MeshVertexAttrib
 {
     backend::VertexFormat type;
     shaderinfos::VertexKey vertexAttrib;
+    bool normalized = false;  // integer values are read as normalized [0, 1] or [-1, 1] floats
     int getAttribSizeBytes() const;
 };
 
@@ -328,7 +330,33 @@ struct MeshData
     std::vector<MeshVertexAttrib> attribs;
     int attribCount;
 
+    /** Positions quantized by MeshOptimizer are dequantized with `positionOffset + positionScale * position`,
+     * positionScale is 0 when the positions are floats. */
+    Vec3 positionOffset;
+    float positionScale = 0.0f;
+
+    /** A byte range of mapped file data. */
+    struct BufferView
+    {
+        const void* data = nullptr;
+        size_t size      = 0;
+    };
+
+    /**
+     * Vertices and U_SHORT indices read in place from a memory mapped c3b, used instead of `vertex` and
+     * `subMeshIndices` when `vertexView.data` is set. `source` keeps the mapping alive.
+     */
+    std::shared_ptr<const void> source;
+    BufferView vertexView;
+    std::vector<BufferView> subMeshIndexViews;
+
 public:
+    /** Returns true if the vertices and indices are views of mapped file data. */
+    bool isMapped() const { return vertexView.data != nullptr; }
+
+    /** Returns the number of sub meshes. */
+    size_t getSubMeshCount() const { return isMapped() ? subMeshIndexViews.size() : subMeshIndices.size(); }
+
     /**
      * Get per vertex size
      * @return return the sum size of all vertex attributes.
@@ -352,6 +380,11 @@ public:
         subMeshIndices.clear();
         subMeshAABB.clear();
         attribs.clear();
+        source.reset();
+        vertexView = BufferView{};
+        subMeshIndexViews.clear();
+        positionOffset.setZero();
+        positionScale     = 0.0f;
         vertexSizeInFloat = 0;
         numIndex          = 0;
         attribCount       = 0;
@@ -39,7 +39,7 @@ BundleReader::~BundleReader(){
 
 };
 
-void BundleReader::init(char* buffer, ssize_t length)
+void BundleReader::init(const char* buffer, ssize_t length)
 {
     _position = 0;
     _buffer   = buffer;
@@ -62,13 +62,13 @@ ssize_t BundleReader::read(void* ptr, ssize_t size, ssize_t count)
     {
         validCount         = validLength / size;
         ssize_t readLength = size * validCount;
-        memcpy(ptr1, (char*)_buffer + _position, readLength);
+        memcpy(ptr1, _buffer + _position, readLength);
         ptr1 += readLength;
         _position += readLength;
         readLength = validLength - readLength;
         if (readLength > 0)
         {
-            memcpy(ptr1, (char*)_buffer + _position, readLength);
+            memcpy(ptr1, _buffer + _position, readLength);
             _position += readLength;
             validCount += 1;
         }
@@ -76,7 +76,7 @@ ssize_t BundleReader::read(void* ptr, ssize_t size, ssize_t count)
     }
     else
     {
-        memcpy(ptr1, (char*)_buffer + _position, needLength);
+        memcpy(ptr1, _buffer + _position, needLength);
         _position += needLength;
         validCount = count;
     }
@@ -84,12 +84,25 @@ ssize_t BundleReader::read(void* ptr, ssize_t size, ssize_t count)
     return validCount;
 }
 
+const void* BundleReader::view(ssize_t size, ssize_t count)
+{
+    if (!_buffer || _length - _position < size * count)
+    {
+        AXLOG("warning: bundle reader out of range");
+        return nullptr;
+    }
+
+    auto data = _buffer + _position;
+    _position += size * count;
+    return data;
+}
+
 char* BundleReader::readLine(int num, char* line)
 {
     if (!_buffer)
         return nullptr;
 
-    char* buffer = (char*)_buffer + _position;
+    const char* buffer = _buffer + _position;
     char* p      = line;
     char c;
     ssize_t readNum = 0;
@@ -63,7 +63,7 @@ public:
      * @param buffer The data buffer pointer
      * @param length The data buffer size
      */
-    void init(char* buffer, ssize_t length);
+    void init(const char* buffer, ssize_t length);
 
     /**
      * Reads an array of elements.
@@ -77,6 +77,16 @@ public:
      */
     ssize_t read(void* ptr, ssize_t size, ssize_t count);
 
+    /**
+     * Skips an array of elements and returns where it starts in the buffer, nothing is copied.
+     *
+     * @param size  The size of each element, in bytes.
+     * @param count The number of elements.
+     *
+     * @return The elements in place, nullptr if the buffer holds fewer elements.
+     */
+    const void* view(ssize_t size, ssize_t count);
+
     /**
      * Reads a line from the buffer.
      */
@@ -129,7 +139,7 @@ public:
 private:
     ssize_t _position;
     ssize_t _length;
-    char* _buffer;
+    const char* _buffer;
 };
 
 /// @cond
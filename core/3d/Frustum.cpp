@@ -26,6 +26,13 @@
 #include "3d/Frustum.h"
 #include "2d/Camera.h"
 
+#if defined(__aarch64__) || defined(_M_ARM64)
+#    include <arm_neon.h>
+#    define AX_FRUSTUM_NEON
+#elif defined(__SSE__)
+#    define AX_FRUSTUM_SSE
+#endif
+
 NS_AX_BEGIN
 
 bool Frustum::initFrustum(const Camera* camera)
@@ -36,23 +43,79 @@ bool Frustum::initFrustum(const Camera* camera)
 }
 bool Frustum::isOutOfFrustum(const AABB& aabb) const
 {
-    if (_initialized)
+    return intersectAABB(aabb) == Intersection::OUTSIDE;
+}
+
+Frustum::Intersection Frustum::intersectAABB(const AABB& aabb) const
+{
+    if (!_initialized)
+        return Intersection::INSIDE;
+
+    // per plane: dist is the signed distance of the box center, radius the projected half extents,
+    // the box is outside when even its nearest corner is in front of a plane
+    const float cx = (aabb._min.x + aabb._max.x) * 0.5f;
+    const float cy = (aabb._min.y + aabb._max.y) * 0.5f;
+    const float cz = (aabb._min.z + aabb._max.z) * 0.5f;
+    const float ex = (aabb._max.x - aabb._min.x) * 0.5f;
+    const float ey = (aabb._max.y - aabb._min.y) * 0.5f;
+    const float ez = (aabb._max.z - aabb._min.z) * 0.5f;
+
+    // the near and far planes are the second group of 4
+    const int groups = _clipZ ? 2 : 1;
+    bool intersect   = false;
+#if defined(AX_FRUSTUM_NEON)
+    const float32x4_t vcx = vdupq_n_f32(cx), vcy = vdupq_n_f32(cy), vcz = vdupq_n_f32(cz);
+    const float32x4_t vex = vdupq_n_f32(ex), vey = vdupq_n_f32(ey), vez = vdupq_n_f32(ez);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    for (int i = 0; i < groups * 4; i += 4)
     {
-        Vec3 point;
+        float32x4_t nx = vld1q_f32(&_planeRows[0][i]);
+        float32x4_t ny = vld1q_f32(&_planeRows[1][i]);
+        float32x4_t nz = vld1q_f32(&_planeRows[2][i]);
 
-        int plane = _clipZ ? 6 : 4;
-        for (int i = 0; i < plane; i++)
-        {
-            const Vec3& normal = _plane[i].getNormal();
-            point.x            = normal.x < 0 ? aabb._max.x : aabb._min.x;
-            point.y            = normal.y < 0 ? aabb._max.y : aabb._min.y;
-            point.z            = normal.z < 0 ? aabb._max.z : aabb._min.z;
+        float32x4_t dist = vmlaq_f32(vmlaq_f32(vmulq_f32(nx, vcx), ny, vcy), nz, vcz);
+        dist             = vsubq_f32(dist, vld1q_f32(&_planeRows[3][i]));
+        float32x4_t radius =
+            vmlaq_f32(vmlaq_f32(vmulq_f32(vabsq_f32(nx), vex), vabsq_f32(ny), vey), vabsq_f32(nz), vez);
 
-            if (_plane[i].getSide(point) == PointSide::FRONT_PLANE)
-                return true;
-        }
+        if (vmaxvq_u32(vcgtq_f32(vsubq_f32(dist, radius), zero)))
+            return Intersection::OUTSIDE;
+        intersect |= vmaxvq_u32(vcgtq_f32(vaddq_f32(dist, radius), zero)) != 0;
     }
-    return false;
+#elif defined(AX_FRUSTUM_SSE)
+    const __m128 vcx = _mm_set1_ps(cx), vcy = _mm_set1_ps(cy), vcz = _mm_set1_ps(cz);
+    const __m128 vex = _mm_set1_ps(ex), vey = _mm_set1_ps(ey), vez = _mm_set1_ps(ez);
+    const __m128 zero = _mm_setzero_ps();
+    for (int i = 0; i < groups * 4; i += 4)
+    {
+        __m128 nx = _mm_load_ps(&_planeRows[0][i]);
+        __m128 ny = _mm_load_ps(&_planeRows[1][i]);
+        __m128 nz = _mm_load_ps(&_planeRows[2][i]);
+
+        __m128 dist   = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, vcx), _mm_mul_ps(ny, vcy)), _mm_mul_ps(nz, vcz));
+        dist          = _mm_sub_ps(dist, _mm_load_ps(&_planeRows[3][i]));
+        // |n| as max(n, -n)
+        __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_max_ps(nx, _mm_sub_ps(zero, nx)), vex),
+                                              _mm_mul_ps(_mm_max_ps(ny, _mm_sub_ps(zero, ny)), vey)),
+                                   _mm_mul_ps(_mm_max_ps(nz, _mm_sub_ps(zero, nz)), vez));
+
+        if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_sub_ps(dist, radius), zero)))
+            return Intersection::OUTSIDE;
+        intersect |= _mm_movemask_ps(_mm_cmpgt_ps(_mm_add_ps(dist, radius), zero)) != 0;
+    }
+#else
+    for (int i = 0; i < groups * 4; i++)
+    {
+        const float nx = _planeRows[0][i], ny = _planeRows[1][i], nz = _planeRows[2][i];
+
+        float dist   = nx * cx + ny * cy + nz * cz - _planeRows[3][i];
+        float radius = std::abs(nx) * ex + std::abs(ny) * ey + std::abs(nz) * ez;
+        if (dist - radius > 0)
+            return Intersection::OUTSIDE;
+        intersect |= dist + radius > 0;
+    }
+#endif
+    return intersect ? Intersection::INTERSECT : Intersection::INSIDE;
 }
 
 bool Frustum::isOutOfFrustum(const OBB& obb) const
@@ -97,6 +160,17 @@ void Frustum::createPlane(const Camera* camera)
                         (mat.m[15] + mat.m[14]));  // near
     _plane[5].initPlane(-Vec3(mat.m[3] - mat.m[2], mat.m[7] - mat.m[6], mat.m[11] - mat.m[10]),
                         (mat.m[15] - mat.m[14]));  // far
+
+    // the 2 padding planes have a zero normal and distance, nothing is ever in front of them
+    memset(_planeRows, 0, sizeof(_planeRows));
+    for (int i = 0; i < 6; ++i)
+    {
+        const Vec3& normal = _plane[i].getNormal();
+        _planeRows[0][i]   = normal.x;
+        _planeRows[1][i]   = normal.y;
+        _planeRows[2][i]   = normal.z;
+        _planeRows[3][i]   = _plane[i].getDist();
+    }
 }
 
 NS_AX_END
@@ -32,6 +32,10 @@
 #include "3d/OBB.h"
 #include "3d/Plane.h"
 
+#ifdef __SSE__
+#    include <xmmintrin.h>
+#endif
+
 NS_AX_BEGIN
 
 class Camera;
@@ -47,6 +51,16 @@ class AX_DLL Frustum
     friend class Camera;
 
 public:
+    /**
+     * The result of testing a volume against the frustum.
+     */
+    enum class Intersection
+    {
+        OUTSIDE,
+        INTERSECT,
+        INSIDE,
+    };
+
     /**
      * Constructor & Destructor.
      */
@@ -67,6 +81,12 @@ public:
      */
     bool isOutOfFrustum(const OBB& obb) const;
 
+    /**
+     * tests the aabb against all clip planes at once, INSIDE means no plane cuts the aabb,
+     * so volumes contained in it don't need to be tested again.
+     */
+    Intersection intersectAABB(const AABB& aabb) const;
+
     /**
      * get & set z clip. if bclipZ == true use near and far plane
      */
@@ -82,6 +102,9 @@ protected:
     Plane _plane[6];  // clip plane, left, right, top, bottom, near, far
     bool _clipZ;      // use near and far clip plane
     bool _initialized;
+
+    // the clip planes as normal x, y, z and distance rows, padded to 8 planes for 4 wide plane tests
+    alignas(16) float _planeRows[4][8];
 };
 
 NS_AX_END
@@ -25,6 +25,7 @@
 
 #include "3d/Mesh.h"
 #include "3d/MeshSkin.h"
+#include "3d/MeshMaterial.h"
 #include "3d/Skeleton3D.h"
 #include "3d/MeshVertexIndexData.h"
 #include "3d/VertexAttribBinding.h"
@@ -42,6 +43,7 @@
 #include "renderer/backend/Program.h"
 #include "renderer/RenderConsts.h"
 #include "math/Mat4.h"
+#include "xxhash.h"
 
 using namespace std;
 
@@ -99,6 +101,8 @@ Mesh::Mesh()
     , _instanceCount(0)
     , _dynamicInstancing(false)
     , _instanceMatrixCache(nullptr)
+    , _autoInstancing(true)
+    , _instancedMaterial(nullptr)
     , meshIndexFormat(CustomCommand::IndexFormat::U_SHORT)
     , _meshIndexData(nullptr)
     , _blend(BlendFunc::ALPHA_NON_PREMULTIPLIED)
@@ -117,6 +121,7 @@ Mesh::~Mesh()
     AX_SAFE_RELEASE(_skin);
     AX_SAFE_RELEASE(_meshIndexData);
     AX_SAFE_RELEASE(_material);
+    AX_SAFE_RELEASE(_instancedMaterial);
     AX_SAFE_RELEASE(_instanceTransformBuffer);
     AX_SAFE_DELETE_ARRAY(_instanceMatrixCache);
 }
@@ -333,6 +338,8 @@ void Mesh::setTexture(Texture2D* tex, NTextureData::Usage usage, bool cacheFileN
                 pass->setUniformTexture(0, tex->getBackendTexture());
             }
         }
+        if (_instancedMaterial)
+            _instancedMaterial->getTechnique()->getPassByIndex(0)->setUniformTexture(0, tex->getBackendTexture());
 
         bindMeshCommand();
         if (cacheFileName)
@@ -376,6 +383,7 @@ void Mesh::setMaterial(Material* material)
         AX_SAFE_RETAIN(_material);
     }
     _meshCommands.clear();
+    AX_SAFE_RELEASE_NULL(_instancedMaterial);
 
     if (_material)
     {
@@ -482,10 +490,14 @@ void Mesh::draw(Renderer* renderer,
         {
             _instanceTransformDirty = false;
 
-            int memOffset = 0;
+            // quantized positions are dequantized before the instance transform
+            auto vertexData = _meshIndexData->getMeshVertexData();
+            int memOffset   = 0;
             for (auto& _ : _instances)
             {
-                auto& mat = _->getNodeToParentTransform();
+                auto mat = _->getNodeToParentTransform();
+                if (vertexData->hasQuantizedPositions())
+                    mat *= vertexData->getPositionDequantization();
                 std::copy(mat.m, mat.m + 16, _instanceMatrixCache + 16 * memOffset++);
             }
             _instanceTransformBuffer->updateSubData(_instanceMatrixCache, 0, _instanceCount * 64);
@@ -526,9 +538,15 @@ void Mesh::draw(Renderer* renderer,
     }
     auto& commands = _meshCommands[technique->getName()];
 
+    // quantized positions are dequantized by the model transform
+    auto vertexData    = _meshIndexData->getMeshVertexData();
+    Mat4 drawTransform = transform;
+    if (vertexData->hasQuantizedPositions() && !_instancing)
+        drawTransform *= vertexData->getPositionDequantization();
+
     for (auto&& command : commands)
     {
-        command.init(globalZ, transform);
+        command.init(globalZ, drawTransform);
         command.setSkipBatching(isTransparent);
         command.setTransparent(isTransparent);
         command.set3D(!_material->isForce2DQueue());
@@ -540,11 +558,108 @@ void Mesh::draw(Renderer* renderer,
         }
         else if (_instancing)
             return;
+        command.setInstancing(0, nullptr);
+    }
+
+    if (_autoInstancing && !_instancing && !_skin && !isTransparent && globalZ == 0 && commands.size() == 1 &&
+        !_material->isForce2DQueue() && renderer->isAutoInstancing())
+    {
+        auto key = prepareAutoInstancing(globalZ, color, lightMask, wireframe, scene);
+        commands[0].setInstancing(key, key ? &_instancedCommand : nullptr);
     }
 
     _meshIndexData->setPrimitiveType(_material->_drawPrimitive);
     _material->draw(commands.data(), globalZ, getVertexBuffer(), getIndexBuffer(), getPrimitiveType(), getIndexFormat(),
-                    static_cast<unsigned int>(getIndexCount()), transform);
+                    static_cast<unsigned int>(getIndexCount()), drawTransform);
+}
+
+uint64_t Mesh::prepareAutoInstancing(float globalZOrder,
+                                     const Vec4& color,
+                                     unsigned int lightMask,
+                                     bool wireframe,
+                                     Scene* scene)
+{
+    auto meshMaterial = dynamic_cast<MeshMaterial*>(_material);
+    if (!meshMaterial)
+        return 0;
+
+    MeshMaterial::MaterialType instancedType;
+    switch (meshMaterial->getMaterialType())
+    {
+    case MeshMaterial::MaterialType::UNLIT:
+        instancedType = MeshMaterial::MaterialType::UNLIT_INSTANCE;
+        break;
+    case MeshMaterial::MaterialType::DIFFUSE:
+        instancedType = MeshMaterial::MaterialType::DIFFUSE_INSTANCE;
+        break;
+    default:
+        return 0;
+    }
+
+    auto textureIter = _textures.find(NTextureData::Usage::Diffuse);
+    auto texture     = textureIter != _textures.end() ? textureIter->second : nullptr;
+
+    if (!_instancedMaterial)
+    {
+        _instancedMaterial = MeshMaterial::createBuiltInMaterial(instancedType, false);
+        if (!_instancedMaterial)
+            return 0;
+        _instancedMaterial->retain();
+
+        auto pass = _instancedMaterial->getTechnique()->getPassByIndex(0);
+        pass->setVertexAttribBinding(VertexAttribBinding::create(_meshIndexData, pass, &_instancedCommand));
+        if (texture)
+            pass->setUniformTexture(0, texture->getBackendTexture());
+    }
+
+    auto& stateBlock = _material->getStateBlock();
+    _instancedMaterial->setStateBlock(stateBlock);
+
+    auto pass = _instancedMaterial->getTechnique()->getPassByIndex(0);
+    pass->setUniformColor(&color, sizeof(color));
+    if (scene && !scene->getLights().empty())
+        setLightUniforms(pass, scene, color, lightMask);
+
+    // the instance transforms carry the model view, so the group is drawn with an identity model view
+    pass->prepareDraw(&_instancedCommand, globalZOrder, getVertexBuffer(), getIndexBuffer(), getPrimitiveType(),
+                      getIndexFormat(), static_cast<unsigned int>(getIndexCount()), Mat4::IDENTITY);
+    _instancedCommand.setDrawType(CustomCommand::DrawType::ELEMENT_INSTANCE);
+    _instancedCommand.setWireframe(wireframe);
+
+    // everything which has to be equal for two meshes to share one draw, trivially copyable and hashed as raw memory
+    struct InstancingKey
+    {
+        backend::Buffer* vertexBuffer;
+        backend::Buffer* indexBuffer;
+        Texture2D* texture;
+        float color[4];
+        uint32_t indexCount;
+        uint32_t lightMask;
+        uint32_t stateBlock;
+        uint8_t primitive;
+        uint8_t materialType;
+        uint8_t wireframe;
+        uint8_t reserved;  // keeps the key free of padding bytes, it is hashed as raw memory
+    };
+    static_assert(sizeof(InstancingKey) == 3 * sizeof(void*) + 32, "InstancingKey must not have padding");
+
+    InstancingKey key{};
+    key.vertexBuffer = getVertexBuffer();
+    key.indexBuffer  = getIndexBuffer();
+    key.texture      = texture;
+    key.color[0]     = color.x;
+    key.color[1]     = color.y;
+    key.color[2]     = color.z;
+    key.color[3]     = color.w;
+    key.indexCount   = static_cast<uint32_t>(getIndexCount());
+    key.lightMask    = scene && !scene->getLights().empty() ? lightMask : 0;
+    key.stateBlock   = stateBlock.getHash();
+    key.primitive    = static_cast<uint8_t>(getPrimitiveType());
+    key.materialType = static_cast<uint8_t>(instancedType);
+    key.wireframe    = wireframe;
+
+    auto hash = XXH64(&key, sizeof(key), 0);
+    return hash ? hash : 1;
 }
 
 void Mesh::setSkin(MeshSkin* skin)
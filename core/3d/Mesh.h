@@ -273,6 +273,13 @@ public:
     /** rebuilds the instance transform buffer next frame. */
     void rebuildInstances();
 
+    /** Allows the renderer to draw this mesh together with identical meshes in one instanced draw when
+     * Renderer::setAutoInstancing() is enabled. Only opaque, unskinned meshes using the built in UNLIT or DIFFUSE
+     * material qualify. true by default.
+     */
+    void setAutoInstancing(bool enabled) { _autoInstancing = enabled; }
+    bool isAutoInstancing() const { return _autoInstancing; }
+
     Mesh();
     virtual ~Mesh();
 
@@ -280,6 +287,12 @@ protected:
     void resetLightUniformValues();
     void setLightUniforms(Pass* pass, Scene* scene, const Vec4& color, unsigned int lightmask);
     void bindMeshCommand();
+    /* prepares _instancedCommand for this frame, returns the key of identical meshes or 0 if it can't be merged */
+    uint64_t prepareAutoInstancing(float globalZOrder,
+                                   const Vec4& color,
+                                   unsigned int lightMask,
+                                   bool wireframe,
+                                   Scene* scene);
 
     std::map<NTextureData::Usage, Texture2D*> _textures;  // textures that submesh is using
     MeshSkin* _skin;                                      // skin
@@ -294,6 +307,10 @@ protected:
     float* _instanceMatrixCache;
     bool _dynamicInstancing;
 
+    bool _autoInstancing;
+    Material* _instancedMaterial;  // instanced copy of _material for automatic instancing, created on demand
+    MeshCommand _instancedCommand;
+
     CustomCommand::IndexFormat meshIndexFormat;
 
     std::string _name;
@@ -44,6 +44,7 @@ MeshMaterial* MeshMaterial::_unLitInstanceMaterial = nullptr;
 MeshMaterial* MeshMaterial::_unLitNoTexMaterial    = nullptr;
 MeshMaterial* MeshMaterial::_vertexLitMaterial     = nullptr;
 MeshMaterial* MeshMaterial::_diffuseMaterial       = nullptr;
+MeshMaterial* MeshMaterial::_diffuseInstanceMaterial = nullptr;
 MeshMaterial* MeshMaterial::_diffuseNoTexMaterial  = nullptr;
 MeshMaterial* MeshMaterial::_bumpedDiffuseMaterial = nullptr;
 
@@ -60,6 +61,7 @@ backend::ProgramState* MeshMaterial::_unLitInstanceMaterialProgState = nullptr;
 backend::ProgramState* MeshMaterial::_unLitNoTexMaterialProgState    = nullptr;
 backend::ProgramState* MeshMaterial::_vertexLitMaterialProgState     = nullptr;
 backend::ProgramState* MeshMaterial::_diffuseMaterialProgState       = nullptr;
+backend::ProgramState* MeshMaterial::_diffuseInstanceMaterialProgState = nullptr;
 backend::ProgramState* MeshMaterial::_diffuseNoTexMaterialProgState  = nullptr;
 backend::ProgramState* MeshMaterial::_bumpedDiffuseMaterialProgState = nullptr;
 
@@ -97,6 +99,14 @@ void MeshMaterial::createBuiltInMaterial()
         _diffuseMaterial->_type = MeshMaterial::MaterialType::DIFFUSE;
     }
 
+    program = backend::Program::getBuiltinProgram(backend::ProgramType::POSITION_NORMAL_TEXTURE_3D_INSTANCE);
+    _diffuseInstanceMaterialProgState = new backend::ProgramState(program);
+    _diffuseInstanceMaterial          = new MeshMaterial();
+    if (_diffuseInstanceMaterial && _diffuseInstanceMaterial->initWithProgramState(_diffuseInstanceMaterialProgState))
+    {
+        _diffuseInstanceMaterial->_type = MeshMaterial::MaterialType::DIFFUSE_INSTANCE;
+    }
+
     program                 = backend::Program::getBuiltinProgram(backend::ProgramType::POSITION_TEXTURE_3D);
     _unLitMaterialProgState = new backend::ProgramState(program);
     _unLitMaterial          = new MeshMaterial();
@@ -171,6 +181,7 @@ void MeshMaterial::releaseBuiltInMaterial()
     AX_SAFE_RELEASE_NULL(_unLitNoTexMaterial);
     AX_SAFE_RELEASE_NULL(_vertexLitMaterial);
     AX_SAFE_RELEASE_NULL(_diffuseMaterial);
+    AX_SAFE_RELEASE_NULL(_diffuseInstanceMaterial);
     AX_SAFE_RELEASE_NULL(_diffuseNoTexMaterial);
     AX_SAFE_RELEASE_NULL(_bumpedDiffuseMaterial);
 
@@ -182,6 +193,7 @@ void MeshMaterial::releaseBuiltInMaterial()
     AX_SAFE_RELEASE_NULL(_unLitNoTexMaterialProgState);
     AX_SAFE_RELEASE_NULL(_vertexLitMaterialProgState);
     AX_SAFE_RELEASE_NULL(_diffuseMaterialProgState);
+    AX_SAFE_RELEASE_NULL(_diffuseInstanceMaterialProgState);
     AX_SAFE_RELEASE_NULL(_diffuseNoTexMaterialProgState);
     AX_SAFE_RELEASE_NULL(_bumpedDiffuseMaterialProgState);
 
@@ -241,7 +253,14 @@ MeshMaterial* MeshMaterial::createBuiltInMaterial(MaterialType type, bool skinne
         break;
 
     case MeshMaterial::MaterialType::UNLIT_INSTANCE:
-        material = skinned ? /* TODO: implement instanced hardware skinning */ nullptr : _unLitInstanceMaterial;
+        if (skinned)
+        {
+            // the instance shaders have no matrix palette, skinned meshes are drawn one by one
+            AXLOG("MeshMaterial: skinned meshes can't be instanced, using the UNLIT material");
+            material = _unLitMaterialSkin;
+        }
+        else
+            material = _unLitInstanceMaterial;
         break;
 
     case MeshMaterial::MaterialType::UNLIT_NOTEX:
@@ -256,6 +275,16 @@ MeshMaterial* MeshMaterial::createBuiltInMaterial(MaterialType type, bool skinne
         material = skinned ? _diffuseMaterialSkin : _diffuseMaterial;
         break;
 
+    case MeshMaterial::MaterialType::DIFFUSE_INSTANCE:
+        if (skinned)
+        {
+            AXLOG("MeshMaterial: skinned meshes can't be instanced, using the DIFFUSE material");
+            material = _diffuseMaterialSkin;
+        }
+        else
+            material = _diffuseInstanceMaterial;
+        break;
+
     case MeshMaterial::MaterialType::DIFFUSE_NOTEX:
         material = _diffuseNoTexMaterial;
         break;
@@ -66,6 +66,7 @@ public:
         BUMPED_DIFFUSE,  // bumped diffuse
         QUAD_TEXTURE,    // textured quad material
         QUAD_COLOR,      // colored quad material (without texture)
+        DIFFUSE_INSTANCE,  // diffuse instance material
 
         // Custom material
         CUSTOM,  // Create from a material file
@@ -78,6 +79,7 @@ public:
     {
         NO_INSTANCING,  // disabled instancing
         UNLIT_INSTANCE,  // unlit instance material
+        DIFFUSE_INSTANCE,  // diffuse instance material
 
         // Custom material
         CUSTOM,  // Create from a material file
@@ -141,6 +143,7 @@ protected:
     static MeshMaterial* _unLitNoTexMaterial;
     static MeshMaterial* _vertexLitMaterial;
     static MeshMaterial* _diffuseMaterial;
+    static MeshMaterial* _diffuseInstanceMaterial;
     static MeshMaterial* _diffuseNoTexMaterial;
     static MeshMaterial* _bumpedDiffuseMaterial;
 
@@ -157,6 +160,7 @@ protected:
     static backend::ProgramState* _unLitNoTexMaterialProgState;
     static backend::ProgramState* _vertexLitMaterialProgState;
     static backend::ProgramState* _diffuseMaterialProgState;
+    static backend::ProgramState* _diffuseInstanceMaterialProgState;
     static backend::ProgramState* _diffuseNoTexMaterialProgState;
     static backend::ProgramState* _bumpedDiffuseMaterialProgState;
 
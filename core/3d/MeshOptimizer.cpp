@@ -0,0 +1,845 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "3d/MeshOptimizer.h"
+#include "3d/Bundle3D.h"
+#include "3d/BundleReader.h"
+#include "platform/FileUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+#include "mio/mio.hpp"
+#include "xxhash.h"
+#include "fmt/format.h"
+
+NS_AX_BEGIN
+
+using VertexKey = shaderinfos::VertexKey;
+
+// the simulated LRU cache of the vertex cache optimization
+static const int VERTEX_CACHE_SIZE = 32;
+// the simulated FIFO cache which splits triangles into clusters for the overdraw optimization
+static const uint32_t CLUSTER_CACHE_SIZE = 16;
+
+static const char MESH_CACHE_MAGIC[4]    = {'A', 'X', 'M', 'C'};
+static const uint32_t MESH_CACHE_VERSION = 1;
+
+// models are loaded on the job system, the cache files and the cache directory are written by one thread at a time
+static std::mutex s_cacheWriteMutex;
+
+struct MeshCacheHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t meshCount;
+    uint64_t modelSize;
+    uint64_t modelHash;
+};
+
+/* Copies mesh data read in place from a mapped file, the optimizations rewrite it. */
+static void detachMeshData(MeshData& meshData)
+{
+    if (!meshData.isMapped())
+        return;
+
+    auto vertexView = meshData.vertexView;
+    meshData.vertex.resize(vertexView.size / sizeof(float));
+    memcpy(meshData.vertex.data(), vertexView.data, vertexView.size);
+
+    meshData.subMeshIndices.clear();
+    for (auto&& view : meshData.subMeshIndexViews)
+    {
+        IndexArray indices(backend::IndexFormat::U_SHORT);
+        indices.bresize(view.size);
+        memcpy(indices.data(), view.data, view.size);
+        meshData.subMeshIndices.emplace_back(std::move(indices));
+    }
+
+    meshData.vertexView = MeshData::BufferView{};
+    meshData.subMeshIndexViews.clear();
+    meshData.source.reset();
+}
+
+static size_t getVertexCount(const MeshData& meshData)
+{
+    const int stride = meshData.getPerVertexSize();
+    return stride > 0 ? meshData.vertex.size() * sizeof(float) / stride : 0;
+}
+
+/* Returns the byte offset of an attribute in a vertex, -1 if the mesh doesn't have it. */
+static int getAttribOffset(const MeshData& meshData, VertexKey key, backend::VertexFormat* type = nullptr)
+{
+    int offset = 0;
+    for (auto&& attrib : meshData.attribs)
+    {
+        if (attrib.vertexAttrib == key)
+        {
+            if (type)
+                *type = attrib.type;
+            return offset;
+        }
+        offset += attrib.getAttribSizeBytes();
+    }
+    return -1;
+}
+
+static bool isTriangleList(const IndexArray& indices)
+{
+    return indices.size() % 3 == 0;
+}
+
+static std::vector<uint32_t> readIndices(const IndexArray& indices)
+{
+    std::vector<uint32_t> ret;
+    ret.reserve(indices.size());
+    indices.for_each([&ret](uint32_t index) { ret.push_back(index); });
+    return ret;
+}
+
+static void writeIndices(IndexArray& indices, const std::vector<uint32_t>& values)
+{
+    AXASSERT(indices.size() == values.size(), "index count mismatch");
+    if (indices.format() == backend::IndexFormat::U_SHORT)
+    {
+        auto dst = indices.begin<uint16_t>();
+        for (size_t i = 0; i < values.size(); ++i)
+            dst[i] = static_cast<uint16_t>(values[i]);
+    }
+    else
+        memcpy(indices.data(), values.data(), values.size() * sizeof(uint32_t));
+}
+
+/* Returns the float3 positions of the vertices, empty if the positions aren't float3. */
+static std::vector<Vec3> readPositions(const MeshData& meshData)
+{
+    std::vector<Vec3> positions;
+    backend::VertexFormat type;
+    const int offset = getAttribOffset(meshData, VertexKey::VERTEX_ATTRIB_POSITION, &type);
+    if (offset < 0 || type != backend::VertexFormat::FLOAT3)
+        return positions;
+
+    const size_t stride = meshData.getPerVertexSize();
+    const auto vertices = reinterpret_cast<const uint8_t*>(meshData.vertex.data());
+    positions.resize(getVertexCount(meshData));
+    for (size_t i = 0; i < positions.size(); ++i)
+        memcpy(&positions[i], vertices + i * stride + offset, sizeof(Vec3));
+    return positions;
+}
+
+static float vertexCacheScore(int cachePosition, uint32_t remainingTriangles)
+{
+    if (remainingTriangles == 0)
+        return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 3)
+        score = std::pow(1.0f - float(cachePosition - 3) / (VERTEX_CACHE_SIZE - 3), 1.5f);
+    else if (cachePosition >= 0)
+        score = 0.75f;  // the vertices of the last triangle, they shouldn't make the next triangle a strip
+    // vertices with few triangles left are finished first
+    return score + 2.0f / std::sqrt(float(remainingTriangles));
+}
+
+/* Tom Forsyth's linear-speed vertex cache optimization. */
+static void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+    const size_t triangleCount = indices.size() / 3;
+
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (auto index : indices)
+        ++remaining[index];
+
+    // the triangles using each vertex, the first remaining[v] entries of a vertex are the ones not emitted yet
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        offsets[v + 1] = offsets[v] + remaining[v];
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); ++i)
+        adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        vertexScore[v] = vertexCacheScore(-1, remaining[v]);
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+
+    uint32_t cache[VERTEX_CACHE_SIZE + 3];
+    uint32_t newCache[VERTEX_CACHE_SIZE + 3];
+    size_t cacheSize = 0;
+
+    int64_t best  = -1;
+    size_t cursor = 0;  // all triangles before it are emitted
+    for (size_t n = 0; n < triangleCount; ++n)
+    {
+        if (best < 0)
+        {
+            // no triangle uses a cached vertex, continue with the next triangle in the original order
+            while (emitted[cursor])
+                ++cursor;
+            best = static_cast<int64_t>(cursor);
+        }
+
+        const uint32_t* triangle = &indices[best * 3];
+        result.insert(result.end(), triangle, triangle + 3);
+        emitted[best] = true;
+
+        for (int k = 0; k < 3; ++k)
+        {
+            auto v     = triangle[k];
+            auto first = adjacency.data() + offsets[v];
+            auto last  = first + remaining[v];
+            auto it    = std::find(first, last, static_cast<uint32_t>(best));
+            *it        = *(last - 1);
+            --remaining[v];
+        }
+
+        // the triangle's vertices move to the front of the cache
+        size_t newCacheSize = 0;
+        for (int k = 0; k < 3; ++k)
+            newCache[newCacheSize++] = triangle[k];
+        for (size_t i = 0; i < cacheSize; ++i)
+        {
+            auto v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                newCache[newCacheSize++] = v;
+        }
+        for (size_t i = VERTEX_CACHE_SIZE; i < newCacheSize; ++i)
+        {
+            auto v           = newCache[i];
+            cachePosition[v] = -1;
+            vertexScore[v]   = vertexCacheScore(-1, remaining[v]);
+        }
+        cacheSize = std::min(newCacheSize, static_cast<size_t>(VERTEX_CACHE_SIZE));
+        for (size_t i = 0; i < cacheSize; ++i)
+        {
+            auto v           = newCache[i];
+            cache[i]         = v;
+            cachePosition[v] = static_cast<int>(i);
+            vertexScore[v]   = vertexCacheScore(static_cast<int>(i), remaining[v]);
+        }
+
+        // the next triangle is the best one using a cached vertex
+        best            = -1;
+        float bestScore = -1.0f;
+        for (size_t i = 0; i < cacheSize; ++i)
+        {
+            auto v     = cache[i];
+            auto first = adjacency.data() + offsets[v];
+            for (auto it = first; it != first + remaining[v]; ++it)
+            {
+                auto t      = *it;
+                float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] +
+                              vertexScore[indices[t * 3 + 2]];
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best      = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(result);
+}
+
+/* Sorts clusters of triangles to draw the ones facing away from the mesh center first. */
+static void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vec3>& positions)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2)
+        return;
+
+    // a cluster starts at a triangle missing the cache with all its vertices, so the cache hits inside a cluster
+    // don't depend on the order of the clusters
+    std::vector<uint32_t> timestamps(positions.size(), 0);
+    uint32_t time = CLUSTER_CACHE_SIZE + 1;
+    std::vector<uint32_t> clusterStarts;
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        int misses = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            auto v = indices[t * 3 + k];
+            if (time - timestamps[v] > CLUSTER_CACHE_SIZE)
+            {
+                timestamps[v] = time++;
+                ++misses;
+            }
+        }
+        if (t == 0 || misses == 3)
+            clusterStarts.push_back(static_cast<uint32_t>(t));
+    }
+    if (clusterStarts.size() < 2)
+        return;
+    clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+    struct Cluster
+    {
+        uint32_t first;
+        uint32_t last;
+        Vec3 centroid;
+        Vec3 normal;
+        float area;
+        float sortKey;
+    };
+    std::vector<Cluster> clusters(clusterStarts.size() - 1);
+
+    Vec3 meshCentroid;
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusters.size(); ++c)
+    {
+        auto& cluster = clusters[c];
+        cluster.first = clusterStarts[c];
+        cluster.last  = clusterStarts[c + 1];
+        cluster.area  = 0.0f;
+        for (auto t = cluster.first; t < cluster.last; ++t)
+        {
+            auto& p0 = positions[indices[t * 3]];
+            auto& p1 = positions[indices[t * 3 + 1]];
+            auto& p2 = positions[indices[t * 3 + 2]];
+            Vec3 normal;
+            Vec3::cross(p1 - p0, p2 - p0, &normal);
+            const float area = normal.length();
+            cluster.centroid += (p0 + p1 + p2) * (area / 3.0f);
+            cluster.normal += normal;
+            cluster.area += area;
+        }
+        meshCentroid += cluster.centroid;
+        meshArea += cluster.area;
+        if (cluster.area > 0.0f)
+            cluster.centroid *= 1.0f / cluster.area;
+    }
+    if (meshArea > 0.0f)
+        meshCentroid *= 1.0f / meshArea;
+
+    for (auto&& cluster : clusters)
+    {
+        auto normal = cluster.normal;
+        normal.normalize();
+        cluster.sortKey = Vec3::dot(cluster.centroid - meshCentroid, normal);
+    }
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (auto&& cluster : clusters)
+        result.insert(result.end(), indices.begin() + cluster.first * 3, indices.begin() + cluster.last * 3);
+    indices.swap(result);
+}
+
+static uint16_t toHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign     = (bits >> 16) & 0x8000;
+    const int32_t exponent  = static_cast<int32_t>((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa       = bits & 0x7fffff;
+
+    if (((bits >> 23) & 0xff) == 0xff)
+        return static_cast<uint16_t>(sign | 0x7c00 | (mantissa ? 0x200 : 0));  // inf and nan
+    if (exponent >= 31)
+        return static_cast<uint16_t>(sign | 0x7c00);  // too large, inf
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+            return static_cast<uint16_t>(sign);  // too small, zero
+        // subnormal
+        mantissa |= 0x800000;
+        const uint32_t shift = 14 - exponent;
+        uint32_t half        = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1)
+            ++half;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = sign | (exponent << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000)
+        ++half;  // rounding may carry into the exponent, which is still the nearest value
+    return static_cast<uint16_t>(half);
+}
+
+static int8_t toSnorm8(float value)
+{
+    return static_cast<int8_t>(std::lround(clampf(value, -1.0f, 1.0f) * 127.0f));
+}
+
+static bool hashModelFile(std::string_view modelPath, uint64_t& size, uint64_t& hash)
+{
+    mio::mmap_source mapping;
+    std::error_code error;
+    mapping.map(std::string{modelPath}, error);
+    if (!error && mapping.is_mapped())
+    {
+        size = mapping.size();
+        hash = XXH64(mapping.data(), mapping.size(), 0);
+        return true;
+    }
+
+    auto data = FileUtils::getInstance()->getDataFromFile(modelPath);
+    if (data.isNull())
+        return false;
+    size = data.getSize();
+    hash = XXH64(data.getBytes(), data.getSize(), 0);
+    return true;
+}
+
+template <typename T>
+static void appendValue(std::string& buffer, const T& value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void appendBytes(std::string& buffer, const void* data, size_t size)
+{
+    appendValue(buffer, static_cast<uint32_t>(size));
+    buffer.append(static_cast<const char*>(data), size);
+}
+
+void MeshOptimizer::optimize(MeshDatas& meshDatas, uint32_t flags)
+{
+    for (auto meshData : meshDatas.meshDatas)
+        optimize(*meshData, flags);
+}
+
+void MeshOptimizer::optimize(MeshData& meshData, uint32_t flags)
+{
+    if (flags & VERTEX_CACHE)
+        optimizeVertexCache(meshData);
+    if (flags & OVERDRAW)
+        optimizeOverdraw(meshData);
+    if (flags & VERTEX_FETCH)
+        optimizeVertexFetch(meshData);
+    if (flags & QUANTIZE)
+        quantize(meshData, flags);
+}
+
+void MeshOptimizer::optimizeVertexCache(MeshData& meshData)
+{
+    detachMeshData(meshData);
+
+    const size_t vertexCount = getVertexCount(meshData);
+    for (auto&& subMeshIndices : meshData.subMeshIndices)
+    {
+        if (!isTriangleList(subMeshIndices))
+            continue;
+        auto indices = readIndices(subMeshIndices);
+        ax::optimizeVertexCache(indices, vertexCount);
+        writeIndices(subMeshIndices, indices);
+    }
+}
+
+void MeshOptimizer::optimizeOverdraw(MeshData& meshData)
+{
+    detachMeshData(meshData);
+
+    auto positions = readPositions(meshData);
+    if (positions.empty())
+        return;
+
+    for (auto&& subMeshIndices : meshData.subMeshIndices)
+    {
+        if (!isTriangleList(subMeshIndices))
+            continue;
+        auto indices = readIndices(subMeshIndices);
+        ax::optimizeOverdraw(indices, positions);
+        writeIndices(subMeshIndices, indices);
+    }
+}
+
+void MeshOptimizer::optimizeVertexFetch(MeshData& meshData)
+{
+    detachMeshData(meshData);
+
+    const size_t stride      = meshData.getPerVertexSize();
+    const size_t vertexCount = getVertexCount(meshData);
+    if (vertexCount == 0)
+        return;
+
+    std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+    uint32_t usedCount = 0;
+    for (auto&& subMeshIndices : meshData.subMeshIndices)
+    {
+        auto indices = readIndices(subMeshIndices);
+        for (auto&& index : indices)
+        {
+            if (remap[index] == UINT32_MAX)
+                remap[index] = usedCount++;
+            index = remap[index];
+        }
+        writeIndices(subMeshIndices, indices);
+    }
+
+    std::vector<float> vertices(usedCount * stride / sizeof(float));
+    const auto src = reinterpret_cast<const uint8_t*>(meshData.vertex.data());
+    const auto dst = reinterpret_cast<uint8_t*>(vertices.data());
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        if (remap[v] != UINT32_MAX)
+            memcpy(dst + remap[v] * stride, src + v * stride, stride);
+    }
+    meshData.vertex.swap(vertices);
+}
+
+bool MeshOptimizer::quantize(MeshData& meshData, uint32_t flags)
+{
+    detachMeshData(meshData);
+
+    const size_t stride      = meshData.getPerVertexSize();
+    const size_t vertexCount = getVertexCount(meshData);
+    if (vertexCount == 0)
+        return false;
+
+    const bool skinned = getAttribOffset(meshData, VertexKey::VERTEX_ATTRIB_BLEND_INDEX) >= 0;
+
+    auto attribs   = meshData.attribs;
+    bool quantized = false;
+    for (auto&& attrib : attribs)
+    {
+        switch (attrib.vertexAttrib)
+        {
+        case VertexKey::VERTEX_ATTRIB_POSITION:
+            if ((flags & QUANTIZE_POSITIONS) && !skinned && attrib.type == backend::VertexFormat::FLOAT3)
+            {
+                attrib.type       = backend::VertexFormat::USHORT4;
+                attrib.normalized = true;
+                quantized         = true;
+            }
+            break;
+        case VertexKey::VERTEX_ATTRIB_NORMAL:
+        case VertexKey::VERTEX_ATTRIB_TANGENT:
+        case VertexKey::VERTEX_ATTRIB_BINORMAL:
+            if ((flags & QUANTIZE_NORMALS) && attrib.type == backend::VertexFormat::FLOAT3)
+            {
+                attrib.type       = backend::VertexFormat::BYTE4;
+                attrib.normalized = true;
+                quantized         = true;
+            }
+            break;
+        case VertexKey::VERTEX_ATTRIB_TEX_COORD:
+        case VertexKey::VERTEX_ATTRIB_TEX_COORD1:
+        case VertexKey::VERTEX_ATTRIB_TEX_COORD2:
+        case VertexKey::VERTEX_ATTRIB_TEX_COORD3:
+            if ((flags & QUANTIZE_TEXCOORDS) && attrib.type == backend::VertexFormat::FLOAT2)
+            {
+                attrib.type = backend::VertexFormat::HALF2;
+                quantized   = true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    if (!quantized)
+        return false;
+
+    // the aabbs can't be calculated from quantized positions
+    if (meshData.subMeshAABB.size() != meshData.subMeshIndices.size())
+    {
+        meshData.subMeshAABB.clear();
+        for (auto&& indices : meshData.subMeshIndices)
+            meshData.subMeshAABB.push_back(Bundle3D::calculateAABB(meshData.vertex, (int)stride, indices));
+    }
+
+    // positions are scaled uniformly, so the dequantization keeps normals perpendicular
+    Vec3 positionOffset;
+    float positionScale = 1.0f;
+    auto positions      = readPositions(meshData);
+    if (!positions.empty())
+    {
+        AABB bounds;
+        bounds.updateMinMax(positions.data(), positions.size());
+        const auto extent = bounds._max - bounds._min;
+        positionOffset    = bounds._min;
+        positionScale     = std::max(std::max(extent.x, extent.y), extent.z);
+        if (positionScale <= 0.0f)
+            positionScale = 1.0f;
+    }
+
+    int newStride = 0;
+    for (auto&& attrib : attribs)
+        newStride += attrib.getAttribSizeBytes();
+
+    std::vector<float> vertices(vertexCount * newStride / sizeof(float));
+    const auto src = reinterpret_cast<const uint8_t*>(meshData.vertex.data());
+    const auto dst = reinterpret_cast<uint8_t*>(vertices.data());
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        auto srcVertex = src + v * stride;
+        auto dstVertex = dst + v * newStride;
+        for (size_t i = 0; i < attribs.size(); ++i)
+        {
+            auto& srcAttrib     = meshData.attribs[i];
+            auto& dstAttrib     = attribs[i];
+            const int srcSize   = srcAttrib.getAttribSizeBytes();
+            const int dstSize   = dstAttrib.getAttribSizeBytes();
+            if (srcAttrib.type == dstAttrib.type)
+            {
+                memcpy(dstVertex, srcVertex, srcSize);
+            }
+            else
+            {
+                float value[3];
+                memcpy(value, srcVertex, srcSize);
+                switch (dstAttrib.type)
+                {
+                case backend::VertexFormat::USHORT4:
+                {
+                    const float offset[3] = {positionOffset.x, positionOffset.y, positionOffset.z};
+                    uint16_t position[4];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        const float q = (value[k] - offset[k]) / positionScale * 65535.0f + 0.5f;
+                        position[k]   = static_cast<uint16_t>(clampf(q, 0.0f, 65535.0f));
+                    }
+                    position[3] = 65535;  // w = 1
+                    memcpy(dstVertex, position, sizeof(position));
+                    break;
+                }
+                case backend::VertexFormat::BYTE4:
+                {
+                    int8_t normal[4] = {toSnorm8(value[0]), toSnorm8(value[1]), toSnorm8(value[2]), 0};
+                    memcpy(dstVertex, normal, sizeof(normal));
+                    break;
+                }
+                case backend::VertexFormat::HALF2:
+                {
+                    uint16_t texCoord[2] = {toHalf(value[0]), toHalf(value[1])};
+                    memcpy(dstVertex, texCoord, sizeof(texCoord));
+                    break;
+                }
+                default:
+                    AXASSERT(false, "unexpected quantized vertex format");
+                    break;
+                }
+            }
+            srcVertex += srcSize;
+            dstVertex += dstSize;
+        }
+    }
+
+    meshData.vertex.swap(vertices);
+    meshData.attribs           = attribs;
+    meshData.vertexSizeInFloat = newStride / static_cast<int>(sizeof(float));
+    for (auto&& attrib : attribs)
+    {
+        if (attrib.vertexAttrib == VertexKey::VERTEX_ATTRIB_POSITION && attrib.normalized)
+        {
+            meshData.positionOffset = positionOffset;
+            meshData.positionScale  = positionScale;
+        }
+    }
+    return true;
+}
+
+bool MeshOptimizer::saveCache(const MeshDatas& meshDatas, std::string_view modelPath, uint32_t flags)
+{
+    MeshCacheHeader header{};
+    memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+    header.version   = MESH_CACHE_VERSION;
+    header.flags     = flags;
+    header.meshCount = static_cast<uint32_t>(meshDatas.meshDatas.size());
+    if (!hashModelFile(modelPath, header.modelSize, header.modelHash))
+        return false;
+
+    std::string buffer;
+    appendValue(buffer, header);
+    for (auto meshData : meshDatas.meshDatas)
+    {
+        if (meshData->isMapped())
+        {
+            AXLOG("axmol: MeshOptimizer: can't cache mesh data read in place: %s", modelPath.data());
+            return false;
+        }
+
+        appendValue(buffer, static_cast<uint32_t>(meshData->attribs.size()));
+        for (auto&& attrib : meshData->attribs)
+        {
+            appendValue(buffer, static_cast<uint32_t>(attrib.type));
+            appendValue(buffer, static_cast<int32_t>(attrib.vertexAttrib));
+            appendValue(buffer, static_cast<uint32_t>(attrib.normalized));
+        }
+        appendValue(buffer, meshData->positionOffset);
+        appendValue(buffer, meshData->positionScale);
+        appendBytes(buffer, meshData->vertex.data(), meshData->vertex.size() * sizeof(float));
+
+        const bool hasAABB = meshData->subMeshAABB.size() == meshData->subMeshIndices.size();
+        appendValue(buffer, static_cast<uint32_t>(meshData->subMeshIndices.size()));
+        appendValue(buffer, static_cast<uint32_t>(hasAABB));
+        for (size_t i = 0; i < meshData->subMeshIndices.size(); ++i)
+        {
+            auto& indices = meshData->subMeshIndices[i];
+            const std::string& id = i < meshData->subMeshIds.size() ? meshData->subMeshIds[i] : std::string{};
+            appendBytes(buffer, id.data(), id.size());
+            appendValue(buffer, static_cast<uint32_t>(indices.format()));
+            appendBytes(buffer, indices.data(), indices.bsize());
+            if (hasAABB)
+            {
+                appendValue(buffer, meshData->subMeshAABB[i]._min);
+                appendValue(buffer, meshData->subMeshAABB[i]._max);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(s_cacheWriteMutex);
+    if (FileUtils::writeBinaryToFile(buffer.data(), buffer.size(), getCachePath(modelPath)))
+        return true;
+
+    // the model's directory is read only, e.g. inside an apk
+    auto fileUtils      = FileUtils::getInstance();
+    const auto cacheDir = fileUtils->getWritablePath() + "meshcache/";
+    if (!fileUtils->isDirectoryExist(cacheDir))
+        fileUtils->createDirectory(cacheDir);
+    return FileUtils::writeBinaryToFile(buffer.data(), buffer.size(), getWritableCachePath(modelPath));
+}
+
+bool MeshOptimizer::loadCache(MeshDatas& meshDatas, std::string_view modelPath, uint32_t flags)
+{
+    auto fileUtils = FileUtils::getInstance();
+
+    Data data;
+    auto cachePath = getCachePath(modelPath);
+    if (fileUtils->isFileExist(cachePath))
+        data = fileUtils->getDataFromFile(cachePath);
+    if (data.isNull())
+    {
+        cachePath = getWritableCachePath(modelPath);
+        if (fileUtils->isFileExist(cachePath))
+            data = fileUtils->getDataFromFile(cachePath);
+    }
+    if (data.isNull())
+        return false;
+
+    BundleReader reader;
+    reader.init(reinterpret_cast<const char*>(data.getBytes()), data.getSize());
+
+    MeshCacheHeader header;
+    uint64_t modelSize = 0, modelHash = 0;
+    if (!reader.read(&header) || memcmp(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != MESH_CACHE_VERSION || header.flags != flags ||
+        !hashModelFile(modelPath, modelSize, modelHash) || header.modelSize != modelSize ||
+        header.modelHash != modelHash)
+        return false;
+
+    auto readBytes = [&reader](void* dst, uint32_t size) { return reader.read(dst, 1, size) == size; };
+
+    MeshDatas cached;
+    for (uint32_t m = 0; m < header.meshCount; ++m)
+    {
+        auto meshData = new MeshData();
+        cached.meshDatas.push_back(meshData);
+
+        uint32_t attribCount = 0;
+        if (!reader.read(&attribCount))
+            return false;
+        for (uint32_t i = 0; i < attribCount; ++i)
+        {
+            uint32_t type = 0, normalized = 0;
+            int32_t key   = 0;
+            if (!reader.read(&type) || !reader.read(&key) || !reader.read(&normalized))
+                return false;
+            MeshVertexAttrib attrib;
+            attrib.type         = static_cast<backend::VertexFormat>(type);
+            attrib.vertexAttrib = static_cast<VertexKey>(key);
+            attrib.normalized   = normalized != 0;
+            meshData->attribs.push_back(attrib);
+        }
+        meshData->attribCount       = static_cast<int>(attribCount);
+        meshData->vertexSizeInFloat = meshData->getPerVertexSize() / static_cast<int>(sizeof(float));
+
+        // the vertex data must hold whole vertices of the cached layout
+        const uint32_t vertexSize = static_cast<uint32_t>(meshData->getPerVertexSize());
+        uint32_t vertexBytes      = 0;
+        if (!reader.read(&meshData->positionOffset) || !reader.read(&meshData->positionScale) ||
+            !reader.read(&vertexBytes) || vertexSize == 0 || vertexSize % sizeof(float) != 0 ||
+            vertexBytes % vertexSize != 0)
+            return false;
+        meshData->vertex.resize(vertexBytes / sizeof(float));
+        if (!readBytes(meshData->vertex.data(), vertexBytes))
+            return false;
+
+        uint32_t subMeshCount = 0, hasAABB = 0;
+        if (!reader.read(&subMeshCount) || !reader.read(&hasAABB))
+            return false;
+        for (uint32_t i = 0; i < subMeshCount; ++i)
+        {
+            uint32_t idLength = 0, format = 0, indexBytes = 0;
+            if (!reader.read(&idLength))
+                return false;
+            std::string id(idLength, '\0');
+            if (!readBytes(id.data(), idLength) || !reader.read(&format) || !reader.read(&indexBytes))
+                return false;
+
+            // saveCache writes the index buffer size in bytes, it must hold whole indices of a supported format
+            const auto indexFormat = static_cast<backend::IndexFormat>(format);
+            if ((indexFormat != backend::IndexFormat::U_SHORT && indexFormat != backend::IndexFormat::U_INT) ||
+                indexBytes % IndexArray::formatToStride(indexFormat) != 0)
+                return false;
+
+            IndexArray indices(indexFormat);
+            indices.bresize(indexBytes);
+            if (!readBytes(indices.data(), indexBytes))
+                return false;
+            meshData->subMeshIds.push_back(std::move(id));
+            meshData->subMeshIndices.push_back(std::move(indices));
+
+            if (hasAABB)
+            {
+                AABB aabb;
+                if (!reader.read(&aabb._min) || !reader.read(&aabb._max))
+                    return false;
+                meshData->subMeshAABB.push_back(aabb);
+            }
+        }
+        // like Bundle3D, numIndex is the number of index arrays, not of indices
+        meshData->numIndex = static_cast<int>(meshData->subMeshIndices.size());
+    }
+
+    meshDatas.resetData();
+    std::swap(meshDatas.meshDatas, cached.meshDatas);
+    return true;
+}
+
+std::string MeshOptimizer::getCachePath(std::string_view modelPath)
+{
+    std::string ret{modelPath};
+    ret.append(".axmc"sv);
+    return ret;
+}
+
+std::string MeshOptimizer::getWritableCachePath(std::string_view modelPath)
+{
+    return fmt::format("{}meshcache/{:016x}.axmc", FileUtils::getInstance()->getWritablePath(),
+                       XXH64(modelPath.data(), modelPath.size(), 0));
+}
+
+NS_AX_END
@@ -0,0 +1,120 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __AX_MESH_OPTIMIZER_H__
+#define __AX_MESH_OPTIMIZER_H__
+
+#include <string>
+
+#include "3d/Bundle3DData.h"
+
+NS_AX_BEGIN
+
+/**
+ * @addtogroup _3d
+ * @{
+ */
+
+/**
+ * Optimizes loaded MeshData for rendering.
+ *
+ * The index order of every sub mesh is rearranged for the post transform vertex cache and then, cluster by cluster,
+ * to draw outward facing triangles first, which reduces overdraw. Vertices are then reordered by first use so the
+ * vertex fetch walks the buffer linearly, unreferenced vertices are dropped.
+ *
+ * Quantization stores texture coordinates as half floats, normals, tangents and binormals as signed normalized bytes
+ * and positions as unsigned normalized shorts. Quantized positions are dequantized by the model transform of the mesh
+ * (see MeshVertexData::getPositionDequantization), they are never quantized for skinned meshes.
+ *
+ * Optimized meshes can be cached in a file beside the model, or in the writable path when the model's directory is
+ * read only, see saveCache() and loadCache().
+ * @js NA
+ * @lua NA
+ */
+class AX_DLL MeshOptimizer
+{
+public:
+    enum Flags : uint32_t
+    {
+        VERTEX_CACHE       = 1,
+        OVERDRAW           = 1 << 1,
+        VERTEX_FETCH       = 1 << 2,
+        QUANTIZE_TEXCOORDS = 1 << 3,
+        QUANTIZE_NORMALS   = 1 << 4,
+        QUANTIZE_POSITIONS = 1 << 5,
+
+        REORDER  = VERTEX_CACHE | OVERDRAW | VERTEX_FETCH,
+        QUANTIZE = QUANTIZE_TEXCOORDS | QUANTIZE_NORMALS | QUANTIZE_POSITIONS,
+        ALL      = REORDER | QUANTIZE,
+    };
+
+    /** Applies the optimizations selected by `flags` to every mesh. */
+    static void optimize(MeshDatas& meshDatas, uint32_t flags);
+    static void optimize(MeshData& meshData, uint32_t flags);
+
+    /** Reorders the triangles of every sub mesh for the post transform vertex cache. */
+    static void optimizeVertexCache(MeshData& meshData);
+
+    /** Reorders clusters of triangles of every sub mesh to draw outward facing ones first, call it after
+     * optimizeVertexCache(). */
+    static void optimizeOverdraw(MeshData& meshData);
+
+    /** Reorders the vertices by their first use in the sub meshes and drops unreferenced vertices. */
+    static void optimizeVertexFetch(MeshData& meshData);
+
+    /** Quantizes the float attributes selected by `flags`, returns true if any attribute was quantized. */
+    static bool quantize(MeshData& meshData, uint32_t flags);
+
+    /**
+     * Writes optimized meshes to the cache file of a model.
+     *
+     * @param meshDatas The optimized meshes.
+     * @param modelPath The full path of the model file the meshes were loaded from.
+     * @param flags The optimizations applied to the meshes.
+     * @return true if the cache file was written.
+     * @note Thread safe, writes are serialized.
+     */
+    static bool saveCache(const MeshDatas& meshDatas, std::string_view modelPath, uint32_t flags);
+
+    /**
+     * Reads the optimized meshes of a model from its cache file. The cache is rejected if it was written for
+     * different flags or if the model file changed since.
+     *
+     * @return true if the meshes were loaded.
+     */
+    static bool loadCache(MeshDatas& meshDatas, std::string_view modelPath, uint32_t flags);
+
+    /** Returns the cache file beside the model. */
+    static std::string getCachePath(std::string_view modelPath);
+
+    /** Returns the cache file in the writable path, used when the model's directory is read only. */
+    static std::string getWritableCachePath(std::string_view modelPath);
+};
+
+// end of 3d group
+/// @}
+
+NS_AX_END
+
+#endif  // __AX_MESH_OPTIMIZER_H__
@@ -31,13 +31,18 @@
 #include "3d/MeshMaterial.h"
 #include "3d/AttachNode.h"
 #include "3d/Mesh.h"
+#include "3d/AABBTree.h"
+#include "3d/MeshOptimizer.h"
+
+#include <deque>
 
 #include "base/Director.h"
-#include "base/AsyncTaskPool.h"
+#include "base/JobSystem.h"
 #include "base/UTF8.h"
 #include "base/Utils.h"
 #include "2d/Light.h"
 #include "2d/Camera.h"
+#include "2d/Scene.h"
 #include "base/Macros.h"
 #include "platform/PlatformMacros.h"
 #include "platform/FileUtils.h"
@@ -51,6 +56,76 @@ NS_AX_BEGIN
 
 static MeshMaterial* getMeshRendererMaterialForAttribs(MeshVertexData* meshVertexData, bool usesLight);
 
+namespace
+{
+/* Models parsed by createAsync wait here for the main thread to create their GPU buffers, a few per frame so that a
+ * burst of finished loads doesn't stall a single frame. */
+struct AsyncModelQueue
+{
+    struct Upload
+    {
+        size_t bytes;
+        std::function<void()> finish;
+    };
+
+    void push(size_t bytes, std::function<void()> finish)
+    {
+        pending.emplace_back(Upload{bytes, std::move(finish)});
+
+        auto scheduler = Director::getInstance()->getScheduler();
+        if (!scheduler->isScheduled(UPDATE_KEY, this))
+            scheduler->schedule([this](float) { update(); }, this, 0, false, UPDATE_KEY);
+    }
+
+    void update()
+    {
+        // at least one model per frame, then as many as fit the budget
+        size_t uploaded = 0;
+        while (!pending.empty() && (uploaded == 0 || budget == 0 || uploaded + pending.front().bytes <= budget))
+        {
+            auto upload = std::move(pending.front());
+            pending.pop_front();
+            uploaded += upload.bytes;
+            upload.finish();
+        }
+
+        if (pending.empty())
+            Director::getInstance()->getScheduler()->unschedule(UPDATE_KEY, this);
+    }
+
+    static constexpr std::string_view UPDATE_KEY = "MeshRenderer.asyncUpload"sv;
+
+    std::deque<Upload> pending;
+    hlookup::string_map<std::vector<MeshRenderer*>> loading;  // models being loaded, with the renderers waiting on them
+    size_t budget = 8 * 1024 * 1024;
+};
+
+AsyncModelQueue s_asyncModels;
+
+uint32_t s_meshOptimization = 0;
+
+size_t getUploadSize(const MeshDatas& meshdatas)
+{
+    size_t bytes = 0;
+    for (auto meshdata : meshdatas.meshDatas)
+    {
+        if (meshdata->isMapped())
+        {
+            bytes += meshdata->vertexView.size;
+            for (auto&& view : meshdata->subMeshIndexViews)
+                bytes += view.size;
+        }
+        else
+        {
+            bytes += meshdata->vertex.size() * sizeof(float);
+            for (auto&& indices : meshdata->subMeshIndices)
+                bytes += indices.bsize();
+        }
+    }
+    return bytes;
+}
+}  // namespace
+
 MeshRenderer* MeshRenderer::create()
 {
     auto mesh = new MeshRenderer();
@@ -108,18 +183,54 @@ void MeshRenderer::createAsync(std::string_view modelPath,
     meshRenderer->_asyncLoadParam.afterLoadCallback = callback;
     meshRenderer->_asyncLoadParam.texPath             = texturePath;
     meshRenderer->_asyncLoadParam.modelPath           = modelPath;
-    meshRenderer->_asyncLoadParam.modelFullPath       = FileUtils::getInstance()->fullPathForFilename(modelPath);
     meshRenderer->_asyncLoadParam.callbackParam       = callbackparam;
+
+    // the same model requested again while it is loading is created from the cache once the first load is done
+    auto loading = s_asyncModels.loading.find(modelPath);
+    if (loading != s_asyncModels.loading.end())
+    {
+        loading->second.emplace_back(meshRenderer);
+        return;
+    }
+    s_asyncModels.loading.emplace(modelPath, std::vector<MeshRenderer*>{});
+
+    meshRenderer->_asyncLoadParam.modelFullPath       = FileUtils::getInstance()->fullPathForFilename(modelPath);
+    meshRenderer->_asyncLoadParam.optimization        = s_meshOptimization;
     meshRenderer->_asyncLoadParam.materialdatas       = new MaterialDatas();
     meshRenderer->_asyncLoadParam.meshdatas           = new MeshDatas();
     meshRenderer->_asyncLoadParam.nodeDatas           = new NodeDatas();
-    AsyncTaskPool::getInstance()->enqueue(
-        AsyncTaskPool::TaskType::TASK_IO, AX_CALLBACK_1(MeshRenderer::afterAsyncLoad, meshRenderer),
-        (void*)(&meshRenderer->_asyncLoadParam), [meshRenderer]() {
-            auto& loadParam                      = meshRenderer->_asyncLoadParam;
-            loadParam.result = meshRenderer->loadFromFile(loadParam.modelFullPath, loadParam.nodeDatas,
-                                                          loadParam.meshdatas, loadParam.materialdatas);
+
+    // models are parsed in parallel on the job system, the GPU buffers are created on the main thread
+    JobSystem::getInstance()->enqueue([meshRenderer]() {
+        auto& loadParam  = meshRenderer->_asyncLoadParam;
+        loadParam.result = meshRenderer->loadFromFile(loadParam.modelFullPath, loadParam.nodeDatas,
+                                                      loadParam.meshdatas, loadParam.materialdatas,
+                                                      loadParam.optimization);
+        size_t bytes     = loadParam.result ? getUploadSize(*loadParam.meshdatas) : 0;
+        Director::getInstance()->getScheduler()->runOnAxmolThread([meshRenderer, bytes]() {
+            s_asyncModels.push(bytes, [meshRenderer]() { meshRenderer->afterAsyncLoad(&meshRenderer->_asyncLoadParam); });
         });
+    });
+}
+
+void MeshRenderer::setAsyncUploadBudget(size_t bytesPerFrame)
+{
+    s_asyncModels.budget = bytesPerFrame;
+}
+
+size_t MeshRenderer::getAsyncUploadBudget()
+{
+    return s_asyncModels.budget;
+}
+
+void MeshRenderer::setMeshOptimization(uint32_t flags)
+{
+    s_meshOptimization = flags;
+}
+
+uint32_t MeshRenderer::getMeshOptimization()
+{
+    return s_meshOptimization;
 }
 
 void MeshRenderer::afterAsyncLoad(void* param)
@@ -132,7 +243,7 @@ void MeshRenderer::afterAsyncLoad(void* param)
         {
             _meshes.clear();
             _meshVertexDatas.clear();
-            AX_SAFE_RELEASE_NULL(_skeleton);
+            releaseSkeleton();
             removeAllAttachNode();
 
             // create in the main thread
@@ -172,6 +283,24 @@ void MeshRenderer::afterAsyncLoad(void* param)
             AXLOG("file load failed: %s\n", asyncParam->modelPath.c_str());
         }
         asyncParam->afterLoadCallback(this, asyncParam->callbackParam);
+
+        std::vector<MeshRenderer*> waiting;
+        auto loading = s_asyncModels.loading.find(asyncParam->modelPath);
+        if (loading != s_asyncModels.loading.end())
+        {
+            waiting = std::move(loading->second);
+            s_asyncModels.loading.erase(loading);
+        }
+        for (auto meshRenderer : waiting)
+        {
+            auto& waitingParam = meshRenderer->_asyncLoadParam;
+            meshRenderer->autorelease();
+            if (meshRenderer->loadFromCache(waitingParam.modelPath))
+                meshRenderer->setModelTexture(waitingParam.modelPath, waitingParam.texPath);
+            else
+                AXLOG("file load failed: %s\n", waitingParam.modelPath.c_str());
+            waitingParam.afterLoadCallback(meshRenderer, waitingParam.callbackParam);
+        }
     }
 }
 
@@ -234,27 +363,44 @@ bool MeshRenderer::loadFromCache(std::string_view path)
 bool MeshRenderer::loadFromFile(std::string_view path,
                             NodeDatas* nodedatas,
                             MeshDatas* meshdatas,
-                            MaterialDatas* materialdatas)
+                            MaterialDatas* materialdatas,
+                            uint32_t optimization)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(path);
 
     std::string ext = FileUtils::getInstance()->getFileExtension(path);
     if (ext == ".obj")
     {
-        return Bundle3D::loadObj(*meshdatas, *materialdatas, *nodedatas, fullPath);
+        if (!Bundle3D::loadObj(*meshdatas, *materialdatas, *nodedatas, fullPath))
+            return false;
+        if (optimization && !MeshOptimizer::loadCache(*meshdatas, fullPath, optimization))
+        {
+            MeshOptimizer::optimize(*meshdatas, optimization);
+            MeshOptimizer::saveCache(*meshdatas, fullPath, optimization);
+        }
+        return true;
     }
     else if (ext == ".c3b" || ext == ".c3t")
     {
         // load from .c3b or .c3t
         auto bundle = Bundle3D::createBundle();
+        bundle->setMeshDataInPlace(optimization == 0);
         if (!bundle->load(fullPath))
         {
             Bundle3D::destroyBundle(bundle);
             return false;
         }
 
-        auto ret =
-            bundle->loadMeshDatas(*meshdatas) && bundle->loadMaterials(*materialdatas) && bundle->loadNodes(*nodedatas);
+        auto ret = bundle->loadMaterials(*materialdatas) && bundle->loadNodes(*nodedatas);
+        if (ret && (!optimization || !MeshOptimizer::loadCache(*meshdatas, fullPath, optimization)))
+        {
+            ret = bundle->loadMeshDatas(*meshdatas);
+            if (ret && optimization)
+            {
+                MeshOptimizer::optimize(*meshdatas, optimization);
+                MeshOptimizer::saveCache(*meshdatas, fullPath, optimization);
+            }
+        }
         Bundle3D::destroyBundle(bundle);
 
         return ret;
@@ -271,15 +417,25 @@ MeshRenderer::MeshRenderer()
     , _forceDepthWrite(false)
     , _wireframe(false)
     , _usingAutogeneratedGLProgram(true)
+    , _instancing(false)
     , _transparentMaterialHint(false)
     , _meshTextureHint(0)
 {}
 
+void MeshRenderer::releaseSkeleton()
+{
+    if (_skeleton)
+    {
+        _skeleton->discardAnimateSamples();
+        AX_SAFE_RELEASE_NULL(_skeleton);
+    }
+}
+
 MeshRenderer::~MeshRenderer()
 {
     _meshes.clear();
     _meshVertexDatas.clear();
-    AX_SAFE_RELEASE_NULL(_skeleton);
+    releaseSkeleton();
     removeAllAttachNode();
 }
 
@@ -297,7 +453,7 @@ bool MeshRenderer::initWithFile(std::string_view path)
     _aabbDirty = true;
     _meshes.clear();
     _meshVertexDatas.clear();
-    AX_SAFE_RELEASE_NULL(_skeleton);
+    releaseSkeleton();
     removeAllAttachNode();
 
     if (loadFromCache(path))
@@ -306,7 +462,7 @@ bool MeshRenderer::initWithFile(std::string_view path)
     MeshDatas* meshdatas         = new MeshDatas();
     MaterialDatas* materialdatas = new MaterialDatas();
     NodeDatas* nodeDatas         = new NodeDatas();
-    if (loadFromFile(path, nodeDatas, meshdatas, materialdatas))
+    if (loadFromFile(path, nodeDatas, meshdatas, materialdatas, s_meshOptimization))
     {
         if (initFrom(*nodeDatas, *meshdatas, *materialdatas))
         {
@@ -700,7 +856,16 @@ void MeshRenderer::enableInstancing(MeshMaterial::InstanceMaterialType instanceM
     {
         auto mat = MeshMaterial::createBuiltInMaterial(MeshMaterial::MaterialType::UNLIT_INSTANCE, false);
         enableInstancing(mat, count);
+        break;
+    }
+    case MeshMaterial::InstanceMaterialType::DIFFUSE_INSTANCE:
+    {
+        auto mat = MeshMaterial::createBuiltInMaterial(MeshMaterial::MaterialType::DIFFUSE_INSTANCE, false);
+        enableInstancing(mat, count);
+        break;
     }
+    default:
+        break;
     }
 }
 
@@ -711,12 +876,14 @@ void MeshRenderer::enableInstancing(MeshMaterial* instanceMat, int count)
         mesh->enableInstancing(true, MAX(1, count));
         mesh->setMaterial(instanceMat);
     }
+    _instancing = true;
 }
 
 void MeshRenderer::disableInstancing()
 {
     for (auto&& mesh : _meshes)
         mesh->enableInstancing(false, 0);
+    _instancing = false;
 }
 
 void MeshRenderer::setDynamicInstancing(bool dynamic)
@@ -749,6 +916,61 @@ void MeshRenderer::rebuildInstances()
         mesh->rebuildInstances();
 }
 
+void MeshRenderer::setAnimationLODs(const std::vector<AnimationLOD>& lods)
+{
+    _animationLODs = lods;
+    std::stable_sort(_animationLODs.begin(), _animationLODs.end(),
+                     [](const AnimationLOD& a, const AnimationLOD& b) { return a.distance < b.distance; });
+    _animationLODLevel = -1;
+}
+
+bool MeshRenderer::isAnimationUpdateDue(unsigned int* maxBones) const
+{
+    *maxBones  = 0;
+    auto frame = _director->getTotalFrames();
+
+    // drawn in the previous frame, the update runs before this frame is drawn
+    if (_animationCulling && frame - _animationDrawnFrame > 1)
+        return false;
+
+    if (_animationLODLevel >= 0)
+    {
+        const auto& lod = _animationLODs[_animationLODLevel];
+        *maxBones       = lod.maxBones;
+        // spread the crowd sharing an interval over the frames
+        auto phase = static_cast<unsigned int>(reinterpret_cast<uintptr_t>(this) >> 4);
+        if (lod.updateInterval > 1 && (frame + phase) % lod.updateInterval != 0)
+            return false;
+    }
+    return true;
+}
+
+void MeshRenderer::updateAnimationLOD(const Mat4& transform)
+{
+    auto camera = Camera::getVisitingCamera();
+    if (!camera)
+        return;
+
+    const auto& cameraTransform = camera->getNodeToWorldTransform();
+    float distance = Vec3(transform.m[12], transform.m[13], transform.m[14])
+                         .distance(Vec3(cameraTransform.m[12], cameraTransform.m[13], cameraTransform.m[14]));
+
+    // the closest camera of the frame decides
+    auto frame = _director->getTotalFrames();
+    if (frame != _animationDrawnFrame || distance < _animationLODDistance)
+    {
+        _animationDrawnFrame  = frame;
+        _animationLODDistance = distance;
+        _animationLODLevel    = -1;
+        for (int i = 0, count = static_cast<int>(_animationLODs.size()); i < count; ++i)
+        {
+            if (distance < _animationLODs[i].distance)
+                break;
+            _animationLODLevel = i;
+        }
+    }
+}
+
 void MeshRenderer::setTexture(std::string_view texFile)
 {
     auto tex = _director->getTextureCache()->addImage(texFile);
@@ -813,6 +1035,11 @@ void MeshRenderer::visit(ax::Renderer* renderer, const ax::Mat4& parentTransform
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
     flags |= FLAGS_RENDER_AS_3D;
 
+#if AX_USE_CULLING
+    // even when not drawn by this camera, so later cameras find the proxy up to date
+    updateCullingProxy();
+#endif
+
     //
     _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
     _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
@@ -852,15 +1079,18 @@ void MeshRenderer::visit(ax::Renderer* renderer, const ax::Mat4& parentTransform
 void MeshRenderer::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
 {
 #if AX_USE_CULLING
-    // TODO new-renderer: interface isVisibleInFrustum removal
-    //  camera clipping
-//    if(_children.empty() && Camera::getVisitingCamera() &&
-//    !Camera::getVisitingCamera()->isVisibleInFrustum(&getAABB()))
-//        return;
+    // camera clipping, attached nodes are children which need the bone matrices updated below
+    updateWorldAABB(transform);
+    if (_children.empty() && isCulled())
+        return;
 #endif
 
     if (_skeleton)
+    {
+        if (_animationCulling || !_animationLODs.empty())
+            updateAnimationLOD(transform);
         _skeleton->updateBoneMatrix();
+    }
 
     Color4F color(getDisplayedColor());
     color.a = getDisplayedOpacity() / 255.0f;
@@ -929,33 +1159,99 @@ AABB MeshRenderer::getAABBRecursively()
 
 const AABB& MeshRenderer::getAABB() const
 {
-    Mat4 nodeToWorldTransform(getNodeToWorldTransform());
+    updateWorldAABB(getNodeToWorldTransform());
+    return _aabb;
+}
 
+bool MeshRenderer::updateWorldAABB(const Mat4& nodeToWorldTransform) const
+{
     // If nodeToWorldTransform matrix isn't changed, we don't need to transform aabb.
     if (memcmp(_nodeToWorldTransform.m, nodeToWorldTransform.m, sizeof(Mat4)) == 0 && !_aabbDirty)
+        return false;
+
+    _aabb.reset();
+    if (_meshes.size())
     {
-        return _aabb;
+        for (const auto& it : _meshes)
+        {
+            if (it->isVisible())
+                _aabb.merge(it->getAABB());
+        }
+
+        _aabb.transform(nodeToWorldTransform);
+        _nodeToWorldTransform = nodeToWorldTransform;
+        _aabbDirty            = false;
     }
-    else
+    return true;
+}
+
+void MeshRenderer::onEnter()
+{
+    Node::onEnter();
+#if AX_USE_CULLING
+    // the proxy is created by the first visit, once the meshes are loaded
+    _cullingScene = getScene();
+#endif
+}
+
+void MeshRenderer::onExit()
+{
+    // a mesh off the scene isn't drawn, the skeleton leaves the animation batch until it's animated again
+    if (_skeleton)
+        _skeleton->discardAnimateSamples();
+#if AX_USE_CULLING
+    if (_cullingProxy != AABBTree::NULL_NODE)
+        _cullingScene->getCullingTree()->destroyProxy(_cullingProxy);
+    _cullingProxy = AABBTree::NULL_NODE;
+    _cullingScene = nullptr;
+#endif
+    Node::onExit();
+}
+
+#if AX_USE_CULLING
+void MeshRenderer::updateCullingProxy()
+{
+    if (!_cullingScene)
+        return;
+
+    bool changed = updateWorldAABB(_modelViewTransform);
+    if (_aabb.isEmpty())
+        return;
+
+    auto tree = _cullingScene->getCullingTree();
+    if (_cullingProxy == AABBTree::NULL_NODE)
+        _cullingProxy = tree->createProxy(_aabb, this);
+    else if (changed)
+        tree->moveProxy(_cullingProxy, _aabb);
+}
+
+bool MeshRenderer::isCulled()
+{
+    auto camera = Camera::getVisitingCamera();
+    if (!camera || _instancing)
+        return false;
+
+    bool culled;
+    if (_cullingProxy != AABBTree::NULL_NODE && _cullingScene->_cullingCamera == camera)
     {
-        _aabb.reset();
-        if (_meshes.size())
+        auto visibility = _cullingScene->_cullingTree->getVisibility(_cullingProxy, _cullingScene->_cullingQuery);
+        if (visibility != AABBTree::Visibility::UNKNOWN)
         {
-            Mat4 transform(nodeToWorldTransform);
-            for (const auto& it : _meshes)
-            {
-                if (it->isVisible())
-                    _aabb.merge(it->getAABB());
-            }
-
-            _aabb.transform(transform);
-            _nodeToWorldTransform = nodeToWorldTransform;
-            _aabbDirty            = false;
+            culled = visibility == AABBTree::Visibility::CULLED;
+            _cullingScene->_cullingStats.culled += culled;
+            return culled;
         }
     }
 
-    return _aabb;
+    culled = !camera->isVisibleInFrustum(&_aabb);
+    if (_cullingScene)
+    {
+        ++_cullingScene->_cullingStats.directTests;
+        _cullingScene->_cullingStats.culled += culled;
+    }
+    return culled;
 }
+#endif
 
 Action* MeshRenderer::runAction(Action* action)
 {
@@ -90,6 +90,17 @@ public:
                             const std::function<void(MeshRenderer*, void*)>& callback,
                             void* callbackparam);
 
+    /** Sets how many bytes of vertex and index data models loaded by createAsync may upload per frame, at least one
+     * model is finished each frame. 0 finishes every loaded model as soon as possible. Default is 8MB. */
+    static void setAsyncUploadBudget(size_t bytesPerFrame);
+    static size_t getAsyncUploadBudget();
+
+    /** Sets the MeshOptimizer::Flags applied to the meshes of model files when they are loaded, 0 (the default)
+     * disables the optimization. Optimized meshes are cached beside the model file, see MeshOptimizer.
+     * Call it in the main thread, createAsync uses the flags set when it is called. */
+    static void setMeshOptimization(uint32_t flags);
+    static uint32_t getMeshOptimization();
+
     /** set diffuse texture, set the first mesh's texture if multiple textures exist */
     void setTexture(std::string_view texFile);
     void setTexture(Texture2D* texture);
@@ -223,8 +234,12 @@ public:
     bool loadFromCache(std::string_view path);
 
     /** load a file and feed it's content into meshedatas, nodedatas and materialdatas, obj file and .mtl file
-     should be in the same directory. */
-    bool loadFromFile(std::string_view path, NodeDatas* nodedatas, MeshDatas* meshdatas, MaterialDatas* materialdatas);
+     should be in the same directory. The meshes are optimized with the MeshOptimizer::Flags in optimization. */
+    bool loadFromFile(std::string_view path,
+                      NodeDatas* nodedatas,
+                      MeshDatas* meshdatas,
+                      MaterialDatas* materialdatas,
+                      uint32_t optimization);
 
     /**
      * Visits this MeshRenderer's children and draws them recursively.
@@ -233,6 +248,9 @@ public:
      */
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
 
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
     /** generate default material. */
     void genMaterial(bool useLight = false);
 
@@ -249,6 +267,9 @@ public:
 
     void afterAsyncLoad(void* param);
 
+    /** takes the skeleton out of the animation batch and releases it */
+    void releaseSkeleton();
+
     static AABB getAABBRecursivelyImp(Node* node);
 
     /** Enables instancing for this Mesh Renderer, keep in mind that
@@ -295,6 +316,40 @@ public:
     /** rebuilds the instance transform buffer next frame. */
     void rebuildInstances();
 
+    /**
+     * Animation level of detail, applied when the closest camera that drew this mesh renderer in the last frame is
+     * at least `distance` away.
+     */
+    struct AnimationLOD
+    {
+        float distance;               // min camera distance of this level
+        unsigned int updateInterval;  // bones are sampled every updateInterval frames, 0 or 1 samples every frame
+        unsigned int maxBones;        // bones sampled at most, bones closest to the root first, 0 samples all
+    };
+
+    /** Sets the animation levels of detail of Animate3D actions running on this mesh renderer, sorted by distance.
+     * Keyframe events keep firing every frame whatever the level. An empty list (the default) samples every bone
+     * every frame.
+     */
+    void setAnimationLODs(const std::vector<AnimationLOD>& lods);
+    const std::vector<AnimationLOD>& getAnimationLODs() const { return _animationLODs; }
+
+    /** Gets the animation level of detail picked in the last frame, -1 if none applies */
+    int getAnimationLODLevel() const { return _animationLODLevel; }
+
+    /** Freezes the skeleton while this mesh renderer isn't drawn (culled, invisible or off the scene), false by
+     * default. The pose catches up one frame after it's drawn again.
+     */
+    void setAnimationCullingEnabled(bool enabled) { _animationCulling = enabled; }
+    bool isAnimationCullingEnabled() const { return _animationCulling; }
+
+    /**
+     * Returns whether Animate3D should sample the bones this frame, called from Animate3D::update.
+     *
+     * @param maxBones Set to the number of bones to sample, 0 for all.
+     */
+    bool isAnimationUpdateDue(unsigned int* maxBones) const;
+
 protected:
     /** set specific mesh texture, for private use (create mesh stage) only */
     Texture2D* setMeshTexture(Mesh* mesh,
@@ -306,8 +361,31 @@ protected:
     */
     void setModelTexture(std::string_view modelPath, std::string_view texPath);
 
+    /* recomputes the world aabb when the transform or the meshes changed, returns true if it was recomputed */
+    bool updateWorldAABB(const Mat4& nodeToWorldTransform) const;
+
+#if AX_USE_CULLING
+    /* keeps the proxy in the culling tree of the scene in sync with the world aabb */
+    void updateCullingProxy();
+
+    /* tests the world aabb against the visiting camera, using the scene culling tree when it is up to date */
+    bool isCulled();
+
+    Scene* _cullingScene = nullptr;  // weak ref, set while running
+    int _cullingProxy    = -1;
+#endif
+
+    /* picks the animation level of detail from the distance to the visiting camera */
+    void updateAnimationLOD(const Mat4& transform);
+
     Skeleton3D* _skeleton;
 
+    std::vector<AnimationLOD> _animationLODs;
+    int _animationLODLevel            = -1;
+    float _animationLODDistance       = 0.0f;  // distance to the closest camera in _animationDrawnFrame
+    unsigned int _animationDrawnFrame = 0;     // last frame this mesh renderer was drawn
+    bool _animationCulling            = false;
+
     Vector<MeshVertexData*> _meshVertexDatas;
 
     hlookup::string_map<AttachNode*> _attachments;
@@ -324,6 +402,7 @@ protected:
     bool _forceDepthWrite;   // Always write to depth buffer
     bool _wireframe;         // render in wireframe mode
     bool _usingAutogeneratedGLProgram;
+    bool _instancing;  // instances are placed by children, so the aabb doesn't bound them
     bool _transparentMaterialHint; // Generate transparent materials when building from files
     unsigned short _meshTextureHint; // Whether model file has texture config
 
@@ -335,6 +414,7 @@ protected:
         std::string modelPath;
         std::string modelFullPath;
         std::string texPath;
+        uint32_t optimization;  // MeshOptimizer::Flags captured on the main thread
         MeshDatas* meshdatas;
         MaterialDatas* materialdatas;
         NodeDatas* nodeDatas;
@@ -110,48 +110,65 @@ void MeshVertexData::setVertexData(const std::vector<float>& vertexData)
 
 MeshVertexData* MeshVertexData::create(const MeshData& meshdata, CustomCommand::IndexFormat format)
 {
+    // mapped mesh data is uploaded straight from the file mapping
+    const bool mapped       = meshdata.isMapped();
+    const void* vertices    = mapped ? meshdata.vertexView.data : meshdata.vertex.data();
+    const size_t vertexSize = mapped ? meshdata.vertexView.size : meshdata.vertex.size() * sizeof(meshdata.vertex[0]);
+
     auto vertexdata           = new MeshVertexData();
-    vertexdata->_vertexBuffer = backend::Device::getInstance()->newBuffer(
-        meshdata.vertex.size() * sizeof(meshdata.vertex[0]), backend::BufferType::VERTEX, backend::BufferUsage::STATIC);
+    vertexdata->_vertexBuffer = backend::Device::getInstance()->newBuffer(vertexSize, backend::BufferType::VERTEX,
+                                                                          backend::BufferUsage::STATIC);
     // AX_SAFE_RETAIN(vertexdata->_vertexBuffer);
 
     vertexdata->_sizePerVertex = meshdata.getPerVertexSize();
 
     vertexdata->_attribs = meshdata.attribs;
 
+    if (meshdata.positionScale != 0.0f)
+    {
+        Mat4::createTranslation(meshdata.positionOffset, &vertexdata->_positionDequantization);
+        vertexdata->_positionDequantization.scale(meshdata.positionScale);
+        vertexdata->_quantizedPositions = true;
+    }
+
     if (vertexdata->_vertexBuffer)
     {
 #if AX_ENABLE_CACHE_TEXTURE_DATA
+        AXASSERT(!mapped, "mapped mesh data can't be cached for renderer recreation");
         vertexdata->setVertexData(meshdata.vertex);
         vertexdata->_vertexBuffer->usingDefaultStoredData(false);
 #endif
-        vertexdata->_vertexBuffer->updateData((void*)&meshdata.vertex[0],
-                                              meshdata.vertex.size() * sizeof(meshdata.vertex[0]));
+        vertexdata->_vertexBuffer->updateData(vertices, vertexSize);
     }
 
-    bool needCalcAABB = (meshdata.subMeshAABB.size() != meshdata.subMeshIndices.size());
-    for (size_t i = 0, size = meshdata.subMeshIndices.size(); i < size; ++i)
+    const size_t subMeshCount = meshdata.getSubMeshCount();
+    bool needCalcAABB         = (meshdata.subMeshAABB.size() != subMeshCount);
+    for (size_t i = 0; i < subMeshCount; ++i)
     {
-        auto& indices = meshdata.subMeshIndices[i];
-        auto indexBuffer = backend::Device::getInstance()->newBuffer(
-            indices.bsize(), backend::BufferType::INDEX, backend::BufferUsage::STATIC);
+        const void* indices = mapped ? meshdata.subMeshIndexViews[i].data : meshdata.subMeshIndices[i].data();
+        size_t indexSize    = mapped ? meshdata.subMeshIndexViews[i].size : meshdata.subMeshIndices[i].bsize();
+        auto indexBuffer    = backend::Device::getInstance()->newBuffer(indexSize, backend::BufferType::INDEX,
+                                                                        backend::BufferUsage::STATIC);
         indexBuffer->autorelease();
 #if AX_ENABLE_CACHE_TEXTURE_DATA
         indexBuffer->usingDefaultStoredData(false);
 #endif
-        indexBuffer->updateData((void*)indices.data(), indices.bsize());
+        indexBuffer->updateData(indices, indexSize);
 
         std::string id           = (i < meshdata.subMeshIds.size() ? meshdata.subMeshIds[i] : "");
         MeshIndexData* indexdata = nullptr;
         if (needCalcAABB)
         {
-            auto aabb = Bundle3D::calculateAABB(meshdata.vertex, meshdata.getPerVertexSize(), indices);
+            // the c3b reader and MeshOptimizer always store the aabbs of mapped and quantized mesh data
+            AXASSERT(!mapped && meshdata.positionScale == 0.0f, "missing aabb of mapped or quantized mesh data");
+            auto aabb = Bundle3D::calculateAABB(meshdata.vertex, meshdata.getPerVertexSize(),
+                                                meshdata.subMeshIndices[i]);
             indexdata = MeshIndexData::create(id, vertexdata, indexBuffer, aabb);
         }
         else
             indexdata = MeshIndexData::create(id, vertexdata, indexBuffer, meshdata.subMeshAABB[i]);
 #if AX_ENABLE_CACHE_TEXTURE_DATA
-        indexdata->setIndexData(indices);
+        indexdata->setIndexData(meshdata.subMeshIndices[i]);
 #endif
         vertexdata->_indices.pushBack(indexdata);
     }
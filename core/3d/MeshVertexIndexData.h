@@ -132,6 +132,12 @@ public:
 
     ssize_t getSizePerVertex() const { return _sizePerVertex; }
 
+    /** Returns true if the positions are quantized and have to be dequantized by the model transform. */
+    bool hasQuantizedPositions() const { return _quantizedPositions; }
+
+    /** Returns the transform of quantized positions to model space, identity if they are not quantized. */
+    const Mat4& getPositionDequantization() const { return _positionDequantization; }
+
     /**has vertex attribute?*/
     // TODO: will be removed!
     bool hasVertexAttrib(shaderinfos::VertexKey attrib) const;
@@ -147,6 +153,9 @@ protected:
     Vector<MeshIndexData*> _indices;           // index data
     std::vector<MeshVertexAttrib> _attribs;    // vertex attributes
 
+    Mat4 _positionDequantization;
+    bool _quantizedPositions = false;
+
     int _vertexCount = 0;  // vertex count
     std::vector<float> _vertexData;
 #if AX_ENABLE_CACHE_TEXTURE_DATA
@@ -24,9 +24,16 @@
  ****************************************************************************/
 
 #include "3d/Skeleton3D.h"
+#include "3d/Animate3D.h"
+#include "base/Director.h"
+#include "base/JobSystem.h"
+
+#include <algorithm>
 
 NS_AX_BEGIN
 
+std::vector<Skeleton3D*> Skeleton3D::s_animatedSkeletons;
+
 /**
  * Sets the inverse bind pose matrix.
  *
@@ -246,7 +253,7 @@ void Bone3D::updateLocalMat()
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-Skeleton3D::Skeleton3D() {}
+Skeleton3D::Skeleton3D() : _bonesSorted(false), _animateQueued(false), _updatedFrame(0) {}
 
 Skeleton3D::~Skeleton3D()
 {
@@ -315,22 +322,130 @@ int Skeleton3D::getBoneIndex(Bone3D* bone) const
 // refresh bone world matrix
 void Skeleton3D::updateBoneMatrix()
 {
-    for (const auto& it : _rootBones)
+    // already refreshed by updateAnimatedSkeletons this frame
+    if (_animateSamples.empty() && _updatedFrame == Director::getInstance()->getTotalFrames())
+        return;
+
+    for (auto&& sample : _animateSamples)
+    {
+        sample.animate->evaluateBones(sample.t, sample.weight, sample.maxBones);
+        sample.animate->release();
+    }
+    _animateSamples.clear();
+
+    updateWorldMatrices();
+}
+
+void Skeleton3D::updateWorldMatrices()
+{
+    if (!_bonesSorted)
+        sortBones();
+
+    // parents precede their children, so one pass over the flat array resolves the whole hierarchy
+    for (size_t i = 0, count = _sortedBones.size(); i < count; ++i)
     {
-        it->setWorldMatDirty(true);
-        it->updateWorldMat();
+        auto bone = _sortedBones[i];
+        bone->updateLocalMat();
+        int parent = _parentIndices[i];
+        if (parent < 0)
+            bone->_world = bone->_local;
+        else
+            Mat4::multiply(_sortedBones[parent]->_world, bone->_local, &bone->_world);
+        bone->_worldDirty = false;
     }
 }
 
+void Skeleton3D::updateAnimatedSkeletons()
+{
+    if (s_animatedSkeletons.empty())
+        return;
+
+    std::vector<Skeleton3D*> skeletons;
+    skeletons.swap(s_animatedSkeletons);
+
+    // an Animate3D only drives the bones of its own target, so skeletons are independent of each other
+    JobSystem::getInstance()->parallelFor(skeletons.size(), 0, [&skeletons](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            auto skeleton = skeletons[i];
+            for (auto&& sample : skeleton->_animateSamples)
+                sample.animate->evaluateBones(sample.t, sample.weight, sample.maxBones);
+            skeleton->updateWorldMatrices();
+        }
+    });
+
+    // Ref::release isn't thread safe, the queued references are dropped here
+    auto frame = Director::getInstance()->getTotalFrames();
+    for (auto&& skeleton : skeletons)
+    {
+        for (auto&& sample : skeleton->_animateSamples)
+            sample.animate->release();
+        skeleton->_animateSamples.clear();
+        skeleton->_animateQueued = false;
+        skeleton->_updatedFrame  = frame;
+        skeleton->release();
+    }
+}
+
+void Skeleton3D::discardAnimateSamples()
+{
+    if (!_animateQueued)
+        return;
+
+    auto it = std::find(s_animatedSkeletons.begin(), s_animatedSkeletons.end(), this);
+    if (it != s_animatedSkeletons.end())
+        s_animatedSkeletons.erase(it);
+
+    for (auto&& sample : _animateSamples)
+        sample.animate->release();
+    _animateSamples.clear();
+    _animateQueued = false;
+    release();
+}
+
+void Skeleton3D::addAnimateSample(Animate3D* animate, float t, float weight, unsigned int maxBones)
+{
+    if (!_animateQueued)
+    {
+        _animateQueued = true;
+        retain();
+        s_animatedSkeletons.emplace_back(this);
+    }
+    animate->retain();
+    _animateSamples.emplace_back(AnimateSample{animate, t, weight, maxBones});
+}
+
+void Skeleton3D::sortBones()
+{
+    _sortedBones.clear();
+    _parentIndices.clear();
+    for (const auto& it : _rootBones)
+        sortBones(it, -1);
+    _bonesSorted = true;
+}
+
+void Skeleton3D::sortBones(Bone3D* bone, int parentIndex)
+{
+    int index = static_cast<int>(_sortedBones.size());
+    _sortedBones.emplace_back(bone);
+    _parentIndices.emplace_back(parentIndex);
+    for (auto&& child : bone->_children)
+        sortBones(child, index);
+}
+
 void Skeleton3D::removeAllBones()
 {
     _bones.clear();
     _rootBones.clear();
+    _sortedBones.clear();
+    _parentIndices.clear();
+    _bonesSorted = false;
 }
 
 void Skeleton3D::addBone(Bone3D* bone)
 {
     _bones.pushBack(bone);
+    _bonesSorted = false;
 }
 
 Bone3D* Skeleton3D::createBone3D(const NodeData& nodedata)
@@ -343,6 +458,7 @@ Bone3D* Skeleton3D::createBone3D(const NodeData& nodedata)
         child->_parent = bone;
     }
     _bones.pushBack(bone);
+    _bonesSorted   = false;
     bone->_oriPose = nodedata.transform;
     return bone;
 }
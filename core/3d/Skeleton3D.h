@@ -32,6 +32,8 @@
 
 NS_AX_BEGIN
 
+class Animate3D;
+
 /**
  * @addtogroup _3d
  * @{
@@ -199,9 +201,22 @@ public:
     /**get bone index*/
     int getBoneIndex(Bone3D* bone) const;
 
-    /**refresh bone world matrix*/
+    /**refresh bone world matrix, evaluates the animations queued by Animate3D first*/
     void updateBoneMatrix();
 
+    /**
+     * Evaluates the queued animations and refreshes the bone matrices of every animated skeleton, spreading the
+     * skeletons across the JobSystem workers. Called once per frame before the scene is drawn, skeletons updated
+     * here skip the refresh when their MeshRenderer draws.
+     */
+    static void updateAnimatedSkeletons();
+
+    /**
+     * Drops the animations queued for updateAnimatedSkeletons and the reference the batch holds on this skeleton,
+     * called when the mesh renderer of the skeleton leaves the scene or lets go of it.
+     */
+    void discardAnimateSamples();
+
     Skeleton3D();
 
     ~Skeleton3D();
@@ -216,9 +231,38 @@ public:
     Bone3D* createBone3D(const NodeData& nodedata);
 
 protected:
+    friend class Animate3D;
+
+    /**queue an animation to be sampled at time t (0 - 1) before the next bone matrix refresh, maxBones 0 samples all*/
+    void addAnimateSample(Animate3D* animate, float t, float weight, unsigned int maxBones);
+
+    /**refresh the world matrices of the sorted bones, safe to run on a worker thread*/
+    void updateWorldMatrices();
+
+    /**sort bones parent first into _sortedBones and _parentIndices*/
+    void sortBones();
+    void sortBones(Bone3D* bone, int parentIndex);
+
     Vector<Bone3D*> _bones;  // bones
 
     Vector<Bone3D*> _rootBones;
+
+    struct AnimateSample
+    {
+        Animate3D* animate;
+        float t;
+        float weight;
+        unsigned int maxBones;
+    };
+    std::vector<AnimateSample> _animateSamples;  // animations waiting for evaluation, retained
+
+    std::vector<Bone3D*> _sortedBones;  // bones of the root bone trees, every parent precedes its children
+    std::vector<int> _parentIndices;    // index of the parent in _sortedBones, -1 for root bones
+    bool _bonesSorted;
+    bool _animateQueued;         // in s_animatedSkeletons
+    unsigned int _updatedFrame;  // frame of the last updateAnimatedSkeletons refresh
+
+    static std::vector<Skeleton3D*> s_animatedSkeletons;
 };
 
 // end of 3d group
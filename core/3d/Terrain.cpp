@@ -29,6 +29,7 @@ USING_NS_AX;
 #include <stdlib.h>
 #include <float.h>
 #include <set>
+#include <mutex>
 #include <stddef.h>  // offsetof
 #include "renderer/Renderer.h"
 #include "renderer/Shaders.h"
@@ -43,6 +44,7 @@ USING_NS_AX;
 #include "platform/Image.h"
 #include "3d/3DProgramInfo.h"
 #include "base/Utils.h"
+#include "base/JobSystem.h"
 
 NS_AX_BEGIN
 
@@ -189,6 +191,7 @@ void Terrain::draw(ax::Renderer* renderer, const ax::Mat4& transform, uint32_t f
         {
             _quadRoot->cullByCamera(camera, _terrainModelMatrix);
         }
+        updateChunksLOD();
     }
     _quadRoot->draw();
     if (_isCameraViewChanged)
@@ -215,16 +218,34 @@ bool Terrain::initHeightMap(std::string_view heightMap)
         calculateNormal();
         memset(_chunkesArray, 0, sizeof(_chunkesArray));
 
+        // every chunk has the same layout, the skirts follow the (w + 1) * (h + 1) grid vertices
+        int gridX               = static_cast<int>(_chunkSize.width);
+        int gridY               = static_cast<int>(_chunkSize.height);
+        _skirtVerticesOffset[0] = (gridX + 1) * (gridY + 1);
+        _skirtVerticesOffset[1] = _skirtVerticesOffset[0] + (gridY + 1);
+        _skirtVerticesOffset[2] = _skirtVerticesOffset[1] + (gridX + 1);
+        _skirtVerticesOffset[3] = _skirtVerticesOffset[2] + (gridY + 1);
+
         for (int m = 0; m < chunk_amount_y; m++)
         {
             for (int n = 0; n < chunk_amount_x; n++)
             {
                 _chunkesArray[m][n]        = new Chunk(this);
                 _chunkesArray[m][n]->_size = _chunkSize;
-                _chunkesArray[m][n]->generate(_imageWidth, _imageHeight, m, n, _data);
             }
         }
 
+        // chunks only read the shared vertices, the GPU buffers are created on their first draw
+        JobSystem::getInstance()->parallelFor(
+            chunk_amount_x * chunk_amount_y, 0, [this, chunk_amount_x](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    int m = static_cast<int>(i) / chunk_amount_x;
+                    int n = static_cast<int>(i) % chunk_amount_x;
+                    _chunkesArray[m][n]->generate(_imageWidth, _imageHeight, m, n, _data);
+                }
+            });
+
         // calculate the neighbor
         for (int m = 0; m < chunk_amount_y; m++)
         {
@@ -242,6 +263,7 @@ bool Terrain::initHeightMap(std::string_view heightMap)
         }
         _quadRoot = new QuadTree(0, 0, _imageWidth, _imageHeight, this);
         setLODDistance(_chunkSize.width, 2 * _chunkSize.width, 3 * _chunkSize.width);
+        _isCameraViewChanged = true;
         return true;
     }
     else
@@ -278,22 +300,47 @@ void Terrain::setChunksLOD(const Vec3& cameraPos)
 {
     int chunk_amount_y = _imageHeight / _chunkSize.height;
     int chunk_amount_x = _imageWidth / _chunkSize.width;
-    for (int m = 0; m < chunk_amount_y; m++)
-        for (int n = 0; n < chunk_amount_x; n++)
-        {
-            AABB aabb                        = _chunkesArray[m][n]->_parent->_worldSpaceAABB;
-            auto center                      = aabb.getCenter();
-            float dist                       = Vec2(center.x, center.z).distance(Vec2(cameraPos.x, cameraPos.z));
-            _chunkesArray[m][n]->_currentLod = 3;
-            for (int i = 0; i < 3; ++i)
+    JobSystem::getInstance()->parallelFor(
+        chunk_amount_x * chunk_amount_y, 0, [this, &cameraPos, chunk_amount_x](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k)
             {
-                if (dist <= _lodDistance[i])
+                auto chunk        = _chunkesArray[k / chunk_amount_x][k % chunk_amount_x];
+                auto center       = chunk->_parent->_worldSpaceAABB.getCenter();
+                float dist        = Vec2(center.x, center.z).distance(Vec2(cameraPos.x, cameraPos.z));
+                chunk->_currentLod = 3;
+                for (int i = 0; i < 3; ++i)
                 {
-                    _chunkesArray[m][n]->_currentLod = i;
-                    break;
+                    if (dist <= _lodDistance[i])
+                    {
+                        chunk->_currentLod = i;
+                        break;
+                    }
                 }
             }
+        });
+}
+
+void Terrain::updateChunksLOD()
+{
+    int chunk_amount_y = _imageHeight / _chunkSize.height;
+    int chunk_amount_x = _imageWidth / _chunkSize.width;
+    _chunksToUpdate.clear();
+    for (int m = 0; m < chunk_amount_y; m++)
+        for (int n = 0; n < chunk_amount_x; n++)
+        {
+            if (_chunkesArray[m][n]->_parent->_needDraw)
+                _chunksToUpdate.emplace_back(_chunkesArray[m][n]);
         }
+
+    // a chunk only writes its own LOD data and reads the LOD of its neighbors, which setChunksLOD already settled
+    JobSystem::getInstance()->parallelFor(_chunksToUpdate.size(), 0, [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            _chunksToUpdate[i]->updateLOD();
+    });
+
+    // index buffers are created and shared here, Ref counting and the backend aren't thread safe
+    for (auto&& chunk : _chunksToUpdate)
+        chunk->commitIndicesLOD();
 }
 
 float Terrain::getHeight(float x, float z, Vec3* normal) const
@@ -381,69 +428,89 @@ float Terrain::getImageHeight(int pixel_x, int pixel_y) const
 
 void Terrain::loadVertices()
 {
+    _vertices.resize(_imageWidth * _imageHeight);
+
+    // rows are independent, each range keeps its own min & max height which are merged afterwards
+    std::mutex heightMutex;
     _maxHeight = -99999;
     _minHeight = 99999;
-    for (int i = 0; i < _imageHeight; ++i)
-    {
-        for (int j = 0; j < _imageWidth; j++)
+    JobSystem::getInstance()->parallelFor(_imageHeight, 0, [this, &heightMutex](size_t begin, size_t end) {
+        float maxHeight = -99999;
+        float minHeight = 99999;
+        for (int i = static_cast<int>(begin); i < static_cast<int>(end); ++i)
         {
-            float height = getImageHeight(j, i);
-            TerrainVertexData v;
-            v._position = Vec3(j * _terrainData._mapScale - _imageWidth / 2 * _terrainData._mapScale,    // x
-                               height,                                                                   // y
-                               i * _terrainData._mapScale - _imageHeight / 2 * _terrainData._mapScale);  // z
-            v._texcoord = Tex2F(j * 1.0 / _imageWidth, i * 1.0 / _imageHeight);
-            _vertices.emplace_back(v);
-
-            // update the min & max height;
-            if (height > _maxHeight)
-                _maxHeight = height;
-            if (height < _minHeight)
-                _minHeight = height;
+            for (int j = 0; j < _imageWidth; j++)
+            {
+                float height = getImageHeight(j, i);
+                auto& v      = _vertices[i * _imageWidth + j];
+                v._position  = Vec3(j * _terrainData._mapScale - _imageWidth / 2 * _terrainData._mapScale,    // x
+                                    height,                                                                   // y
+                                    i * _terrainData._mapScale - _imageHeight / 2 * _terrainData._mapScale);  // z
+                v._texcoord = Tex2F(j * 1.0 / _imageWidth, i * 1.0 / _imageHeight);
+
+                // update the min & max height;
+                if (height > maxHeight)
+                    maxHeight = height;
+                if (height < minHeight)
+                    minHeight = height;
+            }
         }
-    }
+        std::lock_guard<std::mutex> lock(heightMutex);
+        _maxHeight = std::max(_maxHeight, maxHeight);
+        _minHeight = std::min(_minHeight, minHeight);
+    });
 }
 
 void Terrain::calculateNormal()
 {
-    _indices.clear();
-    // we generate whole terrain indices(global indices) for correct normal calculate
-    for (int i = 0; i < _imageHeight - 1; i += 1)
-    {
-        for (int j = 0; j < _imageWidth - 1; j += 1)
+    // the whole terrain is a grid of quads split into the triangles (a, a + w, a + 1) and (a + 1, a + w, a + w + 1),
+    // each vertex gathers the normals of the triangles around it, so rows can be processed independently
+    auto faceNormal = [this](int index0, int index1, int index2) {
+        Vec3 v1 = _vertices[index1]._position - _vertices[index0]._position;
+        Vec3 v2 = _vertices[index2]._position - _vertices[index0]._position;
+        Vec3 normal;
+        Vec3::cross(v1, v2, &normal);
+        normal.normalize();
+        return normal;
+    };
+    JobSystem::getInstance()->parallelFor(_imageHeight, 0, [this, &faceNormal](size_t begin, size_t end) {
+        int w = _imageWidth;
+        for (int i = static_cast<int>(begin); i < static_cast<int>(end); ++i)
         {
-
-            int nLocIndex = i * _imageWidth + j;
-            _indices.emplace_back(nLocIndex);
-            _indices.emplace_back(nLocIndex + _imageWidth);
-            _indices.emplace_back(nLocIndex + 1);
-
-            _indices.emplace_back(nLocIndex + 1);
-            _indices.emplace_back(nLocIndex + _imageWidth);
-            _indices.emplace_back(nLocIndex + _imageWidth + 1);
+            for (int j = 0; j < w; j++)
+            {
+                Vec3 normal;
+                // quad (i, j): first triangle
+                if (i < _imageHeight - 1 && j < w - 1)
+                {
+                    int a = i * w + j;
+                    normal += faceNormal(a, a + w, a + 1);
+                }
+                // quad (i, j - 1): both triangles
+                if (i < _imageHeight - 1 && j > 0)
+                {
+                    int a = i * w + j - 1;
+                    normal += faceNormal(a, a + w, a + 1);
+                    normal += faceNormal(a + 1, a + w, a + w + 1);
+                }
+                // quad (i - 1, j): both triangles
+                if (i > 0 && j < w - 1)
+                {
+                    int a = (i - 1) * w + j;
+                    normal += faceNormal(a, a + w, a + 1);
+                    normal += faceNormal(a + 1, a + w, a + w + 1);
+                }
+                // quad (i - 1, j - 1): second triangle
+                if (i > 0 && j > 0)
+                {
+                    int a = (i - 1) * w + j - 1;
+                    normal += faceNormal(a + 1, a + w, a + w + 1);
+                }
+                normal.normalize();
+                _vertices[i * w + j]._normal = normal;
+            }
         }
-    }
-    for (size_t i = 0, size = _indices.size(); i < size; i += 3)
-    {
-        unsigned int Index0 = _indices[i];
-        unsigned int Index1 = _indices[i + 1];
-        unsigned int Index2 = _indices[i + 2];
-        Vec3 v1             = _vertices[Index1]._position - _vertices[Index0]._position;
-        Vec3 v2             = _vertices[Index2]._position - _vertices[Index0]._position;
-        Vec3 Normal;
-        Vec3::cross(v1, v2, &Normal);
-        Normal.normalize();
-        _vertices[Index0]._normal += Normal;
-        _vertices[Index1]._normal += Normal;
-        _vertices[Index2]._normal += Normal;
-    }
-
-    for (auto&& vertex : _vertices)
-    {
-        vertex._normal.normalize();
-    }
-    // global indices no need at all
-    _indices.clear();
+    });
 }
 
 void Terrain::setDrawWire(bool bool_value)
@@ -698,33 +765,34 @@ void Terrain::setDetailMap(unsigned int index, DetailMap detailMap)
     delete textImage;
 }
 
-Terrain::ChunkIndices Terrain::lookForIndicesLOD(int neighborLod[4], int selfLod, bool* result)
+const Terrain::ChunkIndices* Terrain::findIndicesLOD(const int neighborLod[4], int selfLod) const
 {
-    (*result) = false;
-    ChunkIndices tmp;
-    tmp._indexBuffer = nullptr;
-    tmp._size        = 0;
-    if (_chunkLodIndicesSet.empty())
+    int test[5];
+    memcpy(test, neighborLod, sizeof(int[4]));
+    test[4] = selfLod;
+    for (auto&& lodIndices : _chunkLodIndicesSet)
     {
-        (*result) = false;
-        return tmp;
+        if (memcmp(test, lodIndices._relativeLod, sizeof(test)) == 0)
+            return &lodIndices._chunkIndices;
     }
-    else
+    return nullptr;
+}
+
+const Terrain::ChunkIndices* Terrain::findIndicesLODSkirt(int selfLod) const
+{
+    for (auto&& skirtIndices : _chunkLodIndicesSkirtSet)
     {
-        int test[5];
-        memcpy(test, neighborLod, sizeof(int[4]));
-        test[4] = selfLod;
-        for (size_t i = 0, size = _chunkLodIndicesSet.size(); i < size; ++i)
-        {
-            if (memcmp(test, _chunkLodIndicesSet[i]._relativeLod, sizeof(test)) == 0)
-            {
-                (*result) = true;
-                return _chunkLodIndicesSet[i]._chunkIndices;
-            }
-        }
+        if (skirtIndices._selfLod == selfLod)
+            return &skirtIndices._chunkIndices;
     }
-    (*result) = false;
-    return tmp;
+    return nullptr;
+}
+
+Terrain::ChunkIndices Terrain::lookForIndicesLOD(int neighborLod[4], int selfLod, bool* result)
+{
+    auto indices = findIndicesLOD(neighborLod, selfLod);
+    (*result)    = indices != nullptr;
+    return indices ? *indices : ChunkIndices{};
 }
 
 Terrain::ChunkIndices Terrain::insertIndicesLOD(int neighborLod[4], int selfLod, uint16_t* indices, int size)
@@ -746,24 +814,9 @@ Terrain::ChunkIndices Terrain::insertIndicesLOD(int neighborLod[4], int selfLod,
 
 Terrain::ChunkIndices Terrain::lookForIndicesLODSkrit(int selfLod, bool* result)
 {
-    ChunkIndices badResult;
-    badResult._indexBuffer = nullptr;
-    badResult._size        = 0;
-    if (this->_chunkLodIndicesSkirtSet.empty())
-    {
-        (*result) = false;
-        return badResult;
-    }
-    for (size_t i = 0, size = _chunkLodIndicesSkirtSet.size(); i < size; ++i)
-    {
-        if (_chunkLodIndicesSkirtSet[i]._selfLod == selfLod)
-        {
-            (*result) = true;
-            return _chunkLodIndicesSkirtSet[i]._chunkIndices;
-        }
-    }
-    (*result) = false;
-    return badResult;
+    auto indices = findIndicesLODSkirt(selfLod);
+    (*result)    = indices != nullptr;
+    return indices ? *indices : ChunkIndices{};
 }
 
 Terrain::ChunkIndices Terrain::insertIndicesLODSkirt(int selfLod, uint16_t* indices, int size)
@@ -891,17 +944,25 @@ void Terrain::reload()
     int chunk_amount_y = _imageHeight / _chunkSize.height;
     int chunk_amount_x = _imageWidth / _chunkSize.width;
 
+    // the buffers are recreated on the next draw of each chunk
     for (int m = 0; m < chunk_amount_y; m++)
     {
         for (int n = 0; n < chunk_amount_x; n++)
         {
-            _chunkesArray[m][n]->finish();
+            auto chunk = _chunkesArray[m][n];
+            AX_SAFE_RELEASE_NULL(chunk->_buffer);
+            chunk->_chunkIndices = ChunkIndices{};
+            chunk->_oldLod       = -1;
+            chunk->_verticesLod  = -1;
+            for (int i = 0; i < 4; ++i)
+                chunk->_neighborOldLOD[i] = -1;
         }
     }
 
     initTextures();
     _chunkLodIndicesSet.clear();
     _chunkLodIndicesSkirtSet.clear();
+    _isCameraViewChanged = true;
 }
 
 void Terrain::Chunk::finish()
@@ -915,39 +976,54 @@ void Terrain::Chunk::finish()
                                                         backend::BufferType::VERTEX, backend::BufferUsage::DYNAMIC);
 
     _buffer->updateData(&_originalVertices[0], sizeof(TerrainVertexData) * _originalVertices.size());
+}
 
-    calculateSlope();
-
-    for (int i = 0; i < 4; ++i)
+void Terrain::Chunk::updateLOD()
+{
+    switch (_terrain->_crackFixedType)
     {
-        int step = 1 << _currentLod;
-        // reserve the indices size, the first part is the core part of the chunk, the second part & third part is for
-        // fix crack
-        int indicesAmount = (_terrain->_chunkSize.width / step + 1) * (_terrain->_chunkSize.height / step + 1) * 6 +
-                            (_terrain->_chunkSize.height / step) * 6 + (_terrain->_chunkSize.width / step) * 6;
-        _lod[i]._indices.reserve(indicesAmount);
+    case CrackFixedType::SKIRT:
+
+        updateIndicesLODSkirt();
+        break;
+    case CrackFixedType::INCREASE_LOWER:
+        updateVerticesForLOD();
+        updateIndicesLOD();
+        break;
+    default:
+        break;
     }
-    _oldLod = -1;
 }
 
-void Terrain::Chunk::bindAndDraw()
+void Terrain::Chunk::commitIndicesLOD()
 {
-    if (_terrain->_isCameraViewChanged || _oldLod < 0)
-    {
-        switch (_terrain->_crackFixedType)
-        {
-        case CrackFixedType::SKIRT:
+    if (!_indicesDirty)
+        return;
+    _indicesDirty = false;
 
-            updateIndicesLODSkirt();
-            break;
-        case CrackFixedType::INCREASE_LOWER:
-            updateVerticesForLOD();
-            updateIndicesLOD();
-            break;
-        default:
-            break;
-        }
+    // chunks with the same LOD pattern share one index buffer, only the first of them generated the indices
+    auto& indices = _lod[_currentLod]._indices;
+    if (_terrain->_crackFixedType == CrackFixedType::SKIRT)
+    {
+        bool isOk;
+        _chunkIndices = _terrain->lookForIndicesLODSkrit(_currentLod, &isOk);
+        if (!isOk)
+            _chunkIndices = _terrain->insertIndicesLODSkirt(_currentLod, indices.data(), (int)indices.size());
+    }
+    else
+    {
+        bool isOk;
+        _chunkIndices = _terrain->lookForIndicesLOD(_neighborOldLOD, _currentLod, &isOk);
+        if (!isOk)
+            _chunkIndices = _terrain->insertIndicesLOD(_neighborOldLOD, _currentLod, indices.data(), (int)indices.size());
     }
+}
+
+void Terrain::Chunk::bindAndDraw()
+{
+    // stream the chunks to the GPU as they become visible
+    if (!_buffer)
+        finish();
 
     auto* renderer = Director::getInstance()->getRenderer();
     AXASSERT(_buffer && _chunkIndices._indexBuffer, "buffer should not be nullptr");
@@ -983,7 +1059,6 @@ void Terrain::Chunk::generate(int imgWidth, int imageHei, int m, int n, const un
 
         float skirtHeight = _terrain->_skirtRatio * _terrain->_terrainData._mapScale * 8;
         //#1
-        _terrain->_skirtVerticesOffset[0] = (int)_originalVertices.size();
         for (int i = _size.height * m; i <= _size.height * (m + 1); ++i)
         {
             auto v = _terrain->_vertices[i * imgWidth + _size.width * (n + 1)];
@@ -992,7 +1067,6 @@ void Terrain::Chunk::generate(int imgWidth, int imageHei, int m, int n, const un
         }
 
         //#2
-        _terrain->_skirtVerticesOffset[1] = (int)_originalVertices.size();
         for (int j = _size.width * n; j <= _size.width * (n + 1); j++)
         {
             auto v = _terrain->_vertices[_size.height * (m + 1) * imgWidth + j];
@@ -1001,7 +1075,6 @@ void Terrain::Chunk::generate(int imgWidth, int imageHei, int m, int n, const un
         }
 
         //#3
-        _terrain->_skirtVerticesOffset[2] = (int)_originalVertices.size();
         for (int i = _size.height * m; i <= _size.height * (m + 1); ++i)
         {
             auto v = _terrain->_vertices[i * imgWidth + _size.width * n];
@@ -1010,7 +1083,6 @@ void Terrain::Chunk::generate(int imgWidth, int imageHei, int m, int n, const un
         }
 
         //#4
-        _terrain->_skirtVerticesOffset[3] = (int)_originalVertices.size();
         for (int j = _size.width * n; j <= _size.width * (n + 1); j++)
         {
             auto v = _terrain->_vertices[_size.height * m * imgWidth + j];
@@ -1056,7 +1128,18 @@ void Terrain::Chunk::generate(int imgWidth, int imageHei, int m, int n, const un
     }
 
     calculateAABB();
-    finish();
+    calculateSlope();
+
+    for (int i = 0; i < 4; ++i)
+    {
+        int step = 1 << i;
+        // reserve the indices size, the first part is the core part of the chunk, the second part & third part is for
+        // fix crack
+        int indicesAmount = (_terrain->_chunkSize.width / step + 1) * (_terrain->_chunkSize.height / step + 1) * 6 +
+                            (_terrain->_chunkSize.height / step) * 6 + (_terrain->_chunkSize.width / step) * 6;
+        _lod[i]._indices.reserve(indicesAmount);
+    }
+    _oldLod = -1;
 }
 
 Terrain::Chunk::Chunk(Terrain* terrain)
@@ -1072,6 +1155,8 @@ Terrain::Chunk::Chunk(Terrain* terrain)
     {
         _neighborOldLOD[i] = -1;
     }
+    _verticesLod  = -1;
+    _indicesDirty = false;
     _command.init(_terrain->_globalZOrder);
     _command.setTransparent(false);
     _command.set3D(true);
@@ -1125,14 +1210,13 @@ void Terrain::Chunk::updateIndicesLOD()
     {
         return;  // no need to update
     }
-    bool isOk;
-    _chunkIndices = _terrain->lookForIndicesLOD(currentNeighborLOD, _currentLod, &isOk);
-    if (isOk)
+    memcpy(_neighborOldLOD, currentNeighborLOD, sizeof(currentNeighborLOD));
+    _oldLod       = _currentLod;
+    _indicesDirty = true;
+    if (_terrain->findIndicesLOD(currentNeighborLOD, _currentLod))
     {
-        return;
+        return;  // another chunk created these indices
     }
-    memcpy(_neighborOldLOD, currentNeighborLOD, sizeof(currentNeighborLOD));
-    _oldLod   = _currentLod;
     int gridY = static_cast<int>(_size.height);
     int gridX = static_cast<int>(_size.width);
 
@@ -1293,8 +1377,6 @@ void Terrain::Chunk::updateIndicesLOD()
             }
         }
 
-        _chunkIndices = _terrain->insertIndicesLOD(currentNeighborLOD, _currentLod, &_lod[_currentLod]._indices[0],
-                                                   (int)_lod[_currentLod]._indices.size());
     }
     else
     {
@@ -1315,8 +1397,6 @@ void Terrain::Chunk::updateIndicesLOD()
                 _lod[_currentLod]._indices.emplace_back(nLocIndex + step * (gridX + 1) + step);
             }
         }
-        _chunkIndices = _terrain->insertIndicesLOD(currentNeighborLOD, _currentLod, &_lod[_currentLod]._indices[0],
-                                                   (int)_lod[_currentLod]._indices.size());
     }
 }
 
@@ -1379,7 +1459,7 @@ bool Terrain::Chunk::getIntersectPointWithRay(const Ray& ray, Vec3& intersectPoi
 
 void Terrain::Chunk::updateVerticesForLOD()
 {
-    if (_oldLod == _currentLod)
+    if (_verticesLod == _currentLod)
     {
         return;
     }  // no need to update vertices
@@ -1409,7 +1489,7 @@ void Terrain::Chunk::updateVerticesForLOD()
             }
     }
 
-    _oldLod = _currentLod;
+    _verticesLod = _currentLod;
 }
 
 Terrain::Chunk::~Chunk()
@@ -1421,16 +1501,16 @@ void Terrain::Chunk::updateIndicesLODSkirt()
 {
     if (_oldLod == _currentLod)
         return;
-    _oldLod = _currentLod;
-    bool isOk;
-    _chunkIndices = _terrain->lookForIndicesLODSkrit(_currentLod, &isOk);
-    if (isOk)
-        return;
+    _oldLod       = _currentLod;
+    _indicesDirty = true;
+    if (_terrain->findIndicesLODSkirt(_currentLod))
+        return;  // another chunk created these indices
 
     int gridY = _size.height;
     int gridX = _size.width;
     int step  = 1 << _currentLod;
     int k     = 0;
+    _lod[_currentLod]._indices.clear();
     for (int i = 0; i < gridY; i += step, k += step)
     {
         for (int j = 0; j < gridX; j += step)
@@ -1497,9 +1577,6 @@ void Terrain::Chunk::updateIndicesLODSkirt()
         _lod[_currentLod]._indices.emplace_back(_terrain->_skirtVerticesOffset[3] + j);
         _lod[_currentLod]._indices.emplace_back(nLocIndex + step);
     }
-
-    _chunkIndices = _terrain->insertIndicesLODSkirt(_currentLod, &_lod[_currentLod]._indices[0],
-                                                    (int)_lod[_currentLod]._indices.size());
 }
 
 Terrain::QuadTree::QuadTree(int x, int y, int w, int h, Terrain* terrain)
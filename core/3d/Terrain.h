@@ -250,6 +250,10 @@ private:
         void bindAndDraw();
         /**finish opengl setup*/
         void finish();
+        /**update the vertices & indices for the current LOD, safe to run on a worker thread*/
+        void updateLOD();
+        /**assign the shared index buffer of the current LOD, must run on the render thread*/
+        void commitIndicesLOD();
         /*use linear-sample vertices for LOD mesh*/
         void updateVerticesForLOD();
         /*updateIndices */
@@ -268,6 +272,11 @@ private:
         int _oldLod;
 
         int _neighborOldLOD[4];
+
+        /**LOD of _currentVertices*/
+        int _verticesLod;
+        /**whether _chunkIndices must be looked up again for the current LOD*/
+        bool _indicesDirty;
         /*the left,right,front,back neighbors*/
         Chunk* _left;
         Chunk* _right;
@@ -479,6 +488,11 @@ protected:
      **/
     void setChunksLOD(const Vec3& cameraPos);
 
+    /**
+     * update the LOD geometry of the visible chunks on the job system, then assign their index buffers
+     **/
+    void updateChunksLOD();
+
     /**
      * load Vertices from height filed for the whole terrain.
      **/
@@ -497,7 +511,11 @@ protected:
      **/
     void cacheUniformAttribLocation();
 
-    // IBO generate & cache
+    // IBO generate & cache, the find functions only read the caches and may be called from worker threads
+    const ChunkIndices* findIndicesLODSkirt(int selfLod) const;
+
+    const ChunkIndices* findIndicesLOD(const int neighborLod[4], int selfLod) const;
+
     ChunkIndices lookForIndicesLODSkrit(int selfLod, bool* result);
 
     ChunkIndices lookForIndicesLOD(int neighborLod[4], int selfLod, bool* result);
@@ -529,8 +547,8 @@ protected:
     Vec3 _lightDir;
     QuadTree* _quadRoot;
     Chunk* _chunkesArray[MAX_CHUNKES][MAX_CHUNKES];
+    std::vector<Chunk*> _chunksToUpdate;
     std::vector<TerrainVertexData> _vertices;
-    std::vector<unsigned int> _indices;
     int _imageWidth;
     int _imageHeight;
     Vec2 _chunkSize;
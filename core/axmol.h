@@ -42,6 +42,10 @@ THE SOFTWARE.
 
 // base
 #include "base/AsyncTaskPool.h"
+#include "base/DestructionQueue.h"
+#include "base/DispatchQueue.h"
+#include "base/JobSystem.h"
+#include "base/ObjectAllocator.h"
 #include "base/AutoreleasePool.h"
 #include "base/Configuration.h"
 #include "base/Console.h"
@@ -174,6 +178,11 @@ THE SOFTWARE.
 #include "physics/PhysicsShape.h"
 #include "physics/PhysicsWorld.h"
 
+// ecs
+#include "ecs/EntityComponents.h"
+#include "ecs/EntityLayer.h"
+#include "ecs/EntityWorld.h"
+
 // platform
 #include "platform/Common.h"
 #include "platform/Device.h"
@@ -267,6 +276,7 @@ THE SOFTWARE.
 
 // 3d
 #include "3d/AABB.h"
+#include "3d/AABBTree.h"
 #include "3d/Animate3D.h"
 #include "3d/Animation3D.h"
 #include "3d/AttachNode.h"
@@ -283,6 +293,7 @@ THE SOFTWARE.
 #include "3d/Skybox.h"
 #include "3d/MeshRenderer.h"
 #include "3d/MeshMaterial.h"
+#include "3d/MeshOptimizer.h"
 #include "3d/Terrain.h"
 #include "3d/VertexAttribBinding.h"
 
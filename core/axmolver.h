@@ -0,0 +1,25 @@
+#pragma once
+
+/* Define the axmol version */
+// 0x00 HI ME LO
+// 00   03 08 00
+#define AX_VERSION_MAJOR 2
+#define AX_VERSION_MINOR 0
+#define AX_VERSION_PATCH 0
+
+/* Define the axmol version string, easy for script parsing */
+#define AX_VERSION_STR "2.0.0"
+
+/* Define axmol version helper macros */
+#define AX_VERSION_MAKE(a,b,c) ((a << 16) | (b << 8) | (c & 0xff))
+#define AX_VERSION_NUM AX_VERSION_MAKE(AX_VERSION_MAJOR, AX_VERSION_MINOR, AX_VERSION_PATCH)
+#define AX_VERSION AX_VERSION_NUM
+
+/* Define to the library build number from git commit count */
+#define AX_BUILD_NUM "26"
+
+/* Define the branch being built */
+#define AX_GIT_BRANCH "master"
+
+/* Define the hash of the head commit */
+#define AX_GIT_COMMIT_HASH "81ba63d"
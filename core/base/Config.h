@@ -246,6 +246,14 @@ THE SOFTWARE.
 #    define AX_ENABLE_PROFILERS 0
 #endif
 
+/** @def AX_ENABLE_OBJECT_POOL
+ * If enabled, Node and Action objects are allocated from the size class pool of ObjectAllocator instead of the global
+ * allocator. Enabled by default.
+ */
+#ifndef AX_ENABLE_OBJECT_POOL
+#    define AX_ENABLE_OBJECT_POOL 1
+#endif
+
 /** Enable Lua engine debug log. */
 #ifndef AX_LUA_ENGINE_DEBUG
 #    define AX_LUA_ENGINE_DEBUG 0
@@ -290,6 +298,11 @@ THE SOFTWARE.
 #    define AX_USE_NAVMESH 1
 #endif
 
+/** Use the entity component store, see EntityWorld and EntityLayer. */
+#ifndef AX_USE_ECS
+#    define AX_USE_ECS 1
+#endif
+
 /** Use culling or not. */
 #ifndef AX_USE_CULLING
 #    define AX_USE_CULLING 1
@@ -51,6 +51,7 @@
 #include "2d/Scene.h"
 #include "platform/FileUtils.h"
 #include "renderer/TextureCache.h"
+#include "renderer/Renderer.h"
 #include "base/Utils.h"
 #include "base/UTF8.h"
 
@@ -485,6 +486,7 @@ Console::Console()
     createCommandFps();
     createCommandHelp();
     createCommandProjection();
+    createCommandRenderer();
     createCommandResolution();
     createCommandSceneGraph();
     createCommandTexture();
@@ -1045,6 +1047,23 @@ void Console::createCommandProjection()
                                  AX_CALLBACK_2(Console::commandProjectionSubCommand3d, this)});
 }
 
+void Console::createCommandRenderer()
+{
+    addCommand({"renderer",
+                "Collect or print the frame statistics. Args: [-h | help | on | off | stats | json | csv | ]",
+                AX_CALLBACK_2(Console::commandRenderer, this)});
+    addSubCommand("renderer", {"on", "Start collecting frame statistics.",
+                               AX_CALLBACK_2(Console::commandRendererSubCommandOnOff, this)});
+    addSubCommand("renderer", {"off", "Stop collecting frame statistics.",
+                               AX_CALLBACK_2(Console::commandRendererSubCommandOnOff, this)});
+    addSubCommand("renderer", {"stats", "Print the statistics of the last frame.",
+                               AX_CALLBACK_2(Console::commandRendererSubCommandStats, this)});
+    addSubCommand("renderer", {"json", "renderer json [file]: print or save the frame history as JSON.",
+                               AX_CALLBACK_2(Console::commandRendererSubCommandExport, this)});
+    addSubCommand("renderer", {"csv", "renderer csv [file]: print or save the frame history as CSV.",
+                               AX_CALLBACK_2(Console::commandRendererSubCommandExport, this)});
+}
+
 void Console::createCommandResolution()
 {
     addCommand({"resolution",
@@ -1060,10 +1079,14 @@ void Console::createCommandSceneGraph()
 
 void Console::createCommandTexture()
 {
-    addCommand({"texture", "Flush or print the TextureCache info. Args: [-h | help | flush | ] ",
+    addCommand({"texture", "Flush or print the TextureCache info. Args: [-h | help | flush | stats | budget | ] ",
                 AX_CALLBACK_2(Console::commandTextures, this)});
     addSubCommand("texture", {"flush", "Purges the dictionary of loaded textures.",
                               AX_CALLBACK_2(Console::commandTexturesSubCommandFlush, this)});
+    addSubCommand("texture", {"stats", "Print the texture memory statistics.",
+                              AX_CALLBACK_2(Console::commandTexturesSubCommandStats, this)});
+    addSubCommand("texture", {"budget", "texture budget MB: set the texture memory budget, 0 disables it.",
+                              AX_CALLBACK_2(Console::commandTexturesSubCommandBudget, this)});
 }
 
 void Console::createCommandTouch()
@@ -1226,6 +1249,68 @@ void Console::commandProjectionSubCommand3d(socket_native_type /*fd*/, std::stri
     sched->runOnAxmolThread([=]() { director->setProjection(Director::Projection::_3D); });
 }
 
+void Console::commandRenderer(socket_native_type fd, std::string_view /*args*/)
+{
+    Scheduler* sched = Director::getInstance()->getScheduler();
+    sched->runOnAxmolThread([=]() {
+        auto renderer = Director::getInstance()->getRenderer();
+        Console::Utility::mydprintf(fd, "frame stats are: %s, history: %d frames\n",
+                                    renderer->isFrameStatsEnabled() ? "on" : "off",
+                                    (int)renderer->getFrameStatsHistorySize());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
+void Console::commandRendererSubCommandOnOff(socket_native_type /*fd*/, std::string_view args)
+{
+    bool state       = (args.compare("on") == 0);
+    Renderer* render = Director::getInstance()->getRenderer();
+    Scheduler* sched = Director::getInstance()->getScheduler();
+    sched->runOnAxmolThread(std::bind(&Renderer::setFrameStatsEnabled, render, state));
+}
+
+void Console::commandRendererSubCommandStats(socket_native_type fd, std::string_view /*args*/)
+{
+    Scheduler* sched = Director::getInstance()->getScheduler();
+    sched->runOnAxmolThread([=]() {
+        auto renderer = Director::getInstance()->getRenderer();
+        if (!renderer->isFrameStatsEnabled())
+            Console::Utility::mydprintf(fd, "frame stats are off, enable them with: renderer on\n");
+        else
+            Console::Utility::mydprintf(fd, "%s\n", renderer->getLastFrameStats().toJson().c_str());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
+void Console::commandRendererSubCommandExport(socket_native_type fd, std::string_view args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    if (argv.size() > 2)
+    {
+        Console::Utility::mydprintf(fd, "invalid arguments, usage: renderer %s [file]\n", argv[0].c_str());
+        return;
+    }
+
+    bool json        = argv[0] == "json";
+    std::string path = argv.size() == 2 ? argv[1] : "";
+    Scheduler* sched = Director::getInstance()->getScheduler();
+    sched->runOnAxmolThread([=]() {
+        auto renderer = Director::getInstance()->getRenderer();
+        auto content  = json ? renderer->exportFrameStatsJson() : renderer->exportFrameStatsCsv();
+        if (path.empty())
+            Console::Utility::sendToConsole(fd, content.data(), content.size());
+        else
+        {
+            auto fullPath = FileUtils::getInstance()->getWritablePath() + path;
+            if (FileUtils::getInstance()->writeStringToFile(content, fullPath))
+                Console::Utility::mydprintf(fd, "frame stats saved to: %s\n", fullPath.c_str());
+            else
+                Console::Utility::mydprintf(fd, "can't write: %s\n", fullPath.c_str());
+        }
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
 void Console::commandResolution(socket_native_type /*fd*/, std::string_view args)
 {
     int policy;
@@ -1287,6 +1372,35 @@ void Console::commandTexturesSubCommandFlush(socket_native_type /*fd*/, std::str
     sched->runOnAxmolThread([]() { Director::getInstance()->getTextureCache()->removeAllTextures(); });
 }
 
+void Console::commandTexturesSubCommandStats(socket_native_type fd, std::string_view /*args*/)
+{
+    Scheduler* sched = Director::getInstance()->getScheduler();
+    sched->runOnAxmolThread([=]() {
+        auto stats = Director::getInstance()->getTextureCache()->getMemoryStats();
+        Console::Utility::mydprintf(fd,
+                                    "textures: %d (%d pinned)\nmemory: %.2f MB, peak: %.2f MB, budget: %.2f MB\n"
+                                    "evictions: %d (%.2f MB), reloads: %d\n",
+                                    (int)stats.textureCount, (int)stats.pinnedCount, stats.bytes / (1024.0f * 1024.0f),
+                                    stats.peakBytes / (1024.0f * 1024.0f), stats.budget / (1024.0f * 1024.0f),
+                                    (int)stats.evictions, stats.evictedBytes / (1024.0f * 1024.0f), (int)stats.reloads);
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
+void Console::commandTexturesSubCommandBudget(socket_native_type fd, std::string_view args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    if (argv.size() != 2 || !Console::Utility::isFloat(argv[1]))
+    {
+        Console::Utility::mydprintf(fd, "invalid arguments, usage: texture budget MB\n");
+        return;
+    }
+
+    size_t bytes     = static_cast<size_t>(utils::atof(argv[1].c_str()) * 1024 * 1024);
+    Scheduler* sched = Director::getInstance()->getScheduler();
+    sched->runOnAxmolThread([=]() { Director::getInstance()->getTextureCache()->setMemoryBudget(bytes); });
+}
+
 void Console::commandTouchSubCommandTap(socket_native_type fd, std::string_view args)
 {
     auto argv = Console::Utility::split(args, ' ');
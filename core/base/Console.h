@@ -236,6 +236,7 @@ protected:
     void createCommandFps();
     void createCommandHelp();
     void createCommandProjection();
+    void createCommandRenderer();
     void createCommandResolution();
     void createCommandSceneGraph();
     void createCommandTexture();
@@ -262,11 +263,17 @@ protected:
     void commandProjection(socket_native_type fd, std::string_view args);
     void commandProjectionSubCommand2d(socket_native_type fd, std::string_view args);
     void commandProjectionSubCommand3d(socket_native_type fd, std::string_view args);
+    void commandRenderer(socket_native_type fd, std::string_view args);
+    void commandRendererSubCommandOnOff(socket_native_type fd, std::string_view args);
+    void commandRendererSubCommandStats(socket_native_type fd, std::string_view args);
+    void commandRendererSubCommandExport(socket_native_type fd, std::string_view args);
     void commandResolution(socket_native_type fd, std::string_view args);
     void commandResolutionSubCommandEmpty(socket_native_type fd, std::string_view args);
     void commandSceneGraph(socket_native_type fd, std::string_view args);
     void commandTextures(socket_native_type fd, std::string_view args);
     void commandTexturesSubCommandFlush(socket_native_type fd, std::string_view args);
+    void commandTexturesSubCommandStats(socket_native_type fd, std::string_view args);
+    void commandTexturesSubCommandBudget(socket_native_type fd, std::string_view args);
     void commandTouchSubCommandTap(socket_native_type fd, std::string_view args);
     void commandTouchSubCommandSwipe(socket_native_type fd, std::string_view args);
     void commandUpload(socket_native_type fd);
@@ -0,0 +1,194 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "base/DestructionQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "base/JobSystem.h"
+#include "base/Ref.h"
+#if AX_ENABLE_SCRIPT_BINDING
+#    include "base/ScriptSupport.h"
+#endif
+
+NS_AX_BEGIN
+
+namespace
+{
+DestructionQueue* s_sharedDestructionQueue = nullptr;
+bool s_destructionQueueEnabled             = false;
+thread_local int t_deferringDepth          = 0;
+}  // namespace
+
+DestructionQueue* DestructionQueue::getInstance()
+{
+    if (!s_sharedDestructionQueue)
+        s_sharedDestructionQueue = new DestructionQueue();
+    return s_sharedDestructionQueue;
+}
+
+void DestructionQueue::destroyInstance()
+{
+    if (s_sharedDestructionQueue)
+    {
+        s_sharedDestructionQueue->flush();
+        delete s_sharedDestructionQueue;
+        s_sharedDestructionQueue = nullptr;
+    }
+}
+
+bool DestructionQueue::isDeferring()
+{
+    return t_deferringDepth > 0 && s_destructionQueueEnabled;
+}
+
+void DestructionQueue::beginDeferring()
+{
+    ++t_deferringDepth;
+}
+
+void DestructionQueue::endDeferring()
+{
+    --t_deferringDepth;
+}
+
+DestructionQueue::DestructionQueue() {}
+
+DestructionQueue::~DestructionQueue() {}
+
+void DestructionQueue::setEnabled(bool enabled)
+{
+    s_destructionQueueEnabled = enabled;
+}
+
+bool DestructionQueue::isEnabled() const
+{
+    return s_destructionQueueEnabled;
+}
+
+void DestructionQueue::push(Ref* object)
+{
+    _objects.emplace_back(object);
+    ++_stats.queued;
+    _stats.peakBacklog = (std::max)(_stats.peakBacklog, getBacklogSize());
+}
+
+size_t DestructionQueue::update()
+{
+    if (_objects.empty())
+    {
+        _stats.lastUpdateTime = 0.0f;
+        return 0;
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    const auto start    = Clock::now();
+    const auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(_timeBudget));
+
+    std::vector<Ref*> background;
+    size_t destroyed = 0;
+    {
+        // the objects released by these destructors, e.g. the children of a node, are queued behind
+        Scope scope;
+        while (!_objects.empty())
+        {
+            if (_timeBudget > 0.0f && destroyed > 0 && Clock::now() >= deadline)
+                break;
+
+            auto object = _objects.front();
+            _objects.pop_front();
+            if (!_backgroundTypes.empty() && isBackgroundDestructible(object))
+            {
+                background.emplace_back(object);
+                continue;
+            }
+
+            delete object;
+            ++destroyed;
+        }
+    }
+
+    if (!background.empty())
+    {
+#if AX_ENABLE_SCRIPT_BINDING
+        // ~Ref looks the script engine up, create the lazy singleton here rather than racing on a worker
+        ScriptEngineManager::getInstance();
+#endif
+        const auto count = background.size();
+        _backgroundPending.fetch_add(count, std::memory_order_relaxed);
+        _stats.destroyedInBackground += count;
+        JobSystem::getInstance()->enqueue([this, objects = std::move(background)]() {
+            for (auto object : objects)
+                delete object;
+            _backgroundPending.fetch_sub(objects.size(), std::memory_order_release);
+        });
+    }
+
+    _stats.destroyed += destroyed;
+    _stats.lastUpdateTime = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    return destroyed;
+}
+
+void DestructionQueue::flush()
+{
+    while (!_objects.empty())
+    {
+        auto object = _objects.front();
+        _objects.pop_front();
+        delete object;
+        ++_stats.destroyed;
+    }
+
+    while (_backgroundPending.load(std::memory_order_acquire) != 0)
+        std::this_thread::yield();
+}
+
+bool DestructionQueue::isBackgroundDestructible(Ref* object) const
+{
+#if AX_ENABLE_SCRIPT_BINDING
+    // ~Ref removes the script object, the script engine is main thread only
+    if (object->_luaID != 0)
+        return false;
+#endif
+    return _backgroundTypes.count(std::type_index(typeid(*object))) != 0;
+}
+
+void DestructionQueue::setBackgroundDestruction(const std::type_info& type, bool enabled)
+{
+    if (enabled)
+        _backgroundTypes.emplace(type);
+    else
+        _backgroundTypes.erase(type);
+}
+
+size_t DestructionQueue::getBacklogSize() const
+{
+    return _objects.size() + _backgroundPending.load(std::memory_order_relaxed);
+}
+
+NS_AX_END
@@ -0,0 +1,173 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __AX_DESTRUCTION_QUEUE_H__
+#define __AX_DESTRUCTION_QUEUE_H__
+
+#include "platform/PlatformMacros.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <deque>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_set>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_AX_BEGIN
+
+class Ref;
+
+/**
+ * @class DestructionQueue
+ * @brief Spreads the destruction of released objects over several frames.
+ *
+ * While a Scope is alive on the main thread, a Ref whose reference count drops to zero is queued instead of being
+ * deleted. Director::mainLoop destroys the queued objects until the time budget of the frame is spent. Objects
+ * released to zero by those destructors are queued too, so tearing down a large scene costs a bounded amount of
+ * time per frame instead of stalling the transition frame.
+ *
+ * Deferring is off by default, see setEnabled(). Once enabled, Director defers the scene it releases in
+ * setNextScene(), so the destructors of the old scene run after the new scene's onEnter(). The autorelease pool can
+ * be deferred too, see setAutoreleasePoolDeferred().
+ *
+ * Types registered with setBackgroundDestruction() are deleted by the JobSystem instead. Their destructors must not
+ * release other Refs or touch the renderer or any other engine state, the exact dynamic type is matched. Objects
+ * bound to a script are always deleted on the main thread.
+ * @js NA
+ */
+class AX_DLL DestructionQueue
+{
+public:
+    struct Stats
+    {
+        /** Objects queued so far. */
+        uint64_t queued = 0;
+        /** Objects destroyed on the main thread so far. */
+        uint64_t destroyed = 0;
+        /** Objects handed to the JobSystem so far. */
+        uint64_t destroyedInBackground = 0;
+        /** The most objects waiting at once. */
+        size_t peakBacklog = 0;
+        /** Time the last update() took, in milliseconds. */
+        float lastUpdateTime = 0.0f;
+    };
+
+    /** Defers the destruction of the objects released to zero on this thread while it's alive. */
+    class Scope
+    {
+    public:
+        explicit Scope(bool active = true) : _active(active)
+        {
+            if (_active)
+                DestructionQueue::beginDeferring();
+        }
+        ~Scope()
+        {
+            if (_active)
+                DestructionQueue::endDeferring();
+        }
+
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        bool _active;
+    };
+
+    static DestructionQueue* getInstance();
+
+    /** Destroys the queued objects and the queue. */
+    static void destroyInstance();
+
+    /** Returns true if an object released to zero on the calling thread is queued, used by Ref::release. */
+    static bool isDeferring();
+
+    static void beginDeferring();
+    static void endDeferring();
+
+    /** Enables deferring, off by default. When disabled, Scopes have no effect and objects are deleted at once. */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /** Queues an object whose reference count reached zero, main thread only. */
+    void push(Ref* object);
+
+    /**
+     * Destroys queued objects until the time budget is spent. Called by Director::mainLoop.
+     * Every call deletes at least one object on the main thread, unless all the queued objects are handed to the
+     * JobSystem.
+     *
+     * @return The number of objects destroyed on the main thread, the ones handed to the JobSystem aren't counted.
+     */
+    size_t update();
+
+    /** Destroys all queued objects now and waits for the background ones. */
+    void flush();
+
+    /** Sets the time update() may spend per frame, in seconds, 0 destroys the whole backlog. Default is 2ms. */
+    void setTimeBudget(float seconds) { _timeBudget = seconds; }
+    float getTimeBudget() const { return _timeBudget; }
+
+    /** Sets whether the objects released by clearing the autorelease pool each frame are deferred, off by default. */
+    void setAutoreleasePoolDeferred(bool deferred) { _autoreleasePoolDeferred = deferred; }
+    bool isAutoreleasePoolDeferred() const { return _autoreleasePoolDeferred; }
+
+    /** Deletes the objects of a type on a worker thread, see the class description for the requirements. */
+    template <typename T>
+    void setBackgroundDestruction(bool enabled)
+    {
+        setBackgroundDestruction(typeid(T), enabled);
+    }
+    void setBackgroundDestruction(const std::type_info& type, bool enabled);
+
+    /** Gets the number of objects waiting to be destroyed, on the main thread and on the workers. */
+    size_t getBacklogSize() const;
+
+    const Stats& getStats() const { return _stats; }
+
+protected:
+    DestructionQueue();
+    ~DestructionQueue();
+
+    bool isBackgroundDestructible(Ref* object) const;
+
+    std::deque<Ref*> _objects;
+    std::unordered_set<std::type_index> _backgroundTypes;
+    std::atomic<size_t> _backgroundPending{0};
+    float _timeBudget             = 0.002f;
+    bool _autoreleasePoolDeferred = false;
+    Stats _stats;
+};
+
+NS_AX_END
+// end of base group
+/** @} */
+
+#endif  // __AX_DESTRUCTION_QUEUE_H__
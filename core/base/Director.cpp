@@ -58,6 +58,9 @@ THE SOFTWARE.
 #include "base/AutoreleasePool.h"
 #include "base/Configuration.h"
 #include "base/AsyncTaskPool.h"
+#include "base/DestructionQueue.h"
+#include "base/JobSystem.h"
+#include "base/ObjectAllocator.h"
 #include "base/ObjectFactory.h"
 #include "platform/Application.h"
 #include "audio/AudioEngine.h"
@@ -657,6 +660,7 @@ void Director::purgeCachedData()
         log("%s\n", _textureCache->getCachedTextureInfo().c_str());
     }
     FileUtils::getInstance()->purgeCachedEntries();
+    ObjectAllocator::trim();
 }
 
 float Director::getZEye() const
@@ -1015,6 +1019,9 @@ void Director::reset()
     AX_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     AX_SAFE_RELEASE_NULL(_drawnVerticesLabel);
 
+    // destroy what the previous scenes left queued while the caches and the job system are still alive
+    DestructionQueue::destroyInstance();
+
     // purge bitmap cache
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
@@ -1026,6 +1033,7 @@ void Director::reset()
     SpriteFrameCache::destroyInstance();
     FileUtils::destroyInstance();
     AsyncTaskPool::destroyInstance();
+    JobSystem::destroyInstance();
     backend::ProgramManager::destroyInstance();
 
     // axmol specific data structures
@@ -1107,7 +1115,10 @@ void Director::setNextScene()
 
     if (_runningScene)
     {
+        // when enabled, the old scene is torn down over the next frames by the destruction queue
+        DestructionQueue::Scope deferring(DestructionQueue::getInstance()->isEnabled());
         _runningScene->release();
+        _trimObjectPoolInNextLoop = true;
     }
     _runningScene = _nextScene;
     _nextScene->retain();
@@ -1507,7 +1518,25 @@ void Director::mainLoop()
         drawScene();
 
         // release the objects
-        PoolManager::getInstance()->getCurrentPool()->clear();
+        auto destructionQueue = DestructionQueue::getInstance();
+        {
+            DestructionQueue::Scope deferring(destructionQueue->isAutoreleasePoolDeferred());
+            PoolManager::getInstance()->getCurrentPool()->clear();
+        }
+
+        // destroy released objects within the frame's budget
+        destructionQueue->update();
+
+        // evict unused textures over the memory budget
+        if (_textureCache)
+            _textureCache->purgeToBudget();
+
+        // the nodes of the previous scene are gone once the destruction queue drained, hand their slabs back in bulk
+        if (_trimObjectPoolInNextLoop && destructionQueue->getBacklogSize() == 0)
+        {
+            _trimObjectPoolInNextLoop = false;
+            ObjectAllocator::trim();
+        }
     }
 }
 
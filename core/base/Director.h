@@ -535,6 +535,7 @@ protected:
     bool _restartDirectorInNextLoop = false;  // this flag will be set to true in restart()
 
     void setNextScene();
+    bool _trimObjectPoolInNextLoop = false;  // this flag will be set to true when setNextScene() released a scene
 
     void updateFrameRate();
 #if !AX_STRIP_FPS
@@ -0,0 +1,247 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "base/DispatchQueue.h"
+
+#include <algorithm>
+
+NS_AX_BEGIN
+
+DispatchQueue::DispatchQueue(uint32_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity)
+        size <<= 1;
+
+    for (auto& lane : _lanes)
+    {
+        lane.slots.reset(new Slot[size]);
+        lane.mask = size - 1;
+        for (size_t i = 0; i < size; ++i)
+            lane.slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+DispatchQueue::~DispatchQueue() {}
+
+void DispatchQueue::enqueue(DispatchAction&& action, DispatchPriority priority)
+{
+    auto& lane       = _lanes[static_cast<int>(priority)];
+    const auto frame = _frame.load(std::memory_order_relaxed);
+    const auto epoch = _epoch.load(std::memory_order_acquire);
+
+    // once a post overflowed, the following ones queue behind it until the main thread drained the overflow
+    if (!lane.overflowed.load(std::memory_order_acquire))
+    {
+        auto pos = lane.enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto& slot      = lane.slots[pos & lane.mask];
+            const auto diff = static_cast<intptr_t>(slot.sequence.load(std::memory_order_acquire)) -
+                              static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (lane.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.item.action   = std::move(action);
+                    slot.item.postTime =
+                        (pos % LATENCY_SAMPLE_INTERVAL) == 0 ? Clock::now() : Clock::time_point();
+                    slot.item.frame    = frame;
+                    slot.item.epoch    = epoch;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return;
+                }
+            }
+            else if (diff < 0)
+            {
+                break;
+            }
+            else
+            {
+                pos = lane.enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(lane.overflowMutex);
+    lane.overflowed.store(true, std::memory_order_release);
+    auto& item    = lane.overflow.emplace_back();
+    item.action   = std::move(action);
+    item.postTime = (lane.overflowCount % LATENCY_SAMPLE_INTERVAL) == 0 ? Clock::now() : Clock::time_point();
+    item.frame    = frame;
+    item.epoch    = epoch;
+    ++lane.overflowCount;
+}
+
+DispatchQueue::Item* DispatchQueue::front(Lane& lane)
+{
+    if (!lane.pending.empty())
+    {
+        lane.frontInRing = false;
+        return &lane.pending.front();
+    }
+
+    auto& slot = lane.slots[lane.dequeuePos & lane.mask];
+    if (slot.sequence.load(std::memory_order_acquire) == lane.dequeuePos + 1)
+    {
+        lane.frontInRing = true;
+        return &slot.item;
+    }
+
+    // the overflow is newer than anything in the ring, wait for posts still being written to the ring
+    if (!lane.overflowed.load(std::memory_order_acquire) ||
+        lane.enqueuePos.load(std::memory_order_acquire) != lane.dequeuePos)
+        return nullptr;
+
+    // take the whole overflow at once, the producers can go back to the ring as soon as the flag is cleared
+    {
+        std::lock_guard<std::mutex> lock(lane.overflowMutex);
+        lane.pending.swap(lane.overflow);
+        lane.overflowed.store(false, std::memory_order_release);
+    }
+    if (lane.pending.empty())
+        return nullptr;
+
+    lane.frontInRing = false;
+    return &lane.pending.front();
+}
+
+void DispatchQueue::popFront(Lane& lane)
+{
+    if (lane.frontInRing)
+    {
+        auto& slot = lane.slots[lane.dequeuePos & lane.mask];
+        slot.item.action.reset();
+        slot.sequence.store(lane.dequeuePos + lane.mask + 1, std::memory_order_release);
+        ++lane.dequeuePos;
+    }
+    else
+    {
+        lane.pending.pop_front();
+    }
+}
+
+void DispatchQueue::clear()
+{
+    // the actions are dropped when they're reached, so clear() never races with the main thread
+    _epoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+size_t DispatchQueue::perform()
+{
+    const auto frame    = _frame.fetch_add(1, std::memory_order_relaxed) + 1;
+    const auto start    = Clock::now();
+    const auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<float>(_timeBudget));
+
+    size_t performed = 0;
+    for (uint32_t priority = 0; priority < PRIORITY_COUNT; ++priority)
+    {
+        auto& lane          = _lanes[priority];
+        const bool budgeted = _timeBudget > 0.0f && priority != static_cast<uint32_t>(DispatchPriority::HIGH);
+        bool progressed     = false;
+        while (auto item = front(lane))
+        {
+            // only actions older than the last clear() are dropped, the epoch is reread because clear() may run
+            // on another thread while performing and actions posted after it must survive
+            if (static_cast<int32_t>(item->epoch - _epoch.load(std::memory_order_acquire)) < 0)
+            {
+                popFront(lane);
+                ++lane.discarded;
+                continue;
+            }
+
+            // posted while performing, or left over by the budget, stays queued for the next frame
+            if (item->frame == frame)
+                break;
+            if (budgeted && progressed && Clock::now() >= deadline)
+            {
+                ++lane.starvedFrames;
+                break;
+            }
+
+            lane.maxWaitFrames = (std::max)(lane.maxWaitFrames, frame - 1 - item->frame);
+            if (item->postTime != Clock::time_point())
+            {
+                const double latency = std::chrono::duration<double, std::milli>(Clock::now() - item->postTime).count();
+                lane.latencySum += latency;
+                ++lane.latencyCount;
+                lane.maxLatency = (std::max)(lane.maxLatency, latency);
+            }
+
+            // performed in place, the slot is released afterwards
+            item->action();
+            popFront(lane);
+            ++lane.performed;
+            ++performed;
+            progressed = true;
+        }
+    }
+
+    _lastPerformTime = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    return performed;
+}
+
+DispatchQueue::Stats DispatchQueue::getStats(DispatchPriority priority) const
+{
+    auto& lane = const_cast<Lane&>(_lanes[static_cast<int>(priority)]);
+
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(lane.overflowMutex);
+        stats.overflowed = lane.overflowCount;
+    }
+    stats.posted         = lane.enqueuePos.load(std::memory_order_acquire) + stats.overflowed;
+    stats.performed      = lane.performed;
+    stats.discarded      = lane.discarded;
+    stats.pending        = stats.posted - stats.performed - stats.discarded;
+    stats.starvedFrames  = lane.starvedFrames;
+    stats.maxWaitFrames  = lane.maxWaitFrames;
+    stats.averageLatency = lane.latencyCount ? static_cast<float>(lane.latencySum / lane.latencyCount) : 0.0f;
+    stats.maxLatency     = static_cast<float>(lane.maxLatency);
+    return stats;
+}
+
+uint64_t DispatchQueue::getPendingCount() const
+{
+    uint64_t pending = 0;
+    for (uint32_t priority = 0; priority < PRIORITY_COUNT; ++priority)
+        pending += getStats(static_cast<DispatchPriority>(priority)).pending;
+    return pending;
+}
+
+void DispatchQueue::resetStats()
+{
+    for (auto& lane : _lanes)
+    {
+        lane.starvedFrames = 0;
+        lane.maxWaitFrames = 0;
+        lane.latencySum    = 0.0;
+        lane.latencyCount  = 0;
+        lane.maxLatency    = 0.0;
+    }
+}
+
+NS_AX_END
@@ -0,0 +1,312 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __AX_DISPATCH_QUEUE_H__
+#define __AX_DISPATCH_QUEUE_H__
+
+#include "platform/PlatformMacros.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_AX_BEGIN
+
+/** Order in which DispatchQueue performs the queued actions of a frame. */
+enum class DispatchPriority
+{
+    /** Always performed entirely, regardless of the time budget. */
+    HIGH,
+    NORMAL,
+    LOW,
+};
+
+/**
+ * @class DispatchAction
+ * @brief A move only `void()` callable which stores small functors inline.
+ *
+ * Functors up to INLINE_SIZE bytes, including a std::function, are stored without a heap allocation,
+ * larger ones are boxed.
+ * @js NA
+ */
+class DispatchAction
+{
+public:
+    static constexpr size_t INLINE_SIZE = 64;
+
+    DispatchAction() noexcept {}
+
+    template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, DispatchAction>::value>>
+    DispatchAction(F&& func)
+    {
+        typedef std::decay_t<F> C;
+        if constexpr (sizeof(C) <= INLINE_SIZE && alignof(C) <= alignof(std::max_align_t) &&
+                      std::is_nothrow_move_constructible<C>::value)
+        {
+            new (_storage) C(std::forward<F>(func));
+            _ops = &InlineOps<C>::ops;
+        }
+        else
+        {
+            *reinterpret_cast<C**>(_storage) = new C(std::forward<F>(func));
+            _ops                             = &BoxedOps<C>::ops;
+        }
+    }
+
+    DispatchAction(DispatchAction&& other) noexcept { moveFrom(other); }
+
+    DispatchAction& operator=(DispatchAction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    DispatchAction(const DispatchAction&)            = delete;
+    DispatchAction& operator=(const DispatchAction&) = delete;
+
+    ~DispatchAction() { reset(); }
+
+    void operator()() { _ops->invoke(_storage); }
+
+    explicit operator bool() const { return _ops != nullptr; }
+
+    void reset()
+    {
+        if (_ops)
+        {
+            _ops->destroy(_storage);
+            _ops = nullptr;
+        }
+    }
+
+private:
+    struct Ops
+    {
+        void (*invoke)(void* storage);
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void* storage);
+    };
+
+    template <typename C>
+    struct InlineOps
+    {
+        static void invoke(void* storage) { (*static_cast<C*>(storage))(); }
+        static void move(void* dst, void* src)
+        {
+            new (dst) C(std::move(*static_cast<C*>(src)));
+            static_cast<C*>(src)->~C();
+        }
+        static void destroy(void* storage) { static_cast<C*>(storage)->~C(); }
+        static constexpr Ops ops{&invoke, &move, &destroy};
+    };
+
+    template <typename C>
+    struct BoxedOps
+    {
+        static void invoke(void* storage) { (**static_cast<C**>(storage))(); }
+        static void move(void* dst, void* src) { *static_cast<C**>(dst) = *static_cast<C**>(src); }
+        static void destroy(void* storage) { delete *static_cast<C**>(storage); }
+        static constexpr Ops ops{&invoke, &move, &destroy};
+    };
+
+    void moveFrom(DispatchAction& other) noexcept
+    {
+        if (other._ops)
+        {
+            other._ops->move(_storage, other._storage);
+            _ops       = other._ops;
+            other._ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char _storage[INLINE_SIZE];
+    const Ops* _ops = nullptr;
+};
+
+/**
+ * @class DispatchQueue
+ * @brief Queue of actions posted from any thread and performed on the main thread by Scheduler::update().
+ *
+ * Every priority has a bounded lock free ring, posting is a compare and swap and doesn't allocate unless the
+ * functor is larger than DispatchAction::INLINE_SIZE. When a ring is full the posts of that priority take a locked
+ * overflow list until the main thread drained it, the order of the actions of one thread is kept either way.
+ *
+ * With a time budget, the NORMAL and LOW actions left over when the budget is spent are performed in the following
+ * frames, every priority still performs at least one action per frame so none starves. Actions posted while the
+ * queue is performed run in the next frame.
+ * @js NA
+ */
+class AX_DLL DispatchQueue
+{
+public:
+    static const uint32_t PRIORITY_COUNT   = 3;
+    static const uint32_t DEFAULT_CAPACITY = 1024;
+
+    /** One in this many posts is timestamped for the latency statistics, reading the clock costs more than a post. */
+    static const uint32_t LATENCY_SAMPLE_INTERVAL = 16;
+
+    struct Stats
+    {
+        /** Actions posted since the queue was created. */
+        uint64_t posted = 0;
+        /** Actions performed since the queue was created. */
+        uint64_t performed = 0;
+        /** Actions dropped by clear() since the queue was created. */
+        uint64_t discarded = 0;
+        /** Posts which found the ring full and took the locked overflow list. */
+        uint64_t overflowed = 0;
+        /** Actions waiting to be performed. */
+        uint64_t pending = 0;
+        /** Frames which ended with actions left over because the time budget was spent. */
+        uint32_t starvedFrames = 0;
+        /** The most frames an action waited before it was performed. */
+        uint32_t maxWaitFrames = 0;
+        /** Average and max time from post to perform of the sampled actions, in milliseconds. */
+        float averageLatency = 0.0f;
+        float maxLatency     = 0.0f;
+    };
+
+    /**
+     * @param capacity The number of actions each priority's ring holds, rounded up to a power of two.
+     */
+    explicit DispatchQueue(uint32_t capacity = DEFAULT_CAPACITY);
+    ~DispatchQueue();
+
+    DispatchQueue(const DispatchQueue&)            = delete;
+    DispatchQueue& operator=(const DispatchQueue&) = delete;
+
+    /** Queues an action to be performed on the main thread, thread safe. */
+    template <typename F>
+    void post(F&& action, DispatchPriority priority = DispatchPriority::NORMAL)
+    {
+        enqueue(DispatchAction(std::forward<F>(action)), priority);
+    }
+
+    /** Drops the actions queued so far, they won't be performed. Thread safe. */
+    void clear();
+
+    /** Performs the queued actions, must be called on the main thread.
+     *
+     * @return The number of actions performed.
+     */
+    size_t perform();
+
+    /**
+     * Sets the time the NORMAL and LOW actions may take per frame, in seconds. 0 disables the budget, which is the
+     * default, all actions queued before the frame are performed.
+     */
+    void setTimeBudget(float seconds) { _timeBudget = seconds; }
+    float getTimeBudget() const { return _timeBudget; }
+
+    /** Gets the statistics of a priority, must be called on the main thread. */
+    Stats getStats(DispatchPriority priority) const;
+
+    /** Gets the number of actions waiting in all priorities, must be called on the main thread. */
+    uint64_t getPendingCount() const;
+
+    /** Gets the time the last perform() took, in milliseconds. */
+    float getLastPerformTime() const { return _lastPerformTime; }
+
+    /** Resets the latency and starvation statistics, the counters are kept. */
+    void resetStats();
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Item
+    {
+        DispatchAction action;
+        /** Zero unless the post was sampled for the latency. */
+        Clock::time_point postTime;
+        uint32_t frame = 0;
+        uint32_t epoch = 0;
+    };
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence{0};
+        Item item;
+    };
+
+    struct Lane
+    {
+        std::unique_ptr<Slot[]> slots;
+        size_t mask = 0;
+
+        // written by the producers and by the main thread, kept on separate cache lines
+        alignas(64) std::atomic<size_t> enqueuePos{0};
+        alignas(64) size_t dequeuePos = 0;
+
+        std::atomic<bool> overflowed{false};
+        std::mutex overflowMutex;
+        std::deque<Item> overflow;
+        uint64_t overflowCount = 0;
+
+        // actions taken from the overflow, they go before the ring, main thread only
+        std::deque<Item> pending;
+        bool frontInRing = false;
+
+        uint64_t performed = 0;
+        uint64_t discarded = 0;
+        uint32_t starvedFrames = 0;
+        uint32_t maxWaitFrames = 0;
+        double latencySum      = 0.0;
+        uint64_t latencyCount  = 0;
+        double maxLatency      = 0.0;
+    };
+
+    void enqueue(DispatchAction&& action, DispatchPriority priority);
+
+    /** Gets the oldest action of a lane without removing it, nullptr if the lane is empty. */
+    Item* front(Lane& lane);
+    void popFront(Lane& lane);
+
+    Lane _lanes[PRIORITY_COUNT];
+    std::atomic<uint32_t> _frame{0};
+    std::atomic<uint32_t> _epoch{0};
+    float _timeBudget      = 0.0f;
+    float _lastPerformTime = 0.0f;
+};
+
+NS_AX_END
+// end of base group
+/** @} */
+
+#endif  // __AX_DISPATCH_QUEUE_H__
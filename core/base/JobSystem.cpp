@@ -0,0 +1,187 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/JobSystem.h"
+
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+NS_AX_BEGIN
+
+std::atomic<JobSystem*> JobSystem::s_jobSystem{nullptr};
+std::mutex JobSystem::s_instanceMutex;
+
+JobSystem* JobSystem::getInstance()
+{
+    // loaders call this from their own threads, the instance can be recreated after destroyInstance so a function
+    // local static doesn't fit
+    auto jobSystem = s_jobSystem.load(std::memory_order_acquire);
+    if (jobSystem == nullptr)
+    {
+        std::lock_guard<std::mutex> lck(s_instanceMutex);
+        jobSystem = s_jobSystem.load(std::memory_order_relaxed);
+        if (jobSystem == nullptr)
+        {
+            jobSystem = new JobSystem();
+            s_jobSystem.store(jobSystem, std::memory_order_release);
+        }
+    }
+    return jobSystem;
+}
+
+void JobSystem::destroyInstance()
+{
+    JobSystem* jobSystem = nullptr;
+    {
+        std::lock_guard<std::mutex> lck(s_instanceMutex);
+        jobSystem = s_jobSystem.exchange(nullptr, std::memory_order_acq_rel);
+    }
+    // the workers are joined outside the lock, a running job may still call getInstance
+    delete jobSystem;
+}
+
+JobSystem::JobSystem(int workers)
+{
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    if (workers < 0)
+    {
+        // leave one core for the calling thread, which always takes part in parallelFor
+        workers = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1);
+    }
+    for (int i = 0; i < workers; ++i)
+        _workers.emplace_back(std::thread{&JobSystem::run, this});
+#endif
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::unique_lock<std::mutex> lck(_jobsMutex);
+        _stopped = true;
+        _jobs.clear();
+    }
+    _jobsCondition.notify_all();
+
+    for (auto&& t : _workers)
+    {
+        if (t.joinable())
+            t.join();
+    }
+    _workers.clear();
+}
+
+void JobSystem::enqueue(std::function<void()> job)
+{
+    if (_workers.empty())
+    {
+        job();
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lck(_jobsMutex);
+        if (_stopped)
+            return;
+        _jobs.emplace_back(std::move(job));
+    }
+    _jobsCondition.notify_one();
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const RangeJob& job)
+{
+    if (count == 0)
+        return;
+
+    const size_t workers = _workers.size();
+    if (grain == 0)
+        grain = std::max(count / ((workers + 1) * 4), (size_t)1);
+
+    const size_t chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || workers == 0)
+    {
+        job(0, count);
+        return;
+    }
+
+    struct ParallelContext
+    {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mtx;
+        std::condition_variable cv;
+    };
+    auto ctx = std::make_shared<ParallelContext>();
+
+    // the job is only referenced while a chunk is claimed, and the caller waits for all chunks
+    auto process = [ctx, count, grain, chunks, &job]() {
+        for (;;)
+        {
+            const size_t chunk = ctx->next.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunks)
+                break;
+
+            const size_t begin = chunk * grain;
+            job(begin, std::min(begin + grain, count));
+
+            if (ctx->done.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks)
+            {
+                std::lock_guard<std::mutex> lck(ctx->mtx);
+                ctx->cv.notify_all();
+            }
+        }
+    };
+
+    const size_t helpers = std::min(workers, chunks - 1);
+    {
+        std::unique_lock<std::mutex> lck(_jobsMutex);
+        for (size_t i = 0; i < helpers; ++i)
+            _jobs.emplace_back(process);
+    }
+    _jobsCondition.notify_all();
+
+    process();
+
+    std::unique_lock<std::mutex> lck(ctx->mtx);
+    ctx->cv.wait(lck, [&ctx, chunks] { return ctx->done.load(std::memory_order_acquire) == chunks; });
+}
+
+void JobSystem::run()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lck(_jobsMutex);
+            _jobsCondition.wait(lck, [this] { return _stopped || !_jobs.empty(); });
+            if (_stopped)
+                return;
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+        job();
+    }
+}
+
+NS_AX_END
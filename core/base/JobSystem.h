@@ -0,0 +1,109 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __AX_JOB_SYSTEM_H__
+#define __AX_JOB_SYSTEM_H__
+
+#include "platform/PlatformMacros.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_AX_BEGIN
+
+/**
+ * @class JobSystem
+ * @brief A shared pool of worker threads for data parallel engine work.
+ *
+ * Unlike AsyncTaskPool, which owns a single thread per task type, the job system
+ * spreads fine grained jobs across all cores. The calling thread always takes part
+ * in parallelFor, so nested calls from inside a job never dead lock.
+ * @js NA
+ */
+class AX_DLL JobSystem
+{
+public:
+    typedef std::function<void(size_t begin, size_t end)> RangeJob;
+
+    /**
+     * Returns the shared instance of the job system, it's created by the first call from any thread.
+     */
+    static JobSystem* getInstance();
+
+    /**
+     * Destroys the job system, pending jobs are dropped. No other thread may use the instance meanwhile.
+     */
+    static void destroyInstance();
+
+    /**
+     * Gets the number of worker threads, the calling thread is not counted.
+     */
+    int getWorkerCount() const { return static_cast<int>(_workers.size()); }
+
+    /**
+     * Enqueue a job to run on a worker thread.
+     *
+     * @param job The job to be performed off thread.
+     */
+    void enqueue(std::function<void()> job);
+
+    /**
+     * Splits [0, count) into chunks of `grain` items and runs them across the workers and
+     * the calling thread, returns when all chunks are done.
+     *
+     * @param count Total number of items.
+     * @param grain Max items per chunk, 0 picks a chunk size from the worker count.
+     * @param job Invoked with the [begin, end) range of one chunk, must be thread safe.
+     */
+    void parallelFor(size_t count, size_t grain, const RangeJob& job);
+
+    JobSystem(int workers = -1);
+    ~JobSystem();
+
+protected:
+    void run();
+
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _jobs;
+    std::mutex _jobsMutex;
+    std::condition_variable _jobsCondition;
+    bool _stopped = false;
+
+    static std::atomic<JobSystem*> s_jobSystem;
+    static std::mutex s_instanceMutex;
+};
+
+NS_AX_END
+// end group
+/// @}
+#endif  //__AX_JOB_SYSTEM_H__
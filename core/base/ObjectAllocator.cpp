@@ -0,0 +1,301 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "base/ObjectAllocator.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include "fmt/format.h"
+
+NS_AX_BEGIN
+
+namespace
+{
+constexpr size_t SIZE_CLASS_COUNT = ObjectAllocator::MAX_POOLED_SIZE / ObjectAllocator::GRANULARITY;
+
+struct SizeClass
+{
+    std::mutex mutex;
+    void* freeList = nullptr;  // every free block starts with the pointer to the next one
+    std::vector<char*> slabs;
+    ObjectAllocator::Stats stats;
+};
+
+struct ObjectPool
+{
+    SizeClass sizeClasses[SIZE_CLASS_COUNT];
+    SizeClass large;  // above MAX_POOLED_SIZE, only counted
+};
+
+ObjectPool& getPool()
+{
+    // never destroyed, nodes may still be released after static destruction started
+    static ObjectPool* pool = new ObjectPool();
+    return *pool;
+}
+
+inline size_t getSizeClassIndex(size_t size)
+{
+    return size ? (size - 1) / ObjectAllocator::GRANULARITY : 0;
+}
+
+inline size_t getBlockSize(size_t index)
+{
+    return (index + 1) * ObjectAllocator::GRANULARITY;
+}
+
+inline size_t getBlocksPerSlab(size_t index)
+{
+    return ObjectAllocator::SLAB_SIZE / getBlockSize(index);
+}
+
+char* allocateSlab(size_t bytes)
+{
+    return static_cast<char*>(::operator new(bytes, std::align_val_t{ObjectAllocator::GRANULARITY}));
+}
+
+void freeSlab(char* slab)
+{
+    ::operator delete(slab, std::align_val_t{ObjectAllocator::GRANULARITY});
+}
+
+void addSlab(SizeClass& sizeClass, size_t index)
+{
+    const size_t blockSize = getBlockSize(index);
+    const size_t count     = getBlocksPerSlab(index);
+    char* slab             = allocateSlab(blockSize * count);
+
+    // link the blocks back to front, so they are handed out in address order
+    void* next = sizeClass.freeList;
+    for (size_t i = count; i > 0; --i)
+    {
+        void* block                 = slab + (i - 1) * blockSize;
+        *static_cast<void**>(block) = next;
+        next                        = block;
+    }
+    sizeClass.freeList = next;
+
+    sizeClass.slabs.emplace_back(slab);
+    ++sizeClass.stats.slabs;
+    sizeClass.stats.reservedBytes += blockSize * count;
+}
+
+void onAllocated(ObjectAllocator::Stats& stats)
+{
+    ++stats.allocations;
+    if (++stats.liveObjects > stats.peakObjects)
+        stats.peakObjects = stats.liveObjects;
+}
+
+void onDeallocated(ObjectAllocator::Stats& stats)
+{
+    ++stats.deallocations;
+    --stats.liveObjects;
+}
+
+size_t trimSizeClass(SizeClass& sizeClass, size_t index)
+{
+    if (sizeClass.slabs.empty())
+        return 0;
+
+    const size_t slabBytes = getBlockSize(index) * getBlocksPerSlab(index);
+    size_t freed           = 0;
+
+    if (sizeClass.stats.liveObjects == 0)
+    {
+        for (auto slab : sizeClass.slabs)
+            freeSlab(slab);
+        freed = sizeClass.slabs.size() * slabBytes;
+        sizeClass.slabs.clear();
+        sizeClass.freeList = nullptr;
+    }
+    else
+    {
+        // count the free blocks of every slab, the slabs without live objects are dropped from the free list first
+        auto& slabs = sizeClass.slabs;
+        std::sort(slabs.begin(), slabs.end());
+        auto findSlab = [&slabs](void* block) {
+            return static_cast<size_t>(std::upper_bound(slabs.begin(), slabs.end(), static_cast<char*>(block)) -
+                                       slabs.begin() - 1);
+        };
+
+        std::vector<size_t> freeBlocks(slabs.size(), 0);
+        for (void* block = sizeClass.freeList; block; block = *static_cast<void**>(block))
+            ++freeBlocks[findSlab(block)];
+
+        const size_t blocksPerSlab = getBlocksPerSlab(index);
+        void* freeList             = nullptr;
+        for (void* block = sizeClass.freeList; block;)
+        {
+            void* next = *static_cast<void**>(block);
+            if (freeBlocks[findSlab(block)] != blocksPerSlab)
+            {
+                *static_cast<void**>(block) = freeList;
+                freeList                    = block;
+            }
+            block = next;
+        }
+        sizeClass.freeList = freeList;
+
+        size_t kept = 0;
+        for (size_t i = 0; i < slabs.size(); ++i)
+        {
+            if (freeBlocks[i] == blocksPerSlab)
+            {
+                freeSlab(slabs[i]);
+                freed += slabBytes;
+            }
+            else
+                slabs[kept++] = slabs[i];
+        }
+        slabs.resize(kept);
+    }
+
+    sizeClass.stats.slabs = sizeClass.slabs.size();
+    sizeClass.stats.reservedBytes -= freed;
+    return freed;
+}
+
+void addStats(ObjectAllocator::Stats& total, const ObjectAllocator::Stats& stats)
+{
+    total.allocations += stats.allocations;
+    total.deallocations += stats.deallocations;
+    total.liveObjects += stats.liveObjects;
+    total.peakObjects += stats.peakObjects;
+    total.slabs += stats.slabs;
+    total.reservedBytes += stats.reservedBytes;
+}
+}  // namespace
+
+void* ObjectAllocator::allocate(size_t size)
+{
+    auto& pool = getPool();
+    if (size > MAX_POOLED_SIZE)
+    {
+        void* p = ::operator new(size);
+        std::lock_guard<std::mutex> lock(pool.large.mutex);
+        onAllocated(pool.large.stats);
+        return p;
+    }
+
+    const size_t index = getSizeClassIndex(size);
+    auto& sizeClass    = pool.sizeClasses[index];
+
+    std::lock_guard<std::mutex> lock(sizeClass.mutex);
+    if (!sizeClass.freeList)
+        addSlab(sizeClass, index);
+
+    void* p            = sizeClass.freeList;
+    sizeClass.freeList = *static_cast<void**>(p);
+    onAllocated(sizeClass.stats);
+    return p;
+}
+
+void ObjectAllocator::deallocate(void* p, size_t size)
+{
+    if (!p)
+        return;
+
+    auto& pool = getPool();
+    if (size > MAX_POOLED_SIZE)
+    {
+        ::operator delete(p);
+        std::lock_guard<std::mutex> lock(pool.large.mutex);
+        onDeallocated(pool.large.stats);
+        return;
+    }
+
+    auto& sizeClass = pool.sizeClasses[getSizeClassIndex(size)];
+
+    std::lock_guard<std::mutex> lock(sizeClass.mutex);
+    *static_cast<void**>(p) = sizeClass.freeList;
+    sizeClass.freeList      = p;
+    onDeallocated(sizeClass.stats);
+}
+
+size_t ObjectAllocator::trim()
+{
+    auto& pool   = getPool();
+    size_t freed = 0;
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+    {
+        std::lock_guard<std::mutex> lock(pool.sizeClasses[i].mutex);
+        freed += trimSizeClass(pool.sizeClasses[i], i);
+    }
+    return freed;
+}
+
+ObjectAllocator::Stats ObjectAllocator::getStats()
+{
+    auto& pool = getPool();
+    Stats total;
+    for (auto& sizeClass : pool.sizeClasses)
+    {
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        addStats(total, sizeClass.stats);
+    }
+    std::lock_guard<std::mutex> lock(pool.large.mutex);
+    addStats(total, pool.large.stats);
+    return total;
+}
+
+ObjectAllocator::Stats ObjectAllocator::getStats(size_t size)
+{
+    auto& pool      = getPool();
+    auto& sizeClass = size > MAX_POOLED_SIZE ? pool.large : pool.sizeClasses[getSizeClassIndex(size)];
+
+    std::lock_guard<std::mutex> lock(sizeClass.mutex);
+    return sizeClass.stats;
+}
+
+std::string ObjectAllocator::getStatsDescription()
+{
+    auto& pool = getPool();
+    std::string description;
+    auto append = [&description](std::string_view name, const Stats& stats) {
+        fmt::format_to(std::back_inserter(description),
+                       "{}: allocations={} deallocations={} live={} peak={} slabs={} reserved={} KB\n", name,
+                       stats.allocations, stats.deallocations, stats.liveObjects, stats.peakObjects, stats.slabs,
+                       stats.reservedBytes / 1024);
+    };
+
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+    {
+        Stats stats = getStats(getBlockSize(i));
+        if (stats.allocations)
+            append(fmt::format("{} bytes", getBlockSize(i)), stats);
+    }
+    {
+        std::lock_guard<std::mutex> lock(pool.large.mutex);
+        if (pool.large.stats.allocations)
+            append(fmt::format("> {} bytes", MAX_POOLED_SIZE), pool.large.stats);
+    }
+    append("total", getStats());
+    return description;
+}
+
+NS_AX_END
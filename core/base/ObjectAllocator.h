@@ -0,0 +1,127 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __AX_OBJECT_ALLOCATOR_H__
+#define __AX_OBJECT_ALLOCATOR_H__
+
+#include "platform/PlatformMacros.h"
+#include "base/Config.h"
+
+#include <cstddef>
+#include <new>
+#include <string>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_AX_BEGIN
+
+/**
+ * @class ObjectAllocator
+ * @brief A size class pool for the engine's many small, short lived objects.
+ *
+ * Node and Action, and every class derived from them, are allocated here when AX_ENABLE_OBJECT_POOL is on. The
+ * create() factories and Ref::release need no changes. Sizes are rounded up to GRANULARITY bytes. Each size class
+ * carves its blocks out of SLAB_SIZE slabs and recycles freed blocks through a free list, larger objects use the
+ * global allocator.
+ *
+ * Slabs aren't returned to the system when their objects are freed. Director trims the pool once the previous scene
+ * is gone, which releases the slabs it left empty in bulk.
+ * @js NA
+ */
+class AX_DLL ObjectAllocator
+{
+public:
+    static constexpr size_t GRANULARITY     = 16;
+    static constexpr size_t MAX_POOLED_SIZE = 4096;
+    static constexpr size_t SLAB_SIZE       = 64 * 1024;
+
+    /** Allocation counters of a size class, or of the whole pool. */
+    struct Stats
+    {
+        size_t allocations   = 0;  // blocks handed out so far
+        size_t deallocations = 0;  // blocks given back so far
+        size_t liveObjects   = 0;
+        size_t peakObjects   = 0;
+        size_t slabs         = 0;
+        size_t reservedBytes = 0;  // bytes held by the slabs
+    };
+
+    /** Allocates a block of at least `size` bytes aligned to GRANULARITY, thread safe. */
+    static void* allocate(size_t size);
+
+    /** Gives back a block, `size` has to be the size it was allocated with. */
+    static void deallocate(void* p, size_t size);
+
+    /** Releases the slabs without live objects, returns the number of bytes freed. */
+    static size_t trim();
+
+    /** Gets the counters of all size classes, allocations above MAX_POOLED_SIZE included. */
+    static Stats getStats();
+
+    /** Gets the counters of the size class serving `size`. */
+    static Stats getStats(size_t size);
+
+    /** Gets the counters of every size class in use as a printable string. */
+    static std::string getStatsDescription();
+};
+
+NS_AX_END
+
+#if AX_ENABLE_OBJECT_POOL
+/** Routes the allocations of a class and its subclasses through ObjectAllocator, declares public members.
+ * Subclasses aligned beyond GRANULARITY, e.g. with alignas(32), are allocated by the global allocator. */
+#    define AX_POOLED_ALLOCATION                                                                                     \
+    public:                                                                                                          \
+        static void* operator new(std::size_t size) { return ax::ObjectAllocator::allocate(size); }                  \
+        static void* operator new(std::size_t size, const std::nothrow_t&) noexcept                                  \
+        {                                                                                                            \
+            return ax::ObjectAllocator::allocate(size);                                                              \
+        }                                                                                                            \
+        static void* operator new(std::size_t, void* p) noexcept { return p; }                                       \
+        static void* operator new(std::size_t size, std::align_val_t align) { return ::operator new(size, align); }  \
+        static void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept          \
+        {                                                                                                            \
+            return ::operator new(size, align, std::nothrow);                                                        \
+        }                                                                                                            \
+        static void operator delete(void* p, std::size_t size) { ax::ObjectAllocator::deallocate(p, size); }         \
+        static void operator delete(void*, void*) noexcept {}                                                        \
+        static void operator delete(void* p, std::size_t size, std::align_val_t align) noexcept                      \
+        {                                                                                                            \
+            ::operator delete(p, size, align);                                                                       \
+        }                                                                                                            \
+        static void operator delete(void* p, std::align_val_t align) noexcept { ::operator delete(p, align); }       \
+        static void operator delete(void* p, std::align_val_t align, const std::nothrow_t&) noexcept                 \
+        {                                                                                                            \
+            ::operator delete(p, align);                                                                             \
+        }
+#else
+#    define AX_POOLED_ALLOCATION
+#endif
+
+// end group
+/// @}
+#endif  //__AX_OBJECT_ALLOCATOR_H__
@@ -26,6 +26,7 @@ THE SOFTWARE.
 
 #include "base/Ref.h"
 #include "base/AutoreleasePool.h"
+#include "base/DestructionQueue.h"
 #include "base/Macros.h"
 #include "base/ScriptSupport.h"
 
@@ -130,7 +131,10 @@ void Ref::release()
 #if AX_REF_LEAK_DETECTION
         untrackRef(this);
 #endif
-        delete this;
+        if (DestructionQueue::isDeferring())
+            DestructionQueue::getInstance()->push(this);
+        else
+            delete this;
     }
 }
 
@@ -262,10 +262,7 @@ Scheduler::Scheduler()
 #if AX_ENABLE_SCRIPT_BINDING
     , _scriptHandlerEntries(20)
 #endif
-{
-    // I don't expect to have more than 30 functions to all per frame
-    _actionsToPerform.reserve(30);
-}
+{}
 
 Scheduler::~Scheduler()
 {
@@ -812,16 +809,9 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
     }
 }
 
-void Scheduler::runOnAxmolThread(std::function<void()> action)
-{
-    std::lock_guard<std::mutex> lock(_performMutex);
-    _actionsToPerform.emplace_back(std::move(action));
-}
-
 void Scheduler::removeAllPendingActions()
 {
-    std::unique_lock<std::mutex> lock(_performMutex);
-    _actionsToPerform.clear();
+    _dispatchQueue.clear();
 }
 
 // main loop
@@ -942,21 +932,8 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
-    if (!_actionsToPerform.empty())
-    {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if
-        // new functions are added in callback, it will cause thread deadlock.
-        auto temp = std::move(_actionsToPerform);
-        _performMutex.unlock();
-
-        for (const auto& function : temp)
-        {
-            function();
-        }
-    }
+    // Actions queued with runOnAxmolThread, newly queued ones are performed in the next frame.
+    _dispatchQueue.perform();
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector,
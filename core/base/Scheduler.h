@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include <mutex>
 #include <set>
 
+#include "base/DispatchQueue.h"
 #include "base/Ref.h"
 #include "base/Vector.h"
 #include "uthash/uthash.h"
@@ -444,12 +445,19 @@ public:
     void resumeTargets(const std::set<void*>& targetsToResume);
 
     /** Calls a function on the cocos2d thread. Useful when you need to call a cocos2d function from another thread.
-     This function is thread safe.
-     @param function The function to be run in cocos2d thread.
+     This function is thread safe and lock free, functors up to DispatchAction::INLINE_SIZE bytes are queued without
+     a heap allocation.
+     @param action The function to be run in cocos2d thread.
+     @param priority The order among the functions queued for the same frame, see getDispatchQueue() for the time
+     budget.
      @since v3.0
      @js NA
      */
-    void runOnAxmolThread(std::function<void()> action);
+    template <typename F>
+    void runOnAxmolThread(F&& action, DispatchPriority priority = DispatchPriority::NORMAL)
+    {
+        _dispatchQueue.post(std::forward<F>(action), priority);
+    }
 
     AX_DEPRECATED_ATTRIBUTE void performFunctionInCocosThread(std::function<void()> action)
     {
@@ -466,6 +474,13 @@ public:
     void removeAllPendingActions();
     AX_DEPRECATED_ATTRIBUTE void removeAllFunctionsToBePerformedInCocosThread() { removeAllPendingActions(); }
 
+    /**
+     * Gets the queue of the functions posted with runOnAxmolThread, to set its time budget or read its latency and
+     * starvation statistics.
+     * @js NA
+     */
+    DispatchQueue& getDispatchQueue() { return _dispatchQueue; }
+
 protected:
     /** Schedules the 'callback' function for a given target with a given priority.
      The 'callback' selector will be called every frame.
@@ -508,8 +523,7 @@ protected:
 #endif
 
     // Used for "perform action"
-    std::vector<std::function<void()>> _actionsToPerform;
-    std::mutex _performMutex;
+    DispatchQueue _dispatchQueue;
 };
 
 // end of base group
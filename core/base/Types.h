@@ -368,6 +368,24 @@ struct AX_DLL V3F_C4B_T2F
     Tex2F texCoords;  // 8 bytes
 };
 
+/** @struct V3F_C4B_T2F_I1F
+ * A V3F_C4B_T2F with the index of the texture slot it samples from, used by multi texture batching.
+ */
+struct AX_DLL V3F_C4B_T2F_I1F
+{
+    /// vertices (3F)
+    Vec3 vertices;  // 12 bytes
+
+    /// colors (4B)
+    Color4B colors;  // 4 bytes
+
+    // tex coords (2F)
+    Tex2F texCoords;  // 8 bytes
+
+    // texture slot (1F)
+    float texIndex;  // 4 bytes
+};
+
 /** @struct V3F_T2F
  * A Vec2 with a vertex point, a tex coord point.
  */
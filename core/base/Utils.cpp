@@ -115,11 +115,12 @@ void captureScreen(std::function<void(RefPtr<Image>)> imageCallback)
             eventDispatcher->removeEventListener(s_captureScreenListener);
             s_captureScreenListener = nullptr;
             // !!!GL: AFTER_DRAW and BEFORE_END_FRAME
-            renderer->readPixels(renderer->getDefaultRenderTarget(), [=](const backend::PixelBufferDescriptor& pbd) {
+            renderer->readPixels(renderer->getDefaultRenderTarget(), [=](backend::PixelBufferDescriptor& pbd) {
                 if (pbd)
                 {
-                    auto image = utils::makeInstance<Image>(&Image::initWithRawData, pbd._data.getBytes(),
-                                                            pbd._data.getSize(), pbd._width, pbd._height, 8, false);
+                    RefPtr<Image> image(ReferencedObject<Image>{new Image()});
+                    if (!image->initWithRawData(std::move(pbd._data), pbd._width, pbd._height, 8, false))
+                        image.reset();
                     imageCallback(image);
                 }
                 else
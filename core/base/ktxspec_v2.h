@@ -0,0 +1,124 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include <stdint.h>
+
+#define KTX_V2_HEADER_SIZE 80
+
+#define KTX_V2_MAGIC "KTX 20"
+
+// ktxv2 header, refer to: https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html
+struct KTXv2Header
+{
+    // the VkFormat values of the block compressed and RGBA8 formats we can load
+    struct VkFormat
+    {
+        enum : uint32_t
+        {
+            UNDEFINED = 0,  // Basis Universal ETC1S or UASTC, needs transcoding
+            // RGB8 & RGBA8
+            R8G8B8_UNORM   = 23,
+            R8G8B8_SRGB    = 29,
+            R8G8B8A8_UNORM = 37,
+            R8G8B8A8_SRGB  = 43,
+            // S3TC
+            BC1_RGB_UNORM_BLOCK  = 131,
+            BC1_RGB_SRGB_BLOCK   = 132,
+            BC1_RGBA_UNORM_BLOCK = 133,
+            BC1_RGBA_SRGB_BLOCK  = 134,
+            BC2_UNORM_BLOCK      = 135,
+            BC2_SRGB_BLOCK       = 136,
+            BC3_UNORM_BLOCK      = 137,
+            BC3_SRGB_BLOCK       = 138,
+            // ETC2
+            ETC2_R8G8B8_UNORM_BLOCK   = 147,
+            ETC2_R8G8B8_SRGB_BLOCK    = 148,
+            ETC2_R8G8B8A8_UNORM_BLOCK = 151,
+            ETC2_R8G8B8A8_SRGB_BLOCK  = 152,
+            // ASTC
+            ASTC_4x4_UNORM_BLOCK  = 157,
+            ASTC_4x4_SRGB_BLOCK   = 158,
+            ASTC_5x5_UNORM_BLOCK  = 161,
+            ASTC_5x5_SRGB_BLOCK   = 162,
+            ASTC_6x6_UNORM_BLOCK  = 165,
+            ASTC_6x6_SRGB_BLOCK   = 166,
+            ASTC_8x5_UNORM_BLOCK  = 167,
+            ASTC_8x5_SRGB_BLOCK   = 168,
+            ASTC_8x6_UNORM_BLOCK  = 169,
+            ASTC_8x6_SRGB_BLOCK   = 170,
+            ASTC_8x8_UNORM_BLOCK  = 171,
+            ASTC_8x8_SRGB_BLOCK   = 172,
+            ASTC_10x5_UNORM_BLOCK = 173,
+            ASTC_10x5_SRGB_BLOCK  = 174,
+        };
+    };
+
+    struct SupercompressionScheme
+    {
+        enum : uint32_t
+        {
+            NONE     = 0,
+            BASIS_LZ = 1,
+            ZSTD     = 2,
+            ZLIB     = 3,
+        };
+    };
+
+    // flags of the basic data format descriptor block
+    struct DFDFlag
+    {
+        enum : uint8_t
+        {
+            ALPHA_PREMULTIPLIED = 1,
+        };
+    };
+
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+
+    // index
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+
+// follows the header, one per mip level, level 0 is the base level
+struct KTXv2LevelIndex
+{
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+};
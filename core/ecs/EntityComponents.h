@@ -0,0 +1,86 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __AX_ENTITY_COMPONENTS_H__
+#define __AX_ENTITY_COMPONENTS_H__
+
+#include "base/Config.h"
+#if AX_USE_ECS
+
+#    include "base/Types.h"
+#    include "math/Vec2.h"
+
+NS_AX_BEGIN
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** Placement of an entity in the space of its EntityLayer. */
+struct EntityTransform
+{
+    Vec2 position;
+    /** Clockwise rotation in degrees, as Node::setRotation(). */
+    float rotation = 0.0f;
+    Vec2 scale{1.0f, 1.0f};
+};
+
+/** Moves the EntityTransform of an entity, applied by the "movement" system of EntityLayer. */
+struct EntityVelocity
+{
+    /** Points per second. */
+    Vec2 linear;
+    /** Clockwise degrees per second. */
+    float angular = 0.0f;
+};
+
+/** A textured quad drawn by EntityLayer, see EntityLayer::createSprite(). */
+struct EntitySprite
+{
+    /** Size of the quad in points, before the scale of the EntityTransform. */
+    Vec2 size;
+    Vec2 anchorPoint{0.5f, 0.5f};
+    /** Texture coordinates of the left, top, right and bottom edges. */
+    float uvLeft   = 0.0f;
+    float uvTop    = 0.0f;
+    float uvRight  = 1.0f;
+    float uvBottom = 1.0f;
+    Color4B color  = Color4B::WHITE;
+    /** Index of the texture registered with EntityLayer::addTexture(). */
+    uint16_t texture = 0;
+    /** The sprite frame is stored rotated by 90 degrees in the texture. */
+    bool rotated = false;
+    bool visible = true;
+};
+
+// end of _2d group
+/// @}
+
+NS_AX_END
+
+#endif  // AX_USE_ECS
+
+#endif  // __AX_ENTITY_COMPONENTS_H__
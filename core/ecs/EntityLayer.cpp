@@ -0,0 +1,404 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "ecs/EntityLayer.h"
+
+#if AX_USE_ECS
+
+#    include <math.h>
+#    include <algorithm>
+
+#    include "2d/SpriteFrame.h"
+#    include "base/Director.h"
+#    include "base/JobSystem.h"
+#    include "renderer/Texture2D.h"
+#    include "renderer/backend/ProgramState.h"
+#    include "renderer/backend/ProgramStateRegistry.h"
+
+NS_AX_BEGIN
+
+static_assert(EntityLayer::MAX_QUADS_PER_COMMAND * 4 < Renderer::VBO_SIZE &&
+                  EntityLayer::MAX_QUADS_PER_COMMAND * 6 < Renderer::INDEX_VBO_SIZE,
+              "a full command must fit the renderer's buffers");
+
+namespace
+{
+const uint32_t HIDDEN_QUAD = UINT32_MAX;
+
+// Shared by all commands, every batch starts its vertices at quad 0
+unsigned short* getQuadIndices()
+{
+    static std::vector<unsigned short> indices = [] {
+        std::vector<unsigned short> result(EntityLayer::MAX_QUADS_PER_COMMAND * 6);
+        for (uint32_t i = 0; i < EntityLayer::MAX_QUADS_PER_COMMAND; ++i)
+        {
+            const auto v      = static_cast<unsigned short>(i * 4);
+            result[i * 6 + 0] = v + 0;
+            result[i * 6 + 1] = v + 1;
+            result[i * 6 + 2] = v + 2;
+            result[i * 6 + 3] = v + 3;
+            result[i * 6 + 4] = v + 2;
+            result[i * 6 + 5] = v + 1;
+        }
+        return result;
+    }();
+    return indices.data();
+}
+
+// Writes the quad in the tl, bl, tr, br order of V3F_C4B_T2F_Quad
+void fillQuad(V3F_C4B_T2F* quad, const EntityTransform& transform, const EntitySprite& sprite, const Color4B& color)
+{
+    const float width  = sprite.size.x * transform.scale.x;
+    const float height = sprite.size.y * transform.scale.y;
+    const float x0     = -sprite.anchorPoint.x * width;
+    const float y0     = -sprite.anchorPoint.y * height;
+    const float x1     = x0 + width;
+    const float y1     = y0 + height;
+
+    float c = 1.0f, s = 0.0f;
+    if (transform.rotation != 0.0f)
+    {
+        const float radians = -AX_DEGREES_TO_RADIANS(transform.rotation);
+        c                   = cosf(radians);
+        s                   = sinf(radians);
+    }
+
+    const float px = transform.position.x;
+    const float py = transform.position.y;
+    quad[0].vertices.set(px + x0 * c - y1 * s, py + x0 * s + y1 * c, 0.0f);
+    quad[1].vertices.set(px + x0 * c - y0 * s, py + x0 * s + y0 * c, 0.0f);
+    quad[2].vertices.set(px + x1 * c - y1 * s, py + x1 * s + y1 * c, 0.0f);
+    quad[3].vertices.set(px + x1 * c - y0 * s, py + x1 * s + y0 * c, 0.0f);
+
+    if (sprite.rotated)
+    {
+        quad[0].texCoords.set(sprite.uvRight, sprite.uvTop);
+        quad[1].texCoords.set(sprite.uvLeft, sprite.uvTop);
+        quad[2].texCoords.set(sprite.uvRight, sprite.uvBottom);
+        quad[3].texCoords.set(sprite.uvLeft, sprite.uvBottom);
+    }
+    else
+    {
+        quad[0].texCoords.set(sprite.uvLeft, sprite.uvTop);
+        quad[1].texCoords.set(sprite.uvLeft, sprite.uvBottom);
+        quad[2].texCoords.set(sprite.uvRight, sprite.uvTop);
+        quad[3].texCoords.set(sprite.uvRight, sprite.uvBottom);
+    }
+
+    quad[0].colors = quad[1].colors = quad[2].colors = quad[3].colors = color;
+}
+}  // namespace
+
+EntityLayer* EntityLayer::create()
+{
+    EntityLayer* layer = new (std::nothrow) EntityLayer();
+    if (layer && layer->init())
+    {
+        layer->autorelease();
+        return layer;
+    }
+    AX_SAFE_DELETE(layer);
+    return nullptr;
+}
+
+EntityLayer::EntityLayer() {}
+
+EntityLayer::~EntityLayer()
+{
+    for (auto& slot : _textures)
+    {
+        AX_SAFE_RELEASE(slot.programState);
+        AX_SAFE_RELEASE(slot.texture);
+    }
+}
+
+bool EntityLayer::init()
+{
+    if (!Node::init())
+        return false;
+
+    _world.addEachSystem<EntityTransform, const EntityVelocity>(
+        "movement", [](Entity, EntityTransform& transform, const EntityVelocity& velocity, float dt) {
+            transform.position += velocity.linear * dt;
+            transform.rotation += velocity.angular * dt;
+        });
+    return true;
+}
+
+void EntityLayer::onEnter()
+{
+    Node::onEnter();
+    scheduleUpdate();
+}
+
+void EntityLayer::onExit()
+{
+    unscheduleUpdate();
+    Node::onExit();
+}
+
+void EntityLayer::update(float dt)
+{
+    _world.update(dt);
+}
+
+uint16_t EntityLayer::addTexture(Texture2D* texture)
+{
+    AXASSERT(texture, "EntityLayer: texture should not be nullptr");
+    return addTexture(texture, texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED
+                                                                : BlendFunc::ALPHA_NON_PREMULTIPLIED);
+}
+
+uint16_t EntityLayer::addTexture(Texture2D* texture, const BlendFunc& blendFunc)
+{
+    AXASSERT(texture, "EntityLayer: texture should not be nullptr");
+    for (size_t i = 0; i < _textures.size(); ++i)
+    {
+        if (_textures[i].texture == texture && _textures[i].blendFunc == blendFunc)
+            return static_cast<uint16_t>(i);
+    }
+    AXASSERT(_textures.size() < UINT16_MAX, "EntityLayer: too many textures");
+
+    TextureSlot slot;
+    slot.texture      = texture;
+    slot.blendFunc    = blendFunc;
+    slot.programState = backend::ProgramStateRegistry::getInstance()->newProgramState(
+        backend::ProgramType::POSITION_TEXTURE_COLOR, texture->getSamplerFlags());
+    slot.programState->validateSharedVertexLayout(backend::VertexLayoutType::Sprite);
+    slot.programState->setTexture(texture->getBackendTexture());
+    texture->retain();
+
+    _textures.emplace_back(slot);
+    return static_cast<uint16_t>(_textures.size() - 1);
+}
+
+Texture2D* EntityLayer::getTexture(uint16_t index) const
+{
+    return index < _textures.size() ? _textures[index].texture : nullptr;
+}
+
+EntitySprite EntityLayer::createSprite(Texture2D* texture)
+{
+    AXASSERT(texture, "EntityLayer: texture should not be nullptr");
+    return createSprite(texture, Rect(Vec2::ZERO, texture->getContentSize()));
+}
+
+EntitySprite EntityLayer::createSprite(Texture2D* texture, const Rect& rect, bool rotated)
+{
+    AXASSERT(texture, "EntityLayer: texture should not be nullptr");
+
+    EntitySprite sprite;
+    sprite.texture = addTexture(texture);
+    sprite.size    = rect.size;
+    sprite.rotated = rotated;
+
+    // same mapping as Sprite::setTextureCoords(), rotated rects are stored with width and height swapped
+    const auto rectInPixels = AX_RECT_POINTS_TO_PIXELS(rect);
+    const float atlasWidth  = static_cast<float>(texture->getPixelsWide());
+    const float atlasHeight = static_cast<float>(texture->getPixelsHigh());
+    float rw                = rectInPixels.size.width;
+    float rh                = rectInPixels.size.height;
+    if (rotated)
+        std::swap(rw, rh);
+
+    sprite.uvLeft   = rectInPixels.origin.x / atlasWidth;
+    sprite.uvRight  = (rectInPixels.origin.x + rw) / atlasWidth;
+    sprite.uvTop    = rectInPixels.origin.y / atlasHeight;
+    sprite.uvBottom = (rectInPixels.origin.y + rh) / atlasHeight;
+    return sprite;
+}
+
+EntitySprite EntityLayer::createSprite(SpriteFrame* spriteFrame)
+{
+    AXASSERT(spriteFrame, "EntityLayer: sprite frame should not be nullptr");
+
+    auto sprite = createSprite(spriteFrame->getTexture(), spriteFrame->getRect(), spriteFrame->isRotated());
+
+    // the offset moves the trimmed rect away from the center of the untrimmed frame
+    const auto& offset = spriteFrame->getOffset();
+    if (sprite.size.x > 0.0f)
+        sprite.anchorPoint.x -= offset.x / sprite.size.x;
+    if (sprite.size.y > 0.0f)
+        sprite.anchorPoint.y -= offset.y / sprite.size.y;
+    return sprite;
+}
+
+void EntityLayer::buildQuads()
+{
+    struct Chunk
+    {
+        size_t count;
+        size_t first;
+        const EntityTransform* transforms;
+        const EntitySprite* sprites;
+    };
+
+    std::vector<Chunk> chunks;
+    size_t total = 0;
+    _world.eachChunk<const EntityTransform, const EntitySprite>(
+        [&](size_t count, const Entity*, const EntityTransform* transforms, const EntitySprite* sprites) {
+            chunks.push_back(Chunk{count, total, transforms, sprites});
+            total += count;
+        });
+
+    // assign every visible sprite its quad, sequentially since the quads of a batch have to be contiguous
+    const auto textureCount = _textures.size();
+    _quadIndices.resize(total);
+    _batches.clear();
+    uint32_t quadCount = 0;
+    if (_sortByTexture)
+    {
+        std::vector<uint32_t> offsets(textureCount, 0);
+        for (auto& chunk : chunks)
+        {
+            for (size_t i = 0; i < chunk.count; ++i)
+            {
+                const auto& sprite = chunk.sprites[i];
+                if (sprite.visible && sprite.texture < textureCount)
+                    ++offsets[sprite.texture];
+            }
+        }
+
+        for (size_t texture = 0; texture < textureCount; ++texture)
+        {
+            const auto count = offsets[texture];
+            offsets[texture] = quadCount;
+            for (uint32_t done = 0; done < count; done += MAX_QUADS_PER_COMMAND)
+                _batches.push_back(Batch{static_cast<uint16_t>(texture), quadCount + done,
+                                         std::min(count - done, MAX_QUADS_PER_COMMAND)});
+            quadCount += count;
+        }
+
+        for (auto& chunk : chunks)
+        {
+            for (size_t i = 0; i < chunk.count; ++i)
+            {
+                const auto& sprite               = chunk.sprites[i];
+                _quadIndices[chunk.first + i] = (sprite.visible && sprite.texture < textureCount)
+                                                    ? offsets[sprite.texture]++
+                                                    : HIDDEN_QUAD;
+            }
+        }
+    }
+    else
+    {
+        for (auto& chunk : chunks)
+        {
+            for (size_t i = 0; i < chunk.count; ++i)
+            {
+                const auto& sprite = chunk.sprites[i];
+                if (!sprite.visible || sprite.texture >= textureCount)
+                {
+                    _quadIndices[chunk.first + i] = HIDDEN_QUAD;
+                    continue;
+                }
+                if (_batches.empty() || _batches.back().texture != sprite.texture ||
+                    _batches.back().quadCount == MAX_QUADS_PER_COMMAND)
+                    _batches.push_back(Batch{sprite.texture, quadCount, 0});
+                ++_batches.back().quadCount;
+                _quadIndices[chunk.first + i] = quadCount++;
+            }
+        }
+    }
+
+    _quadCount = quadCount;
+    _vertices.resize(static_cast<size_t>(quadCount) * 4);
+    if (quadCount == 0)
+        return;
+
+    const float r = _displayedColor.r / 255.0f;
+    const float g = _displayedColor.g / 255.0f;
+    const float b = _displayedColor.b / 255.0f;
+    const float a = _displayedOpacity / 255.0f;
+
+    auto jobSystem = JobSystem::getInstance();
+    for (auto& chunk : chunks)
+    {
+        jobSystem->parallelFor(chunk.count, EntityWorld::PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto quad = _quadIndices[chunk.first + i];
+                if (quad == HIDDEN_QUAD)
+                    continue;
+
+                const auto& sprite = chunk.sprites[i];
+                Color4B color(static_cast<uint8_t>(sprite.color.r * r), static_cast<uint8_t>(sprite.color.g * g),
+                              static_cast<uint8_t>(sprite.color.b * b), static_cast<uint8_t>(sprite.color.a * a));
+                if (_textures[sprite.texture].blendFunc == BlendFunc::ALPHA_PREMULTIPLIED)
+                {
+                    color.r = static_cast<uint8_t>(color.r * color.a / 255);
+                    color.g = static_cast<uint8_t>(color.g * color.a / 255);
+                    color.b = static_cast<uint8_t>(color.b * color.a / 255);
+                }
+                fillQuad(&_vertices[static_cast<size_t>(quad) * 4], chunk.transforms[i], sprite, color);
+            }
+        });
+    }
+}
+
+void EntityLayer::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    // drawn once per camera, the quads are only built by the first draw of a frame
+    const auto frame = _director->getTotalFrames();
+    if (_quadFrame != frame)
+    {
+        _quadFrame = frame;
+        buildQuads();
+    }
+
+    if (_batches.empty())
+        return;
+
+    const auto& projectionMat = _director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    for (auto& slot : _textures)
+    {
+        auto location = slot.programState->getUniformLocation(backend::Uniform::MVP_MATRIX);
+        slot.programState->setUniform(location, projectionMat.m, sizeof(projectionMat.m));
+    }
+
+    while (_commands.size() < _batches.size())
+        _commands.emplace_back(std::make_unique<TrianglesCommand>());
+
+    auto indices = getQuadIndices();
+    for (size_t i = 0, n = _batches.size(); i < n; ++i)
+    {
+        const auto& batch = _batches[i];
+        const auto& slot  = _textures[batch.texture];
+        if (slot.texture->getBackendTexture() == nullptr)
+            continue;
+
+        auto& command                                  = *_commands[i];
+        command.getPipelineDescriptor().programState = slot.programState;
+        command.init(_globalZOrder, slot.texture, slot.blendFunc,
+                     TrianglesCommand::Triangles(&_vertices[static_cast<size_t>(batch.firstQuad) * 4], indices,
+                                                 batch.quadCount * 4, batch.quadCount * 6),
+                     transform, flags);
+        renderer->addCommand(&command);
+    }
+}
+
+NS_AX_END
+
+#endif  // AX_USE_ECS
@@ -0,0 +1,161 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __AX_ENTITY_LAYER_H__
+#define __AX_ENTITY_LAYER_H__
+
+#include "base/Config.h"
+#if AX_USE_ECS
+
+#    include <limits.h>
+#    include <memory>
+#    include <vector>
+
+#    include "2d/Node.h"
+#    include "ecs/EntityComponents.h"
+#    include "ecs/EntityWorld.h"
+#    include "renderer/Renderer.h"
+#    include "renderer/TrianglesCommand.h"
+
+NS_AX_BEGIN
+
+class SpriteFrame;
+class Texture2D;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/**
+ * @class EntityLayer
+ * @brief A Node which owns an EntityWorld and draws its sprite entities.
+ *
+ * The layer can be added under any Node, entities are placed in its coordinate space so they follow the
+ * transform, visibility, camera mask and global z order of the layer like children would, without a Node,
+ * a scheduler entry and a draw call per object.
+ *
+ * The world is updated with the layer's update(), the "movement" system applies EntityVelocity to EntityTransform.
+ * Entities which have an EntityTransform and an EntitySprite are drawn once per frame by a single render pass,
+ * which fills the quads in parallel and emits one TrianglesCommand per texture, split so no command has more than
+ * MAX_QUADS_PER_COMMAND quads. Those commands still batch with the sprites drawn before and after the layer. Sprites
+ * aren't culled.
+ * @js NA
+ */
+class AX_DLL EntityLayer : public Node
+{
+public:
+    /** Max quads of one TrianglesCommand, the renderer requires a command to have fewer than VBO_SIZE vertices. */
+    static const uint32_t MAX_QUADS_PER_COMMAND = (Renderer::VBO_SIZE - 1) / 4;
+
+    static EntityLayer* create();
+
+    EntityWorld& getWorld() { return _world; }
+    const EntityWorld& getWorld() const { return _world; }
+
+    /**
+     * Registers a texture for EntitySprite::texture, the blend function is picked from its premultiplied alpha.
+     * Registering the same texture again returns the existing index.
+     */
+    uint16_t addTexture(Texture2D* texture);
+    uint16_t addTexture(Texture2D* texture, const BlendFunc& blendFunc);
+    Texture2D* getTexture(uint16_t index) const;
+    size_t getTextureCount() const { return _textures.size(); }
+
+    /** Makes a sprite component showing a whole texture. */
+    EntitySprite createSprite(Texture2D* texture);
+
+    /** Makes a sprite component showing a rect of a texture, in points. */
+    EntitySprite createSprite(Texture2D* texture, const Rect& rect, bool rotated = false);
+
+    /** Makes a sprite component showing a sprite frame, trimmed frames keep their untrimmed center as anchor. */
+    EntitySprite createSprite(SpriteFrame* spriteFrame);
+
+    /**
+     * Sets whether the sprites are grouped by texture when drawn. Enabled by default, sprites of one texture keep
+     * their relative order but are drawn in the order the textures were added. When disabled the sprites are drawn
+     * in storage order, which changes when entities are destroyed or change components.
+     */
+    void setSortByTexture(bool sortByTexture) { _sortByTexture = sortByTexture; }
+    bool isSortByTexture() const { return _sortByTexture; }
+
+    /** Gets the number of sprites drawn in the last frame. */
+    size_t getDrawnSpriteCount() const { return _quadCount; }
+
+    /** Gets the number of TrianglesCommands emitted in the last frame. */
+    size_t getDrawCommandCount() const { return _batches.size(); }
+
+    // Overrides
+    void update(float dt) override;
+    void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override;
+    void onEnter() override;
+    void onExit() override;
+
+    EntityLayer();
+    ~EntityLayer() override;
+
+    bool init() override;
+
+protected:
+    struct TextureSlot
+    {
+        Texture2D* texture                  = nullptr;
+        BlendFunc blendFunc                 = BlendFunc::ALPHA_PREMULTIPLIED;
+        backend::ProgramState* programState = nullptr;
+    };
+
+    struct Batch
+    {
+        uint16_t texture   = 0;
+        uint32_t firstQuad = 0;
+        uint32_t quadCount = 0;
+    };
+
+    /** Fills the quads and batches of the current frame. */
+    void buildQuads();
+
+    EntityWorld _world;
+    std::vector<TextureSlot> _textures;
+
+    std::vector<V3F_C4B_T2F> _vertices;
+    std::vector<uint32_t> _quadIndices;
+    std::vector<Batch> _batches;
+    std::vector<std::unique_ptr<TrianglesCommand>> _commands;
+    size_t _quadCount       = 0;
+    unsigned int _quadFrame = UINT_MAX;
+    bool _sortByTexture     = true;
+
+private:
+    AX_DISALLOW_COPY_AND_ASSIGN(EntityLayer);
+};
+
+// end of _2d group
+/// @}
+
+NS_AX_END
+
+#endif  // AX_USE_ECS
+
+#endif  // __AX_ENTITY_LAYER_H__
@@ -0,0 +1,397 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "ecs/EntityWorld.h"
+
+#if AX_USE_ECS
+
+#    include <string.h>
+#    include <algorithm>
+#    include <new>
+#    include <typeindex>
+
+NS_AX_BEGIN
+
+namespace
+{
+struct ComponentTypeRegistry
+{
+    std::mutex mutex;
+    std::unordered_map<std::type_index, uint32_t> ids;
+    size_t sizes[EntityWorld::MAX_COMPONENT_TYPES] = {};
+    uint32_t count                                 = 0;
+};
+
+// Looked up by type_index rather than a per template counter, so a component type gets the same id in the engine
+// library and in the modules linking it.
+ComponentTypeRegistry& getComponentTypeRegistry()
+{
+    static ComponentTypeRegistry* registry = new ComponentTypeRegistry();
+    return *registry;
+}
+}  // namespace
+
+uint32_t EntityWorld::registerComponentType(const std::type_info& type, size_t size, size_t alignment)
+{
+    AXASSERT(alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "EntityWorld: component alignment isn't supported");
+
+    auto& registry = getComponentTypeRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.ids.find(std::type_index(type));
+    if (it != registry.ids.end())
+        return it->second;
+
+    AXASSERT(registry.count < MAX_COMPONENT_TYPES, "EntityWorld: too many component types");
+    auto id                = registry.count++;
+    registry.sizes[id]     = size;
+    registry.ids.emplace(std::type_index(type), id);
+    return id;
+}
+
+size_t EntityWorld::getComponentSize(uint32_t type)
+{
+    return getComponentTypeRegistry().sizes[type];
+}
+
+EntityWorld::EntityWorld()
+{
+    // archetype 0 holds the entities without components
+    findOrCreateArchetype(0);
+}
+
+EntityWorld::~EntityWorld() {}
+
+Entity EntityWorld::createEntity()
+{
+    return allocateEntity(0);
+}
+
+void EntityWorld::destroyEntity(Entity entity)
+{
+    AXASSERT(!_runningSystems, "EntityWorld: use defer() to destroy entities while systems are running");
+    if (!isAlive(entity))
+        return;
+
+    auto& record = _records[entity.index];
+    removeRow(*_archetypes[record.archetype], record.row);
+
+    record.archetype = INVALID_ARCHETYPE;
+    if (++record.generation == 0)
+        record.generation = 1;
+    _freeIndices.emplace_back(entity.index);
+    --_entityCount;
+}
+
+bool EntityWorld::isAlive(Entity entity) const
+{
+    return entity.index < _records.size() && _records[entity.index].generation == entity.generation &&
+           _records[entity.index].archetype != INVALID_ARCHETYPE;
+}
+
+void EntityWorld::clear()
+{
+    AXASSERT(!_runningSystems, "EntityWorld: use defer() to clear the world while systems are running");
+    for (auto& archetype : _archetypes)
+    {
+        for (auto& entity : archetype->entities)
+        {
+            auto& record     = _records[entity.index];
+            record.archetype = INVALID_ARCHETYPE;
+            if (++record.generation == 0)
+                record.generation = 1;
+            _freeIndices.emplace_back(entity.index);
+        }
+        archetype->entities.clear();
+        for (auto& column : archetype->columns)
+            column.clear();
+    }
+    _entityCount = 0;
+}
+
+void EntityWorld::defer(std::function<void(EntityWorld& world)> command)
+{
+    std::lock_guard<std::mutex> lock(_deferredMutex);
+    _deferred.emplace_back(std::move(command));
+}
+
+void EntityWorld::flushDeferred()
+{
+    std::vector<std::function<void(EntityWorld&)>> commands;
+    for (;;)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_deferredMutex);
+            if (_deferred.empty())
+                break;
+            commands.swap(_deferred);
+        }
+        // commands may defer more commands
+        for (auto& command : commands)
+            command(*this);
+        commands.clear();
+    }
+}
+
+void EntityWorld::addSystem(std::string_view name, ComponentMask reads, ComponentMask writes, SystemFunc func)
+{
+    AXASSERT(!_updating, "EntityWorld: systems can't be changed during update");
+    AXASSERT(!findSystem(name), "EntityWorld: system already exists");
+
+    System system;
+    system.name   = name;
+    system.reads  = reads;
+    system.writes = writes;
+    system.func   = std::move(func);
+    _systems.emplace_back(std::move(system));
+    _stagesDirty = true;
+}
+
+bool EntityWorld::removeSystem(std::string_view name)
+{
+    AXASSERT(!_updating, "EntityWorld: systems can't be changed during update");
+
+    auto it = std::find_if(_systems.begin(), _systems.end(), [&](const System& s) { return s.name == name; });
+    if (it == _systems.end())
+        return false;
+
+    _systems.erase(it);
+    _stagesDirty = true;
+    return true;
+}
+
+bool EntityWorld::hasSystem(std::string_view name) const
+{
+    return findSystem(name) != nullptr;
+}
+
+void EntityWorld::setSystemEnabled(std::string_view name, bool enabled)
+{
+    AXASSERT(!_updating, "EntityWorld: systems can't be changed during update");
+
+    auto system = findSystem(name);
+    if (system && system->enabled != enabled)
+    {
+        system->enabled = enabled;
+        _stagesDirty    = true;
+    }
+}
+
+bool EntityWorld::isSystemEnabled(std::string_view name) const
+{
+    auto system = findSystem(name);
+    return system && system->enabled;
+}
+
+void EntityWorld::update(float dt)
+{
+    if (_stagesDirty)
+    {
+        buildStages();
+        _stagesDirty = false;
+    }
+
+    flushDeferred();
+
+    _updating = true;
+    for (auto& stage : _stages)
+    {
+        _runningSystems = true;
+        if (stage.size() == 1)
+        {
+            _systems[stage[0]].func(*this, dt);
+        }
+        else
+        {
+            JobSystem::getInstance()->parallelFor(stage.size(), 1, [&](size_t begin, size_t end) {
+                for (auto i = begin; i < end; ++i)
+                    _systems[stage[i]].func(*this, dt);
+            });
+        }
+        _runningSystems = false;
+        flushDeferred();
+    }
+    _updating = false;
+}
+
+uint32_t EntityWorld::findOrCreateArchetype(ComponentMask mask)
+{
+    auto it = _archetypeIndices.find(mask);
+    if (it != _archetypeIndices.end())
+        return it->second;
+
+    auto archetype  = std::make_unique<Archetype>();
+    archetype->mask = mask;
+    memset(archetype->columnIndices, -1, sizeof(archetype->columnIndices));
+    for (uint32_t type = 0; type < MAX_COMPONENT_TYPES; ++type)
+    {
+        if (!(mask & (ComponentMask(1) << type)))
+            continue;
+        archetype->columnIndices[type] = static_cast<int8_t>(archetype->types.size());
+        archetype->types.emplace_back(type);
+        archetype->sizes.emplace_back(static_cast<uint32_t>(getComponentSize(type)));
+    }
+    archetype->columns.resize(archetype->types.size());
+
+    auto index = static_cast<uint32_t>(_archetypes.size());
+    _archetypes.emplace_back(std::move(archetype));
+    _archetypeIndices.emplace(mask, index);
+    return index;
+}
+
+Entity EntityWorld::allocateEntity(uint32_t archetype)
+{
+    AXASSERT(!_runningSystems, "EntityWorld: use defer() to create entities while systems are running");
+    Entity entity;
+    if (!_freeIndices.empty())
+    {
+        entity.index = _freeIndices.back();
+        _freeIndices.pop_back();
+    }
+    else
+    {
+        entity.index = static_cast<uint32_t>(_records.size());
+        _records.emplace_back().generation = 1;
+    }
+
+    auto& record      = _records[entity.index];
+    entity.generation = record.generation;
+    record.archetype  = archetype;
+    record.row        = appendRow(*_archetypes[archetype], entity);
+    ++_entityCount;
+    return entity;
+}
+
+uint32_t EntityWorld::appendRow(Archetype& archetype, Entity entity)
+{
+    auto row = static_cast<uint32_t>(archetype.entities.size());
+    archetype.entities.emplace_back(entity);
+    for (size_t i = 0, n = archetype.columns.size(); i < n; ++i)
+        archetype.columns[i].resize(archetype.columns[i].size() + archetype.sizes[i]);
+    return row;
+}
+
+void EntityWorld::removeRow(Archetype& archetype, uint32_t row)
+{
+    auto last = static_cast<uint32_t>(archetype.entities.size() - 1);
+    if (row != last)
+    {
+        // swap the last row in to keep the columns packed
+        for (size_t i = 0, n = archetype.columns.size(); i < n; ++i)
+        {
+            auto size = archetype.sizes[i];
+            auto data = archetype.columns[i].data();
+            memcpy(data + row * size, data + last * size, size);
+        }
+        auto moved                = archetype.entities[last];
+        archetype.entities[row]   = moved;
+        _records[moved.index].row = row;
+    }
+
+    archetype.entities.pop_back();
+    for (size_t i = 0, n = archetype.columns.size(); i < n; ++i)
+        archetype.columns[i].resize(archetype.columns[i].size() - archetype.sizes[i]);
+}
+
+void EntityWorld::moveEntity(Entity entity, uint32_t archetype)
+{
+    AXASSERT(!_runningSystems, "EntityWorld: use defer() to add or remove components while systems are running");
+    auto& record = _records[entity.index];
+    auto& from   = *_archetypes[record.archetype];
+    auto& to     = *_archetypes[archetype];
+
+    auto row = appendRow(to, entity);
+    for (size_t i = 0, n = to.types.size(); i < n; ++i)
+    {
+        auto column = from.columnIndices[to.types[i]];
+        if (column >= 0)
+            memcpy(to.columns[i].data() + row * to.sizes[i], from.columns[column].data() + record.row * to.sizes[i],
+                   to.sizes[i]);
+    }
+    removeRow(from, record.row);
+
+    record.archetype = archetype;
+    record.row       = row;
+}
+
+void* EntityWorld::getComponentData(Entity entity, uint32_t type) const
+{
+    if (!isAlive(entity))
+        return nullptr;
+
+    const auto& record    = _records[entity.index];
+    const auto& archetype = *_archetypes[record.archetype];
+    auto column           = archetype.columnIndices[type];
+    if (column < 0)
+        return nullptr;
+    return const_cast<uint8_t*>(archetype.columns[column].data()) + record.row * archetype.sizes[column];
+}
+
+EntityWorld::System* EntityWorld::findSystem(std::string_view name)
+{
+    for (auto& system : _systems)
+    {
+        if (system.name == name)
+            return &system;
+    }
+    return nullptr;
+}
+
+const EntityWorld::System* EntityWorld::findSystem(std::string_view name) const
+{
+    return const_cast<EntityWorld*>(this)->findSystem(name);
+}
+
+void EntityWorld::buildStages()
+{
+    _stages.clear();
+
+    ComponentMask stageReads  = 0;
+    ComponentMask stageWrites = 0;
+    bool stageExclusive       = false;
+    for (uint32_t i = 0, n = static_cast<uint32_t>(_systems.size()); i < n; ++i)
+    {
+        const auto& system = _systems[i];
+        if (!system.enabled)
+            continue;
+
+        // a system without declared access may touch anything, it runs alone
+        const bool exclusive = system.reads == 0 && system.writes == 0;
+        const bool conflict  = (system.writes & (stageReads | stageWrites)) || (system.reads & stageWrites);
+        if (_stages.empty() || exclusive || stageExclusive || conflict)
+        {
+            _stages.emplace_back();
+            stageReads     = 0;
+            stageWrites    = 0;
+            stageExclusive = exclusive;
+        }
+        _stages.back().emplace_back(i);
+        stageReads |= system.reads;
+        stageWrites |= system.writes;
+    }
+}
+
+NS_AX_END
+
+#endif  // AX_USE_ECS
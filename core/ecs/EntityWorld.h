@@ -0,0 +1,416 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Bytedance Inc.
+
+ https://axmolengine.github.io/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __AX_ENTITY_WORLD_H__
+#define __AX_ENTITY_WORLD_H__
+
+#include "base/Config.h"
+#if AX_USE_ECS
+
+#    include <stdint.h>
+#    include <functional>
+#    include <memory>
+#    include <mutex>
+#    include <string>
+#    include <string_view>
+#    include <tuple>
+#    include <type_traits>
+#    include <typeinfo>
+#    include <unordered_map>
+#    include <vector>
+
+#    include "platform/PlatformMacros.h"
+#    include "base/JobSystem.h"
+#    include "base/Macros.h"
+
+NS_AX_BEGIN
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+/** Handle of an entity in an EntityWorld, a default constructed handle is never alive. */
+struct Entity
+{
+    uint32_t index      = 0;
+    uint32_t generation = 0;
+
+    bool isValid() const { return generation != 0; }
+    bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+/** One bit per component type, see EntityWorld::getComponentMask(). */
+typedef uint64_t ComponentMask;
+
+/**
+ * @class EntityWorld
+ * @brief An archetype based entity component store for large numbers of homogeneous objects.
+ *
+ * Entities with the same set of components share an archetype, which stores every component type in its own
+ * contiguous column, so systems walk plain arrays instead of virtual Node::update calls. Components must be
+ * trivially copyable, they are moved between archetypes with memcpy.
+ *
+ * Systems declare the components they read and write, update() runs the systems in registration order but
+ * groups consecutive systems without conflicting access into stages that run in parallel on the JobSystem.
+ * Creating or destroying entities and adding or removing components isn't allowed while a query or a system is
+ * running, use defer() instead, deferred commands run on the calling thread between stages.
+ *
+ * Component pointers are invalidated by any structural change.
+ * @js NA
+ */
+class AX_DLL EntityWorld
+{
+public:
+    static const uint32_t MAX_COMPONENT_TYPES = 64;
+
+    /** Default number of entities per job of the parallel queries. */
+    static const size_t PARALLEL_GRAIN = 1024;
+
+    typedef std::function<void(EntityWorld& world, float dt)> SystemFunc;
+
+    /** Gets the id of a component type, const qualified types share the id of the unqualified type. */
+    template <typename T>
+    static uint32_t getComponentTypeId();
+
+    /** Gets the mask of a set of component types. */
+    template <typename... Ts>
+    static ComponentMask getComponentMask();
+
+    EntityWorld();
+    ~EntityWorld();
+
+    EntityWorld(const EntityWorld&)            = delete;
+    EntityWorld& operator=(const EntityWorld&) = delete;
+
+    /** Creates an entity without components. */
+    Entity createEntity();
+
+    /** Creates an entity with the given components. */
+    template <typename... Ts>
+    Entity createEntity(const Ts&... components);
+
+    /** Destroys an entity, the handle and copies of it are no longer alive. */
+    void destroyEntity(Entity entity);
+
+    bool isAlive(Entity entity) const;
+
+    /** Destroys all entities, systems are kept. */
+    void clear();
+
+    size_t getEntityCount() const { return _entityCount; }
+
+    template <typename T>
+    bool hasComponent(Entity entity) const;
+
+    /** Gets a component of an entity, nullptr if the entity doesn't have it. */
+    template <typename T>
+    T* getComponent(Entity entity);
+
+    template <typename T>
+    const T* getComponent(Entity entity) const;
+
+    /** Adds a component to an entity or overwrites the existing one. */
+    template <typename T>
+    T& addComponent(Entity entity, const T& component = T());
+
+    template <typename T>
+    void removeComponent(Entity entity);
+
+    /**
+     * Invokes `func(size_t count, const Entity* entities, Ts*... columns)` for every archetype which has all of
+     * the components Ts.
+     */
+    template <typename... Ts, typename F>
+    void eachChunk(F&& func);
+
+    /** Same as eachChunk() but splits the archetypes into ranges of `grain` entities run on the JobSystem. */
+    template <typename... Ts, typename F>
+    void parallelEachChunk(F&& func, size_t grain = PARALLEL_GRAIN);
+
+    /** Invokes `func(Entity entity, Ts&... components)` for every entity which has all of the components Ts. */
+    template <typename... Ts, typename F>
+    void each(F&& func);
+
+    template <typename... Ts, typename F>
+    void parallelEach(F&& func, size_t grain = PARALLEL_GRAIN);
+
+    /** Gets the number of entities which have all of the components Ts. */
+    template <typename... Ts>
+    size_t count() const;
+
+    /** Queues a structural change, thread safe. */
+    void defer(std::function<void(EntityWorld& world)> command);
+
+    /** Runs the queued structural changes on the calling thread. */
+    void flushDeferred();
+
+    /**
+     * Adds a system, systems run in the order they were added.
+     *
+     * @param name The name of the system, unique in the world.
+     * @param reads The components the system only reads.
+     * @param writes The components the system writes. A system which declares no access at all runs alone.
+     * @param func The system, invoked with the world and the delta time. It may run on a worker thread.
+     */
+    void addSystem(std::string_view name, ComponentMask reads, ComponentMask writes, SystemFunc func);
+
+    /**
+     * Adds a system which invokes `func(Entity entity, Ts&... components, float dt)` for every entity which has
+     * all of the components Ts, in parallel. Const qualified components are declared as read, the others as written.
+     */
+    template <typename... Ts, typename F>
+    void addEachSystem(std::string_view name, F&& func);
+
+    bool removeSystem(std::string_view name);
+    bool hasSystem(std::string_view name) const;
+    void setSystemEnabled(std::string_view name, bool enabled);
+    bool isSystemEnabled(std::string_view name) const;
+
+    /** Runs the enabled systems. */
+    void update(float dt);
+
+    /** Gets the number of stages the systems were scheduled in by the last update(). */
+    size_t getStageCount() const { return _stages.size(); }
+
+protected:
+    static constexpr uint32_t INVALID_ARCHETYPE = UINT32_MAX;
+
+    struct Archetype
+    {
+        ComponentMask mask = 0;
+        std::vector<uint32_t> types;
+        std::vector<uint32_t> sizes;
+        std::vector<std::vector<uint8_t>> columns;
+        std::vector<Entity> entities;
+        int8_t columnIndices[MAX_COMPONENT_TYPES];
+
+        template <typename T>
+        T* column()
+        {
+            return reinterpret_cast<T*>(columns[columnIndices[getComponentTypeId<T>()]].data());
+        }
+    };
+
+    struct Record
+    {
+        uint32_t generation = 0;
+        uint32_t archetype  = INVALID_ARCHETYPE;
+        uint32_t row        = 0;
+    };
+
+    struct System
+    {
+        std::string name;
+        ComponentMask reads  = 0;
+        ComponentMask writes = 0;
+        SystemFunc func;
+        bool enabled = true;
+    };
+
+    static uint32_t registerComponentType(const std::type_info& type, size_t size, size_t alignment);
+    static size_t getComponentSize(uint32_t type);
+
+    uint32_t findOrCreateArchetype(ComponentMask mask);
+    Entity allocateEntity(uint32_t archetype);
+    uint32_t appendRow(Archetype& archetype, Entity entity);
+    void removeRow(Archetype& archetype, uint32_t row);
+    void moveEntity(Entity entity, uint32_t archetype);
+    void* getComponentData(Entity entity, uint32_t type) const;
+    System* findSystem(std::string_view name);
+    const System* findSystem(std::string_view name) const;
+    void buildStages();
+
+    std::vector<std::unique_ptr<Archetype>> _archetypes;
+    std::unordered_map<ComponentMask, uint32_t> _archetypeIndices;
+    std::vector<Record> _records;
+    std::vector<uint32_t> _freeIndices;
+    size_t _entityCount = 0;
+
+    std::vector<System> _systems;
+    std::vector<std::vector<uint32_t>> _stages;
+    bool _stagesDirty    = true;
+    bool _updating       = false;
+    bool _runningSystems = false;  ///< structural changes must be deferred
+
+    std::mutex _deferredMutex;
+    std::vector<std::function<void(EntityWorld&)>> _deferred;
+};
+
+template <typename T>
+uint32_t EntityWorld::getComponentTypeId()
+{
+    typedef std::remove_cv_t<T> C;
+    static_assert(std::is_trivially_copyable<C>::value && std::is_trivially_destructible<C>::value,
+                  "components are moved with memcpy and never destructed");
+    static const uint32_t id = registerComponentType(typeid(C), sizeof(C), alignof(C));
+    return id;
+}
+
+template <typename... Ts>
+ComponentMask EntityWorld::getComponentMask()
+{
+    return (ComponentMask(0) | ... | (ComponentMask(1) << getComponentTypeId<Ts>()));
+}
+
+template <typename... Ts>
+Entity EntityWorld::createEntity(const Ts&... components)
+{
+    auto archetypeIndex = findOrCreateArchetype(getComponentMask<Ts...>());
+    auto entity         = allocateEntity(archetypeIndex);
+    auto& archetype     = *_archetypes[archetypeIndex];
+    auto row            = _records[entity.index].row;
+    ((archetype.template column<Ts>()[row] = components), ...);
+    return entity;
+}
+
+template <typename T>
+bool EntityWorld::hasComponent(Entity entity) const
+{
+    return getComponentData(entity, getComponentTypeId<T>()) != nullptr;
+}
+
+template <typename T>
+T* EntityWorld::getComponent(Entity entity)
+{
+    return static_cast<T*>(getComponentData(entity, getComponentTypeId<T>()));
+}
+
+template <typename T>
+const T* EntityWorld::getComponent(Entity entity) const
+{
+    return static_cast<const T*>(getComponentData(entity, getComponentTypeId<T>()));
+}
+
+template <typename T>
+T& EntityWorld::addComponent(Entity entity, const T& component)
+{
+    AXASSERT(isAlive(entity), "EntityWorld: entity isn't alive");
+    if (auto existing = getComponent<T>(entity))
+        return *existing = component;
+
+    const auto& record = _records[entity.index];
+    moveEntity(entity, findOrCreateArchetype(_archetypes[record.archetype]->mask | getComponentMask<T>()));
+    return _archetypes[record.archetype]->template column<T>()[record.row] = component;
+}
+
+template <typename T>
+void EntityWorld::removeComponent(Entity entity)
+{
+    if (!hasComponent<T>(entity))
+        return;
+
+    const auto& record = _records[entity.index];
+    moveEntity(entity, findOrCreateArchetype(_archetypes[record.archetype]->mask & ~getComponentMask<T>()));
+}
+
+template <typename... Ts, typename F>
+void EntityWorld::eachChunk(F&& func)
+{
+    const auto mask = getComponentMask<Ts...>();
+    for (auto& archetype : _archetypes)
+    {
+        if ((archetype->mask & mask) != mask || archetype->entities.empty())
+            continue;
+        func(archetype->entities.size(), archetype->entities.data(), archetype->template column<Ts>()...);
+    }
+}
+
+template <typename... Ts, typename F>
+void EntityWorld::parallelEachChunk(F&& func, size_t grain)
+{
+    const auto mask = getComponentMask<Ts...>();
+    for (auto& archetype : _archetypes)
+    {
+        const auto count = archetype->entities.size();
+        if ((archetype->mask & mask) != mask || count == 0)
+            continue;
+
+        auto entities = archetype->entities.data();
+        auto columns  = std::make_tuple(archetype->template column<Ts>()...);
+        if (count <= grain)
+        {
+            std::apply([&](auto... cols) { func(count, entities, cols...); }, columns);
+            continue;
+        }
+
+        JobSystem::getInstance()->parallelFor(count, grain, [&](size_t begin, size_t end) {
+            std::apply([&](auto... cols) { func(end - begin, entities + begin, (cols + begin)...); }, columns);
+        });
+    }
+}
+
+template <typename... Ts, typename F>
+void EntityWorld::each(F&& func)
+{
+    eachChunk<Ts...>([&](size_t count, const Entity* entities, Ts*... columns) {
+        for (size_t i = 0; i < count; ++i)
+            func(entities[i], columns[i]...);
+    });
+}
+
+template <typename... Ts, typename F>
+void EntityWorld::parallelEach(F&& func, size_t grain)
+{
+    parallelEachChunk<Ts...>(
+        [&](size_t count, const Entity* entities, Ts*... columns) {
+            for (size_t i = 0; i < count; ++i)
+                func(entities[i], columns[i]...);
+        },
+        grain);
+}
+
+template <typename... Ts>
+size_t EntityWorld::count() const
+{
+    const auto mask = getComponentMask<Ts...>();
+    size_t total    = 0;
+    for (auto& archetype : _archetypes)
+    {
+        if ((archetype->mask & mask) == mask)
+            total += archetype->entities.size();
+    }
+    return total;
+}
+
+template <typename... Ts, typename F>
+void EntityWorld::addEachSystem(std::string_view name, F&& func)
+{
+    const ComponentMask reads  = (ComponentMask(0) | ... | (std::is_const<Ts>::value ? getComponentMask<Ts>() : 0));
+    const ComponentMask writes = (ComponentMask(0) | ... | (std::is_const<Ts>::value ? 0 : getComponentMask<Ts>()));
+    addSystem(name, reads, writes, [func = std::forward<F>(func)](EntityWorld& world, float dt) {
+        world.parallelEach<Ts...>([&](Entity entity, Ts&... components) { func(entity, components..., dt); });
+    });
+}
+
+// end of base group
+/// @}
+
+NS_AX_END
+
+#endif  // AX_USE_ECS
+
+#endif  // __AX_ENTITY_WORLD_H__
@@ -30,6 +30,7 @@
 #    include "renderer/Renderer.h"
 #    include "recast/DetourCommon.h"
 #    include "recast/DetourDebugDraw.h"
+#    include "base/JobSystem.h"
 #    include <sstream>
 
 NS_AX_BEGIN
@@ -89,6 +90,10 @@ static unsigned char* parseRow(unsigned char* buf, unsigned char* bufEnd, char*
 static const int TILECACHESET_MAGIC   = 'T' << 24 | 'S' << 16 | 'E' << 8 | 'T';  //'TSET';
 static const int TILECACHESET_VERSION = 1;
 static const int MAX_AGENTS           = 128;
+static const int MAX_POLYS            = 256;
+static const int MAX_SMOOTH           = 2048;
+static const int MAX_QUERY_NODES      = 2048;
+static const float POLY_EXTENTS[3]    = {2, 4, 2};
 
 NavMesh* NavMesh::create(std::string_view navFilePath, std::string_view geomFilePath)
 {
@@ -120,6 +125,10 @@ NavMesh::~NavMesh()
     dtFreeCrowd(_crowed);
     dtFreeNavMesh(_navMesh);
     dtFreeNavMeshQuery(_navMeshQuery);
+    for (auto&& request : _activePathRequests)
+        dtFreeNavMeshQuery(request.query);
+    for (auto&& query : _pathQueryPool)
+        dtFreeNavMeshQuery(query);
     AX_SAFE_DELETE(_allocator);
     AX_SAFE_DELETE(_compressor);
     AX_SAFE_DELETE(_meshProcess);
@@ -230,7 +239,7 @@ bool NavMesh::loadNavMeshFile()
 
     // create NavMeshQuery
     _navMeshQuery = dtAllocNavMeshQuery();
-    _navMeshQuery->init(_navMesh, 2048);
+    _navMeshQuery->init(_navMesh, MAX_QUERY_NODES);
 
     _agentList.assign(MAX_AGENTS, nullptr);
     _obstacleList.assign(header.cacheParams.maxObstacles, nullptr);
@@ -490,8 +499,22 @@ void NavMesh::update(float dt)
             iter->preUpdate(dt);
     }
 
-    if (_crowed)
-        _crowed->update(dt, nullptr);
+    // the crowd and the path requests only read the navmesh, they run in parallel before the tile cache changes it
+    JobSystem::getInstance()->parallelFor(_activePathRequests.size() + 1, 1, [this, dt](size_t begin, size_t end) {
+        int maxIterations = std::max(1, _maxPathIterations / std::max(1, (int)_activePathRequests.size()));
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (i == 0)
+            {
+                if (_crowed)
+                    _crowed->update(dt, nullptr);
+            }
+            else
+                updatePathRequest(_activePathRequests[i - 1], maxIterations);
+        }
+    });
+
+    processPathRequests();
 
     if (_tileCache)
         _tileCache->update(dt, _navMesh);
@@ -509,22 +532,155 @@ void NavMesh::update(float dt)
     }
 }
 
-void ax::NavMesh::findPath(const Vec3& start, const Vec3& end, std::vector<Vec3>& pathPoints)
+void NavMesh::findPath(const Vec3& start, const Vec3& end, std::vector<Vec3>& pathPoints)
 {
-    static const int MAX_POLYS  = 256;
-    static const int MAX_SMOOTH = 2048;
-    float ext[3];
-    ext[0] = 2;
-    ext[1] = 4;
-    ext[2] = 2;
     dtQueryFilter filter;
     dtPolyRef startRef, endRef;
     dtPolyRef polys[MAX_POLYS];
     int npolys = 0;
-    _navMeshQuery->findNearestPoly(&start.x, ext, &filter, &startRef, 0);
-    _navMeshQuery->findNearestPoly(&end.x, ext, &filter, &endRef, 0);
+    _navMeshQuery->findNearestPoly(&start.x, POLY_EXTENTS, &filter, &startRef, 0);
+    _navMeshQuery->findNearestPoly(&end.x, POLY_EXTENTS, &filter, &endRef, 0);
     _navMeshQuery->findPath(startRef, endRef, &start.x, &end.x, &filter, polys, &npolys, MAX_POLYS);
 
+    smoothPath(_navMeshQuery, startRef, start, end, polys, npolys, pathPoints);
+}
+
+int NavMesh::findPathAsync(const Vec3& start, const Vec3& end, const FindPathCallback& callback)
+{
+    PathRequest request;
+    request.id       = ++_pathRequestId;
+    request.start    = start;
+    request.end      = end;
+    request.callback = callback;
+    _pendingPathRequests.emplace_back(std::move(request));
+    return _pathRequestId;
+}
+
+void NavMesh::cancelFindPath(int requestId)
+{
+    auto iter = std::find_if(_pendingPathRequests.begin(), _pendingPathRequests.end(),
+                             [requestId](const PathRequest& request) { return request.id == requestId; });
+    if (iter != _pendingPathRequests.end())
+    {
+        _pendingPathRequests.erase(iter);
+        return;
+    }
+
+    // the search of an active request can't be interrupted, it's dropped once done
+    for (auto&& request : _activePathRequests)
+    {
+        if (request.id == requestId)
+            request.callback = nullptr;
+    }
+    for (auto&& request : _finishedPathRequests)
+    {
+        if (request.id == requestId)
+            request.callback = nullptr;
+    }
+}
+
+void NavMesh::setFindPathBudget(int maxIterations, int maxRequests)
+{
+    _maxPathIterations     = std::max(1, maxIterations);
+    _maxActivePathRequests = std::max(1, maxRequests);
+}
+
+void NavMesh::updatePathRequest(PathRequest& request, int maxIterations)
+{
+    if (request.done)
+        return;
+
+    // Detour keeps the filter pointer for the following slices, so it must outlive the request
+    const dtQueryFilter* filter = &_pathFilter;
+    dtNavMeshQuery* query       = request.query;
+    if (!request.started)
+    {
+        request.started  = true;
+        dtPolyRef endRef = 0;
+        query->findNearestPoly(&request.start.x, POLY_EXTENTS, filter, &request.startRef, 0);
+        query->findNearestPoly(&request.end.x, POLY_EXTENTS, filter, &endRef, 0);
+        dtStatus status = query->initSlicedFindPath(request.startRef, endRef, &request.start.x, &request.end.x, filter);
+        if (dtStatusFailed(status))
+        {
+            request.done = true;
+            return;
+        }
+    }
+
+    dtStatus status = query->updateSlicedFindPath(maxIterations, nullptr);
+    if (dtStatusInProgress(status))
+        return;
+
+    request.done = true;
+    dtPolyRef polys[MAX_POLYS];
+    int npolys = 0;
+    status     = query->finalizeSlicedFindPath(polys, &npolys, MAX_POLYS);
+    if (dtStatusSucceed(status))
+        smoothPath(query, request.startRef, request.start, request.end, polys, npolys, request.pathPoints);
+}
+
+void NavMesh::processPathRequests()
+{
+    // collect the finished requests before delivering them, a callback may cancel or start other requests
+    size_t count = 0;
+    for (size_t i = 0, size = _activePathRequests.size(); i < size; ++i)
+    {
+        auto& request = _activePathRequests[i];
+        if (request.done)
+        {
+            _finishedPathRequests.emplace_back(std::move(request));
+        }
+        else
+        {
+            if (i != count)
+                _activePathRequests[count] = std::move(request);
+            ++count;
+        }
+    }
+    _activePathRequests.resize(count);
+
+    // their queries go back to the pool
+    for (size_t i = 0; i < _finishedPathRequests.size(); ++i)
+    {
+        auto& request = _finishedPathRequests[i];
+        _pathQueryPool.emplace_back(request.query);
+        if (request.callback)
+        {
+            // moved out so the callback can cancel its own request while it runs
+            auto callback = std::move(request.callback);
+            callback(request.pathPoints);
+        }
+    }
+    _finishedPathRequests.clear();
+
+    // start the pending requests, they are searched from the next update
+    while (!_pendingPathRequests.empty() && (int)_activePathRequests.size() < _maxActivePathRequests)
+    {
+        auto request = std::move(_pendingPathRequests.front());
+        _pendingPathRequests.pop_front();
+        if (_pathQueryPool.empty())
+        {
+            request.query = dtAllocNavMeshQuery();
+            request.query->init(_navMesh, MAX_QUERY_NODES);
+        }
+        else
+        {
+            request.query = _pathQueryPool.back();
+            _pathQueryPool.pop_back();
+        }
+        _activePathRequests.emplace_back(std::move(request));
+    }
+}
+
+void NavMesh::smoothPath(dtNavMeshQuery* query,
+                         dtPolyRef startRef,
+                         const Vec3& start,
+                         const Vec3& end,
+                         dtPolyRef* polys,
+                         int npolys,
+                         std::vector<Vec3>& pathPoints)
+{
+    dtQueryFilter filter;
     if (npolys)
     {
         //// Iterate over the path to find smooth path on the detail mesh surface.
@@ -533,8 +689,8 @@ void ax::NavMesh::findPath(const Vec3& start, const Vec3& end, std::vector<Vec3>
         // int npolys = npolys;
 
         float iterPos[3], targetPos[3];
-        _navMeshQuery->closestPointOnPoly(startRef, &start.x, iterPos, 0);
-        _navMeshQuery->closestPointOnPoly(polys[npolys - 1], &end.x, targetPos, 0);
+        query->closestPointOnPoly(startRef, &start.x, iterPos, 0);
+        query->closestPointOnPoly(polys[npolys - 1], &end.x, targetPos, 0);
 
         static const float STEP_SIZE = 0.5f;
         static const float SLOP      = 0.01f;
@@ -555,8 +711,7 @@ void ax::NavMesh::findPath(const Vec3& start, const Vec3& end, std::vector<Vec3>
             unsigned char steerPosFlag;
             dtPolyRef steerPosRef;
 
-            if (!getSteerTarget(_navMeshQuery, iterPos, targetPos, SLOP, polys, npolys, steerPos, steerPosFlag,
-                                steerPosRef))
+            if (!getSteerTarget(query, iterPos, targetPos, SLOP, polys, npolys, steerPos, steerPosFlag, steerPosRef))
                 break;
 
             bool endOfPath         = (steerPosFlag & DT_STRAIGHTPATH_END) ? true : false;
@@ -578,13 +733,13 @@ void ax::NavMesh::findPath(const Vec3& start, const Vec3& end, std::vector<Vec3>
             float result[3];
             dtPolyRef visited[16];
             int nvisited = 0;
-            _navMeshQuery->moveAlongSurface(polys[0], iterPos, moveTgt, &filter, result, visited, &nvisited, 16);
+            query->moveAlongSurface(polys[0], iterPos, moveTgt, &filter, result, visited, &nvisited, 16);
 
             npolys = fixupCorridor(polys, npolys, MAX_POLYS, visited, nvisited);
-            npolys = fixupShortcuts(polys, npolys, _navMeshQuery);
+            npolys = fixupShortcuts(polys, npolys, query);
 
             float h = 0;
-            _navMeshQuery->getPolyHeight(polys[0], result, &h);
+            query->getPolyHeight(polys[0], result, &h);
             result[1] = h;
             dtVcopy(iterPos, result);
 
@@ -642,7 +797,7 @@ void ax::NavMesh::findPath(const Vec3& start, const Vec3& end, std::vector<Vec3>
                     // Move position at the other side of the off-mesh link.
                     dtVcopy(iterPos, endPos);
                     float eh = 0.0f;
-                    _navMeshQuery->getPolyHeight(polys[0], iterPos, &eh);
+                    query->getPolyHeight(polys[0], iterPos, &eh);
                     iterPos[1] = eh;
                 }
             }
@@ -37,6 +37,8 @@
 #    include "recast/DetourTileCache.h"
 #    include <string>
 #    include <vector>
+#    include <deque>
+#    include <functional>
 
 #    include "navmesh/NavMeshAgent.h"
 #    include "navmesh/NavMeshDebugDraw.h"
@@ -95,6 +97,32 @@ public:
     */
     void findPath(const Vec3& start, const Vec3& end, std::vector<Vec3>& pathPoints);
 
+    typedef std::function<void(const std::vector<Vec3>& pathPoints)> FindPathCallback;
+
+    /**
+    find a path on navmesh asynchronously
+
+    The search advances in slices during update(), on the job system and together with the crowd, so many requests
+    don't stall a frame. The callback is invoked on the thread calling update(), with no points if there's no path.
+
+    @param start The start search position in world coordinate system.
+    @param end The end search position in world coordinate system.
+    @param callback Receives the key points of path.
+    @return An id for cancelFindPath().
+    */
+    int findPathAsync(const Vec3& start, const Vec3& end, const FindPathCallback& callback);
+
+    /** cancel a path request of findPathAsync(), its callback won't be invoked. */
+    void cancelFindPath(int requestId);
+
+    /**
+    set the budget of the asynchronous path requests
+
+    @param maxIterations The search iterations per frame shared by all the requests in progress.
+    @param maxRequests The max requests searched at the same time, each of them owns a query object.
+    */
+    void setFindPathBudget(int maxIterations, int maxRequests);
+
     NavMesh();
     virtual ~NavMesh();
 
@@ -108,6 +136,29 @@ protected:
     void drawObstacles();
     void drawOffMeshConnections();
 
+    struct PathRequest
+    {
+        int id;
+        Vec3 start;
+        Vec3 end;
+        FindPathCallback callback;
+        dtNavMeshQuery* query = nullptr;
+        dtPolyRef startRef    = 0;
+        bool started          = false;
+        bool done             = false;
+        std::vector<Vec3> pathPoints;
+    };
+
+    void updatePathRequest(PathRequest& request, int maxIterations);
+    void processPathRequests();
+    void smoothPath(dtNavMeshQuery* query,
+                    dtPolyRef startRef,
+                    const Vec3& start,
+                    const Vec3& end,
+                    dtPolyRef* polys,
+                    int npolys,
+                    std::vector<Vec3>& pathPoints);
+
 protected:
     dtNavMesh* _navMesh;
     dtNavMeshQuery* _navMeshQuery;
@@ -124,6 +175,15 @@ protected:
     std::string _navFilePath;
     std::string _geomFilePath;
     bool _isDebugDrawEnabled;
+
+    std::deque<PathRequest> _pendingPathRequests;
+    std::vector<PathRequest> _activePathRequests;
+    std::vector<PathRequest> _finishedPathRequests;  // being delivered by processPathRequests
+    std::vector<dtNavMeshQuery*> _pathQueryPool;
+    dtQueryFilter _pathFilter;  // shared by the sliced searches, read only while they run
+    int _pathRequestId         = 0;
+    int _maxPathIterations     = 2048;
+    int _maxActivePathRequests = 16;
 };
 
 /** @} */
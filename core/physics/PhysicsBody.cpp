@@ -904,7 +904,7 @@ Vec2 PhysicsBody::local2World(const Vec2& point)
     return PhysicsHelper::cpv2vec2(cpBodyLocalToWorld(_cpBody, PhysicsHelper::vec22cpv(point)));
 }
 
-void PhysicsBody::beforeSimulation(const Mat4& parentToWorldTransform,
+void PhysicsBody::beforeSimulation(const Mat4& worldToParentTransform,
                                    const Mat4& nodeToWorldTransform,
                                    float scaleX,
                                    float scaleY,
@@ -917,43 +917,68 @@ void PhysicsBody::beforeSimulation(const Mat4& parentToWorldTransform,
         setScale(scaleX, scaleY);
     }
 
-    // set rotation
-    if (_recordedRotation != rotation)
-    {
-        setRotation(rotation);
-    }
-
-    // set position
     auto worldPosition = _ownerCenterOffset;
     nodeToWorldTransform.transformVector(worldPosition.x, worldPosition.y, worldPosition.z, 1.f, &worldPosition);
-    setPosition(worldPosition.x, worldPosition.y);
+
+    // an interpolated owner lags behind the body, only move the body when the owner was moved by someone else
+    bool ownerMoved = !(_world && _world->isInterpolationEnabled() && _hasSyncedState) ||
+                      !Vec2(worldPosition.x, worldPosition.y).fuzzyEquals(_syncedPosition, 0.01f) ||
+                      std::abs(rotation - _syncedRotation) > 0.01f;
+    if (ownerMoved)
+    {
+        // set rotation
+        if (_recordedRotation != rotation)
+        {
+            setRotation(rotation);
+        }
+
+        // set position
+        setPosition(worldPosition.x, worldPosition.y);
+        _hasPreviousState = false;
+    }
 
     _recordPosX = worldPosition.x;
     _recordPosY = worldPosition.y;
 
     if (_owner->getAnchorPoint() != Vec2::ANCHOR_MIDDLE)
     {
-        parentToWorldTransform.getInversed().transformVector(worldPosition.x, worldPosition.y, worldPosition.z, 1.f,
-                                                             &worldPosition);
+        worldToParentTransform.transformVector(worldPosition.x, worldPosition.y, worldPosition.z, 1.f, &worldPosition);
         _offset.x = worldPosition.x - _owner->getPositionX();
         _offset.y = worldPosition.y - _owner->getPositionY();
     }
 }
 
-void PhysicsBody::afterSimulation(const Mat4& parentToWorldTransform, float parentRotation)
+void PhysicsBody::afterSimulation(const Mat4& worldToParentTransform, float parentRotation, float alpha)
 {
+    auto position = getPosition();
+    auto rotation = getRotation();
+    if (alpha < 1.f && _hasPreviousState)
+    {
+        position = _previousPosition.lerp(position, alpha);
+        rotation = _previousRotation + (rotation - _previousRotation) * alpha;
+    }
+    _syncedPosition = position;
+    _syncedRotation = rotation;
+    _hasSyncedState = true;
+
     // set Node position
-    auto tmp = getPosition();
-    Vec3 positionInParent(tmp.x, tmp.y, 0.f);
+    Vec3 positionInParent(position.x, position.y, 0.f);
     if (_recordPosX != positionInParent.x || _recordPosY != positionInParent.y)
     {
-        parentToWorldTransform.getInversed().transformVector(positionInParent.x, positionInParent.y, positionInParent.z,
-                                                             1.f, &positionInParent);
+        worldToParentTransform.transformVector(positionInParent.x, positionInParent.y, positionInParent.z, 1.f,
+                                               &positionInParent);
         _owner->setPosition(positionInParent.x - _offset.x, positionInParent.y - _offset.y);
     }
 
     // set Node rotation
-    _owner->setRotation(getRotation() - parentRotation);
+    _owner->setRotation(rotation - parentRotation);
+}
+
+void PhysicsBody::recordState()
+{
+    _previousPosition = getPosition();
+    _previousRotation = getRotation();
+    _hasPreviousState = true;
 }
 
 void PhysicsBody::onEnter()
@@ -558,12 +558,13 @@ protected:
     void addToPhysicsWorld();
     void removeFromPhysicsWorld();
 
-    void beforeSimulation(const Mat4& parentToWorldTransform,
+    void beforeSimulation(const Mat4& worldToParentTransform,
                           const Mat4& nodeToWorldTransform,
                           float scaleX,
                           float scaleY,
                           float rotation);
-    void afterSimulation(const Mat4& parentToWorldTransform, float parentRotation);
+    void afterSimulation(const Mat4& worldToParentTransform, float parentRotation, float alpha);
+    void recordState();
 
 protected:
     std::vector<PhysicsJoint*> _joints;
@@ -608,6 +609,14 @@ protected:
     float _recordPosX;
     float _recordPosY;
 
+    // state before the last step and the state written to the owner, used by the interpolation of PhysicsWorld
+    Vec2 _previousPosition;
+    float _previousRotation = 0.f;
+    bool _hasPreviousState  = false;
+    Vec2 _syncedPosition;
+    float _syncedRotation = 0.f;
+    bool _hasSyncedState  = false;
+
     friend class PhysicsWorld;
     friend class PhysicsShape;
     friend class PhysicsJoint;
@@ -48,11 +48,7 @@ PhysicsContact::PhysicsContact()
     , _preContactData(nullptr)
 {}
 
-PhysicsContact::~PhysicsContact()
-{
-    AX_SAFE_DELETE(_contactData);
-    AX_SAFE_DELETE(_preContactData);
-}
+PhysicsContact::~PhysicsContact() {}
 
 PhysicsContact* PhysicsContact::construct(PhysicsShape* a, PhysicsShape* b)
 {
@@ -75,6 +71,17 @@ bool PhysicsContact::init(PhysicsShape* a, PhysicsShape* b)
         _shapeA = a;
         _shapeB = b;
 
+        // contacts are recycled by PhysicsWorld, reset the state of the previous pair
+        _world              = nullptr;
+        _eventCode          = EventCode::NONE;
+        _notificationEnable = true;
+        _result             = true;
+        _data               = nullptr;
+        _contactInfo        = nullptr;
+        _contactData        = nullptr;
+        _preContactData     = nullptr;
+        _isStopped          = false;
+
         return true;
     } while (false);
 
@@ -88,10 +95,9 @@ void PhysicsContact::generateContactData()
         return;
     }
 
-    cpArbiter* arb = static_cast<cpArbiter*>(_contactInfo);
-    AX_SAFE_DELETE(_preContactData);
-    _preContactData     = _contactData;
-    _contactData        = new PhysicsContactData();
+    cpArbiter* arb  = static_cast<cpArbiter*>(_contactInfo);
+    _preContactData = _contactData;
+    _contactData    = _contactData == &_contactDataStorage[0] ? &_contactDataStorage[1] : &_contactDataStorage[0];
     _contactData->count = cpArbiterGetCount(arb);
     for (int i = 0; i < _contactData->count && i < PhysicsContactData::POINT_MAX; ++i)
     {
@@ -189,7 +195,6 @@ void EventListenerPhysicsContact::onEvent(EventCustom* event)
 
         if (onContactBegin != nullptr && hitTest(contact->getShapeA(), contact->getShapeB()))
         {
-            contact->generateContactData();
             ret = onContactBegin(*contact);
         }
 
@@ -203,8 +208,6 @@ void EventListenerPhysicsContact::onEvent(EventCustom* event)
         if (onContactPreSolve != nullptr && hitTest(contact->getShapeA(), contact->getShapeB()))
         {
             PhysicsContactPreSolve solve(contact->_contactInfo);
-            contact->generateContactData();
-
             ret = onContactPreSolve(*contact, solve);
         }
 
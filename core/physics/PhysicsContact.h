@@ -142,6 +142,8 @@ private:
     void* _contactInfo;
     PhysicsContactData* _contactData;
     PhysicsContactData* _preContactData;
+    // _contactData and _preContactData point into it, so generating contact data never allocates
+    PhysicsContactData _contactDataStorage[2];
 
     friend class EventListenerPhysicsContact;
     friend class PhysicsWorldCallback;
@@ -117,7 +117,7 @@ cpBool PhysicsWorldCallback::collisionBeginCallbackFunc(cpArbiter* arb, struct c
     PhysicsShape* shapeB = static_cast<PhysicsShape*>(cpShapeGetUserData(b));
     AX_ASSERT(shapeA != nullptr && shapeB != nullptr);
 
-    auto contact = PhysicsContact::construct(shapeA, shapeB);
+    auto contact = world->acquireContact(shapeA, shapeB);
     cpArbiterSetUserData(arb, contact);
     contact->_contactInfo = arb;
 
@@ -140,7 +140,9 @@ void PhysicsWorldCallback::collisionSeparateCallbackFunc(cpArbiter* arb, cpSpace
 
     world->collisionSeparateCallback(*contact);
 
-    delete contact;
+    // a queued contact is recycled after its batch was delivered
+    if (!world->queueContact(*contact, PhysicsContact::EventCode::SEPARATE))
+        world->recycleContact(contact);
 }
 
 void PhysicsWorldCallback::rayCastCallbackFunc(cpShape* shape,
@@ -397,11 +399,18 @@ bool PhysicsWorld::collisionBeginCallback(PhysicsContact& contact)
 
     if (contact.isNotificationEnabled())
     {
-        contact.setEventCode(PhysicsContact::EventCode::BEGIN);
-        contact.setWorld(this);
-        _eventDispatcher->dispatchEvent(&contact);
+        generateContactData(contact);
+        if (hasContactListeners())
+        {
+            contact.setEventCode(PhysicsContact::EventCode::BEGIN);
+            contact.setWorld(this);
+            _eventDispatcher->dispatchEvent(&contact);
+        }
     }
 
+    // chipmunk reports the separation of rejected contacts too, keep begin & separate in pairs
+    queueContact(contact, PhysicsContact::EventCode::BEGIN);
+
     return ret ? contact.resetResult() : false;
 }
 
@@ -412,11 +421,22 @@ bool PhysicsWorld::collisionPreSolveCallback(PhysicsContact& contact)
         return true;
     }
 
-    contact.setEventCode(PhysicsContact::EventCode::PRESOLVE);
-    contact.setWorld(this);
-    _eventDispatcher->dispatchEvent(&contact);
+    generateContactData(contact);
 
-    return contact.resetResult();
+    if (hasContactListeners())
+    {
+        contact.setEventCode(PhysicsContact::EventCode::PRESOLVE);
+        contact.setWorld(this);
+        _eventDispatcher->dispatchEvent(&contact);
+    }
+
+    bool ret = contact.resetResult();
+    if (ret)
+    {
+        queueContact(contact, PhysicsContact::EventCode::PRESOLVE);
+    }
+
+    return ret;
 }
 
 void PhysicsWorld::collisionPostSolveCallback(PhysicsContact& contact)
@@ -426,9 +446,14 @@ void PhysicsWorld::collisionPostSolveCallback(PhysicsContact& contact)
         return;
     }
 
-    contact.setEventCode(PhysicsContact::EventCode::POSTSOLVE);
-    contact.setWorld(this);
-    _eventDispatcher->dispatchEvent(&contact);
+    if (hasContactListeners())
+    {
+        contact.setEventCode(PhysicsContact::EventCode::POSTSOLVE);
+        contact.setWorld(this);
+        _eventDispatcher->dispatchEvent(&contact);
+    }
+
+    queueContact(contact, PhysicsContact::EventCode::POSTSOLVE);
 }
 
 void PhysicsWorld::collisionSeparateCallback(PhysicsContact& contact)
@@ -438,9 +463,163 @@ void PhysicsWorld::collisionSeparateCallback(PhysicsContact& contact)
         return;
     }
 
-    contact.setEventCode(PhysicsContact::EventCode::SEPARATE);
+    if (hasContactListeners())
+    {
+        contact.setEventCode(PhysicsContact::EventCode::SEPARATE);
+        contact.setWorld(this);
+        _eventDispatcher->dispatchEvent(&contact);
+    }
+}
+
+PhysicsContact* PhysicsWorld::acquireContact(PhysicsShape* shapeA, PhysicsShape* shapeB)
+{
+    if (_contactPool.empty())
+    {
+        return PhysicsContact::construct(shapeA, shapeB);
+    }
+
+    auto contact = _contactPool.back();
+    _contactPool.pop_back();
+    contact->init(shapeA, shapeB);
+    return contact;
+}
+
+void PhysicsWorld::recycleContact(PhysicsContact* contact)
+{
+    _contactPool.emplace_back(contact);
+}
+
+void PhysicsWorld::generateContactData(PhysicsContact& contact)
+{
+    // generated once per callback and shared by the listeners and the batch callbacks, so getPreContactData() keeps
+    // the data of the previous step. The arbiter is only valid inside the chipmunk callbacks
+    if (hasContactListeners() || !_contactBatchCallbacks.empty())
+    {
+        contact.generateContactData();
+    }
+}
+
+bool PhysicsWorld::queueContact(PhysicsContact& contact, PhysicsContact::EventCode code)
+{
+    if (_contactBatchCallbacks.empty() || !contact.isNotificationEnabled())
+    {
+        return false;
+    }
+
     contact.setWorld(this);
-    _eventDispatcher->dispatchEvent(&contact);
+    _contactBatches[static_cast<int>(code) - 1].emplace_back(&contact);
+
+    // shapes removed outside of a step separate immediately, deliver them before the shapes go away
+    if (!cpSpaceIsLocked(_cpSpace))
+    {
+        flushContactBatches();
+    }
+    return true;
+}
+
+void PhysicsWorld::flushContactBatches()
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        auto& contacts = _contactBatches[i];
+        if (contacts.empty())
+        {
+            continue;
+        }
+
+        auto code = static_cast<PhysicsContact::EventCode>(i + 1);
+        for (size_t k = 0; k < _contactBatchCallbacks.size(); ++k)
+        {
+            auto& batchCallback = _contactBatchCallbacks[k];
+            if (!batchCallback.callback)
+            {
+                continue;
+            }
+
+            _filteredContacts.clear();
+            for (auto&& contact : contacts)
+            {
+                auto shapeA = contact->getShapeA();
+                auto shapeB = contact->getShapeB();
+                if (((shapeA->getCategoryBitmask() | shapeB->getCategoryBitmask()) & batchCallback.categoryBitmask) ==
+                    0)
+                {
+                    continue;
+                }
+                if (batchCallback.group != 0 && shapeA->getGroup() != batchCallback.group &&
+                    shapeB->getGroup() != batchCallback.group)
+                {
+                    continue;
+                }
+                contact->setEventCode(code);
+                _filteredContacts.emplace_back(contact);
+            }
+
+            if (!_filteredContacts.empty())
+            {
+                // copy it, the callback may remove itself
+                auto callback = batchCallback.callback;
+                callback(*this, code, _filteredContacts.data(), _filteredContacts.size());
+            }
+        }
+    }
+
+    for (auto&& contact : _contactBatches[static_cast<int>(PhysicsContact::EventCode::SEPARATE) - 1])
+    {
+        recycleContact(contact);
+    }
+    for (auto&& contacts : _contactBatches)
+    {
+        contacts.clear();
+    }
+
+    _contactBatchCallbacks.erase(std::remove_if(_contactBatchCallbacks.begin(), _contactBatchCallbacks.end(),
+                                                [](const ContactBatchCallback& it) { return !it.callback; }),
+                                 _contactBatchCallbacks.end());
+}
+
+int PhysicsWorld::addContactBatchCallback(const PhysicsContactBatchCallbackFunc& callback,
+                                          int categoryBitmask,
+                                          int group)
+{
+    AXASSERT(callback != nullptr, "callback shouldn't be nullptr");
+
+    int id = ++_contactBatchCallbackId;
+    _contactBatchCallbacks.emplace_back(ContactBatchCallback{id, categoryBitmask, group, callback});
+    return id;
+}
+
+void PhysicsWorld::removeContactBatchCallback(int id)
+{
+    // only cleared here, the entry is erased by the next flush so a running flush stays valid
+    for (auto&& batchCallback : _contactBatchCallbacks)
+    {
+        if (batchCallback.id == id)
+        {
+            batchCallback.callback = nullptr;
+        }
+    }
+}
+
+bool PhysicsWorld::hasContactListeners() const
+{
+    // shapes removed outside of a step are separated right away, the listeners may have changed since the last step
+    return cpSpaceIsLocked(_cpSpace) ? _hasContactListeners
+                                     : _eventDispatcher->hasEventListener(PHYSICSCONTACT_EVENT_NAME);
+}
+
+void PhysicsWorld::stepSpace(float dt)
+{
+    // looking up the listeners of every contact event is costly, check them once per step
+    _hasContactListeners = _eventDispatcher->hasEventListener(PHYSICSCONTACT_EVENT_NAME);
+
+#    if AX_TARGET_PLATFORM == AX_PLATFORM_WIN32
+    cpSpaceStep(_cpSpace, dt);
+#    else
+    cpHastySpaceStep(_cpSpace, dt);
+#    endif
+
+    flushContactBatches();
 }
 
 void PhysicsWorld::rayCast(PhysicsRayCastCallbackFunc func, const Vec2& point1, const Vec2& point2, void* data)
@@ -925,6 +1104,7 @@ void PhysicsWorld::update(float delta, bool userCall /* = false*/)
     }
 
     auto sceneToWorldTransform = _scene->getNodeToParentTransform();
+    _bodySyncs.clear();
     beforeSimulation(_scene, sceneToWorldTransform, 1.f, 1.f, 0.f);
 
     if (!_delayAddJoints.empty() || !_delayRemoveJoints.empty())
@@ -937,29 +1117,32 @@ void PhysicsWorld::update(float delta, bool userCall /* = false*/)
         return;
     }
 
+    float alpha = 1.f;
     if (userCall)
     {
-#    if AX_TARGET_PLATFORM == AX_PLATFORM_WIN32
-        cpSpaceStep(_cpSpace, delta);
-#    else
-        cpHastySpaceStep(_cpSpace, delta);
-#    endif
+        stepSpace(delta);
     }
     else
     {
         _updateTime += delta;
-        if (_fixedRate)
+        int fixedRate = _fixedRate > 0 ? _fixedRate : (_deterministic ? 60 : 0);
+        if (fixedRate)
         {
-            const float step = 1.0f / _fixedRate;
+            const float step = 1.0f / fixedRate;
             const float dt   = step * _speed;
             while (_updateTime > step)
             {
                 _updateTime -= step;
-#    if AX_TARGET_PLATFORM == AX_PLATFORM_WIN32
-                cpSpaceStep(_cpSpace, dt);
-#    else
-                cpHastySpaceStep(_cpSpace, dt);
-#    endif
+                if (_interpolationEnabled)
+                {
+                    for (auto&& body : _bodies)
+                        body->recordState();
+                }
+                stepSpace(dt);
+            }
+            if (_interpolationEnabled)
+            {
+                alpha = _updateTime / step;
             }
         }
         else
@@ -969,11 +1152,7 @@ void PhysicsWorld::update(float delta, bool userCall /* = false*/)
                 const float dt = _updateTime * _speed / _substeps;
                 for (int i = 0; i < _substeps; ++i)
                 {
-#    if AX_TARGET_PLATFORM == AX_PLATFORM_WIN32
-                    cpSpaceStep(_cpSpace, dt);
-#    else
-                    cpHastySpaceStep(_cpSpace, dt);
-#    endif
+                    stepSpace(dt);
                     for (auto&& body : _bodies)
                     {
                         body->update(dt);
@@ -990,9 +1169,8 @@ void PhysicsWorld::update(float delta, bool userCall /* = false*/)
         debugDraw();
     }
 
-    // Update physics position, should loop as the same sequence as node tree.
-    // PhysicsWorld::afterSimulation() will depend on the sequence.
-    afterSimulation(_scene, sceneToWorldTransform, 0.f);
+    // Update physics position, in the same sequence as node tree recorded by beforeSimulation().
+    syncBodies(alpha);
 
     if (_postUpdateCallback)
         _postUpdateCallback();  // fix #11154
@@ -1031,6 +1209,7 @@ PhysicsWorld::PhysicsWorld()
 
 PhysicsWorld::~PhysicsWorld()
 {
+    _bodySyncs.clear();
     removeAllJoints(true);
     removeAllBodies();
     if (_cpSpace)
@@ -1042,6 +1221,11 @@ PhysicsWorld::~PhysicsWorld()
 #    endif
     }
     AX_SAFE_RELEASE_NULL(_debugDraw);
+
+    for (auto&& contact : _contactPool)
+    {
+        delete contact;
+    }
 }
 
 void PhysicsWorld::beforeSimulation(Node* node,
@@ -1059,26 +1243,52 @@ void PhysicsWorld::beforeSimulation(Node* node,
     auto physicsBody = node->getPhysicsBody();
     if (physicsBody)
     {
-        physicsBody->beforeSimulation(parentToWorldTransform, nodeToWorldTransform, scaleX, scaleY, rotation);
+        auto worldToParentTransform = parentToWorldTransform.getInversed();
+        physicsBody->beforeSimulation(worldToParentTransform, nodeToWorldTransform, scaleX, scaleY, rotation);
+        _bodySyncs.emplace_back(BodySync{physicsBody, worldToParentTransform, parentRotation});
     }
 
     for (auto&& child : node->getChildren())
         beforeSimulation(child, nodeToWorldTransform, scaleX, scaleY, rotation);
 }
 
-void PhysicsWorld::afterSimulation(Node* node, const Mat4& parentToWorldTransform, float parentRotation)
+void PhysicsWorld::syncBodies(float alpha)
 {
-    auto nodeToWorldTransform = parentToWorldTransform * node->getNodeToParentTransform();
-    auto nodeRotation         = parentRotation + node->getRotation();
+    for (auto&& sync : _bodySyncs)
+    {
+        // the owner may have been removed by a contact callback
+        auto owner = sync.body->getOwner();
+        if (owner && owner->getPhysicsBody() == sync.body)
+        {
+            sync.body->afterSimulation(sync.worldToParentTransform, sync.parentRotation, alpha);
+        }
+    }
+    _bodySyncs.clear();
+}
 
-    auto physicsBody = node->getPhysicsBody();
-    if (physicsBody)
+void PhysicsWorld::setDeterministic(bool deterministic, int iterations)
+{
+    if (deterministic)
+    {
+        if (!_deterministic)
+            _iterations = cpSpaceGetIterations(_cpSpace);
+        cpSpaceSetIterations(_cpSpace, iterations);
+    }
+    else if (_deterministic)
     {
-        physicsBody->afterSimulation(parentToWorldTransform, parentRotation);
+        cpSpaceSetIterations(_cpSpace, _iterations);
     }
+    _deterministic = deterministic;
+    setThreads(_threads);
+}
 
-    for (auto&& child : node->getChildren())
-        afterSimulation(child, nodeToWorldTransform, nodeRotation);
+void PhysicsWorld::setThreads(int threads)
+{
+    _threads = threads;
+#    if AX_TARGET_PLATFORM != AX_PLATFORM_WIN32
+    // the work split depends on the thread count, pick one which doesn't depend on the device
+    cpHastySpaceSetThreads(_cpSpace, _deterministic && threads == 0 ? 1 : threads);
+#    endif
 }
 
 void PhysicsWorld::setPostUpdateCallback(const std::function<void()>& callback)
@@ -31,8 +31,10 @@
 
 #    include <list>
 #    include "base/Vector.h"
+#    include "base/RefPtr.h"
 #    include "math/Math.h"
 #    include "physics/PhysicsBody.h"
+#    include "physics/PhysicsContact.h"
 
 struct cpSpace;
 
@@ -84,6 +86,13 @@ typedef struct PhysicsRayCastInfo
 typedef std::function<bool(PhysicsWorld& world, const PhysicsRayCastInfo& info, void* data)> PhysicsRayCastCallbackFunc;
 typedef std::function<bool(PhysicsWorld&, PhysicsShape&, void*)> PhysicsQueryRectCallbackFunc;
 typedef PhysicsQueryRectCallbackFunc PhysicsQueryPointCallbackFunc;
+/**
+ * @brief Called after a physics step with the contacts of one event code gathered during that step.
+ * The contacts are only valid during the call, the collision can't be ignored from here.
+ */
+typedef std::function<
+    void(PhysicsWorld& world, PhysicsContact::EventCode code, PhysicsContact* const* contacts, size_t count)>
+    PhysicsContactBatchCallbackFunc;
 
 /**
  * @addtogroup physics
@@ -321,6 +330,39 @@ public:
     /** get the number of substeps */
     int getFixedUpdateRate() const { return _fixedRate; }
 
+    /**
+     * Interpolates the nodes between the last two fixed steps by the time left over in the frame, which hides the
+     * stutter of a fixed update rate that doesn't match the frame rate. The nodes lag one step behind the bodies.
+     * @attention Only works with a fixed update rate, see setFixedUpdateRate().
+     */
+    void setInterpolationEnabled(bool enabled) { _interpolationEnabled = enabled; }
+
+    /** Whether the nodes are interpolated between the last two fixed steps. */
+    bool isInterpolationEnabled() const { return _interpolationEnabled; }
+
+    /**
+     * Makes the simulation reproducible on every device: the solver runs a fixed number of iterations on a fixed number
+     * of threads (one when none was set by setThreads()) and the world steps with the fixed update rate, 60 steps per
+     * second if none was set.
+     *
+     * @param deterministic Whether the simulation is deterministic.
+     * @param iterations The solver iterations per step, chipmunk's default is 10. The iterations used before the
+     * simulation became deterministic are restored when it is disabled.
+     */
+    void setDeterministic(bool deterministic, int iterations = 10);
+
+    /** Whether the simulation is deterministic. */
+    bool isDeterministic() const { return _deterministic; }
+
+    /**
+     * Set the number of threads which solve the space, 0 uses the number of cpu cores.
+     * @attention Ignored on win32, the space is always solved on the calling thread there.
+     */
+    void setThreads(int threads);
+
+    /** Get the number of threads set by setThreads(). */
+    int getThreads() const { return _threads; }
+
     /**
      * Set the debug draw mask of this physics world.
      *
@@ -340,6 +382,23 @@ public:
      */
     void setPostUpdateCallback(const std::function<void()>& callback);
 
+    /**
+     * Adds a callback which receives the contacts of each physics step in batches, one array per event code.
+     *
+     * Contacts are filtered before the callback is invoked: at least one shape must share a bit with `categoryBitmask`
+     * and, if `group` isn't 0, at least one shape must be in `group`. Contacts whose shapes don't pass the contact test
+     * bitmasks are never reported, as for EventListenerPhysicsContact. Unlike the event listeners, batches are
+     * delivered after the step and cost no event dispatch per contact.
+     *
+     * @return An id for removeContactBatchCallback().
+     */
+    int addContactBatchCallback(const PhysicsContactBatchCallbackFunc& callback,
+                                int categoryBitmask = UINT_MAX,
+                                int group           = 0);
+
+    /** Removes a callback added by addContactBatchCallback(). */
+    void removeContactBatchCallback(int id);
+
     /**
      * Get the debug draw mask.
      *
@@ -390,6 +449,14 @@ protected:
     virtual void collisionPostSolveCallback(PhysicsContact& contact);
     virtual void collisionSeparateCallback(PhysicsContact& contact);
 
+    PhysicsContact* acquireContact(PhysicsShape* shapeA, PhysicsShape* shapeB);
+    void recycleContact(PhysicsContact* contact);
+    void generateContactData(PhysicsContact& contact);
+    bool queueContact(PhysicsContact& contact, PhysicsContact::EventCode code);
+    void flushContactBatches();
+    bool hasContactListeners() const;
+    void stepSpace(float dt);
+
     virtual void doAddBody(PhysicsBody* body);
     virtual void doRemoveBody(PhysicsBody* body);
     virtual void doRemoveJoint(PhysicsJoint* joint);
@@ -427,6 +494,35 @@ protected:
     std::function<void()> _preUpdateCallback;
     std::function<void()> _postUpdateCallback;
 
+    struct ContactBatchCallback
+    {
+        int id;
+        int categoryBitmask;
+        int group;
+        PhysicsContactBatchCallbackFunc callback;
+    };
+    std::vector<ContactBatchCallback> _contactBatchCallbacks;
+    int _contactBatchCallbackId = 0;
+    // indexed by EventCode - 1, separated contacts are recycled once their batch is delivered
+    std::vector<PhysicsContact*> _contactBatches[4];
+    std::vector<PhysicsContact*> _filteredContacts;
+    std::vector<PhysicsContact*> _contactPool;
+    bool _hasContactListeners = true;
+
+    // bodies in node tree order with their parent transforms, recorded before the step to sync them in one pass.
+    // The bodies are retained: contact callbacks flushed by stepSpace() may remove and release them before the sync.
+    struct BodySync
+    {
+        RefPtr<PhysicsBody> body;
+        Mat4 worldToParentTransform;
+        float parentRotation;
+    };
+    std::vector<BodySync> _bodySyncs;
+    bool _interpolationEnabled = false;
+    bool _deterministic        = false;
+    int _threads               = 0;
+    int _iterations            = 10;  // solver iterations to restore when the simulation stops being deterministic
+
 protected:
     PhysicsWorld();
     virtual ~PhysicsWorld();
@@ -436,7 +532,7 @@ protected:
                           float nodeParentScaleX,
                           float nodeParentScaleY,
                           float parentRotation);
-    void afterSimulation(Node* node, const Mat4& parentToWorldTransform, float parentRotation);
+    void syncBodies(float alpha);
 
     friend class Node;
     friend class Sprite;
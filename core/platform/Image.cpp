@@ -30,6 +30,9 @@ THE SOFTWARE.
 #include "renderer/backend/PixelFormatUtils.h"
 
 #include <string>
+#include <limits>
+#include <atomic>
+#include <thread>
 #include <ctype.h>
 
 #include "base/axstd.h"
@@ -105,6 +108,7 @@ struct dirent* readdir$INODE64(DIR* dir)
 } /* extern "C" */
 
 #include "base/ktxspec_v1.h"
+#include "base/ktxspec_v2.h"
 
 #include "base/s3tc.h"
 #include "base/atitc.h"
@@ -127,6 +131,12 @@ struct dirent* readdir$INODE64(DIR* dir)
 #include "base/Configuration.h"
 #include "base/Utils.h"
 #include "base/ZipUtils.h"
+#include "base/JobSystem.h"
+#include "base/AsyncTaskPool.h"
+#include "base/Director.h"
+#include "xxhash.h"
+#include "fmt/format.h"
+#include "zlib.h"
 #if (AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID)
 #    include "platform/android/FileUtils-android.h"
 #    include "platform/GL.h"
@@ -540,11 +550,250 @@ static uint32_t makeFourCC(char ch0, char ch1, char ch2, char ch3)
 }
 }  // namespace
 
+namespace
+{
+// A mip level decoded by rows of 4x4 blocks, every block row is independent from the others for all the block
+// compressed formats, so the rows of all the levels are decoded in parallel
+struct BlockDecodeLevel
+{
+    const uint8_t* in;
+    uint8_t* out;
+    int width;
+    int height;
+    int blockRows;
+    size_t inRowPitch;  // compressed bytes of one block row
+};
+
+// decodes one row of blocks `in` into `height` (at most 4) pixel rows `out`
+typedef std::function<void(const uint8_t* in, uint8_t* out, int width, int height)> BlockDecodeFunc;
+
+static const size_t BLOCK_ROWS_PER_JOB = 16;
+
+static void decodeBlocksParallel(const std::vector<BlockDecodeLevel>& levels, const BlockDecodeFunc& decode)
+{
+    std::vector<size_t> firstRows(levels.size() + 1, 0);
+    for (size_t i = 0; i < levels.size(); ++i)
+        firstRows[i + 1] = firstRows[i] + levels[i].blockRows;
+
+    JobSystem::getInstance()->parallelFor(firstRows.back(), BLOCK_ROWS_PER_JOB, [&](size_t begin, size_t end) {
+        // a job may span the last rows of a level and the first rows of the next ones, the decoders are invoked
+        // by single block rows as s3tc_decode and atitc_decode skew the rows of images with partial blocks
+        size_t level = std::upper_bound(firstRows.begin(), firstRows.end(), begin) - firstRows.begin() - 1;
+        for (size_t i = begin; i < end; ++i)
+        {
+            while (i >= firstRows[level + 1])
+                ++level;
+
+            auto& l       = levels[level];
+            const int row = static_cast<int>(i - firstRows[level]);
+            decode(l.in + row * l.inRowPitch, l.out + static_cast<size_t>(row) * 4 * l.width * 4, l.width,
+                   std::min(4, l.height - row * 4));
+        }
+    });
+}
+
+// etc2_decode_image always decode to RGBA8888
+static bool decodeETC2(uint32_t format, const uint8_t* in, uint8_t* out, int width, int height)
+{
+    if (format != ETC2_RGB_NO_MIPMAPS && format != ETC2_RGBA_NO_MIPMAPS)
+        return false;
+
+    const size_t blockSize = format == ETC2_RGBA_NO_MIPMAPS ? 16 : 8;
+    std::atomic<bool> failed{false};
+    decodeBlocksParallel({{in, out, width, height, (height + 3) / 4, ((width + 3) / 4) * blockSize}},
+                         [format, &failed](const uint8_t* in, uint8_t* out, int width, int height) {
+        if (etc2_decode_image(format, in, out, width, height) != 0)
+            failed.store(true, std::memory_order_relaxed);
+    });
+    return !failed.load(std::memory_order_relaxed);
+}
+
+static backend::PixelFormat getKTX2PixelFormat(uint32_t vkFormat)
+{
+    using VkFormat = KTXv2Header::VkFormat;
+    switch (vkFormat)
+    {
+    case VkFormat::R8G8B8_UNORM:
+        return backend::PixelFormat::RGB8;
+    case VkFormat::R8G8B8A8_UNORM:
+        return backend::PixelFormat::RGBA8;
+    case VkFormat::BC1_RGB_UNORM_BLOCK:
+    case VkFormat::BC1_RGBA_UNORM_BLOCK:
+        return backend::PixelFormat::S3TC_DXT1;
+    case VkFormat::BC2_UNORM_BLOCK:
+        return backend::PixelFormat::S3TC_DXT3;
+    case VkFormat::BC3_UNORM_BLOCK:
+        return backend::PixelFormat::S3TC_DXT5;
+    case VkFormat::ETC2_R8G8B8_UNORM_BLOCK:
+        return backend::PixelFormat::ETC2_RGB;
+    case VkFormat::ETC2_R8G8B8A8_UNORM_BLOCK:
+        return backend::PixelFormat::ETC2_RGBA;
+    case VkFormat::ASTC_4x4_UNORM_BLOCK:
+        return backend::PixelFormat::ASTC4x4;
+    case VkFormat::ASTC_5x5_UNORM_BLOCK:
+        return backend::PixelFormat::ASTC5x5;
+    case VkFormat::ASTC_6x6_UNORM_BLOCK:
+        return backend::PixelFormat::ASTC6x6;
+    case VkFormat::ASTC_8x5_UNORM_BLOCK:
+        return backend::PixelFormat::ASTC8x5;
+    case VkFormat::ASTC_8x6_UNORM_BLOCK:
+        return backend::PixelFormat::ASTC8x6;
+    case VkFormat::ASTC_8x8_UNORM_BLOCK:
+        return backend::PixelFormat::ASTC8x8;
+    case VkFormat::ASTC_10x5_UNORM_BLOCK:
+        return backend::PixelFormat::ASTC10x5;
+    default:
+        return backend::PixelFormat::NONE;
+    }
+}
+
+// the engine samples every texture as UNORM, loading these would show them with the wrong gamma
+static bool isKTX2SRGBFormat(uint32_t vkFormat)
+{
+    using VkFormat = KTXv2Header::VkFormat;
+    switch (vkFormat)
+    {
+    case VkFormat::R8G8B8_SRGB:
+    case VkFormat::R8G8B8A8_SRGB:
+    case VkFormat::BC1_RGB_SRGB_BLOCK:
+    case VkFormat::BC1_RGBA_SRGB_BLOCK:
+    case VkFormat::BC2_SRGB_BLOCK:
+    case VkFormat::BC3_SRGB_BLOCK:
+    case VkFormat::ETC2_R8G8B8_SRGB_BLOCK:
+    case VkFormat::ETC2_R8G8B8A8_SRGB_BLOCK:
+    case VkFormat::ASTC_4x4_SRGB_BLOCK:
+    case VkFormat::ASTC_5x5_SRGB_BLOCK:
+    case VkFormat::ASTC_6x6_SRGB_BLOCK:
+    case VkFormat::ASTC_8x5_SRGB_BLOCK:
+    case VkFormat::ASTC_8x6_SRGB_BLOCK:
+    case VkFormat::ASTC_8x8_SRGB_BLOCK:
+    case VkFormat::ASTC_10x5_SRGB_BLOCK:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool isPixelFormatSupported(backend::PixelFormat format)
+{
+    auto configuration = Configuration::getInstance();
+    switch (format)
+    {
+    case backend::PixelFormat::S3TC_DXT1:
+    case backend::PixelFormat::S3TC_DXT3:
+    case backend::PixelFormat::S3TC_DXT5:
+        return configuration->supportsS3TC();
+    case backend::PixelFormat::ETC2_RGB:
+    case backend::PixelFormat::ETC2_RGBA:
+        return configuration->supportsETC2();
+    case backend::PixelFormat::ASTC4x4:
+    case backend::PixelFormat::ASTC5x5:
+    case backend::PixelFormat::ASTC6x6:
+    case backend::PixelFormat::ASTC8x5:
+    case backend::PixelFormat::ASTC8x6:
+    case backend::PixelFormat::ASTC8x8:
+    case backend::PixelFormat::ASTC10x5:
+        return configuration->supportsASTC();
+    default:
+        return true;
+    }
+}
+
+// decodes the mip levels of a block compressed format to RGBA8
+static bool decodeMipmapsToRGBA8(backend::PixelFormat format,
+                                 const MipmapInfo* mipmaps,
+                                 int numberOfMipmaps,
+                                 int width,
+                                 int height,
+                                 MipmapInfo* outMipmaps)
+{
+    auto& descriptor       = backend::PixelFormatUtils::getFormatDescriptor(format);
+    const size_t blockSize = descriptor.blockSize;
+    switch (format)
+    {
+    case backend::PixelFormat::ETC2_RGB:
+    case backend::PixelFormat::ETC2_RGBA:
+    {
+        const uint32_t etc2Format = format == backend::PixelFormat::ETC2_RGBA ? ETC2_RGBA_NO_MIPMAPS : ETC2_RGB_NO_MIPMAPS;
+
+        std::vector<BlockDecodeLevel> levels;
+        for (int i = 0; i < numberOfMipmaps; ++i)
+        {
+            const int w = std::max(width >> i, 1), h = std::max(height >> i, 1);
+            levels.push_back({mipmaps[i].address, outMipmaps[i].address, w, h, (h + 3) / 4, ((w + 3) / 4) * blockSize});
+        }
+        std::atomic<bool> failed{false};
+        decodeBlocksParallel(levels, [etc2Format, &failed](const uint8_t* in, uint8_t* out, int width, int height) {
+            if (etc2_decode_image(etc2Format, in, out, width, height) != 0)
+                failed.store(true, std::memory_order_relaxed);
+        });
+        return !failed.load(std::memory_order_relaxed);
+    }
+    case backend::PixelFormat::S3TC_DXT1:
+    case backend::PixelFormat::S3TC_DXT3:
+    case backend::PixelFormat::S3TC_DXT5:
+    {
+        const auto flag = format == backend::PixelFormat::S3TC_DXT1   ? S3TCDecodeFlag::DXT1
+                          : format == backend::PixelFormat::S3TC_DXT3 ? S3TCDecodeFlag::DXT3
+                                                                      : S3TCDecodeFlag::DXT5;
+
+        // s3tc_decode only decodes whole blocks
+        std::vector<BlockDecodeLevel> levels;
+        for (int i = 0; i < numberOfMipmaps; ++i)
+        {
+            const int w = std::max(width >> i, 1), h = std::max(height >> i, 1);
+            memset(outMipmaps[i].address, 0, outMipmaps[i].len);
+            levels.push_back({mipmaps[i].address, outMipmaps[i].address, w, h, h / 4, ((w + 3) / 4) * blockSize});
+        }
+        decodeBlocksParallel(levels, [flag](const uint8_t* in, uint8_t* out, int width, int height) {
+            s3tc_decode(const_cast<uint8_t*>(in), out, width, height, flag);
+        });
+        return true;
+    }
+    case backend::PixelFormat::ASTC4x4:
+    case backend::PixelFormat::ASTC5x5:
+    case backend::PixelFormat::ASTC6x6:
+    case backend::PixelFormat::ASTC8x5:
+    case backend::PixelFormat::ASTC8x6:
+    case backend::PixelFormat::ASTC8x8:
+    case backend::PixelFormat::ASTC10x5:
+    {
+        // astc_decompress_image decodes the blocks of one level in parallel already
+        for (int i = 0; i < numberOfMipmaps; ++i)
+        {
+            const int w = std::max(width >> i, 1), h = std::max(height >> i, 1);
+            if (astc_decompress_image(mipmaps[i].address, mipmaps[i].len, outMipmaps[i].address, w, h,
+                                      descriptor.blockWidth, descriptor.blockHeight) != 0)
+                return false;
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+static const uint32_t DECODE_CACHE_MAGIC   = 0x43445841;  // AXDC
+static const uint32_t DECODE_CACHE_VERSION = 1;
+
+// followed by the length of each mipmap and the RGBA8 pixels
+struct DecodeCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t numberOfMipmaps;
+    uint32_t dataLen;
+};
+}  // namespace
+
 //////////////////////////////////////////////////////////////////////////
 // Implement Image
 //////////////////////////////////////////////////////////////////////////
 bool Image::PNG_PREMULTIPLIED_ALPHA_ENABLED = true;
 uint32_t Image::COMPRESSED_IMAGE_PMA_FLAGS  = Image::CompressedImagePMAFlag::DUAL_SAMPLER;
+bool Image::DECODE_CACHE_ENABLED            = false;
 
 void Image::setCompressedImagesHavePMA(uint32_t targets, bool havePMA)
 {
@@ -570,6 +819,7 @@ Image::Image()
     , _pixelFormat(backend::PixelFormat::NONE)
     , _numberOfMipmaps(0)
     , _hasPremultipliedAlpha(false)
+    , _pngCompressionLevel(-1)
 {}
 
 Image::~Image()
@@ -688,6 +938,9 @@ bool Image::initWithImageData(uint8_t* data, ssize_t dataLen, bool ownData)
         case Format::ASTC:
             ret = initWithASTCData(unpackedData, unpackedLen, ownData);
             break;
+        case Format::KTX2:
+            ret = initWithKTX2Data(unpackedData, unpackedLen, ownData);
+            break;
         case Format::BMP:
             ret = initWithBmpData(unpackedData, unpackedLen);
             break;
@@ -748,6 +1001,22 @@ bool Image::initWithRawData(const uint8_t* data,
     return ret;
 }
 
+bool Image::initWithRawData(Data&& data, int width, int height, int /*bitsPerComponent*/, bool preMulti)
+{
+    // only RGBA8888 supported
+    const ssize_t dataLen = static_cast<ssize_t>(width) * height * 4;
+    if (0 >= width || 0 >= height || data.getSize() < dataLen)
+        return false;
+
+    _height                = height;
+    _width                 = width;
+    _hasPremultipliedAlpha = preMulti;
+    _pixelFormat           = backend::PixelFormat::RGBA8;
+    _dataLen               = dataLen;
+    _data                  = data.takeBuffer(nullptr);
+    return true;
+}
+
 bool Image::isPng(const uint8_t* data, ssize_t dataLen)
 {
     if (dataLen <= 8)
@@ -792,6 +1061,16 @@ bool Image::isASTC(const uint8_t* data, ssize_t /*dataLen*/)
     return (magicval & 0x0FFFFFFF) == (ASTC_MAGIC_ID & 0x0FFFFFFF);  // wildcard check
 }
 
+bool Image::isKTX2(const uint8_t* data, ssize_t dataLen)
+{
+    if (dataLen < KTX_V2_HEADER_SIZE)
+        return false;
+
+    auto header = (const KTXv2Header*)data;
+    return header->identifier[0] == 0xAB &&
+           memcmp(&header->identifier[1], KTX_V2_MAGIC, sizeof(KTX_V2_MAGIC) - 1) == 0;
+}
+
 bool Image::isJpg(const uint8_t* data, ssize_t dataLen)
 {
     if (dataLen <= 4)
@@ -869,6 +1148,10 @@ Image::Format Image::detectFormat(const uint8_t* data, ssize_t dataLen)
     {
         return Format::ASTC;
     }
+    else if (isKTX2(data, dataLen))
+    {
+        return Format::KTX2;
+    }
     else if (dataLen >= KTX_V1_HEADER_SIZE)
     {  // Check whether ktxspec v1.1 file format
         auto header = (KTXv1Header*)data;
@@ -1738,9 +2021,10 @@ bool Image::initWithPVRv3Data(uint8_t* data, ssize_t dataLen, bool ownData)
                 _unpack                = true;
                 _mipmaps[i].len        = width * height * bytePerPixel;
                 _mipmaps[i].address    = (uint8_t*)malloc(width * height * bytePerPixel);
-                if (etc2_decode_image(ETC2_RGB_NO_MIPMAPS, pixelData + dataOffset,
-                                      static_cast<etc1_byte*>(_mipmaps[i].address), width, height) != 0)
+                if (!decodeETC2(ETC2_RGB_NO_MIPMAPS, pixelData + dataOffset, _mipmaps[i].address, width, height))
                 {
+                    // the decoded levels are released by the destructor
+                    AXLOG("axmol: Image. ETC1 software decode failed");
                     return false;
                 }
             }
@@ -1846,20 +2130,27 @@ bool Image::initWithETCData(uint8_t* data, ssize_t dataLen, bool ownData)
     {
         AXLOG("axmol: Hardware ETC1 decoder not present. Using software decoder");
 
+        const uint64_t cacheKey = DECODE_CACHE_ENABLED ? XXH64(data, dataLen, 0) : 0;
+        if (DECODE_CACHE_ENABLED && loadDecodeCache(cacheKey))
+            return true;
+
+        // if it is not gles or device do not support ETC1, decode texture by software
+        // directly decode ETC1_RGB to RGBA8888
         _dataLen = _width * _height * 4;
         _data    = static_cast<uint8_t*>(malloc(_dataLen));
-        if (etc2_decode_image(ETC2_RGB_NO_MIPMAPS, static_cast<const uint8_t*>(data) + pixelOffset,
-                              static_cast<etc2_byte*>(_data), _width, _height) == 0)
-        {  // if it is not gles or device do not support ETC1, decode texture by software
-           // directly decode ETC1_RGB to RGBA8888
-            _pixelFormat = backend::PixelFormat::RGBA8;
-            return true;
+        if (UTILS_UNLIKELY(!decodeETC2(ETC2_RGB_NO_MIPMAPS, static_cast<const uint8_t*>(data) + pixelOffset, _data,
+                                       _width, _height)))
+        {
+            // software decode fail, release pixels data
+            AX_SAFE_FREE(_data);
+            _dataLen = 0;
+            return false;
         }
+        _pixelFormat = backend::PixelFormat::RGBA8;
 
-        // software decode fail, release pixels data
-        AX_SAFE_FREE(_data);
-        _dataLen = 0;
-        return false;
+        if (DECODE_CACHE_ENABLED)
+            saveDecodeCache(cacheKey);
+        return true;
     }
 }
 
@@ -1911,19 +2202,26 @@ bool Image::initWithETC2Data(uint8_t* data, ssize_t dataLen, bool ownData)
         {
             AXLOG("axmol: Hardware ETC2 decoder not present. Using software decoder");
 
-            // if device do not support ETC2, decode texture by software
-            // etc2_decode_image always decode to RGBA8888
-            _dataLen = _width * _height * 4;
-            _data    = static_cast<uint8_t*>(malloc(_dataLen));
-            if (UTILS_UNLIKELY(etc2_decode_image(format, static_cast<const uint8_t*>(data) + pixelOffset,
-                                                 static_cast<etc2_byte*>(_data), _width, _height) != 0))
+            const uint64_t cacheKey = DECODE_CACHE_ENABLED ? XXH64(data, dataLen, 0) : 0;
+            if (!DECODE_CACHE_ENABLED || !loadDecodeCache(cacheKey))
             {
-                // software decode fail, release pixels data
-                AX_SAFE_FREE(_data);
-                _dataLen = 0;
-                break;
+                // if device do not support ETC2, decode texture by software
+                // etc2_decode_image always decode to RGBA8888
+                _dataLen = _width * _height * 4;
+                _data    = static_cast<uint8_t*>(malloc(_dataLen));
+                if (UTILS_UNLIKELY(
+                        !decodeETC2(format, static_cast<const uint8_t*>(data) + pixelOffset, _data, _width, _height)))
+                {
+                    // software decode fail, release pixels data
+                    AX_SAFE_FREE(_data);
+                    _dataLen = 0;
+                    break;
+                }
+                _pixelFormat = backend::PixelFormat::RGBA8;
+
+                if (DECODE_CACHE_ENABLED)
+                    saveDecodeCache(cacheKey);
             }
-            _pixelFormat = backend::PixelFormat::RGBA8;
         }
 
         _hasPremultipliedAlpha = isCompressedImageHavePMA(CompressedImagePMAFlag::ETC2);
@@ -2020,6 +2318,184 @@ bool Image::initWithASTCData(uint8_t* data, ssize_t dataLen, bool ownData)
     return false;
 }
 
+bool Image::initWithKTX2Data(uint8_t* data, ssize_t dataLen, bool ownData)
+{
+    auto header = (const KTXv2Header*)data;
+
+    do
+    {
+        _width                    = header->pixelWidth;
+        _height                   = header->pixelHeight;
+        const uint32_t levelCount = std::max(header->levelCount, 1u);
+
+        if (0 == _width || 0 == _height)
+            break;
+
+        if (header->pixelDepth > 1 || header->layerCount > 1 || header->faceCount != 1 || levelCount > MIPMAP_MAX)
+        {
+            AXLOG("axmol: KTX2 volume, array and cube map textures are not supported");
+            break;
+        }
+
+        // Basis Universal textures have to be transcoded, and zstd/BasisLZ supercompressed ones inflated, with
+        // libraries we don't ship
+        if (header->vkFormat == KTXv2Header::VkFormat::UNDEFINED)
+        {
+            AXLOG("axmol: KTX2 Basis Universal textures are not supported, please encode them to a block format");
+            break;
+        }
+        const bool zlib = header->supercompressionScheme == KTXv2Header::SupercompressionScheme::ZLIB;
+        if (header->supercompressionScheme != KTXv2Header::SupercompressionScheme::NONE && !zlib)
+        {
+            AXLOG("axmol: KTX2 supercompression scheme %u is not supported", header->supercompressionScheme);
+            break;
+        }
+
+        if (isKTX2SRGBFormat(header->vkFormat))
+        {
+            AXLOG("axmol: KTX2 sRGB vkFormat %u is not supported, please encode the texture as UNORM",
+                  header->vkFormat);
+            break;
+        }
+
+        const auto format = getKTX2PixelFormat(header->vkFormat);
+        if (format == backend::PixelFormat::NONE)
+        {
+            AXLOG("axmol: KTX2 vkFormat %u is not supported", header->vkFormat);
+            break;
+        }
+
+        if (static_cast<size_t>(dataLen) < KTX_V2_HEADER_SIZE + levelCount * sizeof(KTXv2LevelIndex))
+            break;
+        auto levels = (const KTXv2LevelIndex*)(data + KTX_V2_HEADER_SIZE);
+
+        // each level must lie inside the file and hold exactly the blocks of its size. The checks are done in 64 bits
+        // so they can't overflow, and everything must fit the int offsets and MipmapInfo::len used below
+        auto& descriptor       = backend::PixelFormatUtils::getFormatDescriptor(format);
+        const uint64_t fileLen = static_cast<uint64_t>(dataLen);
+        const uint64_t maxLen  = static_cast<uint64_t>((std::numeric_limits<int>::max)());
+        uint64_t levelsLen     = 0;
+        uint64_t decodedLen    = 0;  // the software fallback decodes to RGBA8
+        bool valid             = _width > 0 && _height > 0;
+        for (uint32_t i = 0; i < levelCount && valid; ++i)
+        {
+            const uint64_t w        = std::max<uint64_t>(header->pixelWidth >> i, 1);
+            const uint64_t h        = std::max<uint64_t>(header->pixelHeight >> i, 1);
+            const uint64_t levelLen = ((w + descriptor.blockWidth - 1) / descriptor.blockWidth) *
+                                      ((h + descriptor.blockHeight - 1) / descriptor.blockHeight) *
+                                      descriptor.blockSize;
+            auto& level = levels[i];
+            levelsLen += levelLen;
+            decodedLen += w * h * 4;
+            valid = level.byteOffset <= maxLen && level.byteLength <= maxLen && level.byteOffset <= fileLen &&
+                    level.byteLength <= fileLen - level.byteOffset &&
+                    (zlib ? level.uncompressedByteLength : level.byteLength) == levelLen && levelsLen <= maxLen &&
+                    decodedLen <= maxLen;
+        }
+        if (!valid)
+        {
+            AXLOG("axmol: KTX2 level index is corrupted");
+            break;
+        }
+
+        if (static_cast<uint64_t>(header->dfdByteOffset) + 16 <= static_cast<uint64_t>(dataLen))
+        {  // the flags byte of the basic descriptor block, after the total size of the data format descriptor
+            _hasPremultipliedAlpha = data[header->dfdByteOffset + 15] & KTXv2Header::DFDFlag::ALPHA_PREMULTIPLIED;
+        }
+
+        _numberOfMipmaps = static_cast<int>(levelCount);
+
+        if (isPixelFormatSupported(format) && !zlib && ownData)
+        {  // the levels can be uploaded from the file data directly
+            _pixelFormat = format;
+            for (int i = 0; i < _numberOfMipmaps; ++i)
+            {
+                _mipmaps[i].address = data + levels[i].byteOffset;
+                _mipmaps[i].len     = static_cast<int>(levels[i].byteLength);
+            }
+            forwardPixels(data, static_cast<ssize_t>(levels[0].byteOffset + levels[0].byteLength),
+                          static_cast<int>(levels[0].byteOffset), true);
+            return true;
+        }
+
+        // unpack the levels to one buffer, the base level first
+        auto levelsData = static_cast<uint8_t*>(malloc(levelsLen));
+        MipmapInfo mipmaps[MIPMAP_MAX];
+        size_t offset = 0;
+        for (int i = 0; i < _numberOfMipmaps && valid; ++i)
+        {
+            auto& level        = levels[i];
+            mipmaps[i].address = levelsData + offset;
+            mipmaps[i].len     = static_cast<int>(zlib ? level.uncompressedByteLength : level.byteLength);
+            if (zlib)
+            {
+                uLongf destLen = static_cast<uLongf>(level.uncompressedByteLength);
+                valid          = uncompress(mipmaps[i].address, &destLen, data + level.byteOffset,
+                                            static_cast<uLong>(level.byteLength)) == Z_OK &&
+                        destLen == level.uncompressedByteLength;
+            }
+            else
+                memcpy(mipmaps[i].address, data + level.byteOffset, mipmaps[i].len);
+            offset += mipmaps[i].len;
+        }
+        if (!valid)
+        {
+            AXLOG("axmol: KTX2 level data is corrupted");
+            free(levelsData);
+            break;
+        }
+
+        if (isPixelFormatSupported(format))
+        {
+            _pixelFormat = format;
+            _data        = levelsData;
+            _dataLen     = static_cast<ssize_t>(levelsLen);
+            std::copy(mipmaps, mipmaps + _numberOfMipmaps, _mipmaps);
+            return true;
+        }
+
+        AXLOG("axmol: Hardware %s decoder not present. Using software decoder",
+              backend::PixelFormatUtils::getFormatDescriptor(format).name);
+
+        const uint64_t cacheKey = DECODE_CACHE_ENABLED ? XXH64(data, dataLen, 0) : 0;
+        if (DECODE_CACHE_ENABLED && loadDecodeCache(cacheKey))
+        {
+            free(levelsData);
+            return true;
+        }
+
+        _dataLen = 0;
+        for (int i = 0; i < _numberOfMipmaps; ++i)
+            _dataLen += std::max(_width >> i, 1) * std::max(_height >> i, 1) * 4;
+        _data = static_cast<uint8_t*>(malloc(_dataLen));
+
+        offset = 0;
+        for (int i = 0; i < _numberOfMipmaps; ++i)
+        {
+            _mipmaps[i].address = _data + offset;
+            _mipmaps[i].len     = std::max(_width >> i, 1) * std::max(_height >> i, 1) * 4;
+            offset += _mipmaps[i].len;
+        }
+
+        valid = decodeMipmapsToRGBA8(format, mipmaps, _numberOfMipmaps, _width, _height, _mipmaps);
+        free(levelsData);
+        if (!valid)
+        {
+            AX_SAFE_FREE(_data);
+            _dataLen = 0;
+            break;
+        }
+        _pixelFormat = backend::PixelFormat::RGBA8;
+
+        if (DECODE_CACHE_ENABLED)
+            saveDecodeCache(cacheKey);
+
+        return true;
+    } while (false);
+
+    return false;
+}
+
 bool Image::initWithS3TCData(uint8_t* data, ssize_t dataLen, bool ownData)
 {
     const uint32_t FOURCC_DXT1 = makeFourCC('D', 'X', 'T', '1');
@@ -2046,7 +2522,8 @@ bool Image::initWithS3TCData(uint8_t* data, ssize_t dataLen, bool ownData)
     const int pixelOffset = sizeof(S3TCTexHeader);
     uint8_t* pixelData    = data + pixelOffset;
 
-    bool hardware = Configuration::getInstance()->supportsS3TC();
+    bool hardware     = Configuration::getInstance()->supportsS3TC();
+    uint64_t cacheKey = 0;
     /* if hardware supports s3tc, set pixelformat before loading mipmaps, to support non-mipmapped textures  */
     if (hardware)
     {  // decode texture through hardware
@@ -2066,6 +2543,12 @@ bool Image::initWithS3TCData(uint8_t* data, ssize_t dataLen, bool ownData)
     }
     else
     {  // will software decode
+        AXLOG("axmol: Hardware S3TC decoder not present. Using software decoder");
+
+        cacheKey = DECODE_CACHE_ENABLED ? XXH64(data, dataLen, 0) : 0;
+        if (DECODE_CACHE_ENABLED && loadDecodeCache(cacheKey))
+            return true;
+
         _pixelFormat = backend::PixelFormat::RGBA8;
 
         // prepare data for software decompress
@@ -2090,6 +2573,7 @@ bool Image::initWithS3TCData(uint8_t* data, ssize_t dataLen, bool ownData)
     width            = _width;
     height           = _height;
 
+    std::vector<BlockDecodeLevel> decodeLevels;
     for (int i = 0; i < _numberOfMipmaps && (width || height); ++i)
     {
         if (width == 0)
@@ -2099,36 +2583,21 @@ bool Image::initWithS3TCData(uint8_t* data, ssize_t dataLen, bool ownData)
 
         int size = ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
 
-        if (Configuration::getInstance()->supportsS3TC())
+        if (hardware)
         {  // decode texture through hardware
             _mipmaps[i].address = (uint8_t*)pixelData + encodeOffset;
             _mipmaps[i].len     = size;
         }
         else
-        {  // if it is not gles or device do not support S3TC, decode texture by software
-
-            AXLOG("axmol: Hardware S3TC decoder not present. Using software decoder");
-
+        {  // if it is not gles or device do not support S3TC, decode texture by software, s3tc_decode only
+           // decodes whole blocks
             int bytePerPixel    = 4;
             unsigned int stride = width * bytePerPixel;
 
-            auto decodeImageData = axstd::make_unique_for_overwrite<uint8_t[]>(stride * height);
-            if (FOURCC_DXT1 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
-            {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT1);
-            }
-            else if (FOURCC_DXT3 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
-            {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT3);
-            }
-            else if (FOURCC_DXT5 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
-            {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT5);
-            }
-
             _mipmaps[i].address = (uint8_t*)_data + decodeOffset;
             _mipmaps[i].len     = (stride * height);
-            memcpy((void*)_mipmaps[i].address, (void*)&decodeImageData[0], _mipmaps[i].len);
+            decodeLevels.push_back({pixelData + encodeOffset, _mipmaps[i].address, width, height, height / 4,
+                                    static_cast<size_t>((width + 3) / 4) * blockSize});
             decodeOffset += stride * height;
         }
 
@@ -2143,6 +2612,22 @@ bool Image::initWithS3TCData(uint8_t* data, ssize_t dataLen, bool ownData)
     {
         forwardPixels(data, dataLen, pixelOffset, ownData);
     }
+    else
+    {
+        const auto fourCC = header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC;
+        if (fourCC == FOURCC_DXT1 || fourCC == FOURCC_DXT3 || fourCC == FOURCC_DXT5)
+        {
+            const auto flag = fourCC == FOURCC_DXT1   ? S3TCDecodeFlag::DXT1
+                              : fourCC == FOURCC_DXT3 ? S3TCDecodeFlag::DXT3
+                                                      : S3TCDecodeFlag::DXT5;
+            decodeBlocksParallel(decodeLevels, [flag](const uint8_t* in, uint8_t* out, int width, int height) {
+                s3tc_decode(const_cast<uint8_t*>(in), out, width, height, flag);
+            });
+
+            if (DECODE_CACHE_ENABLED)
+                saveDecodeCache(cacheKey);
+        }
+    }
 
     return true;
 }
@@ -2179,7 +2664,8 @@ bool Image::initWithATITCData(uint8_t* data, ssize_t dataLen, bool ownData)
     int width  = _width;
     int height = _height;
 
-    bool hardware = Configuration::getInstance()->supportsATITC();
+    bool hardware     = Configuration::getInstance()->supportsATITC();
+    uint64_t cacheKey = 0;
     if (hardware)  // compressed data length
     {
         AXLOG("this is atitc H decode");
@@ -2204,6 +2690,10 @@ bool Image::initWithATITCData(uint8_t* data, ssize_t dataLen, bool ownData)
 
         AXLOG("axmol: Hardware ATITC decoder not present. Using software decoder");
 
+        cacheKey = DECODE_CACHE_ENABLED ? XXH64(data, dataLen, 0) : 0;
+        if (DECODE_CACHE_ENABLED && loadDecodeCache(cacheKey))
+            return true;
+
         _pixelFormat = backend::PixelFormat::RGBA8;
 
         for (int i = 0; i < _numberOfMipmaps && (width || height); ++i)
@@ -2227,6 +2717,7 @@ bool Image::initWithATITCData(uint8_t* data, ssize_t dataLen, bool ownData)
     width            = _width;
     height           = _height;
 
+    std::vector<BlockDecodeLevel> decodeLevels;
     for (int i = 0; i < _numberOfMipmaps && (width || height); ++i)
     {
         if (width == 0)
@@ -2247,27 +2738,10 @@ bool Image::initWithATITCData(uint8_t* data, ssize_t dataLen, bool ownData)
             int bytePerPixel    = 4;
             unsigned int stride = width * bytePerPixel;
 
-            std::vector<uint8_t> decodeImageData(stride * height);
-            switch (header->glInternalFormat)
-            {
-            case KTXv1Header::InternalFormat::ATC_RGB_AMD:
-                atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_RGB);
-                break;
-            case KTXv1Header::InternalFormat::ATC_RGBA_EXPLICIT_ALPHA_AMD:
-                atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height,
-                             ATITCDecodeFlag::ATC_EXPLICIT_ALPHA);
-                break;
-            case KTXv1Header::InternalFormat::ATC_RGBA_INTERPOLATED_ALPHA_AMD:
-                atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height,
-                             ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA);
-                break;
-            default:
-                break;
-            }
-
             _mipmaps[i].address = (uint8_t*)_data + decodeOffset;
             _mipmaps[i].len     = (stride * height);
-            memcpy((void*)_mipmaps[i].address, (void*)&decodeImageData[0], _mipmaps[i].len);
+            decodeLevels.push_back({pixelData + encodeOffset, _mipmaps[i].address, width, height, height / 4,
+                                    static_cast<size_t>((width + 3) / 4) * blockSize});
             decodeOffset += stride * height;
         }
 
@@ -2281,6 +2755,36 @@ bool Image::initWithATITCData(uint8_t* data, ssize_t dataLen, bool ownData)
     {
         forwardPixels(data, dataLen, pixelOffset, ownData);
     }
+    else
+    {
+        ATITCDecodeFlag flag = ATITCDecodeFlag::ATC_RGB;
+        bool supported       = true;
+        switch (header->glInternalFormat)
+        {
+        case KTXv1Header::InternalFormat::ATC_RGB_AMD:
+            flag = ATITCDecodeFlag::ATC_RGB;
+            break;
+        case KTXv1Header::InternalFormat::ATC_RGBA_EXPLICIT_ALPHA_AMD:
+            flag = ATITCDecodeFlag::ATC_EXPLICIT_ALPHA;
+            break;
+        case KTXv1Header::InternalFormat::ATC_RGBA_INTERPOLATED_ALPHA_AMD:
+            flag = ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA;
+            break;
+        default:
+            supported = false;
+            break;
+        }
+
+        if (supported)
+        {
+            decodeBlocksParallel(decodeLevels, [flag](const uint8_t* in, uint8_t* out, int width, int height) {
+                atitc_decode(const_cast<uint8_t*>(in), out, width, height, flag);
+            });
+
+            if (DECODE_CACHE_ENABLED)
+                saveDecodeCache(cacheKey);
+        }
+    }
 
     return true;
 }
@@ -2306,6 +2810,98 @@ void Image::forwardPixels(uint8_t* data, ssize_t dataLen, int offset, bool ownDa
     }
 }
 
+std::string Image::getDecodeCachePath(uint64_t key)
+{
+    return fmt::format("{}imagecache/{:016x}.axic", FileUtils::getInstance()->getWritablePath(), key);
+}
+
+bool Image::loadDecodeCache(uint64_t key)
+{
+    auto fileUtils = FileUtils::getInstance();
+    auto cachePath = getDecodeCachePath(key);
+    if (!fileUtils->isFileExist(cachePath))
+        return false;
+
+    Data cache = fileUtils->getDataFromFile(cachePath);
+    DecodeCacheHeader header;
+    if (cache.getSize() < static_cast<ssize_t>(sizeof(header)))
+        return false;
+    memcpy(&header, cache.getBytes(), sizeof(header));
+
+    // a truncated file is rejected by the length check, e.g. the app was killed while writing it
+    const int levels         = std::max(header.numberOfMipmaps, 1);
+    const size_t pixelOffset = sizeof(header) + levels * sizeof(uint32_t);
+    if (header.magic != DECODE_CACHE_MAGIC || header.version != DECODE_CACHE_VERSION || _width <= 0 ||
+        _height <= 0 || header.width != _width || header.height != _height || header.numberOfMipmaps < 0 ||
+        header.numberOfMipmaps > MIPMAP_MAX || static_cast<size_t>(cache.getSize()) != pixelOffset + header.dataLen)
+        return false;
+
+    // every level must hold exactly its RGBA8 pixels, and the levels must cover the pixel data
+    uint32_t mipLens[MIPMAP_MAX];
+    memcpy(mipLens, cache.getBytes() + sizeof(header), levels * sizeof(uint32_t));
+    uint64_t totalLen = 0;
+    for (int i = 0; i < levels; ++i)
+    {
+        const uint64_t expectedLen = uint64_t(std::max(_width >> i, 1)) * uint64_t(std::max(_height >> i, 1)) * 4;
+        if (mipLens[i] != expectedLen)
+            return false;
+        totalLen += mipLens[i];
+    }
+    if (totalLen != header.dataLen)
+        return false;
+
+    _numberOfMipmaps = header.numberOfMipmaps;
+    _pixelFormat     = backend::PixelFormat::RGBA8;
+    _data            = cache.takeBuffer(&_dataLen);
+    _offset          = pixelOffset;
+
+    size_t offset = pixelOffset;
+    for (int i = 0; i < _numberOfMipmaps; ++i)
+    {
+        _mipmaps[i].address = _data + offset;
+        _mipmaps[i].len     = mipLens[i];
+        offset += mipLens[i];
+    }
+
+    return true;
+}
+
+void Image::saveDecodeCache(uint64_t key)
+{
+    const int levels = std::max(_numberOfMipmaps, 1);
+    DecodeCacheHeader header{DECODE_CACHE_MAGIC,
+                             DECODE_CACHE_VERSION,
+                             _width,
+                             _height,
+                             _numberOfMipmaps,
+                             static_cast<uint32_t>(_dataLen)};
+
+    std::vector<uint8_t> buffer(sizeof(header) + levels * sizeof(uint32_t) + _dataLen);
+    memcpy(buffer.data(), &header, sizeof(header));
+    auto mipLens = buffer.data() + sizeof(header);
+    for (int i = 0; i < levels; ++i)
+    {
+        const uint32_t len = _numberOfMipmaps > 0 ? _mipmaps[i].len : static_cast<uint32_t>(_dataLen);
+        memcpy(mipLens + i * sizeof(uint32_t), &len, sizeof(len));
+    }
+    memcpy(mipLens + levels * sizeof(uint32_t), _data, _dataLen);
+
+    // writing is off the loading thread, the texture doesn't wait for the disk
+    JobSystem::getInstance()->enqueue([buffer = std::move(buffer), cachePath = getDecodeCachePath(key)]() {
+        auto fileUtils      = FileUtils::getInstance();
+        const auto cacheDir = fileUtils->getWritablePath() + "imagecache/";
+        if (!fileUtils->isDirectoryExist(cacheDir))
+            fileUtils->createDirectory(cacheDir);
+
+        // readers only ever see complete files, a crash leaves at most a stale temp file behind
+        const auto tempPath =
+            fmt::format("{}.{:x}.tmp", cachePath, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        if (FileUtils::writeBinaryToFile(buffer.data(), buffer.size(), tempPath) &&
+            !fileUtils->renameFile(tempPath, cachePath))
+            fileUtils->removeFile(tempPath);
+    });
+}
+
 #if (AX_TARGET_PLATFORM != AX_PLATFORM_IOS)
 bool Image::saveToFile(std::string_view filename, bool isToRGB)
 {
@@ -2336,6 +2932,32 @@ bool Image::saveToFile(std::string_view filename, bool isToRGB)
 }
 #endif
 
+void Image::saveToFileAsync(std::string_view filename, bool isToRGB, SaveFileResultCallback callback, bool asNonPMA)
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // the image is released on the axmol thread, the task is destroyed on the worker
+    auto task = [image = RefPtr<Image>(this), filename = std::string{filename}, isToRGB, asNonPMA,
+                 callback = std::move(callback), requestTime = clock_type::now()]() mutable {
+        SaveFileResult result;
+        auto encodeStart = clock_type::now();
+
+        if (asNonPMA && image->hasPremultipliedAlpha())
+            image->reversePremultipliedAlpha();
+        result.succeed    = image->saveToFile(filename, isToRGB);
+        result.filename   = std::move(filename);
+        result.waitTime   = std::chrono::duration<float>(encodeStart - requestTime).count();
+        result.encodeTime = std::chrono::duration<float>(clock_type::now() - encodeStart).count();
+
+        Director::getInstance()->getScheduler()->runOnAxmolThread(
+            [image = std::move(image), callback = std::move(callback), result = std::move(result)]() {
+            if (callback)
+                callback(result);
+        });
+    };
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, std::move(task));
+}
+
 bool Image::saveImageToPNG(std::string_view filePath, bool isToRGB)
 {
 #if AX_USE_WIC
@@ -2388,6 +3010,16 @@ bool Image::saveImageToPNG(std::string_view filePath, bool isToRGB)
                          PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
         }
 
+        if (_pngCompressionLevel >= 0)
+        {
+            png_set_compression_level(png_ptr, _pngCompressionLevel);
+            if (_pngCompressionLevel <= 2)
+            {
+                png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+                png_set_compression_strategy(png_ptr, Z_RLE);
+            }
+        }
+
         png_write_info(png_ptr, info_ptr);
 
         png_set_packing(png_ptr);
@@ -2590,12 +3222,7 @@ void Image::premultiplyAlpha()
 #if AX_ENABLE_PREMULTIPLIED_ALPHA
     AXASSERT(_pixelFormat == backend::PixelFormat::RGBA8, "The pixel format should be RGBA8888!");
 
-    unsigned int* fourBytes = (unsigned int*)_data;
-    for (int i = 0; i < _width * _height; i++)
-    {
-        uint8_t* p   = _data + i * 4;
-        fourBytes[i] = AX_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
-    }
+    backend::PixelFormatUtils::premultiplyAlphaRGBA8(_data, (size_t)_width * _height * 4);
 
     _hasPremultipliedAlpha = true;
 #else
@@ -2603,26 +3230,11 @@ void Image::premultiplyAlpha()
 #endif
 }
 
-static inline uint8_t clamp(int x)
-{
-    return (uint8_t)(x >= 0 ? (x < 255 ? x : 255) : 0);
-}
-
 void Image::reversePremultipliedAlpha()
 {
     AXASSERT(_pixelFormat == backend::PixelFormat::RGBA8, "The pixel format should be RGBA8888!");
 
-    unsigned int* fourBytes = (unsigned int*)_data;
-    for (int i = 0; i < _width * _height; i++)
-    {
-        uint8_t* p = _data + i * 4;
-        if (p[3] > 0)
-        {
-            fourBytes[i] = clamp(int(std::ceil((p[0] * 255.0f) / p[3]))) |
-                           clamp(int(std::ceil((p[1] * 255.0f) / p[3]))) << 8 |
-                           clamp(int(std::ceil((p[2] * 255.0f) / p[3]))) << 16 | p[3] << 24;
-        }
-    }
+    backend::PixelFormatUtils::reversePremultipliedAlphaRGBA8(_data, (size_t)_width * _height * 4);
 
     _hasPremultipliedAlpha = false;
 }
@@ -103,6 +103,8 @@ public:
         TGA,
         //! ASTC
         ASTC,
+        //! KTX2
+        KTX2,
         //! Raw Data
         RAW_DATA,
         //! Unknown format
@@ -140,6 +142,16 @@ public:
     static void setCompressedImagesHavePMA(uint32_t targets, bool havePMA);
     static bool isCompressedImageHavePMA(uint32_t target);
 
+    /**
+     * Enables or disables caching the software decoded pixels of ETC, S3TC and ATITC images on disk, so devices
+     * without the hardware decoder only decode them once. Cache files are stored in the writable path, keyed by
+     * the hash of the compressed data.
+     *
+     *  @param enabled (default: false)
+     */
+    static void setDecodeCacheEnabled(bool enabled) { DECODE_CACHE_ENABLED = enabled; }
+    static bool isDecodeCacheEnabled() { return DECODE_CACHE_ENABLED; }
+
     /**
     @brief Load the image from the specified path.
     @param path   the absolute file path.
@@ -167,6 +179,9 @@ public:
                          int bitsPerComponent,
                          bool preMulti = false);
 
+    /** Same as above, but takes over the buffer of data instead of copying it. data is empty afterwards on success. */
+    bool initWithRawData(Data&& data, int width, int height, int bitsPerComponent, bool preMulti = false);
+
     // Getters
     uint8_t* getData() { return _data + _offset; }
     ssize_t getDataLen() { return _dataLen - _offset; }
@@ -183,12 +198,44 @@ public:
     bool hasAlpha();
     bool isCompressed();
 
+    /** The result of saveToFileAsync, reported on the axmol thread. */
+    struct SaveFileResult
+    {
+        std::string filename;
+        bool succeed     = false;
+        float waitTime   = 0;  // seconds from the request until the encoding started
+        float encodeTime = 0;  // seconds spent to encode and write the file on the worker thread
+    };
+    typedef std::function<void(const SaveFileResult&)> SaveFileResultCallback;
+
     /**
      @brief    Save Image data to the specified file, with specified format.
      @param    filePath        the file's absolute path, including file suffix.
      @param    isToRGB        whether the image is saved as RGB format.
      */
     bool saveToFile(std::string_view filename, bool isToRGB = true);
+
+    /**
+     @brief    Save Image data to the specified file on a worker thread, the image is retained and must not be
+               modified until the callback is invoked on the axmol thread.
+     @param    filePath        the file's absolute path, including file suffix.
+     @param    isToRGB        whether the image is saved as RGB format.
+     @param    callback       invoked on the axmol thread when the file is written.
+     @param    asNonPMA       reverses premultiplied alpha before encoding, on the worker thread as well.
+     */
+    void saveToFileAsync(std::string_view filename,
+                         bool isToRGB,
+                         SaveFileResultCallback callback,
+                         bool asNonPMA = false);
+
+    /**
+     * Sets the zlib compression level (0-9) of the PNG files saved by this image, -1 is the libpng default.
+     * Levels up to 2 also select the SUB filter and the RLE strategy, which encode screenshots several times faster.
+     * Ignored when the image is encoded with WIC, whose PNG encoder doesn't expose the zlib level.
+     */
+    void setPNGCompressionLevel(int level) { _pngCompressionLevel = level; }
+    int getPNGCompressionLevel() const { return _pngCompressionLevel; }
+
     void premultiplyAlpha();
     void reversePremultipliedAlpha();
 
@@ -212,12 +259,18 @@ protected:
     bool initWithETCData(uint8_t* data, ssize_t dataLen, bool ownData);
     bool initWithETC2Data(uint8_t* data, ssize_t dataLen, bool ownData);
     bool initWithASTCData(uint8_t* data, ssize_t dataLen, bool ownData);
+    bool initWithKTX2Data(uint8_t* data, ssize_t dataLen, bool ownData);
     bool initWithS3TCData(uint8_t* data, ssize_t dataLen, bool ownData);
     bool initWithATITCData(uint8_t* data, ssize_t dataLen, bool ownData);
 
     // fast forward pixels to GPU if ownData
     void forwardPixels(uint8_t* data, ssize_t dataLen, int offset, bool ownData);
 
+    // software decoded pixels cache, see setDecodeCacheEnabled
+    bool loadDecodeCache(uint64_t key);
+    void saveDecodeCache(uint64_t key);
+    static std::string getDecodeCachePath(uint64_t key);
+
     bool saveImageToPNG(std::string_view filePath, bool isToRGB = true);
     bool saveImageToJPG(std::string_view filePath);
 
@@ -232,6 +285,7 @@ protected:
      */
     static bool PNG_PREMULTIPLIED_ALPHA_ENABLED;
     static uint32_t COMPRESSED_IMAGE_PMA_FLAGS;
+    static bool DECODE_CACHE_ENABLED;
 
     uint8_t* _data;
     ssize_t _dataLen;
@@ -245,6 +299,7 @@ protected:
     int _numberOfMipmaps;
     // false if we can't auto detect the image is premultiplied or not.
     bool _hasPremultipliedAlpha;
+    int _pngCompressionLevel;
     std::string _filePath;
 
 protected:
@@ -271,6 +326,7 @@ protected:
     bool isEtc2(const uint8_t* data, ssize_t dataLen);
     bool isS3TC(const uint8_t* data, ssize_t dataLen);
     bool isASTC(const uint8_t* data, ssize_t dataLen);
+    bool isKTX2(const uint8_t* data, ssize_t dataLen);
 };
 
 // end of platform group
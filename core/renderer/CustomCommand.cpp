@@ -26,11 +26,19 @@
 #include "renderer/TextureAtlas.h"
 #include "renderer/backend/Buffer.h"
 #include "renderer/backend/Device.h"
+#include "renderer/Renderer.h"
+#include "base/Director.h"
 #include "base/Utils.h"
 #include <stddef.h>
 
 NS_AX_BEGIN
 
+static void reportBufferUpload(std::size_t length)
+{
+    if (auto renderer = Director::getInstance()->getRenderer())
+        renderer->addBufferUpload(length);
+}
+
 CustomCommand::CustomCommand()
 {
     _type = RenderCommand::Type::CUSTOM_COMMAND;
@@ -162,12 +170,14 @@ void CustomCommand::updateVertexBuffer(void* data, std::size_t offset, std::size
 {
     assert(_vertexBuffer);
     _vertexBuffer->updateSubData(data, offset, length);
+    reportBufferUpload(length);
 }
 
 void CustomCommand::updateIndexBuffer(void* data, std::size_t offset, std::size_t length)
 {
     assert(_indexBuffer);
     _indexBuffer->updateSubData(data, offset, length);
+    reportBufferUpload(length);
 }
 
 void CustomCommand::setVertexBuffer(backend::Buffer* vertexBuffer)
@@ -197,12 +207,14 @@ void CustomCommand::updateVertexBuffer(void* data, std::size_t length)
 {
     assert(_vertexBuffer);
     _vertexBuffer->updateData(data, length);
+    reportBufferUpload(length);
 }
 
 void CustomCommand::updateIndexBuffer(void* data, std::size_t length)
 {
     assert(_indexBuffer);
     _indexBuffer->updateData(data, length);
+    reportBufferUpload(length);
 }
 
 std::size_t CustomCommand::computeIndexSize() const
@@ -73,11 +73,29 @@ public:
 
     void init(float globalZOrder, const Mat4& transform);
 
+    /**
+     * Sets how the renderer may merge this command when automatic instancing is enabled.
+     * Queued commands with the same non zero key are drawn with one instanced draw of the `instancedCommand` of the
+     * first of them, using the model view matrix of each command as its instance transform.
+     * @param key Identifies the mesh buffers, material and render state, 0 disables merging.
+     * @param instancedCommand The command which draws the group, ELEMENT_INSTANCE with an identity model view.
+     */
+    void setInstancing(uint64_t key, MeshCommand* instancedCommand)
+    {
+        _instancingKey    = key;
+        _instancedCommand = instancedCommand;
+    }
+    uint64_t getInstancingKey() const { return _instancingKey; }
+    MeshCommand* getInstancedCommand() const { return _instancedCommand; }
+
 #if AX_ENABLE_CACHE_TEXTURE_DATA
     void listenRendererRecreated(EventCustom* event);
 #endif
 
 protected:
+    uint64_t _instancingKey        = 0;
+    MeshCommand* _instancedCommand = nullptr;
+
 #if AX_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _rendererRecreatedListener;
 #endif
@@ -182,7 +182,22 @@ void Pass::draw(MeshCommand* meshCommand,
                 unsigned int indexCount,
                 const Mat4& modelView)
 {
+    prepareDraw(meshCommand, globalZOrder, vertexBuffer, indexBuffer, primitive, indexFormat, indexCount, modelView);
 
+    auto* renderer = Director::getInstance()->getRenderer();
+
+    renderer->addCommand(meshCommand);
+}
+
+void Pass::prepareDraw(MeshCommand* meshCommand,
+                       float globalZOrder,
+                       backend::Buffer* vertexBuffer,
+                       backend::Buffer* indexBuffer,
+                       MeshCommand::PrimitiveType primitive,
+                       MeshCommand::IndexFormat indexFormat,
+                       unsigned int indexCount,
+                       const Mat4& modelView)
+{
     meshCommand->setBeforeCallback(AX_CALLBACK_0(Pass::onBeforeVisitCmd, this, meshCommand));
     meshCommand->setAfterCallback(AX_CALLBACK_0(Pass::onAfterVisitCmd, this, meshCommand));
     meshCommand->init(globalZOrder, modelView);
@@ -191,10 +206,6 @@ void Pass::draw(MeshCommand* meshCommand,
     meshCommand->setVertexBuffer(vertexBuffer);
     meshCommand->setIndexDrawInfo(0, indexCount);
     meshCommand->getPipelineDescriptor().programState = _programState;
-
-    auto* renderer = Director::getInstance()->getRenderer();
-
-    renderer->addCommand(meshCommand);
 }
 
 void Pass::updateMVPUniform(const Mat4& modelView)
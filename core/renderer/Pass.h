@@ -77,6 +77,16 @@ public:
               unsigned int indexCount,
               const Mat4& modelView);
 
+    /** Sets up the command like draw() without adding it to the renderer. */
+    void prepareDraw(MeshCommand* meshCommand,
+                     float globalZOrder,
+                     backend::Buffer* vertexBuffer,
+                     backend::Buffer* indexBuffer,
+                     MeshCommand::PrimitiveType primitive,
+                     MeshCommand::IndexFormat indexFormat,
+                     unsigned int indexCount,
+                     const Mat4& modelView);
+
     /**
      * Sets a vertex attribute binding for this pass.
      *
@@ -98,6 +98,7 @@ public:
     void setWireframe(bool value) { _isWireframe = value; }
     /// Can use the result to change the descriptor content.
     inline PipelineDescriptor& getPipelineDescriptor() { return _pipelineDescriptor; }
+    inline const PipelineDescriptor& getPipelineDescriptor() const { return _pipelineDescriptor; }
 
     const Mat4& getMV() const { return _mv; }
 
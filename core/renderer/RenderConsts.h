@@ -0,0 +1,11 @@
+#pragma once
+
+/* The max directional lights */
+#define AX_MAX_DIRECTIONAL_LIGHT 1
+
+/* The max point lights */
+#define AX_MAX_POINT_LIGHT 1
+
+/* The max spot lights */
+#define AX_MAX_SPOT_LIGHT 1
+
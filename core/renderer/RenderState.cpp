@@ -36,6 +36,7 @@
 #include "base/Director.h"
 #include "renderer/Renderer.h"
 #include "renderer/Material.h"
+#include "xxhash.h"
 
 NS_AX_BEGIN
 
@@ -345,8 +346,11 @@ bool RenderState::StateBlock::isDirty() const
 
 uint32_t RenderState::StateBlock::getHash() const
 {
-    // XXX
-    return 0x12345678;
+    const uint32_t state[] = {_cullFaceEnabled,         _depthTestEnabled,       _depthWriteEnabled,
+                              (uint32_t)_depthFunction, _blendEnabled,           (uint32_t)_blendSrc,
+                              (uint32_t)_blendDst,      (uint32_t)_cullFaceSide, (uint32_t)_frontFace,
+                              (uint32_t)_modifiedBits};
+    return XXH32(state, sizeof(state), 0);
 }
 
 void RenderState::StateBlock::setBlend(bool enabled)
@@ -37,6 +37,7 @@
 #include "renderer/Technique.h"
 #include "renderer/Pass.h"
 #include "renderer/Texture2D.h"
+#include "renderer/TextureCache.h"
 
 #include "base/Configuration.h"
 #include "base/Director.h"
@@ -45,6 +46,7 @@
 #include "base/EventType.h"
 #include "2d/Camera.h"
 #include "2d/Scene.h"
+#include "base/format.h"
 #include "xxhash.h"
 
 #include "renderer/backend/Backend.h"
@@ -152,6 +154,64 @@ void RenderQueue::realloc(size_t reserveSize)
     }
 }
 
+// frame stats
+static const char* const s_batchBreakNames[] = {"texture",     "program", "blend",   "uniforms",
+                                                "unbatchable", "buffer_full", "command", "depth_state"};
+static const char* const s_queueGroupNames[] = {"globalz_neg", "opaque_3d", "transparent_3d", "globalz_zero",
+                                                "globalz_pos"};
+static_assert(AX_ARRAYSIZE(s_batchBreakNames) == (int)BatchBreakReason::COUNT, "missing batch break name");
+static_assert(AX_ARRAYSIZE(s_queueGroupNames) == RenderQueue::QUEUE_COUNT, "missing queue group name");
+
+std::string_view FrameStats::getBatchBreakName(BatchBreakReason reason)
+{
+    return s_batchBreakNames[(int)reason];
+}
+
+std::string FrameStats::toJson() const
+{
+    std::string json = fmt::format(
+        R"({{"frame":{},"cpu_ms":{:.3f},"gpu_ms":{:.3f},"draw_calls":{},"vertices":{},"render_passes":{},)"
+        R"("state_changes":{},"texture_uploads":{},"texture_bytes":{},"buffer_bytes":{},"instanced_draws":{},)"
+        R"("instances_merged":{},"queue_draw_calls":{{)",
+        frame, cpuTime, gpuTime, drawCalls, drawnVertices, renderPasses, stateChanges, textureUploads, textureBytes,
+        bufferBytes, instancedDraws, instancesMerged);
+    for (int i = 0; i < RenderQueue::QUEUE_COUNT; ++i)
+        fmt::format_to(std::back_inserter(json), R"({}"{}":{})", i ? "," : "", s_queueGroupNames[i],
+                       drawCallsPerQueue[i]);
+    json += R"(},"batch_breaks":{)";
+    for (int i = 0; i < (int)BatchBreakReason::COUNT; ++i)
+        fmt::format_to(std::back_inserter(json), R"({}"{}":{})", i ? "," : "", s_batchBreakNames[i], batchBreaks[i]);
+    json += "}}";
+    return json;
+}
+
+std::string FrameStats::toCsv() const
+{
+    std::string csv =
+        fmt::format("{},{:.3f},{:.3f},{},{},{},{},{},{},{},{},{}", frame, cpuTime, gpuTime, drawCalls, drawnVertices,
+                    renderPasses, stateChanges, textureUploads, textureBytes, bufferBytes, instancedDraws, instancesMerged);
+    for (auto count : drawCallsPerQueue)
+        fmt::format_to(std::back_inserter(csv), ",{}", count);
+    for (auto count : batchBreaks)
+        fmt::format_to(std::back_inserter(csv), ",{}", count);
+    return csv;
+}
+
+std::string_view FrameStats::getCsvHeader()
+{
+    static const std::string header = [] {
+        std::string ret =
+            "frame,cpu_ms,gpu_ms,draw_calls,vertices,render_passes,state_changes,texture_uploads,texture_bytes,"
+            "buffer_bytes,instanced_draws,instances_merged";
+        for (auto name : s_queueGroupNames)
+            fmt::format_to(std::back_inserter(ret), ",draw_calls_{}", name);
+        for (auto name : s_batchBreakNames)
+            fmt::format_to(std::back_inserter(ret), ",break_{}", name);
+        return ret;
+    }();
+    return header;
+}
+
 //
 //
 //
@@ -189,6 +249,12 @@ Renderer::~Renderer()
 
     free(_triBatchesToDraw);
 
+    delete[] _multiTextureVerts;
+    AX_SAFE_RELEASE(_multiTextureProgramState);
+
+    for (auto&& instanceBuffer : _instanceBuffers)
+        AX_SAFE_RELEASE(instanceBuffer.buffer);
+
     AX_SAFE_RELEASE(_depthStencilState);
     AX_SAFE_RELEASE(_commandBuffer);
     AX_SAFE_RELEASE(_renderPipeline);
@@ -280,6 +346,7 @@ int Renderer::createRenderQueue()
 
 void Renderer::processGroupCommand(GroupCommand* command)
 {
+    recordFlush(BatchBreakReason::COMMAND);
     flush();
 
     int renderQueueID = ((GroupCommand*)command)->getRenderQueueID();
@@ -313,6 +380,7 @@ void Renderer::processRenderCommand(RenderCommand* command)
                      "VBO for vertex is not big enough, please break the data down or use customized render command");
             AXASSERT(cmd->getIndexCount() >= 0 && cmd->getIndexCount() < INDEX_VBO_SIZE,
                      "VBO for index is not big enough, please break the data down or use customized render command");
+            recordFlush(BatchBreakReason::BUFFER_FULL);
             drawBatchedTriangles();
 
             _queuedTotalIndexCount = _queuedTotalVertexCount = 0;
@@ -335,18 +403,24 @@ void Renderer::processRenderCommand(RenderCommand* command)
     }
     break;
     case RenderCommand::Type::MESH_COMMAND:
+        recordFlush(BatchBreakReason::COMMAND);
         flush2D();
-        drawMeshCommand(command);
+        if (_autoInstancing && static_cast<MeshCommand*>(command)->getInstancingKey())
+            _queuedMeshCommands.emplace_back(static_cast<MeshCommand*>(command));
+        else
+            drawMeshCommand(command);
         break;
     case RenderCommand::Type::GROUP_COMMAND:
         processGroupCommand(static_cast<GroupCommand*>(command));
         _groupCommandPool.emplace_back(static_cast<GroupCommand*>(command));
         break;
     case RenderCommand::Type::CUSTOM_COMMAND:
+        recordFlush(BatchBreakReason::COMMAND);
         flush();
         drawCustomCommand(command);
         break;
     case RenderCommand::Type::CALLBACK_COMMAND:
+        recordFlush(BatchBreakReason::COMMAND);
         flush();
         static_cast<CallbackCommand*>(command)->execute();
         _callbackCommandsPool.emplace_back(static_cast<CallbackCommand*>(command));
@@ -359,9 +433,13 @@ void Renderer::processRenderCommand(RenderCommand* command)
 
 void Renderer::visitRenderQueue(RenderQueue& queue)
 {
+    // nested render queues report their draws to their own groups
+    const int parentQueueGroup = _statsQueueGroup;
+
     //
     // Process Global-Z < 0 Objects
     //
+    _statsQueueGroup = RenderQueue::QUEUE_GROUP::GLOBALZ_NEG;
     doVisitRenderQueue(queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_NEG));
 
     //
@@ -371,24 +449,30 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     setDepthTest(true);  // enable depth test in 3D queue by default
     setDepthWrite(true);
     setCullMode(backend::CullMode::BACK);
+    _statsQueueGroup = RenderQueue::QUEUE_GROUP::OPAQUE_3D;
     doVisitRenderQueue(queue.getSubQueue(RenderQueue::QUEUE_GROUP::OPAQUE_3D));
 
     //
     // Process 3D Transparent object
     //
     setDepthWrite(false);
+    _statsQueueGroup = RenderQueue::QUEUE_GROUP::TRANSPARENT_3D;
     doVisitRenderQueue(queue.getSubQueue(RenderQueue::QUEUE_GROUP::TRANSPARENT_3D));
     popStateBlock();
 
     //
     // Process Global-Z = 0 Queue
     //
+    _statsQueueGroup = RenderQueue::QUEUE_GROUP::GLOBALZ_ZERO;
     doVisitRenderQueue(queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_ZERO));
 
     //
     // Process Global-Z > 0 Queue
     //
+    _statsQueueGroup = RenderQueue::QUEUE_GROUP::GLOBALZ_POS;
     doVisitRenderQueue(queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_POS));
+
+    _statsQueueGroup = parentQueueGroup;
 }
 
 void Renderer::doVisitRenderQueue(const std::vector<RenderCommand*>& renderCommands)
@@ -397,6 +481,7 @@ void Renderer::doVisitRenderQueue(const std::vector<RenderCommand*>& renderComma
     {
         processRenderCommand(command);
     }
+    recordFlush(BatchBreakReason::DEPTH_STATE);
     flush();
 }
 
@@ -420,6 +505,22 @@ void Renderer::render()
 
 bool Renderer::beginFrame()
 {
+    if (_frameStatsEnabled != _frameStatsRequested)
+    {
+        _frameStatsEnabled = _frameStatsRequested;
+        _commandBuffer->setGPUTimingEnabled(_frameStatsEnabled);
+    }
+    if (_frameStatsEnabled)
+    {
+        _frameStats       = FrameStats{};
+        _frameStats.frame = _frameCount;
+        _frameStartTime   = std::chrono::steady_clock::now();
+        _lastDrawProgram  = nullptr;
+    }
+    ++_frameCount;
+    _instanceBufferIndex = 0;
+    TextureCache::advanceFrameStamp();
+
     return _commandBuffer->beginFrame();
 }
 
@@ -427,6 +528,22 @@ void Renderer::endFrame()
 {
     _commandBuffer->endFrame();
 
+    if (_frameStatsEnabled)
+    {
+        _frameStats.cpuTime =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _frameStartTime).count();
+        // the backends resolve GPU time a few frames late, so this is the time of a previous frame
+        _frameStats.gpuTime = _commandBuffer->getGPUFrameTime();
+
+        _lastFrameStats = _frameStats;
+        if (!_frameStatsHistory.empty())
+        {
+            _frameStatsHistory[_frameStatsHead] = _frameStats;
+            _frameStatsHead                     = (_frameStatsHead + 1) % _frameStatsHistory.size();
+            _frameStatsCount                    = (std::min)(_frameStatsCount + 1, _frameStatsHistory.size());
+        }
+    }
+
 #ifdef AX_USE_METAL
     _triangleCommandBufferManager.putbackAllBuffers();
     _vertexBuffer = _triangleCommandBufferManager.getVertexBuffer();
@@ -451,6 +568,7 @@ void Renderer::clean()
 
     // Clear batch commands
     _queuedTriangleCommands.clear();
+    _queuedMeshCommands.clear();
 }
 
 void Renderer::setDepthTest(bool value)
@@ -598,16 +716,182 @@ void Renderer::setViewPort(int x, int y, unsigned int w, unsigned int h)
     _viewport.height = h;
 }
 
-void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset)
+void Renderer::setFrameStatsEnabled(bool enabled)
+{
+    if (enabled && _frameStatsHistory.empty())
+        setFrameStatsHistorySize(120);
+    _frameStatsRequested = enabled;
+}
+
+void Renderer::setFrameStatsHistorySize(size_t size)
+{
+    // keep the newest frames which still fit
+    auto history = getFrameStatsHistory();
+    if (history.size() > size)
+        history.erase(history.begin(), history.end() - size);
+
+    _frameStatsCount = history.size();
+    _frameStatsHead  = size ? _frameStatsCount % size : 0;
+    history.resize(size);
+    _frameStatsHistory = std::move(history);
+}
+
+std::vector<FrameStats> Renderer::getFrameStatsHistory() const
+{
+    std::vector<FrameStats> history;
+    history.reserve(_frameStatsCount);
+    const size_t capacity = _frameStatsHistory.size();
+    for (size_t i = 0; i < _frameStatsCount; ++i)
+        history.emplace_back(_frameStatsHistory[(_frameStatsHead + capacity - _frameStatsCount + i) % capacity]);
+    return history;
+}
+
+std::string Renderer::exportFrameStatsJson() const
+{
+    std::string json = "[";
+    for (auto&& stats : getFrameStatsHistory())
+    {
+        if (json.size() > 1)
+            json += ",\n";
+        json += stats.toJson();
+    }
+    json += "]\n";
+    return json;
+}
+
+std::string Renderer::exportFrameStatsCsv() const
+{
+    std::string csv{FrameStats::getCsvHeader()};
+    csv += '\n';
+    for (auto&& stats : getFrameStatsHistory())
+    {
+        csv += stats.toCsv();
+        csv += '\n';
+    }
+    return csv;
+}
+
+void Renderer::recordDrawCall(const PipelineDescriptor& pipelineDescriptor, size_t vertices)
+{
+    ++_frameStats.drawCalls;
+    ++_frameStats.drawCallsPerQueue[_statsQueueGroup];
+    _frameStats.drawnVertices += vertices;
+
+    auto program     = pipelineDescriptor.programState ? pipelineDescriptor.programState->getProgram() : nullptr;
+    auto& blend      = pipelineDescriptor.blendDescriptor;
+    bool blendChange = blend.blendEnabled != _lastDrawBlend.blendEnabled ||
+                       blend.sourceRGBBlendFactor != _lastDrawBlend.sourceRGBBlendFactor ||
+                       blend.destinationRGBBlendFactor != _lastDrawBlend.destinationRGBBlendFactor ||
+                       blend.sourceAlphaBlendFactor != _lastDrawBlend.sourceAlphaBlendFactor ||
+                       blend.destinationAlphaBlendFactor != _lastDrawBlend.destinationAlphaBlendFactor;
+    if (program != _lastDrawProgram || blendChange)
+        ++_frameStats.stateChanges;
+    _lastDrawProgram = program;
+    _lastDrawBlend   = blend;
+}
+
+void Renderer::recordFlush(BatchBreakReason reason)
+{
+    if (_frameStatsEnabled && !_queuedTriangleCommands.empty())
+        ++_frameStats.batchBreaks[(int)reason];
+}
+
+void Renderer::recordBatchBreak(const TrianglesCommand* prev, const TrianglesCommand* next)
+{
+    auto prevProgramState = prev->getPipelineDescriptor().programState;
+    auto nextProgramState = next->getPipelineDescriptor().programState;
+
+    BatchBreakReason reason;
+    if (prev->isSkipBatching() || next->isSkipBatching())
+        reason = BatchBreakReason::UNBATCHABLE;
+    else if (prevProgramState->getProgram() != nextProgramState->getProgram())
+        reason = BatchBreakReason::PROGRAM;
+    else if (prev->getBlendType() != next->getBlendType())
+        reason = BatchBreakReason::BLEND;
+    else if (prev->getTexture() != next->getTexture())
+        reason = BatchBreakReason::TEXTURE;
+    else
+        reason = BatchBreakReason::UNIFORMS;
+    ++_frameStats.batchBreaks[(int)reason];
+}
+
+void Renderer::setMultiTextureBatching(bool enabled)
+{
+    _multiTextureBatching = enabled;
+    if (!enabled || _multiTextureProgramState)
+        return;
+
+    auto program = backend::Program::getBuiltinProgram(backend::ProgramType::POSITION_TEXTURE_COLOR_MULTI);
+    if (!program)
+    {
+        AXLOGWARN("Renderer: multi texture batching is not supported, the shader failed to load");
+        _multiTextureBatching = false;
+        return;
+    }
+
+    _multiTextureVerts                           = new V3F_C4B_T2F_I1F[VBO_SIZE];
+    _multiTextureProgramState                    = new backend::ProgramState(program);
+    _multiTexturePipelineDescriptor.programState = _multiTextureProgramState;
+
+    _multiTextureLocations[0] = _multiTextureProgramState->getUniformLocation(backend::Uniform::TEXTURE);
+    _multiTextureLocations[1] = _multiTextureProgramState->getUniformLocation(backend::Uniform::TEXTURE1);
+    for (int slot = 2; slot < MAX_BATCH_TEXTURES; ++slot)
+        _multiTextureLocations[slot] = _multiTextureProgramState->getUniformLocation(fmt::format("u_tex{}", slot));
+}
+
+bool Renderer::isMultiTextureBatchable(const TrianglesCommand* cmd) const
+{
+    // only the default sprite program has a multi texture variant, programs with custom uniforms or
+    // multi plane textures keep their own material batching
+    return !cmd->isSkipBatching() && cmd->getBatchId() == backend::ProgramType::POSITION_TEXTURE_COLOR &&
+           cmd->getTexture() && cmd->getTexture()->getCount() == 1;
+}
+
+void Renderer::setupMultiTextureBatch(TrianglesCommand* cmd, backend::TextureBackend* const* textures, int count)
+{
+    auto& pipelineDescriptor = cmd->getPipelineDescriptor();
+    auto programState        = _multiTextureProgramState;
+
+    _multiTexturePipelineDescriptor.blendDescriptor = pipelineDescriptor.blendDescriptor;
+
+    // the vertex shaders share the uniform block, so the projection set by the node carries over
+    programState->copyVertexUniforms(pipelineDescriptor.programState);
+
+    // unused slots repeat the first texture, metal requires every declared sampler to be bound
+    for (int slot = 0; slot < MAX_BATCH_TEXTURES; ++slot)
+    {
+        programState->setTexture(_multiTextureLocations[slot], slot, textures[slot < count ? slot : 0]);
+    }
+}
+
+void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset, int textureSlot)
 {
     size_t vertexCount = cmd->getVertexCount();
-    memcpy(&_verts[_filledVertex], cmd->getVertices(), sizeof(V3F_C4B_T2F) * vertexCount);
 
     // fill vertex, and convert them to world coordinates
     const Mat4& modelView = cmd->getModelView();
-    for (size_t i = 0; i < vertexCount; ++i)
+    if (textureSlot < 0)
     {
-        modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
+        memcpy(&_verts[_filledVertex], cmd->getVertices(), sizeof(V3F_C4B_T2F) * vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
+        }
+    }
+    else
+    {
+        // multi texture vertices share the slot range with _verts, so indices are built the same way
+        const auto* src   = cmd->getVertices();
+        auto* dst         = &_multiTextureVerts[_filledVertex];
+        const float index = static_cast<float>(textureSlot);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            dst[i].vertices = src[i].vertices;
+            modelView.transformPoint(&dst[i].vertices);
+            dst[i].colors    = src[i].colors;
+            dst[i].texCoords = src[i].texCoords;
+            dst[i].texIndex  = index;
+        }
     }
 
     // fill index
@@ -639,23 +923,49 @@ void Renderer::drawBatchedTriangles()
     _triBatchesToDraw[0].offset        = indexBufferFillOffset;
     _triBatchesToDraw[0].indicesToDraw = 0;
     _triBatchesToDraw[0].cmd           = nullptr;
+    _triBatchesToDraw[0].textureCount  = 0;
 
     int batchesTotal        = 0;
     uint32_t prevMaterialID = 0;
     bool firstCommand       = true;
+    bool hasSingleTexture   = false;
+    bool hasMultiTexture    = false;
 
     _filledVertex = 0;
     _filledIndex  = 0;
 
     for (const auto& cmd : _queuedTriangleCommands)
     {
-        auto currentMaterialID = cmd->getMaterialID();
-        const bool batchable   = !cmd->isSkipBatching();
-
-        fillVerticesAndIndices(cmd, vertexBufferFillOffset);
+        auto currentMaterialID  = cmd->getMaterialID();
+        const bool batchable    = !cmd->isSkipBatching();
+        const bool multiTexture = _multiTextureBatching && isMultiTextureBatchable(cmd);
+
+        // join the running multi texture batch if it shares the blend function and has a free slot
+        int textureSlot = -1;
+        auto& lastBatch = _triBatchesToDraw[batchesTotal];
+        if (multiTexture && !firstCommand && lastBatch.textureCount > 0 &&
+            lastBatch.cmd->getBlendType() == cmd->getBlendType())
+        {
+            auto texture = cmd->getTexture();
+            auto end     = lastBatch.textures + lastBatch.textureCount;
+            auto it      = std::find(lastBatch.textures, end, texture);
+            if (it != end)
+                textureSlot = static_cast<int>(it - lastBatch.textures);
+            else if (lastBatch.textureCount < MAX_BATCH_TEXTURES)
+            {
+                textureSlot                     = lastBatch.textureCount++;
+                lastBatch.textures[textureSlot] = texture;
+            }
+        }
 
+        if (textureSlot >= 0)
+        {
+            lastBatch.indicesToDraw += cmd->getIndexCount();
+            lastBatch.cmd = cmd;
+        }
         // in the same batch ?
-        if (batchable && (prevMaterialID == currentMaterialID || firstCommand))
+        else if (!multiTexture && batchable && lastBatch.textureCount == 0 &&
+                 (prevMaterialID == currentMaterialID || firstCommand))
         {
             AX_ASSERT((firstCommand || _triBatchesToDraw[batchesTotal].cmd->getMaterialID() == cmd->getMaterialID()) &&
                       "argh... error in logic");
@@ -667,6 +977,8 @@ void Renderer::drawBatchedTriangles()
             // is this the first one?
             if (!firstCommand)
             {
+                if (_frameStatsEnabled)
+                    recordBatchBreak(_triBatchesToDraw[batchesTotal].cmd, cmd);
                 batchesTotal++;
                 _triBatchesToDraw[batchesTotal].offset =
                     _triBatchesToDraw[batchesTotal - 1].offset + _triBatchesToDraw[batchesTotal - 1].indicesToDraw;
@@ -674,12 +986,26 @@ void Renderer::drawBatchedTriangles()
 
             _triBatchesToDraw[batchesTotal].cmd           = cmd;
             _triBatchesToDraw[batchesTotal].indicesToDraw = (int)cmd->getIndexCount();
+            _triBatchesToDraw[batchesTotal].textureCount  = 0;
+
+            if (multiTexture)
+            {
+                _triBatchesToDraw[batchesTotal].textureCount = 1;
+                _triBatchesToDraw[batchesTotal].textures[0]  = cmd->getTexture();
+                textureSlot                                  = 0;
+            }
 
             // is this a single batch ? Prevent creating a batch group then
             if (!batchable)
                 currentMaterialID = 0;
         }
 
+        fillVerticesAndIndices(cmd, vertexBufferFillOffset, textureSlot);
+        if (textureSlot < 0)
+            hasSingleTexture = true;
+        else
+            hasMultiTexture = true;
+
         // capacity full ?
         if (batchesTotal + 1 >= _triBatchesToDrawCapacity)
         {
@@ -692,32 +1018,69 @@ void Renderer::drawBatchedTriangles()
         firstCommand   = false;
     }
     batchesTotal++;
+
+    // both vertex arrays are filled at the same positions, each buffer only receives the array its batches read
+    auto multiTextureVertexBuffer =
+        hasMultiTexture ? _triangleCommandBufferManager.getMultiTextureVertexBuffer() : nullptr;
 #ifdef AX_USE_METAL
-    _vertexBuffer->updateSubData(_verts, vertexBufferFillOffset * sizeof(_verts[0]), _filledVertex * sizeof(_verts[0]));
+    if (hasSingleTexture)
+        _vertexBuffer->updateSubData(_verts, vertexBufferFillOffset * sizeof(_verts[0]),
+                                     _filledVertex * sizeof(_verts[0]));
+    if (multiTextureVertexBuffer)
+        multiTextureVertexBuffer->updateSubData(_multiTextureVerts,
+                                                vertexBufferFillOffset * sizeof(_multiTextureVerts[0]),
+                                                _filledVertex * sizeof(_multiTextureVerts[0]));
     _indexBuffer->updateSubData(_indices, indexBufferFillOffset * sizeof(_indices[0]),
                                 _filledIndex * sizeof(_indices[0]));
 #else
-    _vertexBuffer->updateData(_verts, _filledVertex * sizeof(_verts[0]));
+    if (hasSingleTexture)
+        _vertexBuffer->updateData(_verts, _filledVertex * sizeof(_verts[0]));
+    if (multiTextureVertexBuffer)
+        multiTextureVertexBuffer->updateData(_multiTextureVerts, _filledVertex * sizeof(_multiTextureVerts[0]));
     _indexBuffer->updateData(_indices, _filledIndex * sizeof(_indices[0]));
 #endif
+    if (_frameStatsEnabled)
+    {
+        size_t vertexBytes = 0;
+        if (hasSingleTexture)
+            vertexBytes += _filledVertex * sizeof(_verts[0]);
+        if (multiTextureVertexBuffer)
+            vertexBytes += _filledVertex * sizeof(_multiTextureVerts[0]);
+        addBufferUpload(vertexBytes + _filledIndex * sizeof(_indices[0]));
+    }
 
     /************** 2: Draw *************/
     beginRenderPass();
 
-    _commandBuffer->setVertexBuffer(_vertexBuffer);
     _commandBuffer->setIndexBuffer(_indexBuffer);
 
+    backend::Buffer* boundVertexBuffer = nullptr;
     for (int i = 0; i < batchesTotal; ++i)
     {
-        auto& drawInfo = _triBatchesToDraw[i];
-        _commandBuffer->updatePipelineState(_currentRT, drawInfo.cmd->getPipelineDescriptor());
-        auto& pipelineDescriptor = drawInfo.cmd->getPipelineDescriptor();
-        _commandBuffer->setProgramState(pipelineDescriptor.programState);
+        auto& drawInfo           = _triBatchesToDraw[i];
+        auto* pipelineDescriptor = &drawInfo.cmd->getPipelineDescriptor();
+        auto* vertexBuffer       = _vertexBuffer;
+        if (drawInfo.textureCount > 0)
+        {
+            setupMultiTextureBatch(drawInfo.cmd, drawInfo.textures, drawInfo.textureCount);
+            pipelineDescriptor = &_multiTexturePipelineDescriptor;
+            vertexBuffer       = multiTextureVertexBuffer;
+        }
+        if (boundVertexBuffer != vertexBuffer)
+        {
+            _commandBuffer->setVertexBuffer(vertexBuffer);
+            boundVertexBuffer = vertexBuffer;
+        }
+
+        _commandBuffer->updatePipelineState(_currentRT, *pipelineDescriptor);
+        _commandBuffer->setProgramState(pipelineDescriptor->programState);
         _commandBuffer->drawElements(backend::PrimitiveType::TRIANGLE, backend::IndexFormat::U_SHORT,
                                      drawInfo.indicesToDraw, drawInfo.offset * sizeof(_indices[0]));
 
         _drawnBatches++;
         _drawnVertices += _triBatchesToDraw[i].indicesToDraw;
+        if (_frameStatsEnabled)
+            recordDrawCall(*pipelineDescriptor, drawInfo.indicesToDraw);
     }
 
     endRenderPass();
@@ -744,13 +1107,14 @@ void Renderer::drawCustomCommand(RenderCommand* command)
     _commandBuffer->updatePipelineState(_currentRT, cmd->getPipelineDescriptor());
     _commandBuffer->setProgramState(cmd->getPipelineDescriptor().programState);
 
-    auto drawType = cmd->getDrawType();
+    size_t drawnVertices = 0;
+    auto drawType        = cmd->getDrawType();
     if (CustomCommand::DrawType::ELEMENT == drawType)
     {
         _commandBuffer->setIndexBuffer(cmd->getIndexBuffer());
         _commandBuffer->drawElements(cmd->getPrimitiveType(), cmd->getIndexFormat(), cmd->getIndexDrawCount(),
                                      cmd->getIndexDrawOffset(), cmd->isWireframe());
-        _drawnVertices += cmd->getIndexDrawCount();
+        drawnVertices = cmd->getIndexDrawCount();
     }
     else if (CustomCommand::DrawType::ELEMENT_INSTANCE == drawType)
     {
@@ -758,15 +1122,18 @@ void Renderer::drawCustomCommand(RenderCommand* command)
         _commandBuffer->setInstanceBuffer(cmd->getInstanceBuffer());
         _commandBuffer->drawElementsInstanced(cmd->getPrimitiveType(), cmd->getIndexFormat(), cmd->getIndexDrawCount(),
                                               cmd->getIndexDrawOffset(), cmd->getInstanceCount(), cmd->isWireframe());
-        _drawnVertices += cmd->getIndexDrawCount() * cmd->getInstanceCount();
+        drawnVertices = cmd->getIndexDrawCount() * cmd->getInstanceCount();
     }
     else
     {
         _commandBuffer->drawArrays(cmd->getPrimitiveType(), cmd->getVertexDrawStart(), cmd->getVertexDrawCount(),
                                    cmd->isWireframe());
-        _drawnVertices += cmd->getVertexDrawCount();
+        drawnVertices = cmd->getVertexDrawCount();
     }
+    _drawnVertices += drawnVertices;
     _drawnBatches++;
+    if (_frameStatsEnabled)
+        recordDrawCall(cmd->getPipelineDescriptor(), drawnVertices);
     endRenderPass();
 
     if (cmd->getAfterCallback())
@@ -792,8 +1159,91 @@ void Renderer::flush2D()
 
 void Renderer::flush3D()
 {
-    // TODO 3d instanced rendering
-    // https://learnopengl.com/Advanced-OpenGL/Instancing
+    if (_queuedMeshCommands.empty())
+        return;
+
+    // identical meshes become adjacent, the queue order is kept within a group
+    std::stable_sort(_queuedMeshCommands.begin(), _queuedMeshCommands.end(),
+                     [](const MeshCommand* a, const MeshCommand* b) {
+                         return a->getInstancingKey() < b->getInstancingKey();
+                     });
+
+    const size_t count = _queuedMeshCommands.size();
+    for (size_t begin = 0, end = 0; begin < count; begin = end)
+    {
+        auto key = _queuedMeshCommands[begin]->getInstancingKey();
+        for (end = begin + 1; end < count && _queuedMeshCommands[end]->getInstancingKey() == key; ++end)
+            ;
+
+        if (end - begin > 1 && _queuedMeshCommands[begin]->getInstancedCommand())
+            drawInstancedMeshes(&_queuedMeshCommands[begin], end - begin);
+        else
+        {
+            for (size_t i = begin; i < end; ++i)
+                drawMeshCommand(_queuedMeshCommands[i]);
+        }
+    }
+    _queuedMeshCommands.clear();
+}
+
+void Renderer::drawInstancedMeshes(MeshCommand* const* commands, size_t count)
+{
+    if (_instanceBufferIndex == _instanceBuffers.size())
+        _instanceBuffers.emplace_back();
+    auto& instanceBuffer = _instanceBuffers[_instanceBufferIndex++];
+    auto& transforms     = instanceBuffer.transforms;
+
+    if (!instanceBuffer.buffer || instanceBuffer.buffer->getSize() < count * sizeof(Mat4))
+    {
+        AX_SAFE_RELEASE(instanceBuffer.buffer);
+        // leave room for the group to grow a bit before the buffer is recreated
+        const size_t capacity = (std::max)(count + count / 2, (size_t)16);
+        instanceBuffer.buffer = backend::Device::getInstance()->newBuffer(
+            capacity * sizeof(Mat4), backend::BufferType::VERTEX, backend::BufferUsage::DYNAMIC);
+#ifndef AX_USE_METAL
+        instanceBuffer.buffer->updateData(nullptr, capacity * sizeof(Mat4));
+#endif
+        transforms.clear();
+    }
+
+    // the slot of a group is usually the same every frame, so only the moved instances are uploaded
+    const size_t cached = transforms.size();
+    transforms.resize(count);
+    size_t dirtyBegin = count, dirtyEnd = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto& transform = commands[i]->getMV();
+        if (i >= cached || memcmp(transforms[i].m, transform.m, sizeof(transform.m)) != 0)
+        {
+            transforms[i] = transform;
+            dirtyBegin    = (std::min)(dirtyBegin, i);
+            dirtyEnd      = i + 1;
+        }
+    }
+
+    if (dirtyBegin < dirtyEnd)
+    {
+#ifdef AX_USE_METAL
+        // dynamic metal buffers rotate per frame, a partial update would leave stale transforms in the others
+        dirtyBegin = 0;
+        dirtyEnd   = count;
+        instanceBuffer.buffer->updateData(transforms.data(), count * sizeof(Mat4));
+#else
+        instanceBuffer.buffer->updateSubData(transforms.data() + dirtyBegin, dirtyBegin * sizeof(Mat4),
+                                             (dirtyEnd - dirtyBegin) * sizeof(Mat4));
+#endif
+        addBufferUpload((dirtyEnd - dirtyBegin) * sizeof(Mat4));
+    }
+
+    auto instancedCommand = commands[0]->getInstancedCommand();
+    instancedCommand->setInstanceBuffer(instanceBuffer.buffer, static_cast<int>(count));
+    drawMeshCommand(instancedCommand);
+
+    if (_frameStatsEnabled)
+    {
+        ++_frameStats.instancedDraws;
+        _frameStats.instancesMerged += count;
+    }
 }
 
 void Renderer::flushTriangles()
@@ -837,7 +1287,7 @@ bool Renderer::checkVisibility(const Mat4& transform, const Vec2& size)
 }
 
 void Renderer::readPixels(backend::RenderTarget* rt,
-                          std::function<void(const backend::PixelBufferDescriptor&)> callback)
+                          std::function<void(backend::PixelBufferDescriptor&)> callback)
 {
     assert(!!rt);
     if (rt ==
@@ -849,6 +1299,8 @@ void Renderer::readPixels(backend::RenderTarget* rt,
 
 void Renderer::beginRenderPass()
 {
+    if (_frameStatsEnabled)
+        ++_frameStats.renderPasses;
     _commandBuffer->beginRenderPass(_currentRT, _renderPassDesc);
     _commandBuffer->updateDepthStencilState(_dsDesc);
     _commandBuffer->setStencilReferenceValue(_stencilRef);
@@ -964,6 +1416,9 @@ Renderer::TriangleCommandBufferManager::~TriangleCommandBufferManager()
 
     for (auto&& indexBuffer : _indexBufferPool)
         indexBuffer->release();
+
+    for (auto&& vertexBuffer : _multiTextureVertexBufferPool)
+        AX_SAFE_RELEASE(vertexBuffer);
 }
 
 void Renderer::TriangleCommandBufferManager::init()
@@ -998,6 +1453,19 @@ backend::Buffer* Renderer::TriangleCommandBufferManager::getIndexBuffer() const
     return _indexBufferPool[_currentBufferIndex];
 }
 
+backend::Buffer* Renderer::TriangleCommandBufferManager::getMultiTextureVertexBuffer()
+{
+    if (_multiTextureVertexBufferPool.size() <= static_cast<size_t>(_currentBufferIndex))
+        _multiTextureVertexBufferPool.resize(_currentBufferIndex + 1, nullptr);
+
+    auto& vertexBuffer = _multiTextureVertexBufferPool[_currentBufferIndex];
+    if (!vertexBuffer)
+        vertexBuffer = backend::Device::getInstance()->newBuffer(Renderer::VBO_SIZE * sizeof(V3F_C4B_T2F_I1F),
+                                                                 backend::BufferType::VERTEX,
+                                                                 backend::BufferUsage::DYNAMIC);
+    return vertexBuffer;
+}
+
 void Renderer::TriangleCommandBufferManager::createBuffer()
 {
     auto device = backend::Device::getInstance();
@@ -30,6 +30,8 @@
 #include <array>
 #include <deque>
 #include <optional>
+#include <chrono>
+#include <string>
 
 #include "platform/PlatformMacros.h"
 #include "renderer/RenderCommand.h"
@@ -123,6 +125,44 @@ protected:
     bool _isDepthWrite;
 };
 
+/** Why a batch of TrianglesCommands was cut before the next command could join it. */
+enum class BatchBreakReason
+{
+    TEXTURE,      ///< the next command samples another texture
+    PROGRAM,      ///< the next command uses another program
+    BLEND,        ///< the next command uses another blend function
+    UNIFORMS,     ///< same program, texture and blend but other uniforms
+    UNBATCHABLE,  ///< one of the commands skips batching
+    BUFFER_FULL,  ///< the vertex or index buffer is full
+    COMMAND,      ///< a mesh, custom, callback or group command was drawn in between
+    DEPTH_STATE,  ///< a render queue group ended, depth and cull state change between groups
+    COUNT
+};
+
+/** Render statistics of one frame. */
+struct AX_DLL FrameStats
+{
+    uint64_t frame        = 0;
+    double cpuTime        = 0;   ///< time from Renderer::beginFrame to endFrame, in milliseconds
+    double gpuTime        = -1;  ///< GPU time of the frame in milliseconds, -1 when not supported or not ready
+    size_t drawCalls      = 0;
+    size_t drawnVertices  = 0;
+    size_t renderPasses   = 0;
+    size_t stateChanges   = 0;  ///< draws whose program or blend state differs from the previous draw
+    size_t textureUploads = 0;
+    size_t textureBytes   = 0;
+    size_t bufferBytes    = 0;
+    size_t instancedDraws  = 0;  ///< draws of mesh groups merged by automatic instancing
+    size_t instancesMerged = 0;  ///< mesh commands drawn by those draws
+    size_t drawCallsPerQueue[RenderQueue::QUEUE_COUNT] = {};
+    size_t batchBreaks[(int)BatchBreakReason::COUNT]    = {};
+
+    std::string toJson() const;
+    std::string toCsv() const;
+    static std::string_view getCsvHeader();
+    static std::string_view getBatchBreakName(BatchBreakReason reason);
+};
+
 class GroupCommandManager;
 
 /* Class responsible for the rendering in.
@@ -140,6 +180,8 @@ public:
     static const int BATCH_TRIAGCOMMAND_RESERVED_SIZE = 64;
     /**Reserved for material id, which means that the command could not be batched.*/
     static const int MATERIAL_ID_DO_NOT_BATCH = 0;
+    /**The max number of textures a multi texture batch samples from.*/
+    static const int MAX_BATCH_TEXTURES = 8;
     /**Constructor.*/
     Renderer();
     /**Destructor.*/
@@ -185,6 +227,66 @@ public:
     /* clear draw stats */
     void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
 
+    /**
+     * Enable/disable the collection of per frame statistics, see FrameStats.
+     * GPU time is measured with timer queries on desktop OpenGL and with command buffer timestamps on Metal.
+     * The change takes effect when the next frame begins, so a frame is never partially measured.
+     * @param enabled true to collect frame statistics, disabled by default.
+     */
+    void setFrameStatsEnabled(bool enabled);
+    bool isFrameStatsEnabled() const { return _frameStatsRequested; }
+
+    /** Sets how many frames of statistics are kept, 120 by default. */
+    void setFrameStatsHistorySize(size_t size);
+    size_t getFrameStatsHistorySize() const { return _frameStatsHistory.size(); }
+
+    /** Gets the statistics of the last finished frame. */
+    const FrameStats& getLastFrameStats() const { return _lastFrameStats; }
+
+    /** Gets the recorded frames, oldest first. */
+    std::vector<FrameStats> getFrameStatsHistory() const;
+
+    /** Exports the recorded frames as a JSON array, oldest first. */
+    std::string exportFrameStatsJson() const;
+
+    /** Exports the recorded frames as CSV with a header row, oldest first. */
+    std::string exportFrameStatsCsv() const;
+
+    /* Textures and RenderCommands which upload data to the GPU should report it */
+    void addBufferUpload(size_t bytes)
+    {
+        if (_frameStatsEnabled)
+            _frameStats.bufferBytes += bytes;
+    }
+    void addTextureUpload(size_t bytes)
+    {
+        if (_frameStatsEnabled)
+        {
+            ++_frameStats.textureUploads;
+            _frameStats.textureBytes += bytes;
+        }
+    }
+
+    /**
+     * Enable/disable multi texture batching.
+     * When enabled, consecutive TrianglesCommands which use the default sprite program and share a blend function are
+     * drawn in one call even if their textures differ, up to MAX_BATCH_TEXTURES textures per draw. Each vertex carries
+     * the slot of its texture, so sprites from different atlases no longer break a batch.
+     * @param enabled true to enable multi texture batching, disabled by default.
+     */
+    void setMultiTextureBatching(bool enabled);
+    bool isMultiTextureBatching() const { return _multiTextureBatching; }
+
+    /**
+     * Enable/disable automatic instancing of meshes.
+     * When enabled, queued MeshCommands which share mesh buffers, material and render state (see
+     * MeshCommand::setInstancing) are drawn with one instanced draw, their transforms are streamed into a per frame
+     * instance buffer and only the changed transforms are uploaded.
+     * @param enabled true to enable automatic instancing, disabled by default.
+     */
+    void setAutoInstancing(bool enabled) { _autoInstancing = enabled; }
+    bool isAutoInstancing() const { return _autoInstancing; }
+
     /**
      Set render targets. If not set, will use default render targets. It will effect all commands.
      @flags Flags to indicate which attachment to be replaced.
@@ -417,8 +519,8 @@ public:
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Vec2& size);
 
-    /** read pixels from RenderTarget or screen framebuffer */
-    void readPixels(backend::RenderTarget* rt, std::function<void(const backend::PixelBufferDescriptor&)> callback);
+    /** read pixels from RenderTarget or screen framebuffer, the callback may move the pixel data out of the descriptor */
+    void readPixels(backend::RenderTarget* rt, std::function<void(backend::PixelBufferDescriptor&)> callback);
 
     void beginRenderPass();  /// Begin a render pass.
     void endRenderPass();
@@ -460,18 +562,26 @@ protected:
         backend::Buffer* getVertexBuffer() const;  ///< Get the vertex buffer.
         backend::Buffer* getIndexBuffer() const;   ///< Get the index buffer.
 
+        /**
+         * Get the vertex buffer of multi texture batches paired with the current buffer, created on first use.
+         */
+        backend::Buffer* getMultiTextureVertexBuffer();
+
     private:
         void createBuffer();
 
         int _currentBufferIndex = 0;
         std::vector<backend::Buffer*> _vertexBufferPool;
         std::vector<backend::Buffer*> _indexBufferPool;
+        std::vector<backend::Buffer*> _multiTextureVertexBufferPool;
     };
 
     inline GroupCommandManager* getGroupCommandManager() const { return _groupCommandManager; }
     void drawBatchedTriangles();
     void drawCustomCommand(RenderCommand* command);
     void drawMeshCommand(RenderCommand* command);
+    /* draws `count` identical mesh commands with the instanced command of the first one */
+    void drawInstancedMeshes(MeshCommand* const* commands, size_t count);
 
     bool beginFrame();  /// Indicate the begining of a frame
     void endFrame();    /// Finish a frame.
@@ -490,7 +600,16 @@ protected:
     void visitRenderQueue(RenderQueue& queue);
     void doVisitRenderQueue(const std::vector<RenderCommand*>&);
 
-    void fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset);
+    /* textureSlot >= 0 fills the vertices of a multi texture batch */
+    void fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset, int textureSlot = -1);
+
+    bool isMultiTextureBatchable(const TrianglesCommand* cmd) const;
+    void setupMultiTextureBatch(TrianglesCommand* cmd, backend::TextureBackend* const* textures, int count);
+
+    void recordDrawCall(const PipelineDescriptor& pipelineDescriptor, size_t vertices);
+    /* counts a batch break when queued triangles are about to be flushed */
+    void recordFlush(BatchBreakReason reason);
+    void recordBatchBreak(const TrianglesCommand* prev, const TrianglesCommand* next);
 
     void pushStateBlock();
 
@@ -532,6 +651,8 @@ protected:
         TrianglesCommand* cmd      = nullptr;  // needed for the Material
         unsigned int indicesToDraw = 0;
         unsigned int offset        = 0;
+        int textureCount           = 0;  // > 0 for multi texture batches
+        backend::TextureBackend* textures[MAX_BATCH_TEXTURES];
     };
     // capacity of the array of TriBatches
     int _triBatchesToDrawCapacity = 500;
@@ -545,9 +666,42 @@ protected:
     unsigned int _filledIndex            = 0;
     unsigned int _filledVertex           = 0;
 
+    // multi texture batching
+    bool _multiTextureBatching                       = false;
+    V3F_C4B_T2F_I1F* _multiTextureVerts              = nullptr;
+    backend::ProgramState* _multiTextureProgramState = nullptr;
+    PipelineDescriptor _multiTexturePipelineDescriptor;
+    backend::UniformLocation _multiTextureLocations[MAX_BATCH_TEXTURES];
+
+    // automatic instancing
+    struct InstanceBuffer
+    {
+        backend::Buffer* buffer = nullptr;
+        std::vector<Mat4> transforms;  // contents of the buffer, so only changed transforms are uploaded
+    };
+    bool _autoInstancing = false;
+    std::vector<MeshCommand*> _queuedMeshCommands;
+    std::vector<InstanceBuffer> _instanceBuffers;  // one per instanced draw of the frame
+    size_t _instanceBufferIndex = 0;
+
     // stats
     size_t _drawnBatches  = 0;
     size_t _drawnVertices = 0;
+
+    // frame stats
+    bool _frameStatsEnabled   = false;  // latched from _frameStatsRequested in beginFrame
+    bool _frameStatsRequested = false;
+    int _statsQueueGroup    = RenderQueue::GLOBALZ_ZERO;
+    FrameStats _frameStats;
+    FrameStats _lastFrameStats;
+    std::vector<FrameStats> _frameStatsHistory;  // ring buffer
+    size_t _frameStatsHead  = 0;
+    size_t _frameStatsCount = 0;
+    uint64_t _frameCount    = 0;
+    std::chrono::steady_clock::time_point _frameStartTime;
+    const backend::Program* _lastDrawProgram = nullptr;
+    backend::BlendDescriptor _lastDrawBlend;
+
     // the flag for checking whether renderer is rendering
     bool _isRendering      = false;
     bool _isDepthTestFor2D = false;
@@ -46,6 +46,8 @@ extern AX_DLL const std::string_view positionTexture_frag;
 extern AX_DLL const std::string_view positionTextureColor_vert;
 extern AX_DLL const std::string_view positionTextureColor_frag;
 extern AX_DLL const std::string_view positionTextureColorAlphaTest_frag;
+extern AX_DLL const std::string_view positionTextureColorMulti_vert;
+extern AX_DLL const std::string_view positionTextureColorMulti_frag;
 extern AX_DLL const std::string_view label_normal_frag;
 extern AX_DLL const std::string_view label_outline_frag;
 extern AX_DLL const std::string_view label_distanceNormal_frag;
@@ -89,6 +91,7 @@ extern AX_DLL const std::string_view positionNormalTexture_vert;
 extern AX_DLL const std::string_view skinPositionNormalTexture_vert;
 extern AX_DLL const std::string_view positionTexture3D_vert;
 extern AX_DLL const std::string_view positionTextureInstance_vert;
+extern AX_DLL const std::string_view positionNormalTextureInstance_vert;
 extern AX_DLL const std::string_view skinPositionTexture_vert;
 extern AX_DLL const std::string_view skybox_frag;
 extern AX_DLL const std::string_view skybox_vert;
@@ -49,10 +49,7 @@ THE SOFTWARE.
 #include "renderer/Shaders.h"
 #include "renderer/backend/PixelFormatUtils.h"
 #include "renderer/Renderer.h"
-
-#if AX_ENABLE_CACHE_TEXTURE_DATA
-#    include "renderer/TextureCache.h"
-#endif
+#include "renderer/TextureCache.h"
 
 NS_AX_BEGIN
 
@@ -358,6 +355,7 @@ bool Texture2D::updateWithMipmaps(MipmapInfo* mipmaps,
                                                             : backend::SamplerFilter::NEAREST_MIPMAP_NEAREST;
     }
 
+    auto renderer                       = Director::getInstance()->getRenderer();
     int width                           = pixelsWide;
     int height                          = pixelsHigh;
     backend::PixelFormat oriPixelFormat = pixelFormat;
@@ -393,6 +391,8 @@ bool Texture2D::updateWithMipmaps(MipmapInfo* mipmaps,
         {
             _texture->updateData(outData, width, height, i, index);
         }
+        if (renderer)
+            renderer->addTextureUpload(compressed ? dataLen : outDataLen);
 
         if (outData && outData != data && outDataLen > 0)
         {
@@ -442,6 +442,8 @@ bool Texture2D::updateWithSubData(void* data, int offsetX, int offsetY, int widt
     {
         uint8_t* textureData = static_cast<uint8_t*>(data);
         _texture->updateSubData(offsetX, offsetY, width, height, 0, textureData, index);
+        if (auto renderer = Director::getInstance()->getRenderer())
+            renderer->addTextureUpload((size_t)width * height * getBitsPerPixelForFormat() / 8);
         return true;
     }
     return false;
@@ -668,6 +670,18 @@ unsigned int Texture2D::getBitsPerPixelForFormat() const
     return getBitsPerPixelForFormat(_pixelFormat);
 }
 
+size_t Texture2D::getMemorySize() const
+{
+    size_t bytes = (size_t)_pixelsWide * _pixelsHigh * getBitsPerPixelForFormat() / 8;
+    // a full mip chain adds one third
+    return hasMipmaps() ? bytes + bytes / 3 : bytes;
+}
+
+void Texture2D::markUsed()
+{
+    _lastUsedFrame = TextureCache::getFrameStamp();
+}
+
 void Texture2D::addSpriteFrameCapInset(SpriteFrame* spritframe, const Rect& capInsets)
 {
     if (nullptr == _ninePatchInfo)
@@ -373,6 +373,16 @@ public:
 
     std::string getPath() const { return _filePath; }
 
+    /** Gets the estimated GPU memory used by the texture in bytes, mipmaps included. */
+    size_t getMemorySize() const;
+
+    /** Marks the texture as used by the current frame, see TextureCache::setMemoryBudget and
+     * TextureCache::getFrameStamp. */
+    void markUsed();
+
+    /** Gets the last frame the texture was used in. */
+    unsigned int getLastUsedFrame() const { return _lastUsedFrame; }
+
 private:
     /**
      * A struct for storing 9-patch image capInsets.
@@ -452,6 +462,11 @@ protected:
     bool _valid;
     std::string _filePath;
 
+    /** cache eviction states, managed by TextureCache */
+    unsigned int _lastUsedFrame = 0;
+    int _cachePriority          = 0;
+    bool _cachePinned           = false;
+
     backend::ProgramState* _programState = nullptr;
     backend::UniformLocation _mvpMatrixLocation;
     backend::UniformLocation _textureLocation;
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
 
 #include "renderer/Texture2D.h"
 #include "base/Macros.h"
@@ -50,6 +51,7 @@ using namespace std;
 NS_AX_BEGIN
 
 std::string TextureCache::s_etc1AlphaFileSuffix = "@alpha";
+unsigned int TextureCache::s_frameStamp         = 0;
 
 // implementation TextureCache
 
@@ -350,6 +352,7 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
 #endif
                 // cache the texture. retain it, since it is added in the map
                 _textures.emplace(asyncStruct->filename, texture);
+                trackReload(asyncStruct->filename);
                 texture->retain();
 
                 texture->autorelease();
@@ -467,6 +470,7 @@ Texture2D* TextureCache::addImage(std::string_view path, PixelFormat format)
 #endif
                 // texture already retained, no need to re-retain it
                 _textures.emplace(fullpath, texture);
+                trackReload(fullpath);
 
                 //-- ANDROID ETC1 ALPHA SUPPORTS.
                 std::string alphaFullPath{path};
@@ -597,6 +601,7 @@ void TextureCache::removeAllTextures()
         texture.second->release();
     }
     _textures.clear();
+    _evictedKeys.clear();
 }
 
 void TextureCache::removeUnusedTextures()
@@ -724,6 +729,16 @@ std::string TextureCache::getCachedTextureInfo() const
              (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f * 1024.0f));
     buffer += buftmp;
 
+    if (_memoryBudget > 0)
+    {
+        snprintf(buftmp, sizeof(buftmp) - 1,
+                 "TextureCache budget: %.2f MB, peak %.2f MB, %ld evictions (%.2f MB), %ld reloads\n",
+                 _memoryBudget / (1024.0f * 1024.0f), _memoryStats.peakBytes / (1024.0f * 1024.0f),
+                 (long)_memoryStats.evictions, _memoryStats.evictedBytes / (1024.0f * 1024.0f),
+                 (long)_memoryStats.reloads);
+        buffer += buftmp;
+    }
+
     return buffer;
 }
 
@@ -753,6 +768,113 @@ void TextureCache::renameTextureWithKey(std::string_view srcName, std::string_vi
     }
 }
 
+void TextureCache::setMemoryBudget(size_t bytes)
+{
+    _memoryBudget = bytes;
+}
+
+void TextureCache::setTexturePriority(Texture2D* texture, int priority)
+{
+    if (texture)
+        texture->_cachePriority = priority;
+}
+
+void TextureCache::setTexturePinned(Texture2D* texture, bool pinned)
+{
+    if (texture)
+        texture->_cachePinned = pinned;
+}
+
+void TextureCache::trackReload(std::string_view key)
+{
+    if (_evictedKeys.empty())
+        return;
+
+    auto it = _evictedKeys.find(key);
+    if (it != _evictedKeys.end())
+    {
+        _evictedKeys.erase(it);
+        ++_memoryStats.reloads;
+    }
+}
+
+size_t TextureCache::purgeToBudget()
+{
+    if (_memoryBudget == 0)
+        return 0;
+
+    size_t totalBytes = 0;
+    for (auto&& item : _textures)
+        totalBytes += item.second->getMemorySize();
+    _memoryStats.peakBytes = std::max(_memoryStats.peakBytes, totalBytes);
+
+    if (totalBytes <= _memoryBudget)
+        return 0;
+
+    // only the cache references the candidates, textures used by the current frame are kept
+    struct Candidate
+    {
+        hlookup::string_map<Texture2D*>::const_iterator it;
+        size_t bytes;
+    };
+    std::vector<Candidate> candidates;
+    const auto currentFrame = s_frameStamp;
+    for (auto it = _textures.cbegin(); it != _textures.cend(); ++it)
+    {
+        Texture2D* tex = it->second;
+        if (tex->getReferenceCount() == 1 && !tex->_cachePinned && tex->_lastUsedFrame != currentFrame)
+            candidates.emplace_back(Candidate{it, tex->getMemorySize()});
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+        auto a = lhs.it->second;
+        auto b = rhs.it->second;
+        if (a->_cachePriority != b->_cachePriority)
+            return a->_cachePriority < b->_cachePriority;
+        return a->_lastUsedFrame < b->_lastUsedFrame;
+    });
+
+    // collect the keys first, erasing from the robin map invalidates the iterators
+    std::vector<std::string> evictKeys;
+    size_t releasedBytes = 0;
+    for (auto&& candidate : candidates)
+    {
+        if (totalBytes - releasedBytes <= _memoryBudget)
+            break;
+        releasedBytes += candidate.bytes;
+        evictKeys.emplace_back(candidate.it->first);
+    }
+
+    for (auto&& key : evictKeys)
+    {
+        auto it = _textures.find(key);
+        AXLOG("axmol: TextureCache: evicting texture over budget: %s", key.c_str());
+        it->second->release();
+        _textures.erase(it);
+        _evictedKeys.emplace(key);
+    }
+
+    _memoryStats.evictions += evictKeys.size();
+    _memoryStats.evictedBytes += releasedBytes;
+    return releasedBytes;
+}
+
+TextureCache::MemoryStats TextureCache::getMemoryStats() const
+{
+    _memoryStats.textureCount = _textures.size();
+    _memoryStats.pinnedCount  = 0;
+    _memoryStats.bytes        = 0;
+    for (auto&& item : _textures)
+    {
+        _memoryStats.bytes += item.second->getMemorySize();
+        if (item.second->_cachePinned)
+            ++_memoryStats.pinnedCount;
+    }
+    _memoryStats.peakBytes = std::max(_memoryStats.peakBytes, _memoryStats.bytes);
+    _memoryStats.budget    = _memoryBudget;
+    return _memoryStats;
+}
+
 #if AX_ENABLE_CACHE_TEXTURE_DATA
 
 std::list<VolatileTexture*> VolatileTextureMgr::_textures;
@@ -65,10 +65,29 @@ NS_AX_BEGIN
 class AX_DLL TextureCache : public Ref
 {
 public:
+    /** Memory statistics of the cached textures, see TextureCache::getMemoryStats. */
+    struct MemoryStats
+    {
+        size_t textureCount = 0;
+        size_t pinnedCount  = 0;
+        size_t bytes        = 0;
+        size_t peakBytes    = 0;
+        size_t budget       = 0;
+        size_t evictions    = 0;
+        size_t evictedBytes = 0;
+        size_t reloads      = 0;
+    };
+
     // ETC1 ALPHA supports.
     static void setETC1AlphaFileSuffix(std::string_view suffix);
     static std::string getETC1AlphaFileSuffix();
 
+    /** Advances the frame stamp used to mark textures as used, called by the renderer when a frame begins. */
+    static void advanceFrameStamp() { ++s_frameStamp; }
+
+    /** Gets the stamp of the frame being rendered, see Texture2D::markUsed. */
+    static unsigned int getFrameStamp() { return s_frameStamp; }
+
 public:
     /**
      * @js ctor
@@ -189,6 +208,34 @@ public:
      */
     std::string getCachedTextureInfo() const;
 
+    /** Sets the GPU memory budget of the cached textures.
+     * When the cached textures use more memory than the budget, textures only referenced by the cache
+     * are released at the end of the frame, the lowest priority and least recently used ones first.
+     * Evicted textures are loaded again on demand by addImage or addImageAsync.
+     *
+     * @param bytes The budget in bytes, 0 disables the budget.
+     */
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const { return _memoryBudget; }
+
+    /** Sets the eviction priority of a texture, textures with a lower priority are evicted first.
+     * The default priority is 0.
+     */
+    void setTexturePriority(Texture2D* texture, int priority);
+
+    /** Pinned textures are never evicted by the memory budget. */
+    void setTexturePinned(Texture2D* texture, bool pinned);
+
+    /** Evicts unreferenced textures until the cached textures fit in the memory budget.
+     * Called by director at the end of each frame.
+     *
+     * @return The number of bytes released.
+     */
+    size_t purgeToBudget();
+
+    /** Gets the memory statistics of the cached textures. */
+    MemoryStats getMemoryStats() const;
+
     // Wait for texture cache to quit before destroy instance.
     /**Called by director, please do not called outside.*/
     void waitForQuit();
@@ -216,6 +263,7 @@ private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
     void parseNinePatchImage(Image* image, Texture2D* texture, std::string_view path);
+    void trackReload(std::string_view key);
 
 public:
 protected:
@@ -238,7 +286,13 @@ protected:
 
     hlookup::string_map<Texture2D*> _textures;
 
+    // memory budget
+    size_t _memoryBudget = 0;
+    hlookup::string_set _evictedKeys;
+    mutable MemoryStats _memoryStats;
+
     static std::string s_etc1AlphaFileSuffix;
+    static unsigned int s_frameStamp;
 };
 
 #if AX_ENABLE_CACHE_TEXTURE_DATA
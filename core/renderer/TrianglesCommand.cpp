@@ -53,6 +53,8 @@ void TrianglesCommand::init(float globalOrder,
     }
     _mv = mv;
 
+    texture->markUsed();
+
     auto batchId = _pipelineDescriptor.programState->getBatchId();
     if (_batchId != batchId || _texture != texture->getBackendTexture() || _blendType != blendType)
     {
@@ -101,6 +101,12 @@ public:
     const unsigned short* getIndices() const { return _triangles.indices; }
     /**Get the model view matrix.*/
     const Mat4& getModelView() const { return _mv; }
+    /**Get the backend texture of the command.*/
+    backend::TextureBackend* getTexture() const { return _texture; }
+    /**Get the blend function of the command.*/
+    const BlendFunc& getBlendType() const { return _blendType; }
+    /**Get the batch id of the program state, used by multi texture batching.*/
+    uint64_t getBatchId() const { return _batchId; }
 
     /** update material ID */
     void updateMaterialID();
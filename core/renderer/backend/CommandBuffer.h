@@ -206,6 +206,18 @@ public:
      */
     virtual void endFrame() = 0;
 
+    /**
+     * Get the GPU execution time of a recently finished frame.
+     * Backends resolve GPU timings asynchronously, so the value lags a few frames behind.
+     * @return The time in milliseconds, or -1 if the backend can't measure it.
+     */
+    virtual double getGPUFrameTime() const { return -1.0; }
+
+    /**
+     * Enable/disable measuring the GPU time of frames, see `getGPUFrameTime()`.
+     */
+    virtual void setGPUTimingEnabled(bool /*enabled*/) {}
+
     /**
      * Fixed-function state
      * @param x, y Specifies the lower left corner of the scissor box
@@ -216,9 +228,9 @@ public:
 
     /**
      * Get a screen snapshot
-     * @param callback A callback to deal with screen snapshot image.
+     * @param callback A callback to deal with screen snapshot image, it may move the pixel data out of the descriptor.
      */
-    virtual void readPixels(RenderTarget* rt, std::function<void(const PixelBufferDescriptor&)> callback) = 0;
+    virtual void readPixels(RenderTarget* rt, std::function<void(PixelBufferDescriptor&)> callback) = 0;
 
     /**
      * Update both front and back stencil reference value.
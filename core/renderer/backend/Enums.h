@@ -71,7 +71,9 @@ enum class VertexFormat : uint32_t
     INT,
     USHORT4,
     USHORT2,
-    UBYTE4
+    UBYTE4,
+    HALF2,
+    BYTE4
 };
 /** @typedef backend::PixelFormat
      Possible texture pixel formats
@@ -372,6 +374,7 @@ struct ProgramType
         POSITION_NORMAL_3D,                   // positionNormalTexture_vert,      colorNormal_frag
         POSITION_TEXTURE_3D,                  // positionTexture3D_vert,          colorTexture_frag
         POSITION_TEXTURE_3D_INSTANCE,         // positionTextureInstance_vert,    colorTexture_frag
+        POSITION_NORMAL_TEXTURE_3D_INSTANCE,  // positionNormalTextureInstance_vert, colorNormalTexture_frag
         POSITION_3D,                          // positionTexture_vert,            color_frag
         POSITION_BUMPEDNORMAL_TEXTURE_3D,     // positionNormalTexture_vert,      colorNormalTexture_frag
         SKINPOSITION_BUMPEDNORMAL_TEXTURE_3D, // skinPositionNormalTexture_vert,  colorNormalTexture_frag
@@ -389,6 +392,8 @@ struct ProgramType
         VIDEO_TEXTURE_NV12,
         VIDEO_TEXTURE_BGR32,
 
+        POSITION_TEXTURE_COLOR_MULTI,         // positionTextureColorMulti_vert,  positionTextureColorMulti_frag
+
         BUILTIN_COUNT,
 
         VIDEO_TEXTURE_RGB32 = POSITION_TEXTURE_COLOR,
@@ -27,6 +27,19 @@
 #include "PixelFormatUtils.h"
 #include "Macros.h"
 
+#include <cmath>
+#include <utility>
+
+// SSE2 & NEON are always available on x64 & arm64, the kernels return how many pixels they converted and the scalar
+// loops handle the rest, so both produce exactly the same output
+#if defined(__aarch64__) || defined(_M_ARM64)
+#    include <arm_neon.h>
+#    define AX_PIXEL_NEON
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define AX_PIXEL_SSE2
+#endif
+
 NS_AX_BEGIN
 
 namespace backend
@@ -114,6 +127,272 @@ uint32_t computeRowPitch(PixelFormat format, uint32_t width)
     return 0;
 }
 
+//////////////////////////////////////////////////////////////////////////
+// SIMD kernels
+
+#if defined(AX_PIXEL_SSE2)
+// RGBA8 pixels are handled as uint32 lanes: R | G << 8 | B << 16 | A << 24
+static inline __m128i mask32(uint32_t mask)
+{
+    return _mm_set1_epi32((int)mask);
+}
+
+// packs the low 16 bits of 8 uint32 lanes, _mm_packs_epi32 saturates so sign extend them first
+static inline __m128i packLow16(__m128i lo, __m128i hi)
+{
+    lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+    hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+    return _mm_packs_epi32(lo, hi);
+}
+
+template <typename Pack>
+static size_t convertRGBA8To16(const unsigned char* data, size_t pixels, unsigned char* outData, Pack pack)
+{
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        auto lo = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        auto hi = _mm_loadu_si128((const __m128i*)(data + i * 4 + 16));
+        _mm_storeu_si128((__m128i*)(outData + i * 2), packLow16(pack(lo), pack(hi)));
+    }
+    return i;
+}
+
+static size_t simdConvertRGBA8ToRGB565(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    return convertRGBA8To16(data, pixels, outData, [](__m128i x) {
+        auto r = _mm_slli_epi32(_mm_and_si128(x, mask32(0x000000F8)), 8);
+        auto g = _mm_srli_epi32(_mm_and_si128(x, mask32(0x0000FC00)), 5);
+        auto b = _mm_srli_epi32(_mm_and_si128(x, mask32(0x00F80000)), 19);
+        return _mm_or_si128(_mm_or_si128(r, g), b);
+    });
+}
+
+static size_t simdConvertRGBA8ToRGBA4(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    return convertRGBA8To16(data, pixels, outData, [](__m128i x) {
+        auto r = _mm_slli_epi32(_mm_and_si128(x, mask32(0x000000F0)), 8);
+        auto g = _mm_srli_epi32(_mm_and_si128(x, mask32(0x0000F000)), 4);
+        auto b = _mm_srli_epi32(_mm_and_si128(x, mask32(0x00F00000)), 16);
+        auto a = _mm_srli_epi32(x, 28);
+        return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+    });
+}
+
+static size_t simdConvertRGBA8ToRGB5A1(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    return convertRGBA8To16(data, pixels, outData, [](__m128i x) {
+        auto r = _mm_slli_epi32(_mm_and_si128(x, mask32(0x000000F8)), 8);
+        auto g = _mm_srli_epi32(_mm_and_si128(x, mask32(0x0000F800)), 5);
+        auto b = _mm_srli_epi32(_mm_and_si128(x, mask32(0x00F80000)), 18);
+        auto a = _mm_srli_epi32(x, 31);
+        return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+    });
+}
+
+static size_t simdConvertBGRA8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4)
+    {
+        auto x  = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        auto ga = _mm_and_si128(x, mask32(0xFF00FF00));
+        auto r  = _mm_and_si128(_mm_srli_epi32(x, 16), mask32(0x000000FF));
+        auto b  = _mm_slli_epi32(_mm_and_si128(x, mask32(0x000000FF)), 16);
+        _mm_storeu_si128((__m128i*)(outData + i * 4), _mm_or_si128(ga, _mm_or_si128(r, b)));
+    }
+    return i;
+}
+
+static size_t simdPremultiplyAlphaRGBA8(unsigned char* data, size_t pixels)
+{
+    const auto zero      = _mm_setzero_si128();
+    const auto one       = _mm_set1_epi16(1);
+    const auto alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+
+    // c * (a + 1) >> 8 in 16 bit lanes, two pixels per register
+    auto premultiply = [&](__m128i x) {
+        auto alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        auto color = _mm_srli_epi16(_mm_mullo_epi16(x, _mm_add_epi16(alpha, one)), 8);
+        return _mm_or_si128(_mm_andnot_si128(alphaMask, color), _mm_and_si128(alphaMask, x));
+    };
+
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4)
+    {
+        auto x  = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        auto lo = premultiply(_mm_unpacklo_epi8(x, zero));
+        auto hi = premultiply(_mm_unpackhi_epi8(x, zero));
+        _mm_storeu_si128((__m128i*)(data + i * 4), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+static size_t simdReversePremultipliedAlphaRGBA8(unsigned char* data, size_t pixels)
+{
+    const auto byteMask = mask32(0xFF);
+    const auto maxValue = _mm_set1_ps(255.0f);
+    auto alpha          = _mm_setzero_ps();
+
+    // min(ceil(c * 255 / a), 255), ceil is emulated by truncation as SSE2 has no rounding modes
+    auto unpremultiply = [&](__m128i c) {
+        auto v = _mm_min_ps(_mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(c), maxValue), alpha), maxValue);
+        auto t = _mm_cvttps_epi32(v);
+        return _mm_sub_epi32(t, _mm_castps_si128(_mm_cmplt_ps(_mm_cvtepi32_ps(t), v)));
+    };
+
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4)
+    {
+        auto x = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        auto a = _mm_srli_epi32(x, 24);
+        alpha  = _mm_cvtepi32_ps(a);
+
+        auto r   = unpremultiply(_mm_and_si128(x, byteMask));
+        auto g   = unpremultiply(_mm_and_si128(_mm_srli_epi32(x, 8), byteMask));
+        auto b   = unpremultiply(_mm_and_si128(_mm_srli_epi32(x, 16), byteMask));
+        auto out = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)),
+                                _mm_or_si128(_mm_slli_epi32(b, 16), _mm_slli_epi32(a, 24)));
+
+        auto transparent = _mm_cmpeq_epi32(a, _mm_setzero_si128());
+        out = _mm_or_si128(_mm_and_si128(transparent, x), _mm_andnot_si128(transparent, out));
+        _mm_storeu_si128((__m128i*)(data + i * 4), out);
+    }
+    return i;
+}
+#elif defined(AX_PIXEL_NEON)
+static size_t simdConvertRGBA8ToRGB565(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        auto p = vld4_u8(data + i * 4);
+        auto r = vshll_n_u8(vand_u8(p.val[0], vdup_n_u8(0xF8)), 8);
+        auto g = vshll_n_u8(vand_u8(p.val[1], vdup_n_u8(0xFC)), 3);
+        auto b = vmovl_u8(vshr_n_u8(p.val[2], 3));
+        vst1q_u16((uint16_t*)(outData + i * 2), vorrq_u16(vorrq_u16(r, g), b));
+    }
+    return i;
+}
+
+static size_t simdConvertRGBA8ToRGBA4(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        auto p = vld4_u8(data + i * 4);
+        auto r = vshll_n_u8(vand_u8(p.val[0], vdup_n_u8(0xF0)), 8);
+        auto g = vshll_n_u8(vand_u8(p.val[1], vdup_n_u8(0xF0)), 4);
+        auto b = vmovl_u8(vand_u8(p.val[2], vdup_n_u8(0xF0)));
+        auto a = vmovl_u8(vshr_n_u8(p.val[3], 4));
+        vst1q_u16((uint16_t*)(outData + i * 2), vorrq_u16(vorrq_u16(r, g), vorrq_u16(b, a)));
+    }
+    return i;
+}
+
+static size_t simdConvertRGBA8ToRGB5A1(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        auto p = vld4_u8(data + i * 4);
+        auto r = vshll_n_u8(vand_u8(p.val[0], vdup_n_u8(0xF8)), 8);
+        auto g = vshll_n_u8(vand_u8(p.val[1], vdup_n_u8(0xF8)), 3);
+        auto b = vmovl_u8(vshl_n_u8(vshr_n_u8(p.val[2], 3), 1));
+        auto a = vmovl_u8(vshr_n_u8(p.val[3], 7));
+        vst1q_u16((uint16_t*)(outData + i * 2), vorrq_u16(vorrq_u16(r, g), vorrq_u16(b, a)));
+    }
+    return i;
+}
+
+static size_t simdConvertBGRA8ToRGBA8(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        auto p = vld4q_u8(data + i * 4);
+        std::swap(p.val[0], p.val[2]);
+        vst4q_u8(outData + i * 4, p);
+    }
+    return i;
+}
+
+static size_t simdPremultiplyAlphaRGBA8(unsigned char* data, size_t pixels)
+{
+    // c * (a + 1) >> 8 == (c * a + c) >> 8
+    auto premultiply = [](uint8x16_t c, uint8x16_t a) {
+        auto lo = vaddw_u8(vmull_u8(vget_low_u8(c), vget_low_u8(a)), vget_low_u8(c));
+        auto hi = vaddw_u8(vmull_u8(vget_high_u8(c), vget_high_u8(a)), vget_high_u8(c));
+        return vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+    };
+
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        auto p   = vld4q_u8(data + i * 4);
+        p.val[0] = premultiply(p.val[0], p.val[3]);
+        p.val[1] = premultiply(p.val[1], p.val[3]);
+        p.val[2] = premultiply(p.val[2], p.val[3]);
+        vst4q_u8(data + i * 4, p);
+    }
+    return i;
+}
+
+static size_t simdReversePremultipliedAlphaRGBA8(unsigned char* data, size_t pixels)
+{
+    const auto byteMask = vdupq_n_u32(0xFF);
+    const auto maxValue = vdupq_n_f32(255.0f);
+
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4)
+    {
+        auto x     = vld1q_u32((const uint32_t*)(data + i * 4));
+        auto a     = vshrq_n_u32(x, 24);
+        auto alpha = vcvtq_f32_u32(a);
+
+        // min(ceil(c * 255 / a), 255)
+        auto unpremultiply = [&](uint32x4_t c) {
+            auto v = vminq_f32(vdivq_f32(vmulq_f32(vcvtq_f32_u32(c), maxValue), alpha), maxValue);
+            return vcvtq_u32_f32(vrndpq_f32(v));
+        };
+
+        auto r   = unpremultiply(vandq_u32(x, byteMask));
+        auto g   = unpremultiply(vandq_u32(vshrq_n_u32(x, 8), byteMask));
+        auto b   = unpremultiply(vandq_u32(vshrq_n_u32(x, 16), byteMask));
+        auto out = vorrq_u32(vorrq_u32(r, vshlq_n_u32(g, 8)), vorrq_u32(vshlq_n_u32(b, 16), vshlq_n_u32(a, 24)));
+
+        auto transparent = vceqq_u32(a, vdupq_n_u32(0));
+        vst1q_u32((uint32_t*)(data + i * 4), vbslq_u32(transparent, x, out));
+    }
+    return i;
+}
+#else
+static size_t simdConvertRGBA8ToRGB565(const unsigned char*, size_t, unsigned char*)
+{
+    return 0;
+}
+static size_t simdConvertRGBA8ToRGBA4(const unsigned char*, size_t, unsigned char*)
+{
+    return 0;
+}
+static size_t simdConvertRGBA8ToRGB5A1(const unsigned char*, size_t, unsigned char*)
+{
+    return 0;
+}
+static size_t simdConvertBGRA8ToRGBA8(const unsigned char*, size_t, unsigned char*)
+{
+    return 0;
+}
+static size_t simdPremultiplyAlphaRGBA8(unsigned char*, size_t)
+{
+    return 0;
+}
+static size_t simdReversePremultipliedAlphaRGBA8(unsigned char*, size_t)
+{
+    return 0;
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 // convertor function
 
@@ -306,6 +585,11 @@ void convertRGB8ToRGB565(const unsigned char* data, size_t dataLen, unsigned cha
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
 void convertRGBA8ToRGB565(const unsigned char* data, size_t dataLen, unsigned char* outData)
 {
+    size_t done = simdConvertRGBA8ToRGB565(data, dataLen / 4, outData);
+    data += done * 4;
+    dataLen -= done * 4;
+    outData += done * 2;
+
     unsigned short* out16 = (unsigned short*)outData;
     for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
     {
@@ -392,6 +676,11 @@ void convertRGB8ToRGBA4(const unsigned char* data, size_t dataLen, unsigned char
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
 void convertRGBA8ToRGBA4(const unsigned char* data, size_t dataLen, unsigned char* outData)
 {
+    size_t done = simdConvertRGBA8ToRGBA4(data, dataLen / 4, outData);
+    data += done * 4;
+    dataLen -= done * 4;
+    outData += done * 2;
+
     unsigned short* out16 = (unsigned short*)outData;
     for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
     {
@@ -418,6 +707,11 @@ void convertRGB8ToRGB5A1(const unsigned char* data, size_t dataLen, unsigned cha
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGG GGBBBBBA
 void convertRGBA8ToRGB5A1(const unsigned char* data, size_t dataLen, unsigned char* outData)
 {
+    size_t done = simdConvertRGBA8ToRGB5A1(data, dataLen / 4, outData);
+    data += done * 4;
+    dataLen -= done * 4;
+    outData += done * 2;
+
     unsigned short* out16 = (unsigned short*)outData;
     for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
     {
@@ -486,6 +780,11 @@ void convertA8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned char*
 
 void convertBGRA8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned char* outData)
 {
+    size_t done = simdConvertBGRA8ToRGBA8(data, dataLen / 4, outData);
+    data += done * 4;
+    dataLen -= done * 4;
+    outData += done * 4;
+
     const size_t pixelCounts = dataLen / 4;
     for (size_t i = 0; i < pixelCounts; i++)
     {
@@ -496,6 +795,38 @@ void convertBGRA8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned cha
     }
 }
 
+void premultiplyAlphaRGBA8(unsigned char* data, size_t dataLen)
+{
+    const size_t pixelCounts = dataLen / 4;
+    for (size_t i = simdPremultiplyAlphaRGBA8(data, pixelCounts); i < pixelCounts; i++)
+    {
+        auto p = data + i * 4;
+        p[0]   = p[0] * (p[3] + 1) >> 8;
+        p[1]   = p[1] * (p[3] + 1) >> 8;
+        p[2]   = p[2] * (p[3] + 1) >> 8;
+    }
+}
+
+static inline uint8_t clampByte(int x)
+{
+    return (uint8_t)(x >= 0 ? (x < 255 ? x : 255) : 0);
+}
+
+void reversePremultipliedAlphaRGBA8(unsigned char* data, size_t dataLen)
+{
+    const size_t pixelCounts = dataLen / 4;
+    for (size_t i = simdReversePremultipliedAlphaRGBA8(data, pixelCounts); i < pixelCounts; i++)
+    {
+        auto p = data + i * 4;
+        if (p[3] > 0)
+        {
+            p[0] = clampByte(int(std::ceil((p[0] * 255.0f) / p[3])));
+            p[1] = clampByte(int(std::ceil((p[1] * 255.0f) / p[3])));
+            p[2] = clampByte(int(std::ceil((p[2] * 255.0f) / p[3])));
+        }
+    }
+}
+
 // converter function end
 //////////////////////////////////////////////////////////////////////////
 
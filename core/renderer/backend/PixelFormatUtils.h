@@ -163,6 +163,11 @@ void convertRGBA4ToRGBA8(const unsigned char* data, size_t dataLen, unsigned cha
 
 // BGRA8 to XXX
 void convertBGRA8ToRGBA8(const unsigned char* data, size_t dataLen, unsigned char* outData);
+
+// RGBA8 alpha, in place
+void premultiplyAlphaRGBA8(unsigned char* data, size_t dataLen);
+/** pixels with 0 alpha are kept as they are */
+void reversePremultipliedAlphaRGBA8(unsigned char* data, size_t dataLen);
 };  // namespace PixelFormatUtils
 }  // namespace backend
 NS_AX_END
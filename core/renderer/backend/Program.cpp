@@ -162,12 +162,24 @@ struct VertexLayoutHelper
                                 backend::VertexFormat::FLOAT3, offsetof(V3F_T2F_N3F, normal), false);
         vertexLayout->setStride(sizeof(V3F_T2F_N3F));
     }
+
+    static void setupSpriteMultiTexture(Program* program)
+    {
+        setupSprite(program);
+
+        auto vertexLayout = program->getVertexLayout();
+        /// a_texCoord1, the texture slot of the vertex
+        vertexLayout->setAttrib(backend::ATTRIBUTE_NAME_TEXCOORD1,
+                                program->getAttributeLocation(backend::Attribute::TEXCOORD1),
+                                backend::VertexFormat::FLOAT, offsetof(V3F_C4B_T2F_I1F, texIndex), false);
+        vertexLayout->setStride(sizeof(V3F_C4B_T2F_I1F));
+    }
 };
 std::function<void(Program*)> Program::s_vertexLayoutSetupList[static_cast<int>(VertexLayoutType::Count)] = {
     VertexLayoutHelper::setupDummy,    VertexLayoutHelper::setupPos,      VertexLayoutHelper::setupTexture,
     VertexLayoutHelper::setupSprite,   VertexLayoutHelper::setupDrawNode, VertexLayoutHelper::setupDrawNode3D,
     VertexLayoutHelper::setupSkyBox,   VertexLayoutHelper::setupPU3D,     VertexLayoutHelper::setupPosColor,
-    VertexLayoutHelper::setupTerrain3D};
+    VertexLayoutHelper::setupTerrain3D, VertexLayoutHelper::setupSpriteMultiTexture};
 
 Program::Program(std::string_view vs, std::string_view fs)
     : _vertexShader(vs), _fragmentShader(fs), _vertexLayout(new VertexLayout())
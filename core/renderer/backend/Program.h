@@ -48,16 +48,17 @@ class ProgramManager;
 
 enum class VertexLayoutType
 {
-    Unspec,      // needs binding after program load
-    Pos,         // V2F
-    Texture,     // T2F
-    Sprite,      // V3F_C4B_T2F posTexColor
-    DrawNode,    // V2F_C4B_T2F
-    DrawNode3D,  // V3F_C4B
-    SkyBox,      // V3F
-    PU3D,        // V3F_C4B_T2F // same with sprite, TODO: reuse spriete
-    posColor,    // V3F_C4B
-    Terrain3D,   // V3F_T2F_V3F
+    Unspec,              // needs binding after program load
+    Pos,                 // V2F
+    Texture,             // T2F
+    Sprite,              // V3F_C4B_T2F posTexColor
+    DrawNode,            // V2F_C4B_T2F
+    DrawNode3D,          // V3F_C4B
+    SkyBox,              // V3F
+    PU3D,                // V3F_C4B_T2F // same with sprite, TODO: reuse spriete
+    posColor,            // V3F_C4B
+    Terrain3D,           // V3F_T2F_V3F
+    SpriteMultiTexture,  // V3F_C4B_T2F_I1F
     Count
 };
 
@@ -132,6 +132,8 @@ bool ProgramManager::init()
                     VertexLayoutType::Unspec);
     registerProgram(ProgramType::POSITION_TEXTURE_3D_INSTANCE, positionTextureInstance_vert, colorTexture_frag,
                     VertexLayoutType::Unspec);
+    registerProgram(ProgramType::POSITION_NORMAL_TEXTURE_3D_INSTANCE, positionNormalTextureInstance_vert,
+                    colorNormalTexture_frag, VertexLayoutType::Unspec);
     registerProgram(ProgramType::POSITION_3D, position_vert, color_frag, VertexLayoutType::Unspec);
     registerProgram(ProgramType::POSITION_NORMAL_3D, positionNormalTexture_vert, colorNormal_frag,
                     VertexLayoutType::Unspec);
@@ -153,6 +155,9 @@ bool ProgramManager::init()
     registerProgram(ProgramType::VIDEO_TEXTURE_NV12, positionTextureColor_vert, videoTextureNV12_frag,
                     VertexLayoutType::Sprite);
 
+    registerProgram(ProgramType::POSITION_TEXTURE_COLOR_MULTI, positionTextureColorMulti_vert,
+                    positionTextureColorMulti_frag, VertexLayoutType::SpriteMultiTexture);
+
     // The builtin dual sampler shader registry
     ProgramStateRegistry::getInstance()->registerProgram(ProgramType::POSITION_TEXTURE_COLOR,
                                                          TextureSamplerFlag::DUAL_SAMPLER, ProgramType::DUAL_SAMPLER);
@@ -429,6 +429,13 @@ const char* ProgramState::getVertexUniformBuffer(std::size_t& size) const
     return _uniformBuffers.data();
 }
 
+void ProgramState::copyVertexUniforms(const ProgramState* other)
+{
+    assert(_vertexUniformBufferSize == other->_vertexUniformBufferSize);
+    memcpy(_uniformBuffers.data(), other->_uniformBuffers.data(),
+           (std::min)(_vertexUniformBufferSize, other->_vertexUniformBufferSize));
+}
+
 const char* ProgramState::getFragmentUniformBuffer(std::size_t& size) const
 {
     size = _fragmentUniformBufferSize;
@@ -219,6 +219,12 @@ public:
      */
     const char* getVertexUniformBuffer(std::size_t& size) const;
 
+    /**
+     * Copy the vertex uniform values from another program state.
+     * @param other A program state whose vertex shader declares the same uniform block.
+     */
+    void copyVertexUniforms(const ProgramState* other);
+
     /**
      * Get fragment uniform buffer. The buffer store all the fragment uniform's data for metal.
      * @param[out] size Specifies the size of the buffer in bytes.
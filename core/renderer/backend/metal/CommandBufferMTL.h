@@ -27,6 +27,7 @@
 #include "../CommandBuffer.h"
 #include "DeviceMTL.h"
 #include <unordered_map>
+#include <atomic>
 
 NS_AX_BACKEND_BEGIN
 
@@ -184,6 +185,10 @@ public:
      */
     virtual void endFrame() override;
 
+    virtual double getGPUFrameTime() const override { return _gpuFrameTime.load(std::memory_order_relaxed); }
+
+    virtual void setGPUTimingEnabled(bool enabled) override { _gpuTimingEnabled = enabled; }
+
     void endEncoding();
 
     /**
@@ -198,7 +203,7 @@ public:
      * Read pixels from RenderTarget
      * @param callback A callback to deal with pixel data read.
      */
-    virtual void readPixels(RenderTarget* rt, std::function<void(const PixelBufferDescriptor&)> callback) override;
+    virtual void readPixels(RenderTarget* rt, std::function<void(PixelBufferDescriptor&)> callback) override;
     
     id<MTLRenderCommandEncoder> getRenderCommandEncoder() const { return _mtlRenderEncoder; }
 
@@ -257,7 +262,10 @@ private:
     TargetBufferFlags _currentRenderTargetFlags = TargetBufferFlags::NONE;
     NSAutoreleasePool* _autoReleasePool         = nil;
 
-    std::vector<std::pair<TextureBackend*, std::function<void(const PixelBufferDescriptor&)>>> _captureCallbacks;
+    bool _gpuTimingEnabled = false;
+    std::atomic<double> _gpuFrameTime{-1.0};  // written by the command buffer completed handler
+
+    std::vector<std::pair<TextureBackend*, std::function<void(PixelBufferDescriptor&)>>> _captureCallbacks;
 };
 
 // end of _metal group
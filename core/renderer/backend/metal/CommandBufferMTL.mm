@@ -337,7 +337,7 @@ void CommandBufferMTL::endRenderPass()
     afterDraw();
 }
 
-void CommandBufferMTL::readPixels(RenderTarget* rt, std::function<void(const PixelBufferDescriptor&)> callback)
+void CommandBufferMTL::readPixels(RenderTarget* rt, std::function<void(PixelBufferDescriptor&)> callback)
 {
     auto rtMTL = static_cast<RenderTargetMTL*>(rt);
 
@@ -357,7 +357,14 @@ void CommandBufferMTL::endFrame()
     auto currentDrawable = DeviceMTL::getCurrentDrawable();
     [_mtlCommandBuffer presentDrawable:currentDrawable];
     _drawableTexture = currentDrawable.texture;
+    const bool gpuTiming = _gpuTimingEnabled;
     [_mtlCommandBuffer addCompletedHandler:^(id<MTLCommandBuffer> commandBuffer) {
+      if (gpuTiming)
+      {
+          if (@available(macOS 10.15, iOS 10.3, tvOS 10.3, *))
+              _gpuFrameTime.store((commandBuffer.GPUEndTime - commandBuffer.GPUStartTime) * 1000.0,
+                                  std::memory_order_relaxed);
+      }
       // GPU work is complete
       // Signal the semaphore to start the CPU work
       dispatch_semaphore_signal(_frameBoundarySemaphore);
@@ -414,7 +421,9 @@ void CommandBufferMTL::flushCaptureCommands()
                     // screen framebuffer copied, restore screen framebuffer only to true
                     backend::Device::getInstance()->setFrameBufferOnly(true);
                 }
-                cb.second(screenPixelData);
+                // every callback may take the pixels, each one gets its own copy
+                PixelBufferDescriptor pixelData = screenPixelData;
+                cb.second(pixelData);
             }
             else
             {
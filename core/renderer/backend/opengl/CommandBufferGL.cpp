@@ -64,10 +64,54 @@ CommandBufferGL::CommandBufferGL() {}
 CommandBufferGL::~CommandBufferGL()
 {
     cleanResources();
+    setGPUTimingEnabled(false);
+}
+
+void CommandBufferGL::setGPUTimingEnabled(bool enabled)
+{
+#if !AX_GLES_PROFILE  // timer queries are only core in Desktop OpenGL 3.3
+    if (enabled == _gpuTimingEnabled)
+        return;
+
+    if (enabled)
+    {
+        auto deviceInfo = Device::getInstance()->getDeviceInfo();
+        if (strtod(deviceInfo->getVersion(), nullptr) < 3.3 && !deviceInfo->hasExtension("GL_ARB_timer_query"sv))
+            return;
+        glGenQueries(GPU_TIMER_QUERY_COUNT, _gpuTimerQueries);
+    }
+    else
+    {
+        if (_gpuTimerActive)
+            glEndQuery(GL_TIME_ELAPSED);
+        glDeleteQueries(GPU_TIMER_QUERY_COUNT, _gpuTimerQueries);
+        std::fill_n(_gpuTimerQueries, GPU_TIMER_QUERY_COUNT, 0);
+        std::fill_n(_gpuTimerPending, GPU_TIMER_QUERY_COUNT, false);
+        _gpuTimerActive = false;
+        _gpuFrameTime   = -1.0;
+    }
+    _gpuTimingEnabled = enabled;
+#endif
 }
 
 bool CommandBufferGL::beginFrame()
 {
+#if !AX_GLES_PROFILE
+    if (_gpuTimingEnabled)
+    {
+        auto query = _gpuTimerQueries[_gpuTimerIndex];
+        if (_gpuTimerPending[_gpuTimerIndex])
+        {
+            // issued GPU_TIMER_QUERY_COUNT frames ago, so the result is almost always ready without a stall
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+            _gpuFrameTime = elapsed / 1e6;
+        }
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        _gpuTimerPending[_gpuTimerIndex] = true;
+        _gpuTimerActive                  = true;
+    }
+#endif
     return true;
 }
 
@@ -296,7 +340,17 @@ void CommandBufferGL::endRenderPass()
     AX_SAFE_RELEASE_NULL(_instanceTransformBuffer);
 }
 
-void CommandBufferGL::endFrame() {}
+void CommandBufferGL::endFrame()
+{
+#if !AX_GLES_PROFILE
+    if (_gpuTimerActive)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        _gpuTimerIndex  = (_gpuTimerIndex + 1) % GPU_TIMER_QUERY_COUNT;
+        _gpuTimerActive = false;
+    }
+#endif
+}
 
 void CommandBufferGL::prepareDrawing() const
 {
@@ -434,7 +488,7 @@ void CommandBufferGL::setScissorRect(bool isEnabled, float x, float y, float wid
         __gl->disableScissor();
 }
 
-void CommandBufferGL::readPixels(RenderTarget* rt, std::function<void(const PixelBufferDescriptor&)> callback)
+void CommandBufferGL::readPixels(RenderTarget* rt, std::function<void(PixelBufferDescriptor&)> callback)
 {
     PixelBufferDescriptor pbd;
     if (rt->isDefaultRenderTarget())
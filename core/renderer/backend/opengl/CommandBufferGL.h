@@ -190,6 +190,10 @@ public:
      */
     virtual void endFrame() override;
 
+    virtual double getGPUFrameTime() const override { return _gpuFrameTime; }
+
+    virtual void setGPUTimingEnabled(bool enabled) override;
+
     /**
      * Fixed-function state
      * @param x, y Specifies the lower left corner of the scissor box
@@ -202,7 +206,7 @@ public:
      * Get a screen snapshot
      * @param callback A callback to deal with screen snapshot image.
      */
-    virtual void readPixels(RenderTarget* rt, std::function<void(const PixelBufferDescriptor&)> callback) override;
+    virtual void readPixels(RenderTarget* rt, std::function<void(PixelBufferDescriptor&)> callback) override;
 
 protected:
     void readPixels(RenderTarget* rt,
@@ -231,6 +235,15 @@ protected:
     Viewport _viewPort;
     GLboolean _alphaTestEnabled               = false;
 
+    // GL_TIME_ELAPSED queries in flight, a query is read back when its slot is reused
+    static constexpr int GPU_TIMER_QUERY_COUNT = 4;
+    GLuint _gpuTimerQueries[GPU_TIMER_QUERY_COUNT] = {};
+    bool _gpuTimerPending[GPU_TIMER_QUERY_COUNT]   = {};
+    int _gpuTimerIndex                             = 0;
+    bool _gpuTimingEnabled                         = false;
+    bool _gpuTimerActive                           = false;
+    double _gpuFrameTime                           = -1.0;
+
 #if AX_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _backToForegroundListener = nullptr;
 #endif
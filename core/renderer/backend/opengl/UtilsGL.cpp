@@ -125,6 +125,16 @@ GLenum UtilsGL::toGLAttributeType(VertexFormat vertexFormat)
     case VertexFormat::UBYTE4:
         ret = GL_UNSIGNED_BYTE;
         break;
+    case VertexFormat::USHORT4:
+    case VertexFormat::USHORT2:
+        ret = GL_UNSIGNED_SHORT;
+        break;
+    case VertexFormat::HALF2:
+        ret = GL_HALF_FLOAT;
+        break;
+    case VertexFormat::BYTE4:
+        ret = GL_BYTE;
+        break;
     default:
         break;
     }
@@ -139,6 +149,8 @@ GLsizei UtilsGL::getGLAttributeSize(VertexFormat vertexFormat)
     case VertexFormat::FLOAT4:
     case VertexFormat::INT4:
     case VertexFormat::UBYTE4:
+    case VertexFormat::USHORT4:
+    case VertexFormat::BYTE4:
         ret = 4;
         break;
     case VertexFormat::FLOAT3:
@@ -147,6 +159,8 @@ GLsizei UtilsGL::getGLAttributeSize(VertexFormat vertexFormat)
         break;
     case VertexFormat::FLOAT2:
     case VertexFormat::INT2:
+    case VertexFormat::USHORT2:
+    case VertexFormat::HALF2:
         ret = 2;
         break;
     case VertexFormat::FLOAT:
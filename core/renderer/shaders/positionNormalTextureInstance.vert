@@ -0,0 +1,57 @@
+#version 310 es
+
+#include "base.glsl"
+
+layout(location = POSITION) in vec4 a_position;
+layout(location = TEXCOORD0) in vec2 a_texCoord;
+layout(location = NORMAL) in vec3 a_normal;
+#if !defined(METAL)
+layout(location = TEXCOORD1) in mat4 a_instance;
+#endif
+layout(location = TEXCOORD0) out vec2 v_texCoord;
+
+layout(location = POINTLIGHT) out vec3 v_vertexToPointLightDirection[MAX_POINT_LIGHT_NUM];
+layout(location = SPOTLIGHT) out vec3 v_vertexToSpotLightDirection[MAX_SPOT_LIGHT_NUM];
+layout(location = NORMAL) out vec3 v_normal;
+
+layout(std140, binding = 0) uniform vs_ub {
+    vec3 u_PointLightSourcePosition[MAX_POINT_LIGHT_NUM];
+    vec3 u_SpotLightSourcePosition[MAX_SPOT_LIGHT_NUM];
+    mat4 u_MVPMatrix;
+    mat4 u_MVMatrix;
+    mat4 u_PMatrix;
+    mat3 u_NormalMatrix;
+};
+
+#if defined(METAL)
+layout(std140, binding = 1) buffer vs_inst {
+    mat4 u_instance[];
+};
+#endif
+
+void main(void)
+{
+#if defined(METAL)
+    mat4 instance = u_instance[gl_InstanceIndex];
+#else
+    mat4 instance = a_instance;
+#endif
+    vec4 ePosition = u_MVMatrix * instance * a_position;
+
+    for (int i = 0; i < MAX_POINT_LIGHT_NUM; ++i)
+    {
+        v_vertexToPointLightDirection[i] = u_PointLightSourcePosition[i].xyz - ePosition.xyz;
+    }
+
+    for (int i = 0; i < MAX_SPOT_LIGHT_NUM; ++i)
+    {
+        v_vertexToSpotLightDirection[i] = u_SpotLightSourcePosition[i] - ePosition.xyz;
+    }
+
+    // instance transforms are expected to scale uniformly, the upper 3x3 is used as the normal matrix
+    v_normal = u_NormalMatrix * mat3(instance) * a_normal;
+
+    v_texCoord = a_texCoord;
+    v_texCoord.y = 1.0 - v_texCoord.y;
+    gl_Position = u_PMatrix * ePosition;
+}
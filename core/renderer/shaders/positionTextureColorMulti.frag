@@ -0,0 +1,36 @@
+#version 310 es
+precision highp float;
+precision highp int;
+
+layout(location = COLOR0) in vec4 v_color;
+layout(location = TEXCOORD0) in vec2 v_texCoord;
+layout(location = TEXCOORD1) in float v_texIndex;
+
+layout(binding = 0) uniform sampler2D u_tex0;
+layout(binding = 1) uniform sampler2D u_tex1;
+layout(binding = 2) uniform sampler2D u_tex2;
+layout(binding = 3) uniform sampler2D u_tex3;
+layout(binding = 4) uniform sampler2D u_tex4;
+layout(binding = 5) uniform sampler2D u_tex5;
+layout(binding = 6) uniform sampler2D u_tex6;
+layout(binding = 7) uniform sampler2D u_tex7;
+
+layout(location = SV_Target0) out vec4 FragColor;
+
+vec4 sampleTexture(int index, vec2 texCoord)
+{
+    if (index < 4)
+    {
+        if (index < 2)
+            return index == 0 ? texture(u_tex0, texCoord) : texture(u_tex1, texCoord);
+        return index == 2 ? texture(u_tex2, texCoord) : texture(u_tex3, texCoord);
+    }
+    if (index < 6)
+        return index == 4 ? texture(u_tex4, texCoord) : texture(u_tex5, texCoord);
+    return index == 6 ? texture(u_tex6, texCoord) : texture(u_tex7, texCoord);
+}
+
+void main()
+{
+    FragColor = v_color * sampleTexture(int(v_texIndex + 0.5), v_texCoord);
+}
@@ -36,6 +36,9 @@
 #endif
 #include <ioapi.h>
 #include "base/AsyncTaskPool.h"
+#include "base/JobSystem.h"
+#include "base/filesystem.h"
+#include "base/format.h"
 
 NS_AX_EXT_BEGIN
 
@@ -43,6 +46,7 @@ NS_AX_EXT_BEGIN
 #define VERSION_FILENAME "version.manifest"
 #define TEMP_MANIFEST_FILENAME "project.manifest.temp"
 #define MANIFEST_FILENAME "project.manifest"
+#define VERIFIED_CACHE_FILENAME "verified.cache"
 
 #define BUFFER_SIZE 8192
 #define MAX_FILENAME 512
@@ -191,7 +195,9 @@ AssetsManagerEx::AssetsManagerEx(std::string_view manifestUrl, std::string_view
     _tempVersionPath   = _tempStoragePath + VERSION_FILENAME;
     _cacheManifestPath = _storagePath + MANIFEST_FILENAME;
     _tempManifestPath  = _tempStoragePath + TEMP_MANIFEST_FILENAME;
+    _verifiedCachePath = _storagePath + VERIFIED_CACHE_FILENAME;
 
+    loadVerifiedCache();
     initManifests(manifestUrl);
 }
 
@@ -785,35 +791,32 @@ void AssetsManagerEx::startUpdate()
         // in this case, it equals remote manifest.
         _tempManifest = _remoteManifest;
 
-        // Check difference between local manifest and remote manifest
-        hlookup::string_map<Manifest::AssetDiff> diff_map = _localManifest->genDiff(_remoteManifest);
-        if (diff_map.empty())
-        {
-            updateSucceed();
-        }
-        else
-        {
-            // Generate download units for all assets that need to be updated or added
-            std::string_view packageUrl = _remoteManifest->getPackageUrl();
-            // Save current download manifest information for resuming
-            _tempManifest->saveToFile(_tempManifestPath);
-            // Preprocessing local files in previous version and creating download folders
-            for (auto it = diff_map.begin(); it != diff_map.end(); ++it)
-            {
-                Manifest::AssetDiff diff = it->second;
+        // Generate download units for all assets that need to be updated or added, while streaming the
+        // difference between local manifest and remote manifest
+        std::string_view packageUrl = _remoteManifest->getPackageUrl();
+        auto diffCount              = _localManifest->visitDiff(
+            _remoteManifest, [this, packageUrl](std::string_view key, const Manifest::AssetDiff& diff) {
                 if (diff.type != Manifest::DiffType::DELETED)
                 {
                     auto& path = diff.asset.path;
                     DownloadUnit unit;
-                    unit.customId = it->first;
+                    unit.customId = key;
                     unit.srcUrl   = packageUrl;
                     unit.srcUrl += path;
                     unit.storagePath = _tempStoragePath + path;
                     unit.size        = diff.asset.size;
                     _downloadUnits.emplace(unit.customId, unit);
-                    _tempManifest->setAssetDownloadState(it->first, Manifest::DownloadState::UNSTARTED);
+                    _tempManifest->setAssetDownloadState(key, Manifest::DownloadState::UNSTARTED);
                 }
-            }
+            });
+        if (diffCount == 0)
+        {
+            updateSucceed();
+        }
+        else
+        {
+            // Save current download manifest information for resuming
+            _tempManifest->saveToFile(_tempManifestPath);
             _totalWaitToDownload = _totalToDownload = (int)_downloadUnits.size();
             this->batchDownload();
 
@@ -867,9 +870,11 @@ void AssetsManagerEx::updateSucceed()
     _remoteManifest = nullptr;
     // 4. make local manifest take effect
     prepareLocalManifest();
-    // 5. Set update state
+    // 5. Persist verified states, the merged files keep their size and mtime
+    saveVerifiedCache();
+    // 6. Set update state
     _updateState = State::UP_TO_DATE;
-    // 6. Notify finished event
+    // 7. Notify finished event
     dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_FINISHED);
 }
 
@@ -1182,35 +1187,220 @@ void AssetsManagerEx::onSuccess(std::string_view /*srcUrl*/, std::string_view st
     }
     else
     {
-        bool ok      = true;
         auto& assets = _remoteManifest->getAssets();
         auto assetIt = assets.find(customId);
         if (assetIt != assets.end())
         {
-            Manifest::Asset asset = assetIt->second;
             if (_verifyCallback != nullptr)
             {
-                ok = _verifyCallback(storagePath, asset);
+                verifyDownloadedAsset(customId, storagePath, assetIt->second);
             }
+            else
+            {
+                onAssetVerified(customId, storagePath, assetIt->second.compressed, true);
+            }
+        }
+        else
+        {
+            onAssetVerified(customId, storagePath, false, true);
         }
+    }
+}
 
-        if (ok)
+void AssetsManagerEx::verifyDownloadedAsset(std::string_view customId,
+                                            std::string_view storagePath,
+                                            const Manifest::Asset& asset)
+{
+    if (!_parallelVerification)
+    {
+        onAssetVerified(customId, storagePath, asset.compressed, verifyAsset(storagePath, asset));
+        return;
+    }
+
+    // Keep alive until the verification result is handled in the main thread
+    this->retain();
+    JobSystem::getInstance()->enqueue(
+        [this, customId = std::string{customId}, storagePath = std::string{storagePath}, asset]() mutable {
+            bool ok = verifyAsset(storagePath, asset);
+            Director::getInstance()->getScheduler()->runOnAxmolThread(
+                [this, customId = std::move(customId), storagePath = std::move(storagePath),
+                 compressed = asset.compressed, ok]() {
+                    onAssetVerified(customId, storagePath, compressed, ok);
+                    this->release();
+                });
+        });
+}
+
+void AssetsManagerEx::onAssetVerified(std::string_view customId,
+                                      std::string_view storagePath,
+                                      bool compressed,
+                                      bool ok)
+{
+    if (ok)
+    {
+        if (compressed)
         {
-            bool compressed = assetIt != assets.end() ? assetIt->second.compressed : false;
-            if (compressed)
+            decompressDownloadedZip(customId, storagePath);
+        }
+        else
+        {
+            fileSuccess(customId, storagePath);
+        }
+    }
+    else
+    {
+        fileError(customId, "Asset file verification failed after downloaded");
+    }
+}
+
+bool AssetsManagerEx::verifyAsset(std::string_view fullPath, const Manifest::Asset& asset)
+{
+    std::error_code ec;
+    stdfs::path path{fullPath};
+    auto size = static_cast<int64_t>(stdfs::file_size(path, ec));
+    if (ec)
+        return false;
+    auto mtime = static_cast<int64_t>(stdfs::last_write_time(path, ec).time_since_epoch().count());
+    if (ec)
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lck(_verifiedCacheMutex);
+        auto it = _verifiedCache.find(asset.path);
+        if (it != _verifiedCache.end() && it->second.size == size && it->second.mtime == mtime &&
+            it->second.md5 == asset.md5)
+            return true;
+    }
+
+    if (!_verifyCallback(fullPath, asset))
+        return false;
+
+    std::lock_guard<std::mutex> lck(_verifiedCacheMutex);
+    hlookup::set_item(_verifiedCache, asset.path, VerifiedRecord{asset.md5, size, mtime});
+    _verifiedCacheDirty = true;
+    return true;
+}
+
+void AssetsManagerEx::verifyLocalAssets(const std::function<void(std::vector<std::string> failedAssets)>& callback)
+{
+    struct VerifyItem
+    {
+        std::string key;
+        std::string fullPath;
+        Manifest::Asset asset;
+        bool ok;
+    };
+
+    auto items = std::make_shared<std::vector<VerifyItem>>();
+    if (_verifyCallback != nullptr && _localManifest && _localManifest->isLoaded())
+    {
+        auto& assets = _localManifest->getAssets();
+        items->reserve(assets.size());
+        for (auto& item : assets)
+        {
+            // Assets in the app package are never downloaded, only check files in the storage path
+            std::string fullPath = _storagePath + item.second.path;
+            if (_fileUtils->isFileExist(fullPath))
+                items->emplace_back(VerifyItem{item.first, std::move(fullPath), item.second, false});
+        }
+    }
+
+    if (items->empty())
+    {
+        if (callback)
+            callback(std::vector<std::string>{});
+        return;
+    }
+
+    if (!_parallelVerification)
+    {
+        std::vector<std::string> failedAssets;
+        for (auto& item : *items)
+        {
+            if (!verifyAsset(item.fullPath, item.asset))
+                failedAssets.emplace_back(std::move(item.key));
+        }
+        saveVerifiedCache();
+        if (callback)
+            callback(std::move(failedAssets));
+        return;
+    }
+
+    this->retain();
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [this, items, callback]() {
+        JobSystem::getInstance()->parallelFor(items->size(), 0, [this, items](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
             {
-                decompressDownloadedZip(customId, storagePath);
+                auto& item = (*items)[i];
+                item.ok    = verifyAsset(item.fullPath, item.asset);
             }
-            else
+        });
+        saveVerifiedCache();
+
+        Director::getInstance()->getScheduler()->runOnAxmolThread([this, items, callback]() {
+            std::vector<std::string> failedAssets;
+            for (auto& item : *items)
             {
-                fileSuccess(customId, storagePath);
+                if (!item.ok)
+                    failedAssets.emplace_back(std::move(item.key));
             }
-        }
-        else
+            if (callback)
+                callback(std::move(failedAssets));
+            this->release();
+        });
+    });
+}
+
+void AssetsManagerEx::loadVerifiedCache()
+{
+    std::string content = _fileUtils->getStringFromFile(_verifiedCachePath);
+
+    // One record per line: path\tsize\tmtime\tmd5
+    std::lock_guard<std::mutex> lck(_verifiedCacheMutex);
+    _verifiedCache.clear();
+    size_t lineStart = 0;
+    while (lineStart < content.size())
+    {
+        size_t lineEnd = content.find('\n', lineStart);
+        if (lineEnd == std::string::npos)
+            lineEnd = content.size();
+
+        std::string_view line{content.data() + lineStart, lineEnd - lineStart};
+        lineStart = lineEnd + 1;
+
+        auto sep1 = line.find('\t');
+        auto sep2 = line.find('\t', sep1 + 1);
+        auto sep3 = line.find('\t', sep2 + 1);
+        if (sep1 == std::string_view::npos || sep2 == std::string_view::npos || sep3 == std::string_view::npos)
+            continue;
+
+        VerifiedRecord record;
+        record.size  = strtoll(std::string{line.substr(sep1 + 1, sep2 - sep1 - 1)}.c_str(), nullptr, 10);
+        record.mtime = strtoll(std::string{line.substr(sep2 + 1, sep3 - sep2 - 1)}.c_str(), nullptr, 10);
+        record.md5   = line.substr(sep3 + 1);
+        _verifiedCache.emplace(line.substr(0, sep1), std::move(record));
+    }
+    _verifiedCacheDirty = false;
+}
+
+void AssetsManagerEx::saveVerifiedCache()
+{
+    std::string content;
+    {
+        std::lock_guard<std::mutex> lck(_verifiedCacheMutex);
+        if (!_verifiedCacheDirty)
+            return;
+        content.reserve(_verifiedCache.size() * 64);
+        for (auto& item : _verifiedCache)
         {
-            fileError(customId, "Asset file verification failed after downloaded");
+            content += item.first;
+            content += fmt::format("\t{}\t{}\t", item.second.size, item.second.mtime);
+            content += item.second.md5;
+            content += '\n';
         }
+        _verifiedCacheDirty = false;
     }
+    _fileUtils->writeStringToFile(content, _verifiedCachePath);
 }
 
 void AssetsManagerEx::destroyDownloadedVersion()
@@ -29,6 +29,7 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include <mutex>
 
 #include "base/EventDispatcher.h"
 #include "platform/FileUtils.h"
@@ -128,12 +129,29 @@ public:
     /** @brief Set the verification function for checking whether downloaded asset is correct, e.g. using md5
      * verification
      * @param callback  The verify callback function
+     * @note The callback is invoked in the main thread unless parallel verification is enabled.
      */
     void setVerifyCallback(const std::function<bool(std::string_view path, Manifest::Asset asset)>& callback)
     {
         _verifyCallback = callback;
     };
 
+    /** @brief Verify assets on the job system workers instead of the main thread, disabled by default.
+     * @warning When enabled the verify callback is invoked from worker threads, several assets are verified
+     *          at the same time, so it must be thread safe.
+     */
+    void setParallelVerification(bool enabled) { _parallelVerification = enabled; }
+
+    bool isParallelVerification() const { return _parallelVerification; }
+
+    /** @brief Verify all local assets which are stored in the storage path, across all cores when parallel
+     * verification is enabled.
+     * Files whose size and modification time didn't change since their last successful verification
+     * are not verified again, see the verified cache saved in the storage path.
+     * @param callback  Called in the main thread with the keys of the assets which failed verification
+     */
+    void verifyLocalAssets(const std::function<void(std::vector<std::string> failedAssets)>& callback);
+
     AssetsManagerEx(std::string_view manifestUrl, std::string_view storagePath);
 
     virtual ~AssetsManagerEx();
@@ -191,6 +209,22 @@ protected:
 
     void fileSuccess(std::string_view customId, std::string_view storagePath);
 
+    /** @brief Verify a downloaded asset in the main thread, or on a worker thread when parallel verification
+     * is enabled, then continue in the main thread
+     */
+    void verifyDownloadedAsset(std::string_view customId, std::string_view storagePath, const Manifest::Asset& asset);
+
+    void onAssetVerified(std::string_view customId, std::string_view storagePath, bool compressed, bool ok);
+
+    /** @brief Run the verify callback, skipping files already verified with the same size and mtime
+     * @note Thread safe
+     */
+    bool verifyAsset(std::string_view fullPath, const Manifest::Asset& asset);
+
+    void loadVerifiedCache();
+
+    void saveVerifiedCache();
+
     /** @brief  Call back function for error handling,
      the error will then be reported to user's listener registed in addUpdateEventListener
      @param error   The error object contains ErrorCode, message, asset url, asset key
@@ -261,6 +295,9 @@ private:
     //! The local path of cached manifest file
     std::string _cacheManifestPath;
 
+    //! The local path of the verified assets cache
+    std::string _verifiedCachePath;
+
     //! The local path of cached temporary manifest file
     std::string _tempManifestPath;
 
@@ -332,8 +369,22 @@ private:
     //! Callback function to verify the downloaded assets
     std::function<bool(std::string_view path, Manifest::Asset asset)> _verifyCallback = nullptr;
 
+    //! Whether the verify callback may run on worker threads
+    bool _parallelVerification = false;
+
     //! Marker for whether the assets manager is inited
     bool _inited = false;
+
+    //! The file states recorded by the last successful verification of each asset path
+    struct VerifiedRecord
+    {
+        std::string md5;
+        int64_t size;
+        int64_t mtime;
+    };
+    hlookup::string_map<VerifiedRecord> _verifiedCache;
+    std::mutex _verifiedCacheMutex;
+    bool _verifiedCacheDirty = false;
 };
 
 NS_AX_EXT_END
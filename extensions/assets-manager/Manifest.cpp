@@ -27,8 +27,10 @@
 #include "rapidjson/prettywriter.h"
 #include "rapidjson/stringbuffer.h"
 
+#include <algorithm>
 #include <fstream>
 #include <stdio.h>
+#include <string.h>
 
 #define KEY_VERSION "version"
 #define KEY_PACKAGE_URL "packageUrl"
@@ -48,8 +50,86 @@
 #define KEY_COMPRESSED_FILE "compressedFile"
 #define KEY_DOWNLOAD_STATE "downloadState"
 
+// Compact binary manifest, all integers are little endian
+#define BINARY_MANIFEST_MAGIC "AXMF"
+#define BINARY_MANIFEST_VERSION 1
+
 NS_AX_EXT_BEGIN
 
+namespace
+{
+class BinaryManifestWriter
+{
+public:
+    template <typename _Ty>
+    void write(_Ty value)
+    {
+        writeBytes(&value, sizeof(value));
+    }
+    void writeString(std::string_view str)
+    {
+        write<uint32_t>(static_cast<uint32_t>(str.size()));
+        writeBytes(str.data(), str.size());
+    }
+    void writeBytes(const void* data, size_t size) { _buffer.append(static_cast<const char*>(data), size); }
+    const std::string& buffer() const { return _buffer; }
+
+private:
+    std::string _buffer;
+};
+
+class BinaryManifestReader
+{
+public:
+    explicit BinaryManifestReader(std::string_view content) : _content(content) {}
+
+    template <typename _Ty>
+    _Ty read()
+    {
+        _Ty value{};
+        if (ensure(sizeof(value)))
+        {
+            memcpy(&value, _content.data() + _offset, sizeof(value));
+            _offset += sizeof(value);
+        }
+        return value;
+    }
+    std::string_view readString()
+    {
+        auto size = read<uint32_t>();
+        if (!ensure(size))
+            return std::string_view{};
+        std::string_view str = _content.substr(_offset, size);
+        _offset += size;
+        return str;
+    }
+    void skip(size_t size)
+    {
+        if (ensure(size))
+            _offset += size;
+    }
+    bool good() const { return _good; }
+
+private:
+    bool ensure(size_t size)
+    {
+        if (_good && _content.size() - _offset < size)
+            _good = false;
+        return _good;
+    }
+
+    std::string_view _content;
+    size_t _offset = 0;
+    bool _good     = true;
+};
+
+bool isBinaryContent(std::string_view content)
+{
+    return content.size() >= sizeof(BINARY_MANIFEST_MAGIC) - 1 &&
+           memcmp(content.data(), BINARY_MANIFEST_MAGIC, sizeof(BINARY_MANIFEST_MAGIC) - 1) == 0;
+}
+}  // namespace
+
 static int cmpVersion(std::string_view v1, std::string_view v2)
 {
     int i;
@@ -94,32 +174,48 @@ void Manifest::loadJson(std::string_view url)
     {
         // Load file content
         content = _fileUtils->getStringFromFile(url);
+    }
+    parseJson(url, content);
+}
 
-        if (content.empty())
-        {
+void Manifest::parseJson(std::string_view url, std::string_view content)
+{
+    _binary = false;
+    if (content.empty())
+    {
+        if (_fileUtils->isFileExist(url))
             AXLOG("Fail to retrieve local file content: %s\n", url.data());
-        }
-        else
-        {
-            // Parse file with rapid json
-            _json.Parse<0>(content.c_str());
-            // Print error
-            if (_json.HasParseError())
-            {
-                size_t offset = _json.GetErrorOffset();
-                if (offset > 0)
-                    offset--;
-                std::string errorSnippet = content.substr(offset, 10);
-                AXLOG("File parse error %d at <%s>\n", _json.GetParseError(), errorSnippet.c_str());
-            }
-        }
+        _json.SetNull();
+        return;
+    }
+
+    // Parse file with rapid json
+    _json.Parse<0>(content.data(), content.size());
+    // Print error
+    if (_json.HasParseError())
+    {
+        size_t offset = _json.GetErrorOffset();
+        if (offset > 0)
+            offset--;
+        std::string errorSnippet{content.substr(offset, 10)};
+        AXLOG("File parse error %d at <%s>\n", _json.GetParseError(), errorSnippet.c_str());
     }
 }
 
 void Manifest::parseVersion(std::string_view versionUrl)
 {
-    loadJson(versionUrl);
+    clear();
+    std::string content;
+    if (_fileUtils->isFileExist(versionUrl))
+        content = _fileUtils->getStringFromFile(versionUrl);
 
+    if (isBinaryContent(content))
+    {
+        loadBinary(content, true);
+        return;
+    }
+
+    parseJson(versionUrl, content);
     if (_json.IsObject())
     {
         loadVersion(_json);
@@ -128,18 +224,30 @@ void Manifest::parseVersion(std::string_view versionUrl)
 
 void Manifest::parse(std::string_view manifestUrl)
 {
-    loadJson(manifestUrl);
+    clear();
+    std::string content;
+    if (_fileUtils->isFileExist(manifestUrl))
+        content = _fileUtils->getStringFromFile(manifestUrl);
 
-    if (!_json.HasParseError() && _json.IsObject())
+    if (isBinaryContent(content))
     {
-        // Register the local manifest root
-        size_t found = manifestUrl.find_last_of("/\\");
-        if (found != std::string::npos)
-        {
-            _manifestRoot = manifestUrl.substr(0, found + 1);
-        }
+        if (!loadBinary(content, false))
+            return;
+    }
+    else
+    {
+        parseJson(manifestUrl, content);
+        if (_json.HasParseError() || !_json.IsObject())
+            return;
         loadManifest(_json);
     }
+
+    // Register the local manifest root
+    size_t found = manifestUrl.find_last_of("/\\");
+    if (found != std::string::npos)
+    {
+        _manifestRoot = manifestUrl.substr(0, found + 1);
+    }
 }
 
 bool Manifest::isVersionLoaded() const
@@ -203,57 +311,69 @@ bool Manifest::versionGreater(
 hlookup::string_map<Manifest::AssetDiff> Manifest::genDiff(const Manifest* b) const
 {
     hlookup::string_map<AssetDiff> diff_map;
-    auto& bAssets = b->getAssets();
-
-    std::string key;
-    Asset valueA;
-    Asset valueB;
+    visitDiff(b, [&diff_map](std::string_view key, const AssetDiff& diff) { diff_map.emplace(key, diff); });
+    return diff_map;
+}
 
-    hlookup::string_map<Asset>::const_iterator valueIt, it;
-    for (it = _assets.begin(); it != _assets.end(); ++it)
-    {
-        key    = it->first;
-        valueA = it->second;
+size_t Manifest::visitDiff(const Manifest* b,
+                           const std::function<void(std::string_view key, const AssetDiff& diff)>& visitor) const
+{
+    auto& bAssets = b->_assets;
+    auto& bKeys   = b->_sortedKeys;
+
+    const size_t countA = _sortedKeys.size();
+    const size_t countB = bKeys.size();
+    size_t i = 0, j = 0, visited = 0;
+
+    AssetDiff diff;
+    // Both key lists are sorted, merge them in one pass
+    while (i < countA || j < countB)
+    {
+        int order;
+        if (i == countA)
+            order = 1;
+        else if (j == countB)
+            order = -1;
+        else
+            order = _sortedKeys[i].compare(bKeys[j]);
 
-        // Deleted
-        valueIt = bAssets.find(key);
-        if (valueIt == bAssets.cend())
+        if (order < 0)
         {
-            AssetDiff diff;
-            diff.asset = valueA;
+            // Deleted
+            auto& key  = _sortedKeys[i++];
+            diff.asset = _assets.at(key);
             diff.type  = DiffType::DELETED;
-            diff_map.emplace(key, diff);
-            continue;
+            visitor(key, diff);
+            ++visited;
         }
-
-        // Modified
-        valueB = valueIt->second;
-        if (valueA.md5 != valueB.md5)
+        else if (order > 0)
         {
-            AssetDiff diff;
-            diff.asset = valueB;
-            diff.type  = DiffType::MODIFIED;
-            diff_map.emplace(key, diff);
+            // Added
+            auto& key  = bKeys[j++];
+            diff.asset = bAssets.at(key);
+            diff.type  = DiffType::ADDED;
+            visitor(key, diff);
+            ++visited;
         }
-    }
-
-    for (it = bAssets.begin(); it != bAssets.end(); ++it)
-    {
-        key    = it->first;
-        valueB = it->second;
-
-        // Added
-        valueIt = _assets.find(key);
-        if (valueIt == _assets.cend())
+        else
         {
-            AssetDiff diff;
-            diff.asset = valueB;
-            diff.type  = DiffType::ADDED;
-            diff_map.emplace(key, diff);
+            // Modified
+            auto& key   = bKeys[j];
+            auto& valueA = _assets.at(_sortedKeys[i]);
+            auto& valueB = bAssets.at(key);
+            ++i;
+            ++j;
+            if (valueA.md5 != valueB.md5)
+            {
+                diff.asset = valueB;
+                diff.type  = DiffType::MODIFIED;
+                visitor(key, diff);
+                ++visited;
+            }
         }
     }
 
-    return diff_map;
+    return visited;
 }
 
 void Manifest::genResumeAssetsList(DownloadUnits* units) const
@@ -408,6 +528,7 @@ void Manifest::clear()
     if (_loaded)
     {
         _assets.clear();
+        _sortedKeys.clear();
         _searchPaths.clear();
         _loaded = false;
     }
@@ -533,6 +654,7 @@ void Manifest::loadManifest(const rapidjson::Document& json)
             }
         }
     }
+    buildSortedIndex();
 
     // Retrieve all search paths
     if (json.HasMember(KEY_SEARCH_PATHS))
@@ -555,6 +677,12 @@ void Manifest::loadManifest(const rapidjson::Document& json)
 
 void Manifest::saveToFile(std::string_view filepath)
 {
+    if (_binary)
+    {
+        saveToBinaryFile(filepath);
+        return;
+    }
+
     rapidjson::StringBuffer buffer;
     rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
     _json.Accept(writer);
@@ -562,4 +690,139 @@ void Manifest::saveToFile(std::string_view filepath)
     FileUtils::getInstance()->writeStringToFile(buffer.GetString(), filepath);
 }
 
+void Manifest::buildSortedIndex()
+{
+    _sortedKeys.clear();
+    _sortedKeys.reserve(_assets.size());
+    for (auto& item : _assets)
+        _sortedKeys.emplace_back(item.first);
+    std::sort(_sortedKeys.begin(), _sortedKeys.end());
+}
+
+bool Manifest::saveToBinaryFile(std::string_view filepath) const
+{
+    BinaryManifestWriter writer;
+    writer.writeBytes(BINARY_MANIFEST_MAGIC, sizeof(BINARY_MANIFEST_MAGIC) - 1);
+    writer.write<uint32_t>(BINARY_MANIFEST_VERSION);
+
+    writer.writeString(_version);
+    writer.writeString(_packageUrl);
+    writer.writeString(_remoteManifestUrl);
+    writer.writeString(_remoteVersionUrl);
+    writer.writeString(_engineVer);
+
+    writer.write<uint32_t>(static_cast<uint32_t>(_groups.size()));
+    for (auto& group : _groups)
+    {
+        writer.writeString(group);
+        writer.writeString(_groupVer.at(group));
+    }
+
+    writer.write<uint32_t>(static_cast<uint32_t>(_searchPaths.size()));
+    for (auto& path : _searchPaths)
+        writer.writeString(path);
+
+    // Assets are stored in key order, the path is omitted when it equals the key
+    writer.write<uint32_t>(static_cast<uint32_t>(_sortedKeys.size()));
+    for (auto& key : _sortedKeys)
+    {
+        auto& asset = _assets.at(key);
+        writer.writeString(key);
+        writer.writeString(asset.path == key ? hlookup::empty_sv : std::string_view{asset.path});
+        writer.writeString(asset.md5);
+        writer.write<float>(asset.size);
+        writer.write<uint8_t>(asset.compressed ? 1 : 0);
+        writer.write<int8_t>(static_cast<int8_t>(asset.downloadState));
+    }
+
+    return FileUtils::getInstance()->writeStringToFile(writer.buffer(), filepath);
+}
+
+bool Manifest::loadBinary(std::string_view content, bool versionOnly)
+{
+    _binary = true;
+    _json.SetNull();
+
+    BinaryManifestReader reader(content);
+    reader.skip(sizeof(BINARY_MANIFEST_MAGIC) - 1);
+    if (reader.read<uint32_t>() != BINARY_MANIFEST_VERSION)
+    {
+        AXLOG("Unsupported binary manifest version\n");
+        return false;
+    }
+
+    _version           = reader.readString();
+    _packageUrl        = reader.readString();
+    _remoteManifestUrl = reader.readString();
+    _remoteVersionUrl  = reader.readString();
+    _engineVer         = reader.readString();
+
+    auto count = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < count && reader.good(); ++i)
+    {
+        std::string group{reader.readString()};
+        std::string_view version = reader.readString();
+        _groupVer.emplace(group, version);
+        _groups.emplace_back(std::move(group));
+    }
+    _versionLoaded = true;
+    if (!reader.good())
+    {
+        AXLOG("Binary manifest is truncated\n");
+        clear();
+        return false;
+    }
+    if (versionOnly)
+        return true;
+
+    count = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < count && reader.good(); ++i)
+        _searchPaths.emplace_back(reader.readString());
+
+    count = reader.read<uint32_t>();
+    _assets.reserve(count);
+    _sortedKeys.reserve(count);
+    bool sorted = true;
+    for (uint32_t i = 0; i < count && reader.good(); ++i)
+    {
+        std::string_view key  = reader.readString();
+        std::string_view path = reader.readString();
+
+        Asset asset;
+        asset.path          = path.empty() ? key : path;
+        asset.md5           = reader.readString();
+        asset.size          = reader.read<float>();
+        asset.compressed    = reader.read<uint8_t>() != 0;
+        asset.downloadState = reader.read<int8_t>();
+
+        if (!_sortedKeys.empty() && _sortedKeys.back() >= key)
+            sorted = false;
+        _sortedKeys.emplace_back(key);
+        _assets.emplace(key, std::move(asset));
+    }
+    if (!reader.good())
+    {
+        AXLOG("Binary manifest is truncated\n");
+        _loaded = true;  // make clear() drop the partial assets
+        clear();
+        return false;
+    }
+
+    // Produced by another tool, don't trust the order
+    if (!sorted)
+        buildSortedIndex();
+
+    _loaded = true;
+    return true;
+}
+
+bool Manifest::convertToBinary(std::string_view jsonManifestUrl, std::string_view binaryPath)
+{
+    Manifest manifest;
+    manifest.parse(jsonManifestUrl);
+    if (!manifest.isLoaded())
+        return false;
+    return manifest.saveToBinaryFile(binaryPath);
+}
+
 NS_AX_EXT_END
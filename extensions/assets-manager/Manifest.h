@@ -117,6 +117,18 @@ public:
      */
     std::vector<std::string> getSearchPaths() const;
 
+    /** @brief Whether the manifest was loaded from the compact binary format.
+     */
+    bool isBinary() const { return _binary; }
+
+    /** @brief Offline converter, parse a json manifest and save it in the compact binary format.
+     * The binary format stores assets sorted by key, so loading and diffing don't need to hash or sort.
+     * @param jsonManifestUrl   Url of the json manifest
+     * @param binaryPath        Full path of the binary manifest to write
+     * @return Whether the conversion succeeded
+     */
+    static bool convertToBinary(std::string_view jsonManifestUrl, std::string_view binaryPath);
+
 protected:
     /** @brief Constructor for Manifest class
      * @param manifestUrl Url of the local manifest
@@ -157,6 +169,15 @@ protected:
      */
     hlookup::string_map<AssetDiff> genDiff(const Manifest* b) const;
 
+    /** @brief Stream the difference between this Manifest and another, without building a diff map.
+     * Both sorted asset indexes are merged in a single pass, the visitor is called in key order.
+     * @param b         The other manifest
+     * @param visitor   Called for each added, deleted or modified asset
+     * @return The number of differences visited
+     */
+    size_t visitDiff(const Manifest* b,
+                     const std::function<void(std::string_view key, const AssetDiff& diff)>& visitor) const;
+
     /** @brief Generate resuming download assets list
      * @param units   The download units reference to be modified by the generation result
      */
@@ -172,6 +193,24 @@ protected:
 
     void saveToFile(std::string_view filepath);
 
+    /** @brief Save the manifest in the compact binary format.
+     */
+    bool saveToBinaryFile(std::string_view filepath) const;
+
+    /** @brief Load a manifest from compact binary content.
+     * @param content       The binary content, must start with the binary manifest magic
+     * @param versionOnly   Only load the version informations
+     */
+    bool loadBinary(std::string_view content, bool versionOnly);
+
+    /** @brief Parse json content into the local json object.
+     */
+    void parseJson(std::string_view url, std::string_view content);
+
+    /** @brief Rebuild the sorted asset key index.
+     */
+    void buildSortedIndex();
+
     Asset parseAsset(std::string_view path, const rapidjson::Value& json);
 
     void clear();
@@ -243,6 +282,12 @@ private:
     //! All search paths
     std::vector<std::string> _searchPaths;
 
+    //! Asset keys in ascending order, used for the streaming diff
+    std::vector<std::string> _sortedKeys;
+
+    //! Indicate whether the manifest was loaded from the compact binary format
+    bool _binary = false;
+
     rapidjson::Document _json;
 };
 
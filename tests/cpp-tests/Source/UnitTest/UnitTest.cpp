@@ -28,6 +28,15 @@
 #include "network/Uri.h"
 #include "base/Utils.h"
 #include "yasio/byte_buffer.hpp"
+#include "assets-manager/Manifest.h"
+#include "renderer/backend/PixelFormatUtils.h"
+#include "base/format.h"
+#include "base/etc2.h"
+#include "2d/BinarySpriteSheetLoader.h"
+
+#include <chrono>
+#include <random>
+#include <thread>
 
 USING_NS_AX;
 using namespace ax::network;
@@ -79,6 +88,22 @@ UnitTests::UnitTests()
     ADD_TEST_CASE(ParseIntegerListTest);
     ADD_TEST_CASE(ParseUriTest);
     ADD_TEST_CASE(ResizableBufferAdapterTest);
+    ADD_TEST_CASE(ManifestTest);
+    ADD_TEST_CASE(PixelFormatUtilsTest);
+    ADD_TEST_CASE(PixelFormatUtilsBenchmark);
+#if AX_ENABLE_OBJECT_POOL
+    ADD_TEST_CASE(ObjectAllocatorTest);
+    ADD_TEST_CASE(ObjectAllocatorBenchmark);
+#endif
+    ADD_TEST_CASE(NodeVisitBenchmark);
+#if AX_USE_ECS
+    ADD_TEST_CASE(EntityWorldTest);
+#endif
+    ADD_TEST_CASE(DispatchQueueTest);
+    ADD_TEST_CASE(DestructionQueueTest);
+    ADD_TEST_CASE(ETC2DecodeTest);
+    ADD_TEST_CASE(ParticleStepTest);
+    ADD_TEST_CASE(BinarySpriteSheetTest);
 #ifdef UNIT_TEST_FOR_OPTIMIZED_MATH_UTIL
     ADD_TEST_CASE(MathUtilTest);
 #endif
@@ -89,6 +114,42 @@ std::string UnitTestDemo::title() const
     return "UnitTest";
 }
 
+void UnitTestBenchmark::onExit()
+{
+    _report.clear();
+    _reportLabel = nullptr;
+    UnitTestDemo::onExit();
+}
+
+double UnitTestBenchmark::measure(std::string_view name,
+                                  int repeat,
+                                  const std::function<void()>& func,
+                                  size_t items,
+                                  std::string_view itemName)
+{
+    func();  // warm up the caches
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i)
+        func();
+    double ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeat;
+
+    auto line = fmt::format("{}: {:.3f} ms", name, ms);
+    if (items > 0)
+        line.append(fmt::format(", {:.2f} ns/{}", ms * 1e6 / items, itemName));
+    ax::log("%s", line.c_str());
+    _report.append(line).push_back('\n');
+    if (!_reportLabel)
+    {
+        _reportLabel = Label::createWithTTF("", "fonts/arial.ttf", 12);
+        _reportLabel->setPosition(VisibleRect::center());
+        addChild(_reportLabel);
+    }
+    _reportLabel->setString(_report);
+    return ms;
+}
+
 //---------------------------------------------------------------
 
 void TemplateVectorTest::onEnter()
@@ -1724,3 +1785,1409 @@ std::string ResizableBufferAdapterTest::subtitle() const
 {
     return "ResiziableBufferAdapter<yasio::byte_buffer> Test";
 }
+
+// ManifestTest
+
+namespace
+{
+// Exposes the protected loading and diffing interface of Manifest
+class TestManifest : public ax::extension::Manifest
+{
+public:
+    explicit TestManifest(std::string_view manifestUrl = "") : Manifest(manifestUrl) {}
+
+    using Manifest::getAssets;
+    using Manifest::loadBinary;
+    using Manifest::visitDiff;
+};
+}  // namespace
+
+void ManifestTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    using DiffType = ax::extension::Manifest::DiffType;
+
+    auto fileUtils         = FileUtils::getInstance();
+    std::string root       = fileUtils->getWritablePath() + "manifest_test/";
+    std::string oldJson    = root + "old.manifest";
+    std::string newJson    = root + "new.manifest";
+    std::string oldBinary  = root + "old.manifest.bin";
+    std::string newBinary  = root + "new.manifest.bin";
+    fileUtils->createDirectory(root);
+
+    fileUtils->writeStringToFile(R"({
+        "version": "1.0.0",
+        "packageUrl": "http://example.com/package",
+        "remoteManifestUrl": "http://example.com/project.manifest",
+        "remoteVersionUrl": "http://example.com/version.manifest",
+        "groupVersions": {"1": "1.0.1"},
+        "searchPaths": ["res/"],
+        "assets": {
+            "b.png": {"md5": "b0"},
+            "a.png": {"md5": "a0", "size": 16},
+            "pack.zip": {"md5": "z0", "compressed": true, "path": "archives/pack.zip"},
+            "gone.png": {"md5": "g0"}
+        }
+    })",
+                                 oldJson);
+    fileUtils->writeStringToFile(R"({
+        "version": "1.0.1",
+        "assets": {
+            "a.png": {"md5": "a0", "size": 16},
+            "b.png": {"md5": "b1"},
+            "c.png": {"md5": "c0"},
+            "pack.zip": {"md5": "z0", "compressed": true, "path": "archives/pack.zip"}
+        }
+    })",
+                                 newJson);
+
+    EXPECT_TRUE(ax::extension::Manifest::convertToBinary(oldJson, oldBinary));
+    EXPECT_TRUE(ax::extension::Manifest::convertToBinary(newJson, newBinary));
+
+    // The binary manifest round trips every field of the json one
+    TestManifest jsonManifest(oldJson);
+    TestManifest binaryManifest(oldBinary);
+    EXPECT_TRUE(jsonManifest.isLoaded());
+    EXPECT_FALSE(jsonManifest.isBinary());
+    EXPECT_TRUE(binaryManifest.isLoaded());
+    EXPECT_TRUE(binaryManifest.isBinary());
+    EXPECT_EQ(binaryManifest.getVersion(), jsonManifest.getVersion());
+    EXPECT_EQ(binaryManifest.getPackageUrl(), jsonManifest.getPackageUrl());
+    EXPECT_EQ(binaryManifest.getManifestFileUrl(), jsonManifest.getManifestFileUrl());
+    EXPECT_EQ(binaryManifest.getVersionFileUrl(), jsonManifest.getVersionFileUrl());
+    EXPECT_EQ(binaryManifest.getSearchPaths(), jsonManifest.getSearchPaths());
+    EXPECT_EQ(binaryManifest.getAssets().size(), jsonManifest.getAssets().size());
+    for (auto& item : jsonManifest.getAssets())
+    {
+        auto it = binaryManifest.getAssets().find(item.first);
+        EXPECT_TRUE(it != binaryManifest.getAssets().end());
+        EXPECT_EQ(it->second.md5, item.second.md5);
+        EXPECT_EQ(it->second.path, item.second.path);
+        EXPECT_EQ(it->second.size, item.second.size);
+        EXPECT_EQ(it->second.compressed, item.second.compressed);
+        EXPECT_EQ(it->second.downloadState, item.second.downloadState);
+    }
+
+    // Every truncation of the binary content is rejected and leaves no partial assets
+    std::string content = fileUtils->getStringFromFile(oldBinary);
+    for (size_t size = 4; size < content.size(); ++size)
+    {
+        TestManifest truncated;
+        EXPECT_FALSE(truncated.loadBinary(std::string_view{content.data(), size}, false));
+        EXPECT_FALSE(truncated.isLoaded());
+        EXPECT_TRUE(truncated.getAssets().empty());
+    }
+
+    // The streaming diff visits keys in order, for any combination of json and binary manifests
+    const std::pair<std::string_view, DiffType> expected[] = {
+        {"b.png", DiffType::MODIFIED}, {"c.png", DiffType::ADDED}, {"gone.png", DiffType::DELETED}};
+    for (auto& oldUrl : {oldJson, oldBinary})
+    {
+        for (auto& newUrl : {newJson, newBinary})
+        {
+            TestManifest oldManifest(oldUrl);
+            TestManifest newManifest(newUrl);
+
+            size_t index = 0;
+            size_t count = oldManifest.visitDiff(
+                &newManifest, [&](std::string_view key, const ax::extension::Manifest::AssetDiff& diff) {
+                    EXPECT_TRUE(index < std::size(expected));
+                    EXPECT_EQ(key, expected[index].first);
+                    EXPECT_EQ(diff.type, expected[index].second);
+                    // Added and modified assets come from the new manifest
+                    if (diff.type != DiffType::DELETED)
+                        EXPECT_EQ(diff.asset.md5, newManifest.getAssets().at(key).md5);
+                    ++index;
+                });
+            EXPECT_EQ(count, std::size(expected));
+            EXPECT_EQ(index, std::size(expected));
+
+            // No differences against itself
+            EXPECT_EQ(newManifest.visitDiff(&newManifest, [](std::string_view, const auto&) { EXPECT_TRUE(false); }),
+                      0);
+        }
+    }
+
+    fileUtils->removeDirectory(root);
+}
+
+std::string ManifestTest::subtitle() const
+{
+    return "Manifest binary format and streaming diff";
+}
+
+// PixelFormatUtilsTest
+
+namespace
+{
+using namespace ax::backend;
+
+// the per pixel formulas of the scalar code, the SIMD kernels must match them bit for bit
+uint16_t referenceRGB565(const uint8_t* p)
+{
+    return (p[0] & 0xF8) << 8 | (p[1] & 0xFC) << 3 | (p[2] & 0xF8) >> 3;
+}
+
+uint16_t referenceRGBA4(const uint8_t* p)
+{
+    return (p[0] & 0xF0) << 8 | (p[1] & 0xF0) << 4 | (p[2] & 0xF0) | (p[3] & 0xF0) >> 4;
+}
+
+uint16_t referenceRGB5A1(const uint8_t* p)
+{
+    return (p[0] & 0xF8) << 8 | (p[1] & 0xF8) << 3 | (p[2] & 0xF8) >> 2 | (p[3] & 0x80) >> 7;
+}
+
+uint8_t referencePremultiply(uint8_t c, uint8_t a)
+{
+    return c * (a + 1) >> 8;
+}
+
+uint8_t referenceReversePremultiply(uint8_t c, uint8_t a)
+{
+    if (a == 0)
+        return c;
+    int value = int(std::ceil((c * 255.0f) / a));
+    return value < 255 ? value : 255;
+}
+
+std::vector<uint8_t> randomPixels(size_t pixels, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> data(pixels * 4);
+    for (auto& byte : data)
+        byte = static_cast<uint8_t>(rng());
+    return data;
+}
+
+constexpr uint8_t GUARD_BYTE = 0xCD;
+constexpr size_t GUARD_SIZE  = 16;
+
+// converts RGBA8 to a 16 bit format, checks every pixel and that nothing is written past the output
+void check16BitConversion(size_t pixels,
+                          void (*convert)(const unsigned char*, size_t, unsigned char*),
+                          uint16_t (*reference)(const uint8_t*))
+{
+    auto input = randomPixels(pixels, static_cast<uint32_t>(pixels));
+    std::vector<uint8_t> output(pixels * 2 + GUARD_SIZE, GUARD_BYTE);
+    convert(input.data(), input.size(), output.data());
+    for (size_t i = 0; i < pixels; ++i)
+    {
+        uint16_t value;
+        memcpy(&value, output.data() + i * 2, sizeof(value));
+        EXPECT_EQ(value, reference(input.data() + i * 4));
+    }
+    for (size_t i = pixels * 2; i < output.size(); ++i)
+        EXPECT_EQ(output[i], GUARD_BYTE);
+}
+
+void store16(uint8_t* out, uint16_t value)
+{
+    memcpy(out, &value, sizeof(value));
+}
+
+// converts between any two formats, compares each pixel with the reference and checks the guard bytes
+void checkConversion(size_t pixels,
+                     size_t inBytes,
+                     size_t outBytes,
+                     void (*convert)(const unsigned char*, size_t, unsigned char*),
+                     void (*reference)(const uint8_t* in, uint8_t* out))
+{
+    auto input = randomPixels(pixels, static_cast<uint32_t>(pixels) + 2);
+    input.resize(pixels * inBytes);
+    std::vector<uint8_t> output(pixels * outBytes + GUARD_SIZE, GUARD_BYTE);
+    convert(input.data(), input.size(), output.data());
+    for (size_t i = 0; i < pixels; ++i)
+    {
+        uint8_t expected[4];
+        reference(input.data() + i * inBytes, expected);
+        for (size_t b = 0; b < outBytes; ++b)
+            EXPECT_EQ(output[i * outBytes + b], expected[b]);
+    }
+    for (size_t i = pixels * outBytes; i < output.size(); ++i)
+        EXPECT_EQ(output[i], GUARD_BYTE);
+}
+
+uint8_t referenceLuminance(const uint8_t* p)
+{
+    return (p[0] * 299 + p[1] * 587 + p[2] * 114 + 500) / 1000;
+}
+}  // namespace
+
+void PixelFormatUtilsTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    // every length up to a few SIMD blocks, so each kernel hands over odd tails to the scalar code
+    std::vector<size_t> lengths;
+    for (size_t pixels = 0; pixels <= 67; ++pixels)
+        lengths.push_back(pixels);
+    lengths.push_back(1021);
+    lengths.push_back(4099);
+
+    for (auto pixels : lengths)
+    {
+        check16BitConversion(pixels, PixelFormatUtils::convertRGBA8ToRGB565, referenceRGB565);
+        check16BitConversion(pixels, PixelFormatUtils::convertRGBA8ToRGBA4, referenceRGBA4);
+        check16BitConversion(pixels, PixelFormatUtils::convertRGBA8ToRGB5A1, referenceRGB5A1);
+
+        auto input = randomPixels(pixels, static_cast<uint32_t>(pixels) + 1);
+        std::vector<uint8_t> output(pixels * 4 + GUARD_SIZE, GUARD_BYTE);
+        PixelFormatUtils::convertBGRA8ToRGBA8(input.data(), input.size(), output.data());
+        for (size_t i = 0; i < pixels * 4; i += 4)
+        {
+            EXPECT_EQ(output[i + 0], input[i + 2]);
+            EXPECT_EQ(output[i + 1], input[i + 1]);
+            EXPECT_EQ(output[i + 2], input[i + 0]);
+            EXPECT_EQ(output[i + 3], input[i + 3]);
+        }
+        for (size_t i = pixels * 4; i < output.size(); ++i)
+            EXPECT_EQ(output[i], GUARD_BYTE);
+
+        // LA8, the luminance is copied to every color channel
+        checkConversion(pixels, 2, 4, PixelFormatUtils::convertLA8ToRGBA8, [](const uint8_t* in, uint8_t* out) {
+            out[0] = out[1] = out[2] = in[0];
+            out[3]                   = in[1];
+        });
+        checkConversion(pixels, 2, 3, PixelFormatUtils::convertLA8ToRGB8,
+                        [](const uint8_t* in, uint8_t* out) { out[0] = out[1] = out[2] = in[0]; });
+        checkConversion(pixels, 2, 2, PixelFormatUtils::convertLA8ToRGB565, [](const uint8_t* in, uint8_t* out) {
+            const uint8_t p[4] = {in[0], in[0], in[0], in[1]};
+            store16(out, referenceRGB565(p));
+        });
+        checkConversion(pixels, 2, 2, PixelFormatUtils::convertLA8ToRGBA4, [](const uint8_t* in, uint8_t* out) {
+            const uint8_t p[4] = {in[0], in[0], in[0], in[1]};
+            store16(out, referenceRGBA4(p));
+        });
+        checkConversion(pixels, 2, 2, PixelFormatUtils::convertLA8ToRGB5A1, [](const uint8_t* in, uint8_t* out) {
+            const uint8_t p[4] = {in[0], in[0], in[0], in[1]};
+            store16(out, referenceRGB5A1(p));
+        });
+        checkConversion(pixels, 2, 1, PixelFormatUtils::convertLA8ToA8,
+                        [](const uint8_t* in, uint8_t* out) { out[0] = in[1]; });
+        checkConversion(pixels, 2, 1, PixelFormatUtils::convertLA8ToL8,
+                        [](const uint8_t* in, uint8_t* out) { out[0] = in[0]; });
+        checkConversion(pixels, 1, 2, PixelFormatUtils::convertL8ToLA8, [](const uint8_t* in, uint8_t* out) {
+            out[0] = in[0];
+            out[1] = 0xFF;
+        });
+        checkConversion(pixels, 4, 2, PixelFormatUtils::convertRGBA8ToLA8, [](const uint8_t* in, uint8_t* out) {
+            out[0] = referenceLuminance(in);
+            out[1] = in[3];
+        });
+        checkConversion(pixels, 3, 2, PixelFormatUtils::convertRGB8ToLA8, [](const uint8_t* in, uint8_t* out) {
+            out[0] = referenceLuminance(in);
+            out[1] = 0xFF;
+        });
+    }
+
+    // every (color, alpha) pair, shifted by 0 - 3 pixels so each pair also lands in the scalar tail
+    const size_t pairs = 256 * 256;
+    for (size_t shift = 0; shift < 4; ++shift)
+    {
+        std::vector<uint8_t> pixels((pairs + shift) * 4 + GUARD_SIZE, GUARD_BYTE);
+        for (size_t i = 0; i < pairs; ++i)
+        {
+            auto p = pixels.data() + (shift + i) * 4;
+            p[0]   = static_cast<uint8_t>(i);
+            p[1]   = static_cast<uint8_t>(255 - (i & 0xFF));
+            p[2]   = static_cast<uint8_t>((i & 0xFF) ^ 0x5A);
+            p[3]   = static_cast<uint8_t>(i >> 8);
+        }
+        for (size_t i = 0; i < shift * 4; ++i)
+            pixels[i] = static_cast<uint8_t>(i * 37);
+
+        auto premultiplied = pixels;
+        PixelFormatUtils::premultiplyAlphaRGBA8(premultiplied.data(), (pairs + shift) * 4);
+        auto reversed = pixels;
+        PixelFormatUtils::reversePremultipliedAlphaRGBA8(reversed.data(), (pairs + shift) * 4);
+
+        for (size_t i = 0; i < pairs + shift; ++i)
+        {
+            auto p = pixels.data() + i * 4;
+            for (int c = 0; c < 3; ++c)
+            {
+                EXPECT_EQ(premultiplied[i * 4 + c], referencePremultiply(p[c], p[3]));
+                EXPECT_EQ(reversed[i * 4 + c], referenceReversePremultiply(p[c], p[3]));
+            }
+            EXPECT_EQ(premultiplied[i * 4 + 3], p[3]);
+            EXPECT_EQ(reversed[i * 4 + 3], p[3]);
+        }
+        for (size_t i = (pairs + shift) * 4; i < pixels.size(); ++i)
+        {
+            EXPECT_EQ(premultiplied[i], GUARD_BYTE);
+            EXPECT_EQ(reversed[i], GUARD_BYTE);
+        }
+    }
+}
+
+std::string PixelFormatUtilsTest::subtitle() const
+{
+    return "PixelFormatUtils SIMD kernels match the scalar code";
+}
+
+// PixelFormatUtilsBenchmark
+
+void PixelFormatUtilsBenchmark::onEnter()
+{
+    UnitTestBenchmark::onEnter();
+
+    const size_t pixels = 2048 * 2048;
+    const auto source   = randomPixels(pixels, 2048);
+    std::vector<uint8_t> output(pixels * 4);
+    std::vector<uint8_t> work(pixels * 4);
+    const int repeat = 10;
+
+    measure("RGBA8 -> RGB565", repeat,
+            [&] { PixelFormatUtils::convertRGBA8ToRGB565(source.data(), source.size(), output.data()); });
+    measure("RGBA8 -> RGB565 scalar", repeat, [&] {
+        auto out16 = reinterpret_cast<uint16_t*>(output.data());
+        for (size_t i = 0; i < pixels; ++i)
+            out16[i] = referenceRGB565(source.data() + i * 4);
+    });
+    measure("RGBA8 -> RGBA4", repeat,
+            [&] { PixelFormatUtils::convertRGBA8ToRGBA4(source.data(), source.size(), output.data()); });
+    measure("RGBA8 -> RGB5A1", repeat,
+            [&] { PixelFormatUtils::convertRGBA8ToRGB5A1(source.data(), source.size(), output.data()); });
+    measure("BGRA8 -> RGBA8", repeat,
+            [&] { PixelFormatUtils::convertBGRA8ToRGBA8(source.data(), source.size(), output.data()); });
+
+    // the in place routines start from a fresh copy each run
+    measure("premultiply alpha", repeat, [&] {
+        memcpy(work.data(), source.data(), source.size());
+        PixelFormatUtils::premultiplyAlphaRGBA8(work.data(), work.size());
+    });
+    measure("premultiply alpha scalar", repeat, [&] {
+        memcpy(work.data(), source.data(), source.size());
+        for (size_t i = 0; i < work.size(); i += 4)
+        {
+            auto p = work.data() + i;
+            p[0]   = referencePremultiply(p[0], p[3]);
+            p[1]   = referencePremultiply(p[1], p[3]);
+            p[2]   = referencePremultiply(p[2], p[3]);
+        }
+    });
+    measure("reverse premultiplied alpha", repeat, [&] {
+        memcpy(work.data(), source.data(), source.size());
+        PixelFormatUtils::reversePremultipliedAlphaRGBA8(work.data(), work.size());
+    });
+    measure("copy only", repeat, [&] { memcpy(work.data(), source.data(), source.size()); });
+}
+
+std::string PixelFormatUtilsBenchmark::subtitle() const
+{
+    return "PixelFormatUtils 2048x2048 conversions";
+}
+
+// ObjectAllocatorTest
+
+namespace
+{
+class alignas(64) OverAlignedNode : public Node
+{
+public:
+    float simd[16];
+};
+
+class PooledNode : public Node
+{
+public:
+    float extra[4];
+};
+}  // namespace
+
+void ObjectAllocatorTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    // blocks are aligned to the granularity and usable up to their requested size
+    for (size_t size = 1; size <= ObjectAllocator::MAX_POOLED_SIZE + 64; size += 7)
+    {
+        auto p = static_cast<uint8_t*>(ObjectAllocator::allocate(size));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % ObjectAllocator::GRANULARITY, 0);
+        memset(p, 0xAB, size);
+        ObjectAllocator::deallocate(p, size);
+    }
+
+    // subclasses of pooled classes are pooled too
+    auto stats = ObjectAllocator::getStats(sizeof(PooledNode));
+    auto node  = new PooledNode();
+    EXPECT_EQ(ObjectAllocator::getStats(sizeof(PooledNode)).allocations, stats.allocations + 1);
+    node->release();
+    EXPECT_EQ(ObjectAllocator::getStats(sizeof(PooledNode)).liveObjects, stats.liveObjects);
+
+    // over aligned subclasses bypass the pool and keep their alignment
+    stats = ObjectAllocator::getStats();
+    for (int i = 0; i < 64; ++i)
+    {
+        auto aligned = new OverAlignedNode();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % alignof(OverAlignedNode), 0);
+        aligned->release();
+
+        auto nothrowAligned = new (std::nothrow) OverAlignedNode();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(nothrowAligned) % alignof(OverAlignedNode), 0);
+        nothrowAligned->release();
+    }
+    EXPECT_EQ(ObjectAllocator::getStats().allocations, stats.allocations);
+}
+
+std::string ObjectAllocatorTest::subtitle() const
+{
+    return "ObjectAllocator alignment and pooled subclasses";
+}
+
+// ObjectAllocatorBenchmark
+
+void ObjectAllocatorBenchmark::onEnter()
+{
+    UnitTestBenchmark::onEnter();
+
+    const int count  = 10000;
+    const int repeat = 20;
+    std::vector<void*> blocks(count);
+
+    // the pattern of a scene being built then released
+    measure("pool: 10000 node blocks", repeat, [&] {
+        for (auto& block : blocks)
+            block = ObjectAllocator::allocate(sizeof(Node));
+        for (auto block : blocks)
+            ObjectAllocator::deallocate(block, sizeof(Node));
+    });
+    measure("global: 10000 node blocks", repeat, [&] {
+        for (auto& block : blocks)
+            block = ::operator new(sizeof(Node));
+        for (auto block : blocks)
+            ::operator delete(block);
+    });
+
+    // mixed sizes freed in a shuffled order, like actions finishing at different times
+    std::vector<size_t> sizes(count);
+    std::vector<int> order(count);
+    std::mt19937 rng(46);
+    for (int i = 0; i < count; ++i)
+    {
+        sizes[i] = 32 + rng() % 480;
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+    measure("pool: 10000 mixed blocks, shuffled frees", repeat, [&] {
+        for (int i = 0; i < count; ++i)
+            blocks[i] = ObjectAllocator::allocate(sizes[i]);
+        for (auto i : order)
+            ObjectAllocator::deallocate(blocks[i], sizes[i]);
+    });
+    measure("global: 10000 mixed blocks, shuffled frees", repeat, [&] {
+        for (int i = 0; i < count; ++i)
+            blocks[i] = ::operator new(sizes[i]);
+        for (auto i : order)
+            ::operator delete(blocks[i]);
+    });
+
+    // whole objects, constructors and destructors included
+    std::vector<Node*> nodes(count);
+    measure("10000 Node new and release", repeat, [&] {
+        for (auto& node : nodes)
+            node = new Node();
+        for (auto node : nodes)
+            node->release();
+    });
+
+    ObjectAllocator::trim();
+}
+
+std::string ObjectAllocatorBenchmark::subtitle() const
+{
+    return "ObjectAllocator against the global allocator";
+}
+
+// NodeVisitBenchmark
+
+void NodeVisitBenchmark::onEnter()
+{
+    UnitTestBenchmark::onEnter();
+
+    const int branches = 400;
+    const int leaves   = 500;
+    const int repeat   = 10;
+
+    // a detached tree of plain nodes, draw() is empty so the timings are traversal and transforms only
+    auto root = Node::create();
+    std::vector<Node*> nodes;
+    nodes.reserve(branches * leaves);
+    for (int i = 0; i < branches; ++i)
+    {
+        auto branch = Node::create();
+        branch->setPosition(Vec2(i, i));
+        root->addChild(branch, i % 3 - 1);
+        for (int j = 0; j < leaves; ++j)
+        {
+            auto leaf = Node::create();
+            leaf->setPosition(Vec2(j, -j));
+            leaf->setRotation(j);
+            branch->addChild(leaf, j % 3 - 1);
+            nodes.push_back(leaf);
+        }
+    }
+
+    // every visited node, the root and the branches included
+    const size_t visited = 1 + branches + nodes.size();
+    auto renderer        = _director->getRenderer();
+    measure(fmt::format("visit {} nodes, clean", visited), repeat,
+            [&] { root->visit(renderer, Mat4::IDENTITY, 0); }, visited, "node");
+    measure(fmt::format("visit {} nodes, parent transform dirty", visited), repeat,
+            [&] { root->visit(renderer, Mat4::IDENTITY, Node::FLAGS_TRANSFORM_DIRTY); }, visited, "node");
+
+    float angle = 0.0f;
+    measure(
+        fmt::format("visit {} nodes, every leaf moved", visited), repeat,
+        [&] {
+            angle += 1.0f;
+            for (auto node : nodes)
+                node->setRotation(angle);
+            root->visit(renderer, Mat4::IDENTITY, 0);
+        },
+        visited, "node");
+
+    // moved nodes rebuild their cached inverse on the next query
+    measure(
+        fmt::format("{} parent to node transforms", nodes.size()), repeat,
+        [&] {
+            angle += 1.0f;
+            for (auto node : nodes)
+            {
+                node->setRotation(angle);
+                node->getParentToNodeTransform();
+            }
+        },
+        nodes.size(), "node");
+}
+
+std::string NodeVisitBenchmark::subtitle() const
+{
+    return "Node::visit over a 200000 node tree";
+}
+
+// EntityWorldTest
+
+#if AX_USE_ECS
+namespace
+{
+struct TestPosition
+{
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+struct TestHealth
+{
+    int value = 0;
+};
+}  // namespace
+
+void EntityWorldTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    // handles: a destroyed index is reused with a new generation, old handles stay dead
+    {
+        EntityWorld world;
+        EXPECT_FALSE(world.isAlive(Entity()));
+
+        auto first = world.createEntity();
+        EXPECT_TRUE(world.isAlive(first));
+        world.destroyEntity(first);
+        EXPECT_FALSE(world.isAlive(first));
+        EXPECT_EQ(world.getEntityCount(), 0);
+
+        auto second = world.createEntity(TestHealth{3});
+        EXPECT_EQ(second.index, first.index);
+        EXPECT_NE(second.generation, first.generation);
+        EXPECT_NE(second, first);
+        EXPECT_FALSE(world.isAlive(first));
+        EXPECT_TRUE(world.getComponent<TestHealth>(first) == nullptr);
+
+        // destroying a stale handle doesn't touch the entity reusing its index
+        world.destroyEntity(first);
+        EXPECT_TRUE(world.isAlive(second));
+        EXPECT_EQ(world.getComponent<TestHealth>(second)->value, 3);
+
+        world.clear();
+        EXPECT_FALSE(world.isAlive(second));
+        EXPECT_EQ(world.getEntityCount(), 0);
+    }
+
+    // components: data survives archetype moves and the swap removal of other rows
+    {
+        EntityWorld world;
+        Entity entities[4];
+        for (int i = 0; i < 4; ++i)
+            entities[i] = world.createEntity(TestPosition{float(i), float(-i)});
+
+        world.addComponent(entities[1], TestHealth{10});
+        EXPECT_TRUE(world.hasComponent<TestHealth>(entities[1]));
+        EXPECT_FALSE(world.hasComponent<TestHealth>(entities[0]));
+        EXPECT_EQ(world.getComponent<TestPosition>(entities[1])->x, 1.0f);
+        EXPECT_EQ(world.count<TestPosition>(), 4);
+        EXPECT_EQ((world.count<TestPosition, TestHealth>()), 1);
+
+        // adding an existing component overwrites it
+        world.addComponent(entities[1], TestHealth{11});
+        EXPECT_EQ(world.getComponent<TestHealth>(entities[1])->value, 11);
+
+        world.removeComponent<TestPosition>(entities[1]);
+        EXPECT_FALSE(world.hasComponent<TestPosition>(entities[1]));
+        EXPECT_EQ(world.getComponent<TestHealth>(entities[1])->value, 11);
+        EXPECT_EQ(world.count<TestPosition>(), 3);
+
+        world.destroyEntity(entities[0]);
+        EXPECT_EQ(world.getComponent<TestPosition>(entities[2])->x, 2.0f);
+        EXPECT_EQ(world.getComponent<TestPosition>(entities[3])->y, -3.0f);
+
+        int visited = 0;
+        world.each<const TestPosition>([&](Entity entity, const TestPosition& position) {
+            EXPECT_EQ(world.getComponent<TestPosition>(entity)->x, position.x);
+            ++visited;
+        });
+        EXPECT_EQ(visited, 2);
+    }
+
+    // systems: non conflicting neighbours share a stage, stages run in registration order
+    {
+        EntityWorld world;
+        for (int i = 0; i < 3000; ++i)
+            world.createEntity(TestPosition{}, TestHealth{1});
+
+        std::mutex mutex;
+        std::vector<std::string> order;
+        auto record = [&](const char* name) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.emplace_back(name);
+        };
+
+        world.addSystem("move", 0, EntityWorld::getComponentMask<TestPosition>(), [&](EntityWorld& w, float dt) {
+            w.parallelEach<TestPosition>([&](Entity, TestPosition& position) { position.x += dt; });
+            record("move");
+        });
+        world.addSystem("heal", EntityWorld::getComponentMask<TestHealth>(), 0, [&](EntityWorld&, float) {
+            record("heal");
+        });
+        world.addSystem("check", EntityWorld::getComponentMask<TestPosition>(), 0, [&](EntityWorld& w, float) {
+            // runs after "move" wrote every position
+            w.each<const TestPosition>([&](Entity, const TestPosition& position) { EXPECT_EQ(position.x, 1.0f); });
+            record("check");
+        });
+        world.addSystem("exclusive", 0, 0, [&](EntityWorld&, float) { record("exclusive"); });
+
+        world.update(1.0f);
+        EXPECT_EQ(world.getStageCount(), 3);
+        EXPECT_EQ(order.size(), 4);
+        EXPECT_TRUE((order[0] == "move" && order[1] == "heal") || (order[0] == "heal" && order[1] == "move"));
+        EXPECT_EQ(order[2], "check");
+        EXPECT_EQ(order[3], "exclusive");
+
+        world.setSystemEnabled("check", false);
+        order.clear();
+        world.update(0.0f);
+        EXPECT_EQ(world.getStageCount(), 2);
+        EXPECT_EQ(order.size(), 3);
+        EXPECT_TRUE(world.removeSystem("check"));
+        EXPECT_FALSE(world.hasSystem("check"));
+    }
+
+    // deferred changes made by a system apply before the next stage
+    {
+        EntityWorld world;
+        auto doomed = world.createEntity(TestHealth{0});
+
+        world.addSystem("spawn", 0, EntityWorld::getComponentMask<TestHealth>(), [doomed](EntityWorld& w, float) {
+            w.defer([](EntityWorld& world) { world.createEntity(TestHealth{7}); });
+            w.defer([doomed](EntityWorld& world) { world.destroyEntity(doomed); });
+        });
+        size_t seen = 0;
+        world.addSystem("count", EntityWorld::getComponentMask<TestHealth>(), 0,
+                        [&](EntityWorld& w, float) { seen = w.count<TestHealth>(); });
+
+        world.update(0.0f);
+        EXPECT_EQ(world.getStageCount(), 2);
+        EXPECT_EQ(seen, 1);
+        EXPECT_FALSE(world.isAlive(doomed));
+        int value = 0;
+        world.each<const TestHealth>([&](Entity, const TestHealth& health) { value = health.value; });
+        EXPECT_EQ(value, 7);
+    }
+}
+
+std::string EntityWorldTest::subtitle() const
+{
+    return "EntityWorld handles, components, stages and deferred changes";
+}
+#endif
+
+// DispatchQueueTest
+
+namespace
+{
+// counts the live copies of a functor, padded to be stored inline or boxed by DispatchAction
+template <size_t Size>
+struct TrackedAction
+{
+    int* live;
+    int* calls;
+    char padding[Size];
+
+    TrackedAction(int* live, int* calls) : live(live), calls(calls) { ++*live; }
+    TrackedAction(const TrackedAction& other) : live(other.live), calls(other.calls) { ++*live; }
+    TrackedAction(TrackedAction&& other) noexcept : live(other.live), calls(other.calls) { ++*live; }
+    ~TrackedAction() { --*live; }
+
+    void operator()() { ++*calls; }
+};
+
+template <size_t Size>
+void testDispatchAction()
+{
+    int live = 0, calls = 0;
+    {
+        DispatchAction action(TrackedAction<Size>(&live, &calls));
+        EXPECT_TRUE(static_cast<bool>(action));
+        EXPECT_EQ(live, 1);
+
+        DispatchAction moved(std::move(action));
+        EXPECT_FALSE(static_cast<bool>(action));
+        EXPECT_EQ(live, 1);
+        moved();
+        EXPECT_EQ(calls, 1);
+
+        DispatchAction assigned(TrackedAction<Size>(&live, &calls));
+        EXPECT_EQ(live, 2);
+        assigned = std::move(moved);
+        EXPECT_EQ(live, 1);
+        assigned();
+        EXPECT_EQ(calls, 2);
+
+        assigned.reset();
+        EXPECT_EQ(live, 0);
+
+        DispatchAction kept(TrackedAction<Size>(&live, &calls));
+        EXPECT_EQ(live, 1);
+    }
+    EXPECT_EQ(live, 0);
+}
+}  // namespace
+
+void DispatchQueueTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    // functors are stored inline up to INLINE_SIZE and boxed above, both move and destroy exactly once
+    testDispatchAction<8>();
+    testDispatchAction<DispatchAction::INLINE_SIZE * 2>();
+
+    // one producer keeps its order while the ring fills, overflows and is used again
+    {
+        DispatchQueue queue(4);
+        std::vector<int> order;
+        for (int i = 0; i < 20; ++i)
+            queue.post([&order, i] { order.push_back(i); });
+        EXPECT_TRUE(queue.getStats(DispatchPriority::NORMAL).overflowed > 0);
+        for (int i = 20; i < 23; ++i)
+            queue.post([&order, i] { order.push_back(i); });
+
+        EXPECT_EQ(queue.perform(), 23);
+        for (int i = 0; i < 3; ++i)
+            queue.post([&order, i] { order.push_back(23 + i); });
+        EXPECT_EQ(queue.perform(), 3);
+
+        EXPECT_EQ(order.size(), 26);
+        for (int i = 0; i < 26; ++i)
+            EXPECT_EQ(order[i], i);
+        EXPECT_EQ(queue.getPendingCount(), 0);
+    }
+
+    // several producers against a small ring, each one's actions stay in order
+    {
+        const int producers = 4;
+        const int posts     = 5000;
+        DispatchQueue queue(8);
+        std::vector<int> last(producers, -1);
+        std::atomic<int> finished{0};
+        bool ordered = true;
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p] {
+                for (int i = 0; i < posts; ++i)
+                {
+                    queue.post([&, p, i] {
+                        ordered = ordered && last[p] + 1 == i;
+                        last[p] = i;
+                    });
+                }
+                ++finished;
+            });
+        }
+        while (finished < producers)
+            queue.perform();
+        for (auto& thread : threads)
+            thread.join();
+        queue.perform();
+        queue.perform();
+
+        EXPECT_TRUE(ordered);
+        for (int p = 0; p < producers; ++p)
+            EXPECT_EQ(last[p], posts - 1);
+    }
+
+    // actions posted while performing wait for the next frame
+    {
+        DispatchQueue queue;
+        int performed = 0;
+        queue.post([&] {
+            ++performed;
+            queue.post([&] { ++performed; });
+        });
+        EXPECT_EQ(queue.perform(), 1);
+        EXPECT_EQ(performed, 1);
+        EXPECT_EQ(queue.perform(), 1);
+        EXPECT_EQ(performed, 2);
+    }
+
+    // clear() drops the actions posted before it and keeps the ones posted after, even while performing
+    {
+        DispatchQueue queue;
+        std::vector<int> order;
+        queue.post([&] { order.push_back(0); });
+        queue.clear();
+        queue.post([&] { order.push_back(1); });
+        EXPECT_EQ(queue.perform(), 1);
+
+        queue.post(
+            [&] {
+                queue.clear();
+                queue.post([&] { order.push_back(3); }, DispatchPriority::LOW);
+            },
+            DispatchPriority::HIGH);
+        queue.post([&] { order.push_back(2); }, DispatchPriority::LOW);
+        EXPECT_EQ(queue.perform(), 1);
+        EXPECT_EQ(queue.perform(), 1);
+
+        EXPECT_EQ(order, std::vector<int>({1, 3}));
+        EXPECT_EQ(queue.getStats(DispatchPriority::NORMAL).discarded, 1);
+        EXPECT_EQ(queue.getStats(DispatchPriority::LOW).discarded, 1);
+    }
+
+    // a spent budget still performs one NORMAL and one LOW action per frame, HIGH ones all run
+    {
+        DispatchQueue queue;
+        queue.setTimeBudget(0.000001f);
+        auto slow = [] { std::this_thread::sleep_for(std::chrono::microseconds(200)); };
+        for (int i = 0; i < 3; ++i)
+        {
+            queue.post(slow, DispatchPriority::HIGH);
+            queue.post(slow, DispatchPriority::NORMAL);
+            queue.post(slow, DispatchPriority::LOW);
+        }
+
+        EXPECT_EQ(queue.perform(), 5);
+        EXPECT_EQ(queue.perform(), 2);
+        EXPECT_EQ(queue.perform(), 2);
+        EXPECT_EQ(queue.getPendingCount(), 0);
+        EXPECT_TRUE(queue.getStats(DispatchPriority::NORMAL).starvedFrames > 0);
+    }
+}
+
+std::string DispatchQueueTest::subtitle() const
+{
+    return "DispatchQueue order, overflow, clear and budget";
+}
+
+// DestructionQueueTest
+
+namespace
+{
+// records its destruction and releases its children like a Node does
+class TrackedRef : public Ref
+{
+public:
+    TrackedRef(std::vector<int>* destroyed, int id) : _destroyed(destroyed), _id(id) {}
+    ~TrackedRef() override
+    {
+        _destroyed->push_back(_id);
+        for (auto child : _children)
+            child->release();
+    }
+
+    void addChild(TrackedRef* child) { _children.push_back(child); }
+
+private:
+    std::vector<int>* _destroyed;
+    int _id;
+    std::vector<TrackedRef*> _children;
+};
+
+// destroyed by the JobSystem, holds the worker until the gate opens
+class GatedRef : public Ref
+{
+public:
+    GatedRef(std::atomic<bool>* gate, std::atomic<bool>* destroyed) : _gate(gate), _destroyed(destroyed) {}
+    ~GatedRef() override
+    {
+        while (!_gate->load())
+            std::this_thread::yield();
+        _destroyed->store(true);
+    }
+
+private:
+    std::atomic<bool>* _gate;
+    std::atomic<bool>* _destroyed;
+};
+
+void checkBackgroundWait(bool destroyInstance)
+{
+    auto queue = DestructionQueue::getInstance();
+    queue->setBackgroundDestruction<GatedRef>(true);
+
+    std::atomic<bool> gate{false}, destroyed{false};
+    const auto stats = queue->getStats();
+    {
+        DestructionQueue::Scope deferring;
+        (new GatedRef(&gate, &destroyed))->release();
+    }
+
+    // handed to the JobSystem, it isn't counted as destroyed but stays in the backlog until deleted
+    EXPECT_EQ(queue->update(), 0);
+    EXPECT_EQ(queue->getStats().destroyedInBackground, stats.destroyedInBackground + 1);
+    EXPECT_EQ(queue->getBacklogSize(), 1);
+    EXPECT_FALSE(destroyed.load());
+
+    std::thread opener([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        gate = true;
+    });
+    if (destroyInstance)
+        DestructionQueue::destroyInstance();
+    else
+        queue->flush();
+    EXPECT_TRUE(destroyed.load());
+    opener.join();
+
+    queue = DestructionQueue::getInstance();
+    EXPECT_EQ(queue->getBacklogSize(), 0);
+    queue->setBackgroundDestruction<GatedRef>(false);
+}
+}  // namespace
+
+void DestructionQueueTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    auto queue = DestructionQueue::getInstance();
+    queue->flush();
+    const bool enabled = queue->isEnabled();
+    const auto budget  = queue->getTimeBudget();
+
+    std::vector<int> destroyed;
+
+    // disabled, a Scope has no effect
+    queue->setEnabled(false);
+    {
+        DestructionQueue::Scope deferring;
+        (new TrackedRef(&destroyed, 0))->release();
+    }
+    EXPECT_EQ(destroyed, std::vector<int>({0}));
+    destroyed.clear();
+
+    // enabled, a Scope queues instead of deleting
+    queue->setEnabled(true);
+    {
+        DestructionQueue::Scope deferring;
+        (new TrackedRef(&destroyed, 0))->release();
+        EXPECT_TRUE(DestructionQueue::isDeferring());
+    }
+    EXPECT_FALSE(DestructionQueue::isDeferring());
+    EXPECT_TRUE(destroyed.empty());
+    EXPECT_EQ(queue->getBacklogSize(), 1);
+    EXPECT_EQ(queue->update(), 1);
+    EXPECT_EQ(destroyed, std::vector<int>({0}));
+    EXPECT_EQ(queue->getBacklogSize(), 0);
+    destroyed.clear();
+
+    // a spent budget still destroys one object per update, children queue behind their parent
+    queue->setTimeBudget(0.000000001f);
+    {
+        auto root = new TrackedRef(&destroyed, 1);
+        for (int i = 0; i < 2; ++i)
+        {
+            auto child = new TrackedRef(&destroyed, 10 + i);
+            for (int j = 0; j < 2; ++j)
+                child->addChild(new TrackedRef(&destroyed, 100 + i * 10 + j));
+            root->addChild(child);
+        }
+
+        DestructionQueue::Scope deferring;
+        root->release();
+    }
+    const std::vector<int> expected = {1, 10, 11, 100, 101, 110, 111};
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(queue->update(), 1);
+        EXPECT_EQ(destroyed.size(), i + 1);
+    }
+    EXPECT_EQ(destroyed, expected);
+    EXPECT_EQ(queue->update(), 0);
+    destroyed.clear();
+
+    // a zero budget drains the whole backlog, the objects queued by the destructors included
+    queue->setTimeBudget(0.0f);
+    {
+        auto root = new TrackedRef(&destroyed, 1);
+        root->addChild(new TrackedRef(&destroyed, 2));
+        DestructionQueue::Scope deferring;
+        root->release();
+    }
+    EXPECT_EQ(queue->update(), 2);
+    destroyed.clear();
+
+    // background deletions count in the backlog, flush() and destroyInstance() wait for them
+    checkBackgroundWait(false);
+    checkBackgroundWait(true);
+
+    queue = DestructionQueue::getInstance();
+    queue->setTimeBudget(budget);
+    queue->setEnabled(enabled);
+}
+
+std::string DestructionQueueTest::subtitle() const
+{
+    return "DestructionQueue scopes, budget and background deletion";
+}
+
+// ETC2DecodeTest
+
+namespace
+{
+// an ETC1 compatible block in individual mode, every pixel is the base color plus the first modifier of table 0
+const uint8_t ETC2_RED_BLOCK[8] = {0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+const uint8_t ETC2_RED_PIXEL[4] = {255, 2, 2, 255};
+
+bool isSolidETC2Red(const uint8_t* pixels, int width, int height)
+{
+    for (int i = 0; i < width * height; ++i)
+    {
+        if (memcmp(pixels + i * 4, ETC2_RED_PIXEL, 4) != 0)
+            return false;
+    }
+    return true;
+}
+
+// a PKM 2.0 file of width x height pixels filled with ETC2_RED_BLOCK
+std::vector<uint8_t> makeETC2RedPKM(int width, int height)
+{
+    const int blocksWide = (width + 3) / 4, blocksHigh = (height + 3) / 4;
+    std::vector<uint8_t> pkm(ETC2_PKM_HEADER_SIZE + blocksWide * blocksHigh * sizeof(ETC2_RED_BLOCK));
+    const int fields[] = {ETC2_RGB_NO_MIPMAPS, blocksWide * 4, blocksHigh * 4, width, height};
+    memcpy(pkm.data(), "PKM 20", 6);
+    for (int i = 0; i < 5; ++i)
+    {
+        pkm[6 + i * 2]     = static_cast<uint8_t>(fields[i] >> 8);
+        pkm[6 + i * 2 + 1] = static_cast<uint8_t>(fields[i]);
+    }
+    for (size_t offset = ETC2_PKM_HEADER_SIZE; offset < pkm.size(); offset += sizeof(ETC2_RED_BLOCK))
+        memcpy(pkm.data() + offset, ETC2_RED_BLOCK, sizeof(ETC2_RED_BLOCK));
+    return pkm;
+}
+}  // namespace
+
+void ETC2DecodeTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    // partial blocks on both axes
+    const int width = 6, height = 5;
+    std::vector<uint8_t> blocks(4 * sizeof(ETC2_RED_BLOCK));
+    for (size_t offset = 0; offset < blocks.size(); offset += sizeof(ETC2_RED_BLOCK))
+        memcpy(blocks.data() + offset, ETC2_RED_BLOCK, sizeof(ETC2_RED_BLOCK));
+
+    std::vector<uint8_t> pixels(width * height * 4);
+    EXPECT_EQ(etc2_decode_image(ETC2_RGB_NO_MIPMAPS, blocks.data(), pixels.data(), width, height), 0);
+    EXPECT_TRUE(isSolidETC2Red(pixels.data(), width, height));
+
+    // an unsupported format fails, Image must not report such a decode as a success
+    EXPECT_EQ(etc2_decode_image(0, blocks.data(), pixels.data(), width, height), -1);
+
+    // the software decoder only runs without hardware ETC2, the pixels are forwarded otherwise
+    auto pkm   = makeETC2RedPKM(width, height);
+    RefPtr<Image> image(ReferencedObject<Image>{new Image()});
+    EXPECT_TRUE(image->initWithImageData(pkm.data(), static_cast<ssize_t>(pkm.size())));
+    EXPECT_EQ(image->getWidth(), width);
+    EXPECT_EQ(image->getHeight(), height);
+    if (image->getPixelFormat() == backend::PixelFormat::RGBA8)
+    {
+        EXPECT_EQ(image->getDataLen(), static_cast<ssize_t>(pixels.size()));
+        EXPECT_TRUE(isSolidETC2Red(image->getData(), width, height));
+    }
+    else
+    {
+        EXPECT_EQ(image->getPixelFormat(), backend::PixelFormat::ETC2_RGB);
+        EXPECT_EQ(image->getDataLen(), static_cast<ssize_t>(blocks.size()));
+    }
+}
+
+std::string ETC2DecodeTest::subtitle() const
+{
+    return "ETC2 software decoding";
+}
+
+// ParticleStepTest
+
+namespace
+{
+// exposes the particle arrays and the step of a system that is never added to a scene
+class SteppedParticleSystem : public ParticleSystem
+{
+public:
+    ParticleData& getData() { return _particleData; }
+    void setCount(int count) { _particleCount = count; }
+    bool step(float dt) { return stepParticles(dt, dt); }
+};
+
+bool nearlyEqual(float value, float expected)
+{
+    // the SIMD lanes and the scalar tails may round differently, e.g. when multiply-adds are fused
+    return std::abs(value - expected) <= 1e-4f * std::max(1.0f, std::abs(expected));
+}
+
+bool nearlyEqual(const float* values, const std::vector<float>& expected)
+{
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        if (!nearlyEqual(values[i], expected[i]))
+            return false;
+    }
+    return true;
+}
+
+void fillRandom(float* values, int count, std::mt19937& rng, float low, float high)
+{
+    std::uniform_real_distribution<float> dist(low, high);
+    for (int i = 0; i < count; ++i)
+        values[i] = dist(rng);
+}
+}  // namespace
+
+void ParticleStepTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    // not a multiple of 4, the last particles go through the scalar tails of the kernels
+    const int count = 39;
+    const float dt  = 1.0f / 60;
+    std::mt19937 rng(1234);
+
+    auto system = new SteppedParticleSystem();
+    EXPECT_TRUE(system->initWithTotalParticles(count));
+    auto& p = system->getData();
+
+    auto randomize = [&]() {
+        system->setCount(count);
+        fillRandom(p.timeToLive, count, rng, 1.0f, 5.0f);
+        fillRandom(p.posx, count, rng, -100.0f, 100.0f);
+        fillRandom(p.posy, count, rng, -100.0f, 100.0f);
+        fillRandom(p.modeA.dirX, count, rng, -50.0f, 50.0f);
+        fillRandom(p.modeA.dirY, count, rng, -50.0f, 50.0f);
+        fillRandom(p.modeA.radialAccel, count, rng, -20.0f, 20.0f);
+        fillRandom(p.modeA.tangentialAccel, count, rng, -20.0f, 20.0f);
+        fillRandom(p.modeB.angle, count, rng, -3.0f, 3.0f);
+        fillRandom(p.modeB.degreesPerSecond, count, rng, -2.0f, 2.0f);
+        fillRandom(p.modeB.radius, count, rng, 0.0f, 100.0f);
+        fillRandom(p.modeB.deltaRadius, count, rng, -10.0f, 10.0f);
+        for (auto v : {p.colorR, p.colorG, p.colorB, p.colorA})
+            fillRandom(v, count, rng, 0.0f, 1.0f);
+        for (auto v : {p.deltaColorR, p.deltaColorG, p.deltaColorB, p.deltaColorA})
+            fillRandom(v, count, rng, -1.0f, 1.0f);
+        fillRandom(p.size, count, rng, 0.0f, 0.1f);
+        fillRandom(p.deltaSize, count, rng, -20.0f, 20.0f);
+        fillRandom(p.rotation, count, rng, -180.0f, 180.0f);
+        fillRandom(p.deltaRotation, count, rng, -90.0f, 90.0f);
+
+        // the kernels skip the radial acceleration of positions at the origin or on the unit circle
+        p.posx[0] = p.posy[0] = 0.0f;
+        p.posx[5] = 1.0f;
+        p.posy[5] = 0.0f;
+    };
+
+    // the scalar reference of the properties both modes step
+    auto expectCommon = [&]() {
+        std::vector<float> timeToLive(count), color(count * 4), size(count), rotation(count);
+        for (int i = 0; i < count; ++i)
+        {
+            timeToLive[i]        = p.timeToLive[i] - dt;
+            color[i]             = p.colorR[i] + p.deltaColorR[i] * dt;
+            color[count + i]     = p.colorG[i] + p.deltaColorG[i] * dt;
+            color[count * 2 + i] = p.colorB[i] + p.deltaColorB[i] * dt;
+            color[count * 3 + i] = p.colorA[i] + p.deltaColorA[i] * dt;
+            size[i]              = std::max(0.0f, p.size[i] + p.deltaSize[i] * dt);
+            rotation[i]          = p.rotation[i] + p.deltaRotation[i] * dt;
+        }
+        return [=, &p]() {
+            EXPECT_TRUE(nearlyEqual(p.timeToLive, timeToLive));
+            const float* colors[] = {p.colorR, p.colorG, p.colorB, p.colorA};
+            for (int c = 0; c < 4; ++c)
+                EXPECT_TRUE(nearlyEqual(colors[c], std::vector<float>(color.begin() + count * c,
+                                                                      color.begin() + count * (c + 1))));
+            EXPECT_TRUE(nearlyEqual(p.size, size));
+            EXPECT_TRUE(nearlyEqual(p.rotation, rotation));
+        };
+    };
+
+    // gravity mode
+    const Vec2 gravity(3.0f, -9.8f);
+    system->setEmitterMode(ParticleSystem::Mode::GRAVITY);
+    system->setGravity(gravity);
+    randomize();
+    {
+        std::vector<float> dirX(count), dirY(count), posX(count), posY(count);
+        for (int i = 0; i < count; ++i)
+        {
+            float nx = 0.0f, ny = 0.0f;
+            const float n = p.posx[i] * p.posx[i] + p.posy[i] * p.posy[i];
+            if (n != 1.0f && std::sqrt(n) >= MATH_TOLERANCE)
+            {
+                nx = p.posx[i] / std::sqrt(n);
+                ny = p.posy[i] / std::sqrt(n);
+            }
+            const float ax = nx * p.modeA.radialAccel[i] - ny * p.modeA.tangentialAccel[i] + gravity.x;
+            const float ay = ny * p.modeA.radialAccel[i] + nx * p.modeA.tangentialAccel[i] + gravity.y;
+            dirX[i]        = p.modeA.dirX[i] + ax * dt;
+            dirY[i]        = p.modeA.dirY[i] + ay * dt;
+            posX[i]        = p.posx[i] + dirX[i] * dt;
+            posY[i]        = p.posy[i] + dirY[i] * dt;
+        }
+        auto checkCommon = expectCommon();
+
+        EXPECT_TRUE(system->step(dt));
+        EXPECT_EQ(system->getParticleCount(), static_cast<unsigned int>(count));
+        EXPECT_TRUE(nearlyEqual(p.modeA.dirX, dirX));
+        EXPECT_TRUE(nearlyEqual(p.modeA.dirY, dirY));
+        EXPECT_TRUE(nearlyEqual(p.posx, posX));
+        EXPECT_TRUE(nearlyEqual(p.posy, posY));
+        checkCommon();
+    }
+
+    // radius mode
+    system->setEmitterMode(ParticleSystem::Mode::RADIUS);
+    randomize();
+    {
+        std::vector<float> angle(count), radius(count);
+        for (int i = 0; i < count; ++i)
+        {
+            angle[i]  = p.modeB.angle[i] + p.modeB.degreesPerSecond[i] * dt;
+            radius[i] = p.modeB.radius[i] + p.modeB.deltaRadius[i] * dt;
+        }
+        auto checkCommon = expectCommon();
+
+        EXPECT_TRUE(system->step(dt));
+        EXPECT_TRUE(nearlyEqual(p.modeB.angle, angle));
+        EXPECT_TRUE(nearlyEqual(p.modeB.radius, radius));
+        checkCommon();
+    }
+
+    system->release();
+}
+
+std::string ParticleStepTest::subtitle() const
+{
+    return "Particle SIMD step against a scalar reference";
+}
+
+// BinarySpriteSheetTest
+
+namespace
+{
+// a format 3 plist frame, the polygon is a quad of two triangles
+ValueMap makeSpriteSheetFrame(std::string_view textureRect, bool rotated, std::string_view triangles)
+{
+    ValueMap frame;
+    frame["spriteSize"]       = "{32,32}";
+    frame["spriteSourceSize"] = "{40,36}";
+    frame["spriteOffset"]     = "{2,-1}";
+    frame["textureRect"]      = textureRect;
+    frame["textureRotated"]   = rotated;
+    frame["vertices"]         = "0 0 32 0 32 32 0 32";
+    frame["verticesUV"]       = "10 20 42 20 42 52 10 52";
+    frame["triangles"]        = triangles;
+    return frame;
+}
+}  // namespace
+
+void BinarySpriteSheetTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    auto fileUtils       = FileUtils::getInstance();
+    const auto plistPath = fileUtils->getWritablePath() + "unit_test_sheet.plist";
+    const auto sheetPath = fileUtils->getWritablePath() + "unit_test_sheet.axss";
+
+    ValueMap metadata;
+    metadata["format"]          = 3;
+    metadata["size"]            = "{128,64}";
+    metadata["textureFileName"] = "unit_test_sheet.png";
+
+    auto poly       = makeSpriteSheetFrame("{{10,20},{32,32}}", true, "0 1 2 0 2 3");
+    poly["aliases"] = ValueVector{Value("unit_test_alias.png")};
+    poly["anchor"]  = "{0.25,0.75}";
+
+    ValueMap frames;
+    frames["unit_test_poly.png"] = poly;
+    // the last index refers to a fifth vertex of a four vertex polygon
+    frames["unit_test_bad.png"] = makeSpriteSheetFrame("{{50,20},{32,32}}", false, "0 1 2 0 2 4");
+
+    ValueMap sheet;
+    sheet["metadata"] = metadata;
+    sheet["frames"]   = frames;
+    EXPECT_TRUE(fileUtils->writeValueMapToFile(sheet, plistPath));
+    EXPECT_TRUE(BinarySpriteSheetLoader::convertFromPlist(plistPath, sheetPath));
+
+    auto texture = _director->getTextureCache()->addImage("Images/grossini.png");
+    EXPECT_TRUE(texture != nullptr);
+
+    auto cache = SpriteFrameCache::getInstance();
+    cache->addSpriteFramesWithFile(sheetPath, texture, SpriteSheetFormat::BINARY);
+
+    auto frame = cache->getSpriteFrameByName("unit_test_poly.png");
+    EXPECT_TRUE(frame != nullptr);
+    EXPECT_EQ(frame->getTexture(), texture);
+    EXPECT_TRUE(frame->getRect().equals(Rect(10, 20, 32, 32)));
+    EXPECT_TRUE(frame->isRotated());
+    EXPECT_EQ(frame->getOffset(), Vec2(2, -1));
+    EXPECT_EQ(frame->getOriginalSize(), Vec2(40, 36));
+    EXPECT_EQ(frame->getAnchorPoint(), Vec2(0.25f, 0.75f));
+    EXPECT_EQ(cache->getSpriteFrameByName("unit_test_alias.png"), frame);
+
+    // the vertices are flipped into the sprite space, the uvs are normalized by the texture size
+    EXPECT_TRUE(frame->hasPolygonInfo());
+    auto& triangles = frame->getPolygonInfo().triangles;
+    EXPECT_EQ(triangles.indexCount, 6);
+    const unsigned short indices[] = {0, 1, 2, 0, 2, 3};
+    EXPECT_TRUE(std::equal(std::begin(indices), std::end(indices), triangles.indices));
+    const float scale = AX_CONTENT_SCALE_FACTOR();
+    EXPECT_EQ(triangles.verts[1].vertices, Vec3(32 / scale, (36 - 0) / scale, 0));
+    EXPECT_EQ(triangles.verts[2].vertices, Vec3(32 / scale, (36 - 32) / scale, 0));
+    EXPECT_EQ(triangles.verts[2].texCoords.u, 42 / 128.0f);
+    EXPECT_EQ(triangles.verts[2].texCoords.v, 52 / 64.0f);
+
+    // a frame whose triangles leave its vertices is rejected, the others still load
+    EXPECT_TRUE(cache->getSpriteFrameByName("unit_test_bad.png") == nullptr);
+
+    cache->removeSpriteFrameByName("unit_test_alias.png");
+    cache->removeSpriteFrameByName("unit_test_poly.png");
+    fileUtils->removeFile(plistPath);
+    fileUtils->removeFile(sheetPath);
+}
+
+std::string BinarySpriteSheetTest::subtitle() const
+{
+    return "Binary sprite sheet round trip";
+}
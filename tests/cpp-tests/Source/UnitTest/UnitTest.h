@@ -35,6 +35,27 @@ public:
     virtual std::string title() const override;
 };
 
+/** Times code and shows the results, build in release mode for meaningful numbers. */
+class UnitTestBenchmark : public UnitTestDemo
+{
+public:
+    virtual void onExit() override;
+
+protected:
+    /**
+     * Runs func repeat times, logs and shows the average time of one run in milliseconds, and per item in
+     * nanoseconds when a run processes items.
+     */
+    double measure(std::string_view name,
+                   int repeat,
+                   const std::function<void()>& func,
+                   size_t items             = 0,
+                   std::string_view itemName = "item");
+
+    std::string _report;
+    ax::Label* _reportLabel = nullptr;
+};
+
 //-------------------------------------
 
 class TemplateVectorTest : public UnitTestDemo
@@ -112,4 +133,102 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class ManifestTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(ManifestTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class PixelFormatUtilsTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(PixelFormatUtilsTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class PixelFormatUtilsBenchmark : public UnitTestBenchmark
+{
+public:
+    CREATE_FUNC(PixelFormatUtilsBenchmark);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class ObjectAllocatorTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(ObjectAllocatorTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class ObjectAllocatorBenchmark : public UnitTestBenchmark
+{
+public:
+    CREATE_FUNC(ObjectAllocatorBenchmark);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+#if AX_USE_ECS
+class EntityWorldTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(EntityWorldTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+#endif
+
+class NodeVisitBenchmark : public UnitTestBenchmark
+{
+public:
+    CREATE_FUNC(NodeVisitBenchmark);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class DispatchQueueTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(DispatchQueueTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class DestructionQueueTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(DestructionQueueTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class ETC2DecodeTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(ETC2DecodeTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class ParticleStepTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(ParticleStepTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class BinarySpriteSheetTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(BinarySpriteSheetTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
 #endif /* __UNIT_TEST__ */